@@ -0,0 +1,153 @@
+#include "PrimeHost/Audio.h"
+
+#include "AudioLoopbackProbe.h"
+#include "platform/null/AudioNull.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Round-trip latency/jitter harness: drives a real-time duplex stream on the null backend's
+// loopback input for each buffer size, injects impulses through the output callback and times
+// their return. Writes a JSON report to the path given as the first argument (stdout otherwise)
+// and exits non-zero if an impulse is lost or returns later than the configured latency allows.
+
+namespace {
+
+constexpr uint32_t kChannels = 2u;
+constexpr uint32_t kSampleRate = 48000u;
+constexpr uint32_t kLoopbackLatencyFrames = 128u;
+constexpr uint32_t kMinCallbacks = 32u;
+constexpr double kSecondsPerSize = 0.25;
+
+struct SizeResult {
+  AudioLoopbackReport report{};
+  uint64_t expectedLatencyFrames = 0u;
+  bool pass = false;
+};
+
+SizeResult measure(uint32_t bufferFrames) {
+  SizeResult result{};
+  // The duplex callback reads back what earlier callbacks rendered, so the echo arrives one buffer
+  // later at minimum, or after the simulated device latency if that is longer.
+  result.expectedLatencyFrames = std::max(bufferFrames, kLoopbackLatencyFrames);
+
+  AudioNullConfig nullConfig{};
+  nullConfig.loopbackLatencyFrames = kLoopbackLatencyFrames;
+  AudioHostNull audio(nullConfig);
+  AudioStreamConfig config{};
+  config.format.sampleRate = kSampleRate;
+  config.format.channels = kChannels;
+  config.bufferFrames = bufferFrames;
+  config.periodFrames = bufferFrames;
+
+  const auto callbacks = std::max(
+      kMinCallbacks, static_cast<uint32_t>(kSecondsPerSize * kSampleRate / static_cast<double>(bufferFrames)));
+  AudioLoopbackProbe probe;
+  probe.prepare(kSampleRate, bufferFrames, callbacks);
+  if (!audio.openDuplexStream(AudioHostNull::LoopbackDeviceId,
+                              AudioHostNull::DeviceId,
+                              config,
+                              &AudioLoopbackProbe::duplexCallback,
+                              &probe) ||
+      !audio.startStream()) {
+    return result;
+  }
+  const auto expected = std::chrono::duration<double>(static_cast<double>(callbacks) * bufferFrames / kSampleRate);
+  const auto giveUp = std::chrono::steady_clock::now() +
+                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(expected * 4.0);
+  while (!probe.finished() && std::chrono::steady_clock::now() < giveUp) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  audio.stopStream();
+  audio.closeStream();
+
+  result.report = probe.report();
+  result.pass = result.report.impulses > 0u &&
+                result.report.latencyFrames.max <= static_cast<double>(result.expectedLatencyFrames);
+  return result;
+}
+
+void append_percentiles(std::string& out, const char* name, const AudioPercentiles& p) {
+  char buffer[192];
+  std::snprintf(buffer,
+                sizeof(buffer),
+                "\"%s\":{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+                name,
+                p.p50,
+                p.p90,
+                p.p99,
+                p.max);
+  out += buffer;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::vector<SizeResult> results;
+  for (uint32_t frames : {64u, 128u, 256u, 512u, 1024u, 2048u}) {
+    results.push_back(measure(frames));
+  }
+
+  bool pass = true;
+  std::string json;
+  char buffer[256];
+  std::snprintf(buffer,
+                sizeof(buffer),
+                "{\"backend\":\"null\",\"sampleRate\":%u,\"channels\":%u,\"loopbackLatencyFrames\":%u,\"results\":[",
+                kSampleRate,
+                kChannels,
+                kLoopbackLatencyFrames);
+  json += buffer;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const SizeResult& result = results[i];
+    const AudioLoopbackReport& report = result.report;
+    pass = pass && result.pass;
+    std::snprintf(buffer,
+                  sizeof(buffer),
+                  "%s{\"bufferFrames\":%u,\"callbacks\":%u,\"impulses\":%u,\"inputUnderruns\":%u,"
+                  "\"expectedLatencyFrames\":%llu,\"latencyMs\":%.3f,",
+                  i == 0u ? "" : ",",
+                  report.bufferFrames,
+                  report.callbacks,
+                  report.impulses,
+                  report.inputUnderruns,
+                  static_cast<unsigned long long>(result.expectedLatencyFrames),
+                  report.latencyFrames.p50 * 1000.0 / kSampleRate);
+    json += buffer;
+    append_percentiles(json, "latencyFrames", report.latencyFrames);
+    json += ',';
+    append_percentiles(json, "jitterUs", report.jitterUs);
+    json += ',';
+    append_percentiles(json, "wakeErrorUs", report.wakeErrorUs);
+    json += result.pass ? ",\"pass\":true}" : ",\"pass\":false}";
+
+    std::fprintf(stderr,
+                 "frames=%-5u latency=%.0f frames (%.2fms) jitter p99=%.1fus wake p99=%.1fus %s\n",
+                 report.bufferFrames,
+                 report.latencyFrames.p50,
+                 report.latencyFrames.p50 * 1000.0 / kSampleRate,
+                 report.jitterUs.p99,
+                 report.wakeErrorUs.p99,
+                 result.pass ? "ok" : "FAIL");
+  }
+  json += pass ? "],\"pass\":true}\n" : "],\"pass\":false}\n";
+
+  if (argc > 1) {
+    FILE* file = std::fopen(argv[1], "w");
+    if (!file) {
+      std::fprintf(stderr, "cannot write %s\n", argv[1]);
+      return 1;
+    }
+    std::fputs(json.c_str(), file);
+    std::fclose(file);
+  } else {
+    std::fputs(json.c_str(), stdout);
+  }
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include "PrimeHost/Audio.h"
+
+#include "AudioMixKernels.h"
+#include "AudioMixer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+constexpr uint32_t kChannels = 2u;
+constexpr uint32_t kFrames = 256u;
+constexpr uint32_t kSampleRate = 48000u;
+constexpr int kIterations = 20000;
+
+void fill_noise(std::span<float> interleaved, const AudioCallbackContext& ctx, void*) {
+  uint32_t seed = static_cast<uint32_t>(ctx.frameIndex) * 2654435761u + 1u;
+  for (float& sample : interleaved) {
+    seed = seed * 1664525u + 1013904223u;
+    sample = static_cast<float>(seed >> 8u) / 16777216.0f - 0.5f;
+  }
+}
+
+template <typename Fn>
+double time_per_iteration_ns(Fn&& fn) {
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    fn(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+         kIterations;
+}
+
+} // namespace
+
+int main() {
+  std::vector<float> src(kFrames * kChannels, 0.25f);
+  std::vector<float> dst(kFrames * kChannels, 0.0f);
+
+  double scalarNs = time_per_iteration_ns([&](int) {
+    mixScaledScalar(dst.data(), src.data(), src.size(), 0.5f);
+  });
+  double kernelNs = time_per_iteration_ns([&](int) {
+    mixScaled(dst.data(), src.data(), src.size(), 0.5f);
+  });
+  std::printf("kernel frames=%u channels=%u scalar=%.1fns simd=%.1fns speedup=%.2fx\n",
+              kFrames,
+              kChannels,
+              scalarNs,
+              kernelNs,
+              kernelNs > 0.0 ? scalarNs / kernelNs : 0.0);
+
+  const double budgetNs = static_cast<double>(kFrames) * 1'000'000'000.0 / kSampleRate;
+  for (uint32_t streams : {1u, 4u, 8u, AudioMaxMixStreams}) {
+    AudioMixer mixer;
+    mixer.prepare(kChannels, kFrames, kSampleRate);
+    for (uint32_t i = 0; i < streams; ++i) {
+      AudioMixStreamConfig config{};
+      config.channels = (i % 2u == 0u) ? 2u : 1u;
+      config.gain = 0.5f;
+      mixer.addStream(config, fill_noise, nullptr);
+    }
+    AudioCallbackContext ctx{};
+    ctx.requestedFrames = kFrames;
+    double renderNs = time_per_iteration_ns([&](int i) {
+      ctx.frameIndex = static_cast<uint64_t>(i);
+      mixer.render(dst, ctx);
+    });
+    std::printf("mixer streams=%u frames=%u render=%.1fns load=%.4f\n",
+                streams,
+                kFrames,
+                renderNs,
+                renderNs / budgetNs);
+  }
+  return 0;
+}
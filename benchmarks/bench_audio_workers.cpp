@@ -0,0 +1,124 @@
+#include "PrimeHost/AudioWorkers.h"
+
+#include "platform/null/AudioNull.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+constexpr uint32_t kChannels = 2u;
+constexpr uint32_t kFrames = 256u;
+constexpr uint32_t kSampleRate = 48000u;
+constexpr uint32_t kBuses = 32u;
+constexpr uint32_t kFilterStages = 24u;
+constexpr int kIterations = 400;
+
+// Stand-in for per-bus DSP: a cascade of one-pole filters over a mono bus.
+struct Bus {
+  std::vector<float> samples = std::vector<float>(kFrames, 0.0f);
+  std::array<float, kFilterStages> state{};
+  float phase = 0.0f;
+};
+
+struct Mixer {
+  std::vector<Bus> buses = std::vector<Bus>(kBuses);
+  AudioWorkerPool* pool = nullptr;
+  uint64_t late = 0u;
+  uint64_t dropped = 0u;
+};
+
+void render_bus(uint32_t busIndex, void* userData) {
+  auto* mixer = static_cast<Mixer*>(userData);
+  Bus& bus = mixer->buses[busIndex];
+  const float step = 0.01f + 0.001f * static_cast<float>(busIndex);
+  for (float& sample : bus.samples) {
+    bus.phase += step;
+    float value = std::sin(bus.phase);
+    for (float& stage : bus.state) {
+      stage += 0.2f * (value - stage);
+      value = stage;
+    }
+    sample = value;
+  }
+}
+
+void mix_buses(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+  auto* mixer = static_cast<Mixer*>(userData);
+  if (mixer->pool) {
+    auto result = mixer->pool->dispatch(kBuses, render_bus, mixer, audioDispatchDeadline(ctx, kSampleRate));
+    if (result) {
+      mixer->late += result->late;
+      mixer->dropped += result->dropped;
+    }
+  } else {
+    for (uint32_t bus = 0; bus < kBuses; ++bus) {
+      render_bus(bus, mixer);
+    }
+  }
+  const float gain = 1.0f / kBuses;
+  for (const Bus& bus : mixer->buses) {
+    for (uint32_t frame = 0; frame < ctx.requestedFrames; ++frame) {
+      interleaved[frame * kChannels] += bus.samples[frame] * gain;
+      interleaved[frame * kChannels + 1u] += bus.samples[frame] * gain;
+    }
+  }
+}
+
+double render_ns(Mixer& mixer) {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+  AudioStreamConfig config{};
+  config.format.sampleRate = kSampleRate;
+  config.format.channels = kChannels;
+  config.bufferFrames = kFrames;
+  config.periodFrames = kFrames;
+  audio.openStream(AudioHostNull::DeviceId, config, mix_buses, &mixer);
+  audio.startStream();
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    audio.renderFrames(kFrames);
+  }
+  auto end = std::chrono::steady_clock::now();
+  audio.closeStream();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+         kIterations;
+}
+
+} // namespace
+
+int main() {
+  const double budgetNs = static_cast<double>(kFrames) * 1'000'000'000.0 / kSampleRate;
+
+  Mixer serial{};
+  const double serialNs = render_ns(serial);
+  std::printf("serial buses=%u render=%.1fns load=%.3f\n", kBuses, serialNs, serialNs / budgetNs);
+
+  for (uint32_t workers : {1u, 2u, 4u}) {
+    AudioWorkerPoolConfig config{};
+    config.workerCount = workers;
+    auto pool = createAudioWorkerPool(config);
+    if (!pool) {
+      return 1;
+    }
+    Mixer parallel{};
+    parallel.pool = pool.value().get();
+    const double parallelNs = render_ns(parallel);
+    AudioWorkerStats stats = pool.value()->stats();
+    std::printf("pool workers=%u realtime=%u render=%.1fns load=%.3f speedup=%.2fx late=%llu dropped=%llu\n",
+                workers,
+                stats.realtimeWorkers,
+                parallelNs,
+                parallelNs / budgetNs,
+                parallelNs > 0.0 ? serialNs / parallelNs : 0.0,
+                static_cast<unsigned long long>(parallel.late),
+                static_cast<unsigned long long>(parallel.dropped));
+  }
+  return 0;
+}
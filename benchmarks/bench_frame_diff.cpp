@@ -0,0 +1,99 @@
+#include "PrimeHost/FrameDiff.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Golden comparison benchmark: the naive per-pixel loop regression suites started with, against
+// diffImages on one thread and on the default thread count.
+
+namespace {
+
+constexpr uint32_t kWidth = 3840u;
+constexpr uint32_t kHeight = 2160u;
+constexpr int kIterations = 10;
+
+struct NaiveResult {
+  uint32_t maxDelta = 0u;
+  uint64_t differing = 0u;
+};
+
+NaiveResult naive_diff(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, std::vector<uint8_t>& diff) {
+  NaiveResult result{};
+  for (size_t i = 0; i < a.size(); i += 4u) {
+    bool differs = false;
+    for (size_t c = 0; c < 4u; ++c) {
+      const uint32_t delta = static_cast<uint32_t>(std::abs(static_cast<int>(a[i + c]) - static_cast<int>(b[i + c])));
+      result.maxDelta = std::max(result.maxDelta, delta);
+      differs = differs || delta > 0u;
+      diff[i + c] = static_cast<uint8_t>(delta);
+    }
+    result.differing += differs ? 1u : 0u;
+  }
+  return result;
+}
+
+template <typename Fn>
+double time_ms(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    fn();
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kIterations;
+}
+
+} // namespace
+
+int main() {
+  const size_t bytes = static_cast<size_t>(kWidth) * kHeight * 4u;
+  std::vector<uint8_t> expected(bytes);
+  for (size_t i = 0; i < bytes; ++i) {
+    expected[i] = static_cast<uint8_t>((i * 2654435761u) >> 24u);
+  }
+  std::vector<uint8_t> actual = expected;
+  // A small changed widget, as in a typical regression.
+  for (uint32_t y = 900u; y < 960u; ++y) {
+    for (uint32_t x = 1700u; x < 1900u; ++x) {
+      actual[(static_cast<size_t>(y) * kWidth + x) * 4u] ^= 0x5Au;
+    }
+  }
+  std::vector<uint8_t> diff(bytes);
+  const ImageView a{ImageSize{kWidth, kHeight}, kWidth * 4u, ColorFormat::B8G8R8A8_UNORM, expected};
+  const ImageView b{ImageSize{kWidth, kHeight}, kWidth * 4u, ColorFormat::B8G8R8A8_UNORM, actual};
+
+  NaiveResult naive{};
+  const double naiveMs = time_ms([&]() { naive = naive_diff(expected, actual, diff); });
+  std::printf("naive            frame=%.2fms differing=%llu\n",
+              naiveMs,
+              static_cast<unsigned long long>(naive.differing));
+
+  const uint32_t threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+  for (uint32_t threadCount : {1u, threads}) {
+    for (bool withImage : {false, true}) {
+      FrameDiffConfig config{};
+      config.threadCount = threadCount;
+      FrameDiffOutput output{};
+      if (withImage) {
+        output.diffImage = diff;
+      }
+      FrameDiffResult result{};
+      const double ms = time_ms([&]() { result = diffImages(a, b, config, output).value_or(FrameDiffResult{}); });
+      std::printf("diffImages%-6s threads=%u frame=%.2fms speedup=%.2fx differing=%llu tiles=%u\n",
+                  withImage ? "+image" : "",
+                  threadCount,
+                  ms,
+                  naiveMs / ms,
+                  static_cast<unsigned long long>(result.differingPixels),
+                  result.differingTiles);
+    }
+    if (threads == 1u) {
+      break;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "FramePixelStorage.h"
+#include "ParallelFor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Tiled software rasterization into a frame buffer, the access pattern of a multi-threaded CPU
+// renderer: each task shades a 64x64 tile, walking down 64 rows of one column band. Compares a
+// packed std::vector buffer against the FrameBufferPolicy options, on a width whose packed pitch
+// is a 4 KiB multiple and on 4K UHD. The first frame includes allocation and page faults.
+
+namespace {
+
+constexpr uint32_t kTile = 64u;
+constexpr int kIterations = 20;
+
+struct Frame {
+  uint8_t* pixels = nullptr;
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+  uint32_t stride = 0u;
+};
+
+void shade_tile(const Frame& frame, uint32_t tile, uint32_t frameIndex) {
+  const uint32_t tilesX = (frame.width + kTile - 1u) / kTile;
+  const uint32_t x0 = (tile % tilesX) * kTile;
+  const uint32_t y0 = (tile / tilesX) * kTile;
+  const uint32_t x1 = std::min(x0 + kTile, frame.width);
+  const uint32_t y1 = std::min(y0 + kTile, frame.height);
+  for (uint32_t y = y0; y < y1; ++y) {
+    uint8_t* row = frame.pixels + static_cast<size_t>(y) * frame.stride;
+    for (uint32_t x = x0; x < x1; ++x) {
+      uint8_t* pixel = row + static_cast<size_t>(x) * 4u;
+      pixel[0] = static_cast<uint8_t>((pixel[0] + x + frameIndex) >> 1u);
+      pixel[1] = static_cast<uint8_t>((pixel[1] + y) >> 1u);
+      pixel[2] = static_cast<uint8_t>((pixel[2] + (x ^ y)) >> 1u);
+      pixel[3] = 0xFFu;
+    }
+  }
+}
+
+void raster(const Frame& frame, uint32_t threads, uint32_t frameIndex) {
+  const uint32_t tiles = ((frame.width + kTile - 1u) / kTile) * ((frame.height + kTile - 1u) / kTile);
+  parallelFor(tiles, threads, [&](uint32_t tile) { shade_tile(frame, tile, frameIndex); });
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* label, double firstMs, double frameMs) {
+  std::printf("  %-24s first=%.2fms frame=%.2fms\n", label, firstMs, frameMs);
+}
+
+void bench_vector(uint32_t width, uint32_t height, uint32_t threads) {
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4u);
+  const Frame frame{pixels.data(), width, height, width * 4u};
+  raster(frame, threads, 0u);
+  const double firstMs = elapsed_ms(start);
+  const auto steady = std::chrono::steady_clock::now();
+  for (int i = 1; i <= kIterations; ++i) {
+    raster(frame, threads, static_cast<uint32_t>(i));
+  }
+  report("vector packed", firstMs, elapsed_ms(steady) / kIterations);
+}
+
+void bench_policy(const char* label, uint32_t width, uint32_t height, uint32_t threads, FrameBufferPolicy policy) {
+  const auto start = std::chrono::steady_clock::now();
+  const uint32_t stride = *frameBufferStride(width, policy.layout);
+  FramePixelStorage storage;
+  if (!storage.resize(static_cast<size_t>(stride) * height, policy)) {
+    std::printf("  %-24s allocation failed\n", label);
+    return;
+  }
+  const Frame frame{storage.data(), width, height, stride};
+  raster(frame, threads, 0u);
+  const double firstMs = elapsed_ms(start);
+  const auto steady = std::chrono::steady_clock::now();
+  for (int i = 1; i <= kIterations; ++i) {
+    raster(frame, threads, static_cast<uint32_t>(i));
+  }
+  report(label, firstMs, elapsed_ms(steady) / kIterations);
+}
+
+} // namespace
+
+int main() {
+  const uint32_t threads = imageWorkThreads(0u);
+  struct Size {
+    uint32_t width;
+    uint32_t height;
+  };
+  for (const Size size : {Size{4096u, 2048u}, Size{3840u, 2160u}}) {
+    std::printf("%ux%u threads=%u\n", size.width, size.height, threads);
+    bench_vector(size.width, size.height, threads);
+    FrameBufferPolicy policy{};
+    bench_policy("packed", size.width, size.height, threads, policy);
+    policy.layout = FrameBufferLayout::Padded;
+    bench_policy("padded", size.width, size.height, threads, policy);
+    policy.hugePages = true;
+    bench_policy("padded+hugepages", size.width, size.height, threads, policy);
+    policy.firstTouch = true;
+    bench_policy("padded+hugepages+touch", size.width, size.height, threads, policy);
+  }
+  return 0;
+}
@@ -0,0 +1,279 @@
+#include "DeviceNameMatch.h"
+#include "GamepadMapping.h"
+#include "GamepadProfiles.h"
+
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Connect-time lookup benchmark: compares GamepadMappingDb::find and the token matcher against the
+// linear mapping scan and allocating name normalization they replaced. The legacy paths are
+// kept here as the reference, like the scalar kernels in bench_audio_mixer.
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0u};
+
+constexpr int kIterations = 200000;
+// Roughly the number of Linux lines in the community gamecontrollerdb.txt.
+constexpr size_t kImportedEntries = 2048u;
+
+int legacy_match_score(const GamepadGuid& candidate, const GamepadGuid& wanted) {
+  if (candidate.vendor() != wanted.vendor() || candidate.product() != wanted.product() ||
+      candidate.vendor() == 0u) {
+    return candidate == wanted ? 3 : 0;
+  }
+  if (candidate == wanted) {
+    return 3;
+  }
+  return candidate.bus() == wanted.bus() ? 2 : 1;
+}
+
+// GamepadMappingDb::find before the GUID indexes: a scan of the imported mappings, then of every
+// built-in line with its GUID decoded on the way.
+std::optional<GamepadMapping> legacy_mapping_find(const std::vector<GamepadMapping>& imported,
+                                                  const GamepadGuid& guid) {
+  const GamepadMapping* bestImported = nullptr;
+  int bestScore = 0;
+  for (const GamepadMapping& mapping : imported) {
+    const int score = legacy_match_score(mapping.guid, guid);
+    if (score > bestScore) {
+      bestScore = score;
+      bestImported = &mapping;
+    }
+  }
+  if (bestScore == 3) {
+    return *bestImported;
+  }
+  std::string_view bestBuiltin;
+  int bestBuiltinScore = 0;
+  for (std::string_view line : builtinGamepadMappings()) {
+    auto candidate = parseGamepadGuid(line.substr(0u, line.find(',')));
+    const int score = candidate ? legacy_match_score(*candidate, guid) : 0;
+    if (score > bestBuiltinScore) {
+      bestBuiltinScore = score;
+      bestBuiltin = line;
+    }
+  }
+  if (bestImported && bestScore >= bestBuiltinScore) {
+    return *bestImported;
+  }
+  if (bestBuiltinScore > 0) {
+    auto mapping = parseGamepadMapping(bestBuiltin, {});
+    if (mapping) {
+      return std::move(*mapping);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string synthetic_mappings() {
+  std::string text;
+  char line[160];
+  for (size_t i = 0; i < kImportedEntries; ++i) {
+    const auto vendor = static_cast<uint16_t>(0x4000u + (i / 64u) * 0x35u);
+    const auto product = static_cast<uint16_t>(0x1000u + (i % 64u) * 0x101u);
+    std::snprintf(line,
+                  sizeof(line),
+                  "03000000%02x%02x0000%02x%02x000001000000,Synthetic Pad %zu,a:b0,b:b1,x:b2,y:b3,leftx:a0,"
+                  "lefty:a1,platform:Linux,\n",
+                  vendor & 0xFFu,
+                  vendor >> 8u,
+                  product & 0xFFu,
+                  product >> 8u,
+                  i);
+    text += line;
+  }
+  return text;
+}
+
+constexpr std::array<std::string_view, 7> kLegacyTokens{
+    "xbox", "dualshock", "dualsense", "switch pro", "8bitdo", "f310", "f710"};
+
+int legacy_name_profile(std::string_view name) {
+  std::string lower;
+  lower.reserve(name.size());
+  for (char ch : name) {
+    lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+  }
+  for (size_t i = 0; i < kLegacyTokens.size(); ++i) {
+    if (lower.find(kLegacyTokens[i]) != std::string::npos) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::string legacy_normalize(std::string_view name) {
+  std::string normalized;
+  normalized.reserve(name.size());
+  bool pendingSpace = false;
+  for (char ch : name) {
+    unsigned char value = static_cast<unsigned char>(ch);
+    if (std::isalnum(value)) {
+      if (pendingSpace && !normalized.empty()) {
+        normalized.push_back(' ');
+      }
+      normalized.push_back(static_cast<char>(std::tolower(value)));
+      pendingSpace = false;
+    } else {
+      pendingSpace = true;
+    }
+  }
+  return normalized;
+}
+
+int legacy_match_score(std::string_view candidate, std::string_view reference) {
+  std::string left = legacy_normalize(candidate);
+  std::string right = legacy_normalize(reference);
+  if (left.empty() || right.empty()) {
+    return 0;
+  }
+  if (left == right) {
+    return 100;
+  }
+  if (left.size() < right.size() ? right.find(left) != std::string::npos : left.find(right) != std::string::npos) {
+    return 80;
+  }
+  return detail::countSharedTokens(left, right) * 10;
+}
+
+struct Measurement {
+  double ns = 0.0;
+  double allocations = 0.0;
+};
+
+template <typename Fn>
+Measurement measure(int iterations, Fn&& fn) {
+  const uint64_t allocationsBefore = gAllocations.load(std::memory_order_relaxed);
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    fn(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  Measurement result{};
+  result.ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+              iterations;
+  result.allocations =
+      static_cast<double>(gAllocations.load(std::memory_order_relaxed) - allocationsBefore) / iterations;
+  return result;
+}
+
+void report(const char* name, const Measurement& legacy, const Measurement& current) {
+  std::printf("%-14s legacy=%.1fns (%.2f allocs) current=%.1fns (%.2f allocs) speedup=%.2fx\n",
+              name,
+              legacy.ns,
+              legacy.allocations,
+              current.ns,
+              current.allocations,
+              current.ns > 0.0 ? legacy.ns / current.ns : 0.0);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  gAllocations.fetch_add(1u, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0u ? 1u : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+int main() {
+  volatile uint32_t sink = 0u;
+
+  // Probes are built-in pads with a different firmware version (the usual partial match); one in
+  // four is an unknown pad that misses every table.
+  const std::span<const GamepadGuid> builtinGuids = builtinGamepadGuids();
+  auto probe = [&](int i) {
+    const GamepadGuid& guid = builtinGuids[static_cast<size_t>(i * 2654435761u) % builtinGuids.size()];
+    if ((i & 3) == 3) {
+      return makeGamepadGuid(guid.bus(), 0x1234u, static_cast<uint16_t>(i), 0u);
+    }
+    return makeGamepadGuid(guid.bus(), guid.vendor(), guid.product(), 0x0114u);
+  };
+  auto count = [](const std::optional<GamepadMapping>& mapping) {
+    return mapping ? mapping->bindingCount : 0u;
+  };
+
+  GamepadMappingDb builtinDb;
+  const std::vector<GamepadMapping> noImports;
+  auto legacyBuiltin =
+      measure(kIterations, [&](int i) { sink = sink + count(legacy_mapping_find(noImports, probe(i))); });
+  auto currentBuiltin = measure(kIterations, [&](int i) { sink = sink + count(builtinDb.find(probe(i))); });
+  std::printf("mapping builtin=%zu\n", builtinGuids.size());
+  report("mapping", legacyBuiltin, currentBuiltin);
+
+  const std::string community = synthetic_mappings();
+  GamepadMappingDb importedDb;
+  importedDb.importMappings(community);
+  std::vector<GamepadMapping> imported;
+  for (size_t offset = 0; offset < community.size();) {
+    const size_t end = community.find('\n', offset);
+    if (auto mapping = parseGamepadMapping(std::string_view(community).substr(offset, end - offset))) {
+      imported.push_back(std::move(*mapping));
+    }
+    offset = end + 1u;
+  }
+  auto legacyImported =
+      measure(kIterations, [&](int i) { sink = sink + count(legacy_mapping_find(imported, probe(i))); });
+  auto currentImported = measure(kIterations, [&](int i) { sink = sink + count(importedDb.find(probe(i))); });
+  std::printf("mapping imported=%zu\n", importedDb.importedCount());
+  report("mapping+db", legacyImported, currentImported);
+
+  const std::array<std::string_view, 4> names{"Xbox Wireless Controller",
+                                               "Sony Interactive Entertainment Wireless Controller",
+                                               "Nintendo Switch Pro Controller",
+                                               "Generic   USB  Joystick"};
+  auto legacyName = measure(kIterations, [&](int i) {
+    sink = sink + static_cast<uint32_t>(legacy_name_profile(names[static_cast<size_t>(i) % names.size()]));
+  });
+  auto currentName = measure(kIterations, [&](int i) {
+    auto profile = findGamepadProfile(names[static_cast<size_t>(i) % names.size()]);
+    sink = sink + (profile ? static_cast<uint32_t>(profile->token.size()) : 0u);
+  });
+  report("name tokens", legacyName, currentName);
+
+  // hid_vidpid_match scores the controller name against every HID product string on connect.
+  const std::array<std::string_view, 8> hidProducts{"Apple Internal Keyboard / Trackpad",
+                                                    "USB Receiver",
+                                                    "Xbox Wireless Controller",
+                                                    "DualSense Wireless Controller",
+                                                    "Pro Controller",
+                                                    "Magic Mouse",
+                                                    "Logitech G502 HERO Gaming Mouse",
+                                                    "Keychron K2"};
+  constexpr int kScoreIterations = kIterations / 8;
+  auto legacyScore = measure(kScoreIterations, [&](int i) {
+    const std::string_view name = names[static_cast<size_t>(i) % names.size()];
+    for (std::string_view product : hidProducts) {
+      sink = sink + static_cast<uint32_t>(legacy_match_score(name, product));
+    }
+  });
+  auto currentScore = measure(kScoreIterations, [&](int i) {
+    const NormalizedDeviceName name = normalizeDeviceName(names[static_cast<size_t>(i) % names.size()]);
+    for (std::string_view product : hidProducts) {
+      sink = sink + static_cast<uint32_t>(deviceNameMatchScore(name, product));
+    }
+  });
+  std::printf("hid scan devices=%zu\n", hidProducts.size());
+  report("hid scan", legacyScore, currentScore);
+  return sink == 0xFFFFFFFFu ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+#include "PrimeHost/ImageEncode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+constexpr uint32_t kWidth = 3840u;
+constexpr uint32_t kHeight = 2160u;
+constexpr int kIterations = 5;
+
+// UI-like 4K frame: flat panels, text-like stripes and a gradient strip.
+std::vector<uint8_t> make_frame() {
+  std::vector<uint8_t> pixels(static_cast<size_t>(kWidth) * kHeight * 4u);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      uint8_t* px = pixels.data() + (static_cast<size_t>(y) * kWidth + x) * 4u;
+      uint8_t value = x < 480u ? 0x28u : 0xF2u;
+      if (x >= 480u && (y % 24u) < 12u && ((x * 7u + y * 3u) % 11u) < 4u) {
+        value = 0x20u;
+      }
+      if (y >= 1800u) {
+        value = static_cast<uint8_t>(x >> 4u);
+      }
+      px[0] = value;
+      px[1] = value;
+      px[2] = static_cast<uint8_t>(value + (y >> 6u));
+      px[3] = 0xFFu;
+    }
+  }
+  return pixels;
+}
+
+void run(const char* label, const ImageView& image, const ImageEncodeConfig& config) {
+  auto bound = maxEncodedImageSize(image.size, config);
+  if (!bound) {
+    return;
+  }
+  std::vector<uint8_t> out(*bound);
+  size_t size = 0u;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    auto result = encodeImage(image, out, config);
+    if (!result) {
+      std::printf("%s failed\n", label);
+      return;
+    }
+    size = *result;
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const double ms = seconds * 1000.0 / kIterations;
+  const double mbps = static_cast<double>(image.pixels.size()) * kIterations / seconds / 1.0e6;
+  std::printf("%-16s threads=%u frame=%.2fms in=%.0fMB/s out=%.2fMB ratio=%.3f\n",
+              label,
+              config.threadCount,
+              ms,
+              mbps,
+              static_cast<double>(size) / 1.0e6,
+              static_cast<double>(size) / static_cast<double>(image.pixels.size()));
+}
+
+} // namespace
+
+int main() {
+  const std::vector<uint8_t> pixels = make_frame();
+  const ImageView image{ImageSize{kWidth, kHeight}, kWidth * 4u, ColorFormat::B8G8R8A8_UNORM, pixels};
+  const uint32_t threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+
+  for (uint32_t threadCount : {1u, threads}) {
+    ImageEncodeConfig config{};
+    config.threadCount = threadCount;
+    run("png fast", image, config);
+    config.pngCompression = PngCompression::Stored;
+    run("png stored", image, config);
+    if (threadCount == threads && threads == 1u) {
+      break;
+    }
+  }
+  ImageEncodeConfig qoi{};
+  qoi.format = ImageFileFormat::Qoi;
+  qoi.threadCount = 1u;
+  run("qoi", image, qoi);
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include "PrimeHost/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Fine-grained and nested parallelFor calls at 1, 2, 4 and 8 threads: spawning threads per call,
+// as the image passes did before the job system, against a shared work-stealing JobSystem.
+
+namespace {
+
+constexpr int kIterations = 200;
+constexpr uint32_t kTasks = 256u;
+constexpr uint32_t kOuter = 16u;
+
+template <typename Fn>
+double time_us(Fn&& fn) {
+  fn();
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    fn();
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kIterations;
+}
+
+// The former ParallelFor.h: fresh threads for every call, each claiming indices from a counter.
+class SpawnExecutor final : public JobExecutor {
+public:
+  explicit SpawnExecutor(uint32_t threads) : threads_(threads) {}
+
+  uint32_t concurrency() const override { return threads_; }
+
+  void parallelFor(uint32_t count, uint32_t maxConcurrency, const std::function<void(uint32_t)>& task) override {
+    const uint32_t threads = std::min(maxConcurrency == 0u ? threads_ : maxConcurrency, count);
+    std::atomic<uint32_t> next{0u};
+    auto worker = [&]() {
+      for (uint32_t i = next.fetch_add(1u); i < count; i = next.fetch_add(1u)) {
+        task(i);
+      }
+    };
+    std::vector<std::thread> pool;
+    for (uint32_t t = 1; t < threads; ++t) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+      thread.join();
+    }
+  }
+
+private:
+  uint32_t threads_ = 1u;
+};
+
+// A few hundred nanoseconds of arithmetic, about one row of a small image pass.
+uint32_t small_task(uint32_t seed) {
+  uint32_t value = seed;
+  for (int i = 0; i < 200; ++i) {
+    value = value * 1664525u + 1013904223u;
+  }
+  return value;
+}
+
+void report(const char* name, JobExecutor& executor, uint32_t threads) {
+  std::atomic<uint32_t> sink{0u};
+  const double flat = time_us([&]() {
+    executor.parallelFor(kTasks, threads, [&](uint32_t i) {
+      sink.fetch_add(small_task(i), std::memory_order_relaxed);
+    });
+  });
+  const double nested = time_us([&]() {
+    executor.parallelFor(kOuter, threads, [&](uint32_t outer) {
+      executor.parallelFor(kTasks / kOuter, threads, [&](uint32_t inner) {
+        sink.fetch_add(small_task(outer * kTasks + inner), std::memory_order_relaxed);
+      });
+    });
+  });
+  std::printf("%-14s threads=%u flat=%.1fus nested=%.1fus (sink %u)\n", name, threads, flat, nested,
+              sink.load() & 1u);
+}
+
+} // namespace
+
+int main() {
+  std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  for (uint32_t threads : {1u, 2u, 4u, 8u}) {
+    // One worker fewer than the threads, since the caller runs tasks too; a single thread keeps
+    // one idle worker and caps the calls at 1.
+    JobSystemConfig config{};
+    config.workerCount = std::max(threads - 1u, 1u);
+    config.coreClass = CoreClass::Any;
+    auto jobs = createJobSystem(config);
+    if (!jobs) {
+      std::fprintf(stderr, "failed to create the job system\n");
+      return 1;
+    }
+    SpawnExecutor spawn(threads);
+    report("spawn-per-call", spawn, threads);
+    report("job-system", **jobs, threads);
+
+    const JobSystemStats stats = (*jobs)->stats();
+    std::printf("job-system stats: workers=%u calls=%llu tasks=%llu steals=%llu\n", stats.workerCount,
+                static_cast<unsigned long long>(stats.parallelForCalls),
+                static_cast<unsigned long long>(stats.tasksExecuted), static_cast<unsigned long long>(stats.steals));
+  }
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include "SlotMap.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace PrimeHost;
+
+// Per-call surface lookup benchmark: the unordered_map the macOS host used to resolve SurfaceId on
+// every acquire/present/query, against the generation-checked SlotMap, plus one full tick pass over
+// every surface. Surfaces are created and destroyed first so both containers carry some churn.
+
+namespace {
+
+constexpr int kIterations = 2000000;
+constexpr int kTickPasses = 200000;
+
+// Roughly the part of the host's surface state a lookup and a tick pass touch.
+struct FakeSurface {
+  uint64_t surfaceId = 0u;
+  std::array<uint64_t, 24> state{};
+  bool continuous = false;
+};
+
+template <typename Fn>
+double time_ns(int iterations, Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+void run(size_t surfaceCount) {
+  std::unordered_map<uint64_t, std::unique_ptr<FakeSurface>> legacy;
+  SlotMap<FakeSurface> slots;
+  std::vector<uint64_t> legacyIds;
+  std::vector<uint64_t> slotIds;
+  uint64_t nextId = 1u;
+  for (size_t i = 0; i < surfaceCount * 2u; ++i) {
+    const uint64_t id = nextId++;
+    auto a = std::make_unique<FakeSurface>();
+    a->surfaceId = id;
+    a->continuous = (i % 3u) == 0u;
+    legacy.emplace(id, std::move(a));
+    auto b = std::make_unique<FakeSurface>();
+    b->continuous = (i % 3u) == 0u;
+    const uint64_t handle = slots.insert(std::move(b));
+    slots.find(handle)->surfaceId = handle;
+    legacyIds.push_back(id);
+    slotIds.push_back(handle);
+  }
+  // Destroy every other surface, as tool windows come and go.
+  std::vector<uint64_t> liveLegacy;
+  std::vector<uint64_t> liveSlots;
+  for (size_t i = 0; i < legacyIds.size(); ++i) {
+    if (i % 2u == 0u) {
+      legacy.erase(legacyIds[i]);
+      slots.erase(slotIds[i]);
+    } else {
+      liveLegacy.push_back(legacyIds[i]);
+      liveSlots.push_back(slotIds[i]);
+    }
+  }
+
+  std::atomic<uint64_t> sink{0u};
+  const double legacyFind = time_ns(kIterations, [&]() {
+    uint64_t sum = 0u;
+    for (int i = 0; i < kIterations; ++i) {
+      auto it = legacy.find(liveLegacy[static_cast<size_t>(i) % liveLegacy.size()]);
+      sum += it == legacy.end() ? 0u : it->second->state[0] + 1u;
+    }
+    sink += sum;
+  });
+  const double slotFind = time_ns(kIterations, [&]() {
+    uint64_t sum = 0u;
+    for (int i = 0; i < kIterations; ++i) {
+      const FakeSurface* surface = slots.find(liveSlots[static_cast<size_t>(i) % liveSlots.size()]);
+      sum += surface ? surface->state[0] + 1u : 0u;
+    }
+    sink += sum;
+  });
+  const double legacyTick = time_ns(kTickPasses, [&]() {
+    uint64_t count = 0u;
+    for (int pass = 0; pass < kTickPasses; ++pass) {
+      for (const auto& entry : legacy) {
+        count += entry.second->continuous ? 1u : 0u;
+      }
+    }
+    sink += count;
+  });
+  const double slotTick = time_ns(kTickPasses, [&]() {
+    uint64_t count = 0u;
+    for (int pass = 0; pass < kTickPasses; ++pass) {
+      for (const auto& entry : slots) {
+        count += entry.value->continuous ? 1u : 0u;
+      }
+    }
+    sink += count;
+  });
+  std::printf("surfaces=%-3zu unordered_map find=%.2fns tick=%.1fns | SlotMap find=%.2fns tick=%.1fns "
+              "speedup=%.2fx/%.2fx\n",
+              surfaceCount,
+              legacyFind,
+              legacyTick,
+              slotFind,
+              slotTick,
+              legacyFind / slotFind,
+              legacyTick / slotTick);
+  if (sink.load() == 0u) {
+    std::printf("unexpected empty result\n");
+  }
+}
+
+} // namespace
+
+int main() {
+  for (size_t count : {4u, 32u, 128u}) {
+    run(count);
+  }
+  return 0;
+}
@@ -11,6 +11,9 @@
 namespace PrimeHost {
 
 using AudioDeviceId = uint64_t;
+using AudioMixStreamId = uint64_t;
+
+constexpr uint32_t AudioMaxMixStreams = 16u;
 
 enum class SampleFormat {
   Float32,
@@ -29,6 +32,8 @@ struct AudioStreamConfig {
   uint32_t bufferFrames = 512;
   uint32_t periodFrames = 256;
   std::chrono::nanoseconds targetLatency{0};
+  bool followDefaultDevice = false;
+  std::chrono::nanoseconds crossfadeDuration{std::chrono::milliseconds(5)};
 };
 
 struct AudioDeviceInfo {
@@ -45,20 +50,61 @@ struct AudioCallbackContext {
   bool isUnderrun = false;
 };
 
+struct AudioDuplexContext {
+  AudioCallbackContext output{};
+  // Capture time of the first input frame, on the same clock as output.time.
+  std::chrono::steady_clock::time_point inputTime;
+  bool inputUnderrun = false;
+};
+
 struct AudioDeviceEvent {
   AudioDeviceId deviceId = 0;
   bool connected = true;
   bool isDefault = false;
+  bool isInput = false;
+};
+
+struct AudioDeviceSwitchEvent {
+  AudioDeviceId fromDevice = 0;
+  AudioDeviceId toDevice = 0;
+  std::chrono::nanoseconds switchLatency{0};
+  std::chrono::nanoseconds completionTime{0};
+  uint32_t crossfadeFrames = 0u;
+  bool crossfaded = false;
 };
 
 struct AudioCallbacks {
   std::function<void(const AudioDeviceEvent&)> onDeviceEvent;
+  std::function<void(const AudioDeviceSwitchEvent&)> onDeviceSwitch;
 };
 
 using AudioCallback = void (*)(std::span<float> interleaved,
                                const AudioCallbackContext& ctx,
                                void* userData);
 
+using AudioCaptureCallback = void (*)(std::span<const float> interleaved,
+                                      const AudioCallbackContext& ctx,
+                                      void* userData);
+
+// Input and output carry the same frame and channel count (config.format.channels).
+using AudioDuplexCallback = void (*)(std::span<const float> input,
+                                     std::span<float> output,
+                                     const AudioDuplexContext& ctx,
+                                     void* userData);
+
+struct AudioMixStreamConfig {
+  uint16_t channels = 2;
+  float gain = 1.0f;
+};
+
+struct AudioMixStreamStats {
+  uint64_t callbackCount = 0u;
+  std::chrono::nanoseconds lastCallbackTime{0};
+  std::chrono::nanoseconds maxCallbackTime{0};
+  std::chrono::nanoseconds totalCallbackTime{0};
+  float lastLoad = 0.0f;
+};
+
 class AudioHost {
 public:
   virtual ~AudioHost() = default;
@@ -78,9 +124,38 @@ public:
 
   virtual HostResult<AudioStreamConfig> activeConfig() const = 0;
 
+  virtual HostResult<size_t> inputDevices(std::span<AudioDeviceInfo> outDevices) const = 0;
+  virtual HostResult<AudioDeviceInfo> inputDeviceInfo(AudioDeviceId deviceId) const = 0;
+  virtual HostResult<AudioDeviceId> defaultInputDevice() const = 0;
+
+  virtual HostStatus openCaptureStream(AudioDeviceId deviceId,
+                                       const AudioStreamConfig& config,
+                                       AudioCaptureCallback callback,
+                                       void* userData) = 0;
+  virtual HostStatus startCaptureStream() = 0;
+  virtual HostStatus stopCaptureStream() = 0;
+  virtual HostStatus closeCaptureStream() = 0;
+  virtual HostResult<AudioStreamConfig> activeCaptureConfig() const = 0;
+
+  // Opens the output stream in duplex mode: each output callback also receives the matching input
+  // buffer. Controlled with startStream/stopStream/closeStream.
+  virtual HostStatus openDuplexStream(AudioDeviceId inputDeviceId,
+                                      AudioDeviceId outputDeviceId,
+                                      const AudioStreamConfig& config,
+                                      AudioDuplexCallback callback,
+                                      void* userData) = 0;
+
+  virtual HostResult<AudioMixStreamId> addMixStream(const AudioMixStreamConfig& config,
+                                                    AudioCallback callback,
+                                                    void* userData) = 0;
+  virtual HostStatus removeMixStream(AudioMixStreamId streamId) = 0;
+  virtual HostStatus setMixStreamGain(AudioMixStreamId streamId, float gain) = 0;
+  virtual HostResult<AudioMixStreamStats> mixStreamStats(AudioMixStreamId streamId) const = 0;
+
   virtual HostStatus setCallbacks(AudioCallbacks callbacks) = 0;
 };
 
 HostResult<std::unique_ptr<AudioHost>> createAudioHost();
+HostResult<std::unique_ptr<AudioHost>> createNullAudioHost();
 
 } // namespace PrimeHost
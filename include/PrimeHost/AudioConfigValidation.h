@@ -13,6 +13,9 @@ inline HostStatus validateAudioStreamConfig(const AudioStreamConfig& config) {
   if (config.format.sampleRate == 0u) {
     return std::unexpected(HostError{HostErrorCode::InvalidConfig});
   }
+  if (config.crossfadeDuration.count() < 0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
   switch (config.format.format) {
     case SampleFormat::Float32:
     case SampleFormat::Int16:
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "PrimeHost/Audio.h"
+
+namespace PrimeHost {
+
+constexpr uint32_t AudioMaxWorkers = 16u;
+constexpr uint32_t AudioMaxJobsPerDispatch = 0xFFFFu;
+
+struct AudioWorkerPoolConfig {
+  // 0 picks hardware threads - 1 (at least 1), capped at AudioMaxWorkers.
+  uint32_t workerCount = 0u;
+  bool realtimePriority = true;
+  // Expected callback period; used as the scheduling hint for real-time workers.
+  std::chrono::nanoseconds period{std::chrono::microseconds(5333)};
+  // Busy-wait iterations before an idle worker parks on its wake counter.
+  uint32_t spinIterations = 4096u;
+};
+
+using AudioJob = void (*)(uint32_t jobIndex, void* userData);
+
+struct AudioDispatchResult {
+  uint32_t completed = 0u;
+  uint32_t late = 0u;
+  uint32_t dropped = 0u;
+  std::chrono::nanoseconds elapsed{0};
+  // How far past the deadline dispatch returned, e.g. while a descheduled worker finished a job;
+  // 0 when it returned in time.
+  std::chrono::nanoseconds overrun{0};
+};
+
+struct AudioWorkerStats {
+  uint32_t workerCount = 0u;
+  uint32_t realtimeWorkers = 0u;
+  uint64_t dispatchCount = 0u;
+  uint64_t jobsCompleted = 0u;
+  uint64_t jobsLate = 0u;
+  uint64_t jobsDropped = 0u;
+  // Dispatches with late or dropped jobs, or that returned after their deadline.
+  uint64_t deadlineMisses = 0u;
+  // Dispatches that returned after their deadline, and the worst overrun.
+  uint64_t overruns = 0u;
+  std::chrono::nanoseconds maxOverrun{0};
+  std::chrono::nanoseconds lastDispatchTime{0};
+  std::chrono::nanoseconds maxDispatchTime{0};
+};
+
+// Fans independent jobs (per-bus or per-voice DSP) out across a pool of worker threads from inside
+// an audio callback. The calling thread joins in, so dispatch() also makes progress with every
+// worker descheduled. Jobs not started by the deadline are dropped; jobs that finish after it are
+// counted late. dispatch() returns only once every started job has finished, so job output can be
+// read as soon as it returns; time spent waiting past the deadline is reported as overrun.
+// dispatch() never allocates or locks and must be called from one thread at a time.
+class AudioWorkerPool {
+public:
+  virtual ~AudioWorkerPool() = default;
+
+  virtual uint32_t workerCount() const = 0;
+
+  virtual HostResult<AudioDispatchResult> dispatch(uint32_t jobCount,
+                                                   AudioJob job,
+                                                   void* userData,
+                                                   std::chrono::steady_clock::time_point deadline) = 0;
+
+  virtual AudioWorkerStats stats() const = 0;
+  virtual void resetStats() = 0;
+};
+
+// Deadline for work started from an audio callback: `budget` (0-1) of the buffer duration after
+// the callback time.
+inline std::chrono::steady_clock::time_point audioDispatchDeadline(const AudioCallbackContext& ctx,
+                                                                   uint32_t sampleRate,
+                                                                   float budget = 0.75f) {
+  if (sampleRate == 0u) {
+    return ctx.time;
+  }
+  const double seconds = static_cast<double>(ctx.requestedFrames) / sampleRate * budget;
+  return ctx.time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(seconds));
+}
+
+HostResult<std::unique_ptr<AudioWorkerPool>> createAudioWorkerPool(const AudioWorkerPoolConfig& config = {});
+
+} // namespace PrimeHost
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "PrimeHost/Host.h"
+#include "PrimeHost/ImageEncode.h"
+
+namespace PrimeHost {
+
+enum class FrameCaptureFormat : uint8_t {
+  // YUV4MPEG2 stream, full-range BT.601 4:4:4; readable by ffmpeg and most diff tools.
+  Y4m,
+  // Headerless stream of tightly packed RGBA8 frames.
+  Rgba,
+  // One image file per frame in the `path` directory, named frame_<n>.png (or .qoi) where n counts
+  // every submitted frame, so gaps mark decimated or dropped frames.
+  ImageSequence,
+};
+
+struct FrameCaptureConfig {
+  std::string path;
+  FrameCaptureFormat format = FrameCaptureFormat::Y4m;
+  // Keep one presented frame in `frameStep`; the rest count as decimated.
+  uint32_t frameStep = 1u;
+  // Frames that may wait for the writer; a present that finds all of them busy drops its frame.
+  uint32_t queueDepth = 4u;
+  // Stream formats gather frames into writes of about this size.
+  size_t writeBufferBytes = 8u << 20u;
+  // Frame rate recorded in the Y4M header, before decimation.
+  uint32_t frameRateNumerator = 60u;
+  uint32_t frameRateDenominator = 1u;
+  // Encoder settings for ImageSequence; `format` picks the file type.
+  ImageEncodeConfig image{};
+};
+
+struct FrameCaptureStats {
+  uint64_t presented = 0u;
+  uint64_t decimated = 0u;
+  // Frames lost because the queue was full.
+  uint64_t dropped = 0u;
+  // Frames whose size or format did not match the stream's first frame.
+  uint64_t rejected = 0u;
+  uint64_t written = 0u;
+  uint64_t bytesWritten = 0u;
+};
+
+// Writes presented frames to disk on its own thread. submit() copies the frame into one of
+// `queueDepth` reusable buffers and returns; it never blocks on I/O. Attach to a surface with
+// Host::setSurfaceCaptureSink, or feed it directly. submit() must be called from one thread at a
+// time; stats() and flush() may be called from any thread.
+class FrameCaptureSink {
+public:
+  virtual ~FrameCaptureSink() = default;
+
+  virtual HostStatus submit(const ImageView& image) = 0;
+  // Blocks until every queued frame is written and handed to the OS.
+  virtual HostStatus flush() = 0;
+  virtual FrameCaptureStats stats() const = 0;
+};
+
+// Opens the output (the stream file, or the sequence directory, created if missing).
+HostResult<std::shared_ptr<FrameCaptureSink>> createFrameCaptureSink(const FrameCaptureConfig& config);
+
+} // namespace PrimeHost
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "PrimeHost/Host.h"
+#include "PrimeHost/ImageEncode.h"
+#include "PrimeHost/JobSystem.h"
+
+namespace PrimeHost {
+
+struct FrameDiffConfig {
+  // Channel deltas up to this value count as equal, to absorb dithering or rounding noise.
+  uint8_t threshold = 0u;
+  bool compareAlpha = true;
+  // Edge of the square tiles that get their own bounding box.
+  uint32_t tileSize = 64u;
+  // Threads used for rows of tiles, including the caller; 0 picks up to 8 from the hardware.
+  uint32_t threadCount = 0u;
+  // Runs the rows of tiles; null uses defaultJobExecutor(). Must outlive the call.
+  JobExecutor* executor = nullptr;
+};
+
+struct DiffRect {
+  uint32_t x = 0u;
+  uint32_t y = 0u;
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+};
+
+struct FrameDiffOutput {
+  // Bounding boxes of the differences inside each differing tile, in row-major tile order.
+  std::span<DiffRect> tiles;
+  // Optional visualization, width * height * 4 bytes in the inputs' channel order: differing pixels
+  // are opaque red, the rest carry their per-channel delta.
+  std::span<uint8_t> diffImage;
+};
+
+struct FrameDiffResult {
+  uint32_t maxChannelDelta = 0u;
+  uint64_t differingPixels = 0u;
+  // Bounding box of every differing pixel; empty when the images match.
+  DiffRect bounds{};
+  // Differing tiles, which may exceed the tiles written to FrameDiffOutput::tiles.
+  uint32_t differingTiles = 0u;
+};
+
+// Compares two frames of the same size. Rows of tiles are processed in parallel with SSE2/NEON kernels.
+HostResult<FrameDiffResult> diffImages(const ImageView& expected,
+                                       const ImageView& actual,
+                                       const FrameDiffConfig& config = {},
+                                       const FrameDiffOutput& output = {});
+
+// Same for tightly packed RGBA8 images such as clipboard or golden-file data.
+HostResult<FrameDiffResult> diffImages(const ImageData& expected,
+                                       const ImageData& actual,
+                                       const FrameDiffConfig& config = {},
+                                       const FrameDiffOutput& output = {});
+
+} // namespace PrimeHost
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -127,6 +128,7 @@ struct HostCapabilities {
   bool supportsIme = false;
   bool supportsHaptics = false;
   bool supportsHeadless = false;
+  bool supportsRawInput = false;
 };
 
 enum class PermissionType {
@@ -227,6 +229,28 @@ struct FrameDiagnostics {
   bool missedDeadline = false;
   bool wasThrottled = false;
   uint32_t droppedFrames = 0u;
+  // Time a deadline acquireFrameBuffer spent blocked since the previous frame callback.
+  std::chrono::nanoseconds acquireWait{0};
+  // Mailbox presents replaced by a newer frame before they reached the display.
+  uint32_t supersededFrames = 0u;
+};
+
+enum class FrameBufferLayout : uint8_t {
+  // Rows are exactly width * 4 bytes.
+  Packed,
+  // Rows start on a 64-byte boundary and span an odd number of 64-byte lines, so no power-of-two
+  // factor above 64 aliases column walks; FrameBuffer::stride reports the pitch.
+  Padded,
+};
+
+// How a host allocates CPU frame buffers. Storage is page-aligned in either layout.
+struct FrameBufferPolicy {
+  FrameBufferLayout layout = FrameBufferLayout::Packed;
+  // Asks the kernel to back frame storage with transparent huge pages where supported (Linux).
+  bool hugePages = false;
+  // Leaves new pages untouched so the first write places them; render threads should clear their
+  // own tiles before anything else touches the buffer so each lands on the writer's NUMA node.
+  bool firstTouch = false;
 };
 
 struct FrameConfig {
@@ -239,6 +263,7 @@ struct FrameConfig {
   uint32_t maxFrameLatency = 1u;
   uint32_t bufferCount = 2u;
   std::optional<std::chrono::nanoseconds> frameInterval;
+  FrameBufferPolicy bufferPolicy{};
 };
 
 struct SurfaceConfig {
@@ -484,6 +509,83 @@ struct GamepadRumble {
   std::chrono::milliseconds duration{0};
 };
 
+constexpr uint32_t GamepadButtonCount = 16u;
+constexpr uint32_t GamepadAxisCount = 6u;
+
+// Latest input of one gamepad, readable at any time through Host::gamepadState. `axes` hold the
+// values after the radial deadzone and response curve, `rawAxes` the clamped platform values.
+// `sequence` increases with every update, so an unchanged value means no new input.
+struct GamepadState {
+  uint32_t deviceId = 0u;
+  uint64_t sequence = 0u;
+  // Bit i is set while GamepadButtonId(i) is pressed.
+  uint32_t buttons = 0u;
+  std::array<float, GamepadButtonCount> buttonValues{};
+  std::array<float, GamepadAxisCount> rawAxes{};
+  std::array<float, GamepadAxisCount> axes{};
+  std::chrono::steady_clock::time_point time{};
+
+  bool pressed(GamepadButtonId id) const {
+    const auto index = static_cast<uint32_t>(id);
+    return index < GamepadButtonCount && (buttons & (1u << index)) != 0u;
+  }
+
+  float axis(GamepadAxisId id) const {
+    const auto index = static_cast<uint32_t>(id);
+    return index < GamepadAxisCount ? axes[index] : 0.0f;
+  }
+};
+
+// Host-wide gamepad processing. Deadzones are fractions of full deflection; the stick deadzone is
+// radial. `responseExpo` blends linear (0) toward cubic (1) response. Axis events report processed
+// values and are only sent once a value moves by `axisEventThreshold`; with `axisEvents` off,
+// sticks and triggers are read through gamepadState only.
+struct GamepadInputConfig {
+  float stickDeadzone = 0.0f;
+  float stickOuterDeadzone = 0.0f;
+  float triggerDeadzone = 0.0f;
+  float responseExpo = 0.0f;
+  bool axisEvents = true;
+  float axisEventThreshold = 0.0f;
+};
+
+enum class RawInputDeviceType : uint8_t {
+  Mouse,
+  Pen,
+};
+
+// One device report read off the raw-input thread, at device rate and before pointer
+// acceleration. Mouse samples carry relative counts; pen samples carry the absolute position as a
+// fraction of the tablet area. `time` is on the same steady clock as Event::time.
+struct RawInputSample {
+  std::chrono::steady_clock::time_point time{};
+  uint32_t deviceId = 0u;
+  RawInputDeviceType deviceType = RawInputDeviceType::Mouse;
+  // Bit i is set while button i is held (0 primary, 1 secondary, 2 middle; pens: 0 tip).
+  uint32_t buttons = 0u;
+  int32_t deltaX = 0;
+  int32_t deltaY = 0;
+  float scrollX = 0.0f;
+  float scrollY = 0.0f;
+  float x = 0.0f;
+  float y = 0.0f;
+  float pressure = 0.0f;
+  float tiltX = 0.0f;
+  float tiltY = 0.0f;
+};
+
+struct RawInputConfig {
+  bool enabled = false;
+  // Samples buffered between drains; the oldest unread samples are kept and newer ones dropped.
+  uint32_t capacity = 8192u;
+};
+
+struct RawInputBatch {
+  std::span<const RawInputSample> samples;
+  // Samples lost to a full ring since the previous drain.
+  uint64_t droppedSamples = 0u;
+};
+
 struct DeviceEvent {
   uint32_t deviceId = 0u;
   DeviceType deviceType = DeviceType::Mouse;
@@ -534,6 +636,31 @@ struct LifecycleEvent {
   LifecyclePhase phase = LifecyclePhase::Created;
 };
 
+enum class DisplayChange : uint8_t {
+  Added,
+  Removed,
+  Changed,
+};
+
+enum class DisplayField : uint8_t {
+  Bounds = 1u << 0u,
+  Scale = 1u << 1u,
+  RefreshRate = 1u << 2u,
+  Primary = 1u << 3u,
+  Hdr = 1u << 4u,
+};
+
+using DisplayFieldMask = uint8_t;
+
+// Global event sent when a display is attached, detached or reconfigured; query displayInfo for
+// the new state.
+struct DisplayEvent {
+  uint32_t displayId = 0u;
+  DisplayChange change = DisplayChange::Changed;
+  // DisplayInfo/DisplayHdrInfo fields that differ; only set for DisplayChange::Changed.
+  DisplayFieldMask fields = 0u;
+};
+
 struct Event {
   enum class Scope {
     Surface,
@@ -549,7 +676,8 @@ struct Event {
                FocusEvent,
                PowerEvent,
                ThermalEvent,
-               LifecycleEvent> payload;
+               LifecycleEvent,
+               DisplayEvent> payload;
 };
 
 struct EventBuffer {
@@ -557,9 +685,18 @@ struct EventBuffer {
   std::span<char> textBytes;
 };
 
+// Storage needed to take queued events in one pollEvents call.
+struct EventBufferSize {
+  size_t events = 0u;
+  size_t textBytes = 0u;
+};
+
 struct EventBatch {
   std::span<const Event> events;
   std::span<const char> textBytes;
+  // Events left queued because `events` or `textBytes` ran out; grow the buffers to this size to
+  // take them in the next call.
+  EventBufferSize pending{};
 };
 
 struct Callbacks {
@@ -567,6 +704,8 @@ struct Callbacks {
   std::function<void(SurfaceId, const FrameTiming&, const FrameDiagnostics&)> onFrame;
 };
 
+class FrameCaptureSink;
+
 class Host {
 public:
   virtual ~Host() = default;
@@ -586,9 +725,13 @@ public:
   virtual HostStatus destroySurface(SurfaceId surfaceId) = 0;
 
   virtual HostResult<EventBatch> pollEvents(const EventBuffer& buffer) = 0;
+  virtual HostResult<EventBufferSize> pendingEventsSize() const = 0;
   virtual HostStatus waitEvents() = 0;
+  virtual HostStatus wakeEvents() = 0;
 
   virtual HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId) = 0;
+  virtual HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId,
+                                                     std::chrono::steady_clock::time_point deadline) = 0;
   virtual HostStatus presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& buffer) = 0;
 
   virtual HostStatus requestFrame(SurfaceId surfaceId, bool bypassCap) = 0;
@@ -621,6 +764,8 @@ public:
   virtual HostStatus writeSurfaceScreenshot(SurfaceId surfaceId,
                                             Utf8TextView path,
                                             const ScreenshotConfig& config = {}) = 0;
+  // Hands every frame presented on the surface to `sink` (see FrameCapture.h); nullptr detaches.
+  virtual HostStatus setSurfaceCaptureSink(SurfaceId surfaceId, std::shared_ptr<FrameCaptureSink> sink) = 0;
   virtual HostResult<FileDialogResult> fileDialog(const FileDialogConfig& config,
                                                    std::span<char> buffer) const = 0;
   virtual HostResult<size_t> fileDialogPaths(const FileDialogConfig& config,
@@ -633,6 +778,8 @@ public:
   virtual HostStatus setSurfaceMaxSize(SurfaceId surfaceId, uint32_t width, uint32_t height) = 0;
 
   virtual HostStatus setGamepadRumble(const GamepadRumble& rumble) = 0;
+  virtual HostResult<GamepadState> gamepadState(uint32_t deviceId) const = 0;
+  virtual HostStatus setGamepadInputConfig(const GamepadInputConfig& config) = 0;
   virtual HostResult<PermissionStatus> checkPermission(PermissionType type) const = 0;
   virtual HostResult<PermissionStatus> requestPermission(PermissionType type) = 0;
   virtual HostResult<uint64_t> beginIdleSleepInhibit(Utf8TextView reason) = 0;
@@ -652,6 +799,8 @@ public:
   virtual HostStatus updateTrayItemTitle(uint64_t trayId, Utf8TextView title) = 0;
   virtual HostStatus removeTrayItem(uint64_t trayId) = 0;
   virtual HostStatus setRelativePointerCapture(SurfaceId surfaceId, bool enabled) = 0;
+  virtual HostStatus setRawInputConfig(const RawInputConfig& config) = 0;
+  virtual HostResult<RawInputBatch> drainRawInput(std::span<RawInputSample> outSamples) = 0;
   virtual HostStatus setLogCallback(LogCallback callback) = 0;
 
   virtual HostStatus setCallbacks(Callbacks callbacks) = 0;
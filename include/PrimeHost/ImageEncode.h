@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "PrimeHost/Host.h"
+#include "PrimeHost/JobSystem.h"
+
+namespace PrimeHost {
+
+enum class ImageFileFormat : uint8_t {
+  Png,
+  Qoi,
+};
+
+enum class PngCompression : uint8_t {
+  // LZ77 with fixed Huffman codes; about zlib level 1 on UI content.
+  Fast,
+  // Stored deflate blocks: no compression, bounded only by memory bandwidth.
+  Stored,
+};
+
+struct ImageEncodeConfig {
+  ImageFileFormat format = ImageFileFormat::Png;
+  PngCompression pngCompression = PngCompression::Fast;
+  // Keep the alpha channel; otherwise the image is written as opaque RGB.
+  bool alpha = false;
+  // Threads used for PNG row bands, including the caller; 0 picks up to 8 from the hardware.
+  // Band boundaries do not depend on the thread count, so output bytes are identical for any value.
+  uint32_t threadCount = 0u;
+  // Runs the bands; null uses defaultJobExecutor(). Must outlive the call.
+  JobExecutor* executor = nullptr;
+};
+
+// Read-only pixels to encode. Only B8G8R8A8_UNORM is supported.
+struct ImageView {
+  ImageSize size;
+  uint32_t stride = 0u;
+  ColorFormat colorFormat = ColorFormat::B8G8R8A8_UNORM;
+  std::span<const uint8_t> pixels;
+};
+
+// Tightly packed copy of a frame, so it can be encoded on another thread after the frame buffer
+// goes back to the host.
+struct CapturedImage {
+  ImageSize size;
+  ColorFormat colorFormat = ColorFormat::B8G8R8A8_UNORM;
+  std::vector<uint8_t> pixels;
+
+  ImageView view() const { return ImageView{size, size.width * 4u, colorFormat, pixels}; }
+};
+
+inline ImageView imageView(const FrameBuffer& buffer) {
+  return ImageView{buffer.size, buffer.stride, buffer.colorFormat, buffer.pixels};
+}
+
+HostResult<CapturedImage> captureImage(const ImageView& image);
+
+// Largest output encodeImage can produce for an image of `size`.
+HostResult<size_t> maxEncodedImageSize(ImageSize size, const ImageEncodeConfig& config = {});
+
+// Encodes into `out` and returns the bytes written. Thread-safe; PNG bands are spread over
+// `config.threadCount` threads, QOI is encoded on the calling thread.
+HostResult<size_t> encodeImage(const ImageView& image, std::span<uint8_t> out, const ImageEncodeConfig& config = {});
+
+// Format named by a `.png` or `.qoi` extension (case-insensitive).
+std::optional<ImageFileFormat> imageFileFormatForPath(Utf8TextView path);
+
+// Encodes in the format named by the extension of `path` (config.format is ignored) and writes the
+// file with one sequential write.
+HostStatus writeImageFile(const ImageView& image, Utf8TextView path, const ImageEncodeConfig& config = {});
+
+} // namespace PrimeHost
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "PrimeHost/Host.h"
+
+namespace PrimeHost {
+
+constexpr uint32_t JobMaxWorkers = 64u;
+
+enum class CoreClass : uint8_t {
+  // Leave placement to the OS.
+  Any,
+  // Hybrid CPUs: keep workers on performance cores.
+  Performance,
+  // Hybrid CPUs: keep workers on efficiency cores, for work that can take longer.
+  Efficiency,
+};
+
+struct JobSystemConfig {
+  // 0 sizes the pool to the cores of `coreClass`, minus one for the calling thread (at least 1).
+  uint32_t workerCount = 0u;
+  CoreClass coreClass = CoreClass::Performance;
+  // Busy-wait iterations before an idle worker parks.
+  uint32_t spinIterations = 2048u;
+};
+
+struct JobSystemStats {
+  uint32_t workerCount = 0u;
+  // Workers the OS accepted a placement for; 0 on homogeneous machines or with CoreClass::Any.
+  uint32_t placedWorkers = 0u;
+  uint64_t parallelForCalls = 0u;
+  uint64_t tasksExecuted = 0u;
+  uint64_t steals = 0u;
+};
+
+// Runs data-parallel work for host features such as image encoding, frame diffs and pixel ops.
+// Implement it to run those passes on an application's own scheduler, and pass it through the
+// feature's config or setDefaultJobExecutor.
+class JobExecutor {
+public:
+  virtual ~JobExecutor() = default;
+
+  // Threads that can run tasks at once, the caller included.
+  virtual uint32_t concurrency() const = 0;
+
+  // Runs task(i) for every i in [0, count) and returns once all have finished. At most
+  // `maxConcurrency` threads (the caller included) take part; 0 leaves that to the executor.
+  // Tasks may call parallelFor again.
+  virtual void parallelFor(uint32_t count, uint32_t maxConcurrency, const std::function<void(uint32_t)>& task) = 0;
+};
+
+// Work-stealing pool: every worker owns a Chase-Lev deque, and a parallelFor called on a worker
+// pushes its helpers to that deque, where idle workers steal them. Callers always work on their
+// own call instead of blocking, so nested calls cannot starve the pool.
+class JobSystem : public JobExecutor {
+public:
+  virtual JobSystemStats stats() const = 0;
+};
+
+HostResult<std::shared_ptr<JobSystem>> createJobSystem(const JobSystemConfig& config = {});
+
+// Executor for host work whose config names none. Defaults to a JobSystem with the default
+// config, started on first use.
+std::shared_ptr<JobExecutor> defaultJobExecutor();
+// Replaces the default executor; nullptr restores the built-in one. Calls already running keep
+// the executor they started with.
+void setDefaultJobExecutor(std::shared_ptr<JobExecutor> executor);
+
+struct JobTile {
+  uint32_t x = 0u;
+  uint32_t y = 0u;
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+};
+
+// Runs body(begin, end) over [0, count) in chunks of `grain` items.
+inline void parallelForRange(JobExecutor& executor,
+                             uint32_t count,
+                             uint32_t grain,
+                             const std::function<void(uint32_t begin, uint32_t end)>& body) {
+  grain = std::max(grain, 1u);
+  const uint32_t chunks = count / grain + (count % grain != 0u ? 1u : 0u);
+  executor.parallelFor(chunks, 0u, [&](uint32_t chunk) {
+    const uint32_t begin = chunk * grain;
+    body(begin, begin + std::min(grain, count - begin));
+  });
+}
+
+// Runs body(tile) over a width x height area in tileSize squares, clipped at the edges.
+inline void parallelForTiles(JobExecutor& executor,
+                             uint32_t width,
+                             uint32_t height,
+                             uint32_t tileSize,
+                             const std::function<void(const JobTile& tile)>& body) {
+  tileSize = std::max(tileSize, 1u);
+  const uint32_t tilesX = width / tileSize + (width % tileSize != 0u ? 1u : 0u);
+  const uint32_t tilesY = height / tileSize + (height % tileSize != 0u ? 1u : 0u);
+  executor.parallelFor(tilesX * tilesY, 0u, [&](uint32_t index) {
+    const uint32_t x = (index % tilesX) * tileSize;
+    const uint32_t y = (index / tilesX) * tileSize;
+    body(JobTile{x, y, std::min(tileSize, width - x), std::min(tileSize, height - y)});
+  });
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "PrimeHost/Host.h"
+#include "PrimeHost/ImageEncode.h"
+#include "PrimeHost/JobSystem.h"
+
+namespace PrimeHost {
+
+// Straight color, written to B8G8R8A8 frame buffers in their byte order.
+struct PixelColor {
+  uint8_t r = 0u;
+  uint8_t g = 0u;
+  uint8_t b = 0u;
+  uint8_t a = 255u;
+};
+
+// Target area in pixels; may extend past the frame buffer, which clips it.
+struct PixelRect {
+  int32_t x = 0;
+  int32_t y = 0;
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+};
+
+enum class ScaleFilter : uint8_t {
+  Nearest,
+  Bilinear,
+};
+
+struct PixelOpsConfig {
+  // Rows per task; each task covers a full-width band of the clipped target.
+  uint32_t rowsPerTask = 64u;
+  // Threads used for the bands, including the caller; 0 picks up to 8 from the hardware.
+  uint32_t threadCount = 0u;
+  // Runs the bands; null uses defaultJobExecutor(). Must outlive the call.
+  JobExecutor* executor = nullptr;
+};
+
+// Pixel operations on B8G8R8A8 frame buffers, split into row bands that run in parallel with
+// SSE2/NEON kernels. Operations smaller than a few hundred thousand pixels run inline on the
+// caller. Areas outside the buffer are clipped; a fully clipped operation succeeds and writes
+// nothing. Malformed buffers or sources fail with InvalidConfig.
+
+HostStatus clearFrameBuffer(const FrameBuffer& target, PixelColor color, const PixelOpsConfig& config = {});
+
+// Writes `color` over the clipped rect as is; use blendImage to composite.
+HostStatus fillRect(const FrameBuffer& target,
+                    const PixelRect& rect,
+                    PixelColor color,
+                    const PixelOpsConfig& config = {});
+
+// Composites `source` with its top-left corner at (x, y) using premultiplied source-over.
+HostStatus blendImage(const FrameBuffer& target,
+                      const ImageView& source,
+                      int32_t x,
+                      int32_t y,
+                      const PixelOpsConfig& config = {});
+
+// Copies `source` stretched over `rect`, e.g. a point-sized asset onto a frame at
+// FrameBuffer::scale. Samples are taken at pixel centers; Bilinear clamps at the source edges and
+// falls back to Nearest for sources under two pixels wide or tall.
+HostStatus scaleImage(const FrameBuffer& target,
+                      const PixelRect& rect,
+                      const ImageView& source,
+                      ScaleFilter filter = ScaleFilter::Bilinear,
+                      const PixelOpsConfig& config = {});
+
+} // namespace PrimeHost
@@ -3,8 +3,16 @@
 #include <cstdint>
 
 #include "PrimeHost/Audio.h"
+#include "PrimeHost/AudioWorkers.h"
 #include "PrimeHost/Fps.h"
+#include "PrimeHost/FrameCapture.h"
+#include "PrimeHost/FrameDiff.h"
 #include "PrimeHost/Host.h"
+#include "PrimeHost/ImageEncode.h"
+#include "PrimeHost/JobSystem.h"
+#include "PrimeHost/PixelOps.h"
+#include "PrimeHost/Replay.h"
+#include "PrimeHost/SurfacePool.h"
 #include "PrimeHost/Timing.h"
 
 namespace PrimeHost {
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "PrimeHost/Host.h"
+
+namespace PrimeHost {
+
+// Appends events and frame boundaries to a compact binary log (varint and delta encoded,
+// written through a memory mapping). Logs are replayed with ReplayHost. Calls are serialized
+// internally, so frames may be recorded from a render thread while events come from the main one.
+class EventRecorder {
+public:
+  virtual ~EventRecorder() = default;
+
+  virtual HostStatus recordEvents(const EventBatch& batch) = 0;
+  virtual HostStatus recordFrame(SurfaceId surfaceId,
+                                 const FrameTiming& timing,
+                                 const FrameDiagnostics& diagnostics) = 0;
+  // Starts writeback of everything recorded so far. The log is also complete up to the last
+  // record if the process exits without closing the recorder.
+  virtual HostStatus flush() = 0;
+  virtual uint64_t bytesWritten() const = 0;
+  // Events and frames that were not logged, because they were invalid or the file could not grow.
+  // The log stays readable; it simply lacks those records.
+  virtual uint64_t droppedRecords() const = 0;
+};
+
+// Creates or replaces the log at `path`.
+HostResult<std::unique_ptr<EventRecorder>> createEventRecorder(Utf8TextView path);
+
+// Wraps `callbacks` so every batch and frame is recorded before it is forwarded. Callbacks cannot
+// report errors, so records that fail are only counted in recorder.droppedRecords(). The recorder
+// must outlive the returned callbacks.
+inline Callbacks recordingCallbacks(EventRecorder& recorder, Callbacks callbacks) {
+  Callbacks wrapped;
+  wrapped.onEvents = [&recorder, next = std::move(callbacks.onEvents)](const EventBatch& batch) {
+    recorder.recordEvents(batch);
+    if (next) {
+      next(batch);
+    }
+  };
+  wrapped.onFrame = [&recorder, next = std::move(callbacks.onFrame)](
+                        SurfaceId surfaceId, const FrameTiming& timing, const FrameDiagnostics& diagnostics) {
+    recorder.recordFrame(surfaceId, timing, diagnostics);
+    if (next) {
+      next(surfaceId, timing, diagnostics);
+    }
+  };
+  return wrapped;
+}
+
+struct ReplayConfig {
+  std::string path;
+  // Playback rate relative to the recording; 0 delivers every record as soon as it is asked for.
+  double speed = 1.0;
+};
+
+// A headless Host that plays a recorded log back: pollEvents and waitEvents return the recorded
+// events once their (rebased) time has come, and recorded frames are delivered through
+// Callbacks::onFrame in their original order relative to the events. The replay clock starts with
+// the first poll or wait. Surfaces are headless; createSurface hands out the recorded surface ids
+// in order of first appearance, so an app that creates its surfaces the same way sees the same ids,
+// and writeSurfaceScreenshot encodes the last presented frame.
+// Platform services (clipboard, dialogs, devices) report Unsupported.
+class ReplayHost : public Host {
+public:
+  virtual bool finished() const = 0;
+  virtual uint64_t replayedEvents() const = 0;
+  virtual uint64_t replayedFrames() const = 0;
+};
+
+HostResult<std::unique_ptr<ReplayHost>> createReplayHost(const ReplayConfig& config);
+
+} // namespace PrimeHost
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "PrimeHost/Host.h"
+
+namespace PrimeHost {
+
+struct SurfacePoolConfig {
+  // Idle surfaces kept per size class; a release beyond this destroys the surface.
+  uint32_t maxIdlePerClass = 8u;
+};
+
+struct SurfacePoolStats {
+  uint64_t created = 0u;
+  uint64_t reused = 0u;
+  uint64_t destroyed = 0u;
+  uint32_t inUse = 0u;
+  uint32_t idle = 0u;
+};
+
+// Recycles headless surfaces for batch render-to-image work such as thumbnails. Released surfaces
+// stay alive and are sorted into power-of-two size classes by frame bytes; an acquire reuses one
+// from its class and resizes it in place, and the host keeps its frame storage when the new size
+// fits, so a steady workload creates no surfaces and allocates no pixels. A reused surface keeps
+// its frame config and last frame until it presents again. Not thread-safe; call from the thread
+// that owns `host`, which must outlive the pool.
+class HeadlessSurfacePool {
+public:
+  virtual ~HeadlessSurfacePool() = default;
+
+  virtual HostResult<SurfaceId> acquire(uint32_t width, uint32_t height) = 0;
+  // Fills every entry of `surfaces`; on failure none of them stay acquired.
+  virtual HostStatus acquire(uint32_t width, uint32_t height, std::span<SurfaceId> surfaces) = 0;
+  // Returns a surface from acquire(); InvalidSurface for anything else.
+  virtual HostStatus release(SurfaceId surfaceId) = 0;
+  // Destroys every idle surface.
+  virtual void trim() = 0;
+  virtual SurfacePoolStats stats() const = 0;
+};
+
+// Destroying the pool destroys every surface it created, acquired or idle.
+HostResult<std::unique_ptr<HeadlessSurfacePool>> createHeadlessSurfacePool(Host& host,
+                                                                           const SurfacePoolConfig& config = {});
+
+} // namespace PrimeHost
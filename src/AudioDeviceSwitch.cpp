@@ -0,0 +1,240 @@
+#include "AudioDeviceSwitch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PrimeHost {
+namespace {
+
+void zero_samples(std::span<float> samples) {
+  if (!samples.empty()) {
+    std::memset(samples.data(), 0, samples.size() * sizeof(float));
+  }
+}
+
+} // namespace
+
+void AudioDeviceSwitcher::prepare(uint32_t channels,
+                                  uint32_t maxFrames,
+                                  uint32_t crossfadeFrames,
+                                  AudioCallback source,
+                                  void* userData) {
+  channels_ = channels;
+  maxFrames_ = maxFrames;
+  crossfadeFrames_ = crossfadeFrames;
+  source_ = source;
+  userData_ = userData;
+  frameIndex_ = 0u;
+  // Room for the prefill plus a full crossfade with slack for clock drift between devices.
+  const size_t ringFrames = static_cast<size_t>(maxFrames) * 4u + crossfadeFrames;
+  ring_.reset(ringFrames * channels);
+  phase_.store(Phase::Idle);
+  currentLane_.store(0u);
+  released_.store(false);
+  completed_.store(false);
+  crossfaded_.store(false);
+  underrunFrames_.store(0u);
+  switchPending_ = false;
+}
+
+void AudioDeviceSwitcher::release() {
+  source_ = nullptr;
+  userData_ = nullptr;
+  channels_ = 0u;
+  maxFrames_ = 0u;
+  ring_.reset(0u);
+  phase_.store(Phase::Idle);
+  switchPending_ = false;
+}
+
+bool AudioDeviceSwitcher::beginSwitch(std::chrono::steady_clock::time_point requestTime) {
+  if (switchPending_ || phase_.load() != Phase::Idle || channels_ == 0u) {
+    return false;
+  }
+  // Neither lane touches the ring while idle, so it can be rewound here.
+  ring_.reset(ring_.capacity());
+  released_.store(false);
+  completed_.store(false);
+  crossfaded_.store(false);
+  fadeOutProgress_ = 0u;
+  fadeInProgress_ = 0u;
+  requestNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(requestTime.time_since_epoch()).count();
+  crossfadeStartNs_.store(requestNs_);
+  completionNs_.store(requestNs_);
+  switchPending_ = true;
+  phase_.store(Phase::Prefill, std::memory_order_release);
+  return true;
+}
+
+void AudioDeviceSwitcher::abortSwitch() {
+  if (!switchPending_) {
+    return;
+  }
+  Phase expected = Phase::Prefill;
+  if (phase_.compare_exchange_strong(expected, Phase::Idle)) {
+    switchPending_ = false;
+  }
+}
+
+void AudioDeviceSwitcher::outgoingLost() {
+  if (!switchPending_) {
+    return;
+  }
+  released_.store(true, std::memory_order_release);
+}
+
+std::optional<AudioDeviceSwitcher::SwitchResult> AudioDeviceSwitcher::takeCompletedSwitch() {
+  if (!switchPending_ || !completed_.load(std::memory_order_acquire)) {
+    return std::nullopt;
+  }
+  switchPending_ = false;
+  SwitchResult result{};
+  result.switchLatency = std::chrono::nanoseconds(crossfadeStartNs_.load() - requestNs_);
+  result.completionTime = std::chrono::nanoseconds(completionNs_.load() - requestNs_);
+  result.crossfaded = crossfaded_.load();
+  result.crossfadeFrames = result.crossfaded ? crossfadeFrames_ : 0u;
+  return result;
+}
+
+std::optional<AudioDeviceSwitcher::SwitchResult> AudioDeviceSwitcher::settle() {
+  if (!switchPending_) {
+    return std::nullopt;
+  }
+  if (!completed_.load(std::memory_order_acquire)) {
+    const Phase phase = phase_.load(std::memory_order_acquire);
+    if (phase == Phase::Prefill && !released_.load(std::memory_order_acquire)) {
+      phase_.store(Phase::Idle, std::memory_order_release);
+      switchPending_ = false;
+      return std::nullopt;
+    }
+    if (phase == Phase::Prefill) {
+      crossfadeStartNs_.store(nowNs());
+    }
+    currentLane_.store(incomingLane(), std::memory_order_release);
+    phase_.store(Phase::Idle, std::memory_order_release);
+    completionNs_.store(nowNs());
+    completed_.store(true, std::memory_order_release);
+  }
+  return takeCompletedSwitch();
+}
+
+AudioDeviceSwitcher::Phase AudioDeviceSwitcher::phase() const {
+  return phase_.load(std::memory_order_acquire);
+}
+
+bool AudioDeviceSwitcher::switchPending() const {
+  return switchPending_;
+}
+
+uint32_t AudioDeviceSwitcher::currentLane() const {
+  return currentLane_.load(std::memory_order_acquire);
+}
+
+uint32_t AudioDeviceSwitcher::incomingLane() const {
+  return 1u - currentLane();
+}
+
+uint64_t AudioDeviceSwitcher::underrunFrames() const {
+  return underrunFrames_.load(std::memory_order_relaxed);
+}
+
+void AudioDeviceSwitcher::render(uint32_t lane, std::span<float> interleaved) {
+  if (channels_ == 0u || !source_) {
+    zero_samples(interleaved);
+    return;
+  }
+  const Phase phase = phase_.load(std::memory_order_acquire);
+  const bool isCurrent = lane == currentLane_.load(std::memory_order_acquire);
+
+  if (isCurrent) {
+    if (phase == Phase::Idle) {
+      renderSource(interleaved);
+      return;
+    }
+    if (released_.load(std::memory_order_acquire)) {
+      zero_samples(interleaved);
+      return;
+    }
+    renderSource(interleaved);
+    const size_t freeSamples = ring_.capacity() - ring_.size();
+    const size_t pushSamples = (std::min(freeSamples, interleaved.size()) / channels_) * channels_;
+    ring_.push(std::span<const float>(interleaved.data(), pushSamples));
+    if (phase == Phase::Crossfade) {
+      crossfaded_.store(true, std::memory_order_relaxed);
+      applyFade(interleaved, fadeOutProgress_, false);
+      if (fadeOutProgress_ >= crossfadeFrames_) {
+        released_.store(true, std::memory_order_release);
+      }
+    }
+    return;
+  }
+
+  if (phase == Phase::Idle) {
+    zero_samples(interleaved);
+    return;
+  }
+  if (phase == Phase::Prefill) {
+    if (!released_.load(std::memory_order_acquire) && ring_.size() < interleaved.size()) {
+      zero_samples(interleaved);
+      return;
+    }
+    crossfadeStartNs_.store(nowNs());
+    phase_.store(Phase::Crossfade, std::memory_order_release);
+  }
+
+  const size_t popped = ring_.pop(interleaved);
+  if (popped < interleaved.size()) {
+    std::span<float> rest = interleaved.subspan(popped);
+    if (released_.load(std::memory_order_acquire) && ring_.size() == 0u) {
+      renderSource(rest);
+      applyFade(interleaved, fadeInProgress_, true);
+      currentLane_.store(lane, std::memory_order_release);
+      phase_.store(Phase::Idle, std::memory_order_release);
+      completionNs_.store(nowNs());
+      completed_.store(true, std::memory_order_release);
+      return;
+    }
+    zero_samples(rest);
+    underrunFrames_.fetch_add(rest.size() / channels_, std::memory_order_relaxed);
+  }
+  applyFade(interleaved, fadeInProgress_, true);
+}
+
+void AudioDeviceSwitcher::renderSource(std::span<float> interleaved) {
+  zero_samples(interleaved);
+  AudioCallbackContext ctx{};
+  ctx.frameIndex = frameIndex_++;
+  ctx.time = std::chrono::steady_clock::now();
+  ctx.requestedFrames = static_cast<uint32_t>(interleaved.size() / channels_);
+  ctx.isUnderrun = false;
+  source_(interleaved, ctx, userData_);
+}
+
+void AudioDeviceSwitcher::applyFade(std::span<float> interleaved, uint32_t& progress, bool fadeIn) const {
+  const size_t frames = interleaved.size() / channels_;
+  if (progress >= crossfadeFrames_) {
+    if (!fadeIn) {
+      zero_samples(interleaved);
+    }
+    return;
+  }
+  const float invLength = 1.0f / static_cast<float>(crossfadeFrames_);
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const uint32_t step = std::min<uint32_t>(progress + static_cast<uint32_t>(frame) + 1u, crossfadeFrames_);
+    const float t = static_cast<float>(step) * invLength;
+    const float gain = fadeIn ? t : 1.0f - t;
+    float* samples = interleaved.data() + frame * channels_;
+    for (uint32_t c = 0; c < channels_; ++c) {
+      samples[c] *= gain;
+    }
+  }
+  progress = static_cast<uint32_t>(std::min<size_t>(progress + frames, crossfadeFrames_));
+}
+
+int64_t AudioDeviceSwitcher::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "PrimeHost/Audio.h"
+#include "SpscRing.h"
+
+namespace PrimeHost {
+
+// Routes one logical output stream across up to two device "lanes" so a stream can move between
+// devices without a gap. The current lane drives the source callback; during a switch it also
+// copies what it renders into a ring that the incoming lane plays back once prefilled. The two
+// lanes crossfade, then the incoming lane drains the ring and takes over the source itself.
+// frameIndex comes from one shared counter, so it stays monotonic across switches.
+//
+// Threading: render() runs on each device thread with its lane index. The control functions
+// (prepare, beginSwitch, abortSwitch, outgoingLost, takeCompletedSwitch) must come from a single
+// control thread. A lane's previous device must be closed before that lane is reused.
+class AudioDeviceSwitcher {
+public:
+  enum class Phase : uint32_t {
+    Idle,
+    Prefill,
+    Crossfade,
+  };
+
+  struct SwitchResult {
+    std::chrono::nanoseconds switchLatency{0};
+    std::chrono::nanoseconds completionTime{0};
+    uint32_t crossfadeFrames = 0u;
+    bool crossfaded = false;
+  };
+
+  AudioDeviceSwitcher() = default;
+  AudioDeviceSwitcher(const AudioDeviceSwitcher&) = delete;
+  AudioDeviceSwitcher& operator=(const AudioDeviceSwitcher&) = delete;
+
+  // Must not overlap render(). Resets the timeline and makes lane 0 current.
+  void prepare(uint32_t channels,
+               uint32_t maxFrames,
+               uint32_t crossfadeFrames,
+               AudioCallback source,
+               void* userData);
+  void release();
+
+  bool beginSwitch(std::chrono::steady_clock::time_point requestTime);
+  void abortSwitch();
+  // The outgoing device has stopped and will not render again; hand over without a crossfade.
+  void outgoingLost();
+  std::optional<SwitchResult> takeCompletedSwitch();
+  // Must not overlap render(). Ends a pending switch immediately: a switch still prefilling is
+  // dropped, one that already reached the crossfade (or lost its outgoing device) completes.
+  std::optional<SwitchResult> settle();
+
+  Phase phase() const;
+  bool switchPending() const;
+  uint32_t currentLane() const;
+  uint32_t incomingLane() const;
+  uint64_t underrunFrames() const;
+
+  void render(uint32_t lane, std::span<float> interleaved);
+
+private:
+  void renderSource(std::span<float> interleaved);
+  void applyFade(std::span<float> interleaved, uint32_t& progress, bool fadeIn) const;
+  static int64_t nowNs();
+
+  SpscRing<float> ring_;
+  AudioCallback source_ = nullptr;
+  void* userData_ = nullptr;
+  uint32_t channels_ = 0u;
+  uint32_t maxFrames_ = 0u;
+  uint32_t crossfadeFrames_ = 0u;
+  uint64_t frameIndex_ = 0u;
+
+  std::atomic<Phase> phase_{Phase::Idle};
+  std::atomic<uint32_t> currentLane_{0u};
+  std::atomic<bool> released_{false};
+  std::atomic<bool> completed_{false};
+  std::atomic<bool> crossfaded_{false};
+  std::atomic<uint64_t> underrunFrames_{0u};
+  std::atomic<int64_t> crossfadeStartNs_{0};
+  std::atomic<int64_t> completionNs_{0};
+  uint32_t fadeOutProgress_ = 0u;
+  uint32_t fadeInProgress_ = 0u;
+  bool switchPending_ = false;
+  int64_t requestNs_ = 0;
+};
+
+} // namespace PrimeHost
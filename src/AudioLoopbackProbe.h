@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PrimeHost/Audio.h"
+
+namespace PrimeHost {
+
+struct AudioPercentiles {
+  double p50 = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+// Nearest-rank percentiles. Sorts `values` in place.
+inline AudioPercentiles audioPercentiles(std::vector<double>& values) {
+  AudioPercentiles result{};
+  if (values.empty()) {
+    return result;
+  }
+  std::sort(values.begin(), values.end());
+  auto rank = [&](double p) {
+    const auto index = static_cast<size_t>(std::ceil(p * static_cast<double>(values.size())));
+    return values[std::clamp<size_t>(index, 1u, values.size()) - 1u];
+  };
+  result.p50 = rank(0.50);
+  result.p90 = rank(0.90);
+  result.p99 = rank(0.99);
+  result.max = values.back();
+  return result;
+}
+
+struct AudioLoopbackReport {
+  uint32_t bufferFrames = 0u;
+  uint32_t sampleRate = 0u;
+  uint32_t callbacks = 0u;
+  uint32_t impulses = 0u;
+  uint32_t inputUnderruns = 0u;
+  // Impulse round trip (output callback -> loopback -> input), in frames.
+  AudioPercentiles latencyFrames{};
+  // |callback interval - buffer period|, in microseconds.
+  AudioPercentiles jitterUs{};
+  // Callback wake time minus its ideal time (first callback + n periods), in microseconds.
+  AudioPercentiles wakeErrorUs{};
+};
+
+// Duplex callback that writes a single-sample impulse into the output, finds it again in the
+// looped-back input and records per-callback timing. Storage is reserved in prepare(), so the
+// callback never allocates; callbacks past `maxCallbacks` are ignored.
+class AudioLoopbackProbe {
+public:
+  void prepare(uint32_t sampleRate, uint32_t bufferFrames, uint32_t maxCallbacks) {
+    sampleRate_ = sampleRate;
+    bufferFrames_ = bufferFrames;
+    maxCallbacks_ = maxCallbacks;
+    callbackTimes_.clear();
+    callbackTimes_.reserve(maxCallbacks);
+    latencies_.clear();
+    latencies_.reserve(maxCallbacks);
+    position_ = 0u;
+    emittedAt_ = 0u;
+    pending_ = false;
+    inputUnderruns_ = 0u;
+    recorded_.store(0u, std::memory_order_relaxed);
+  }
+
+  // Safe to poll from another thread while the stream runs; read report() once it is stopped.
+  bool finished() const { return recorded_.load(std::memory_order_acquire) >= maxCallbacks_; }
+
+  static void duplexCallback(std::span<const float> input,
+                             std::span<float> output,
+                             const AudioDuplexContext& ctx,
+                             void* userData) {
+    static_cast<AudioLoopbackProbe*>(userData)->process(input, output, ctx);
+  }
+
+  AudioLoopbackReport report() const {
+    AudioLoopbackReport report{};
+    report.bufferFrames = bufferFrames_;
+    report.sampleRate = sampleRate_;
+    report.callbacks = static_cast<uint32_t>(callbackTimes_.size());
+    report.impulses = static_cast<uint32_t>(latencies_.size());
+    report.inputUnderruns = inputUnderruns_;
+
+    std::vector<double> values(latencies_.begin(), latencies_.end());
+    report.latencyFrames = audioPercentiles(values);
+
+    if (callbackTimes_.size() < 2u || sampleRate_ == 0u) {
+      return report;
+    }
+    const double periodUs = static_cast<double>(bufferFrames_) * 1'000'000.0 / sampleRate_;
+    auto micros = [](std::chrono::steady_clock::duration d) {
+      return std::chrono::duration<double, std::micro>(d).count();
+    };
+    values.clear();
+    for (size_t i = 1; i < callbackTimes_.size(); ++i) {
+      values.push_back(std::abs(micros(callbackTimes_[i] - callbackTimes_[i - 1u]) - periodUs));
+    }
+    report.jitterUs = audioPercentiles(values);
+    values.clear();
+    for (size_t i = 1; i < callbackTimes_.size(); ++i) {
+      values.push_back(micros(callbackTimes_[i] - callbackTimes_[0]) - periodUs * static_cast<double>(i));
+    }
+    report.wakeErrorUs = audioPercentiles(values);
+    return report;
+  }
+
+private:
+  // Input below this is treated as silence; the impulse is 1.0.
+  static constexpr float Threshold = 0.5f;
+
+  void process(std::span<const float> input, std::span<float> output, const AudioDuplexContext& ctx) {
+    std::fill(output.begin(), output.end(), 0.0f);
+    const uint32_t frames = ctx.output.requestedFrames;
+    if (finished() || frames == 0u) {
+      return;
+    }
+    const size_t channels = output.size() / frames;
+    callbackTimes_.push_back(ctx.output.time);
+    if (ctx.inputUnderrun) {
+      ++inputUnderruns_;
+    }
+    if (pending_) {
+      for (uint32_t frame = 0; frame < frames; ++frame) {
+        if (input[frame * channels] > Threshold) {
+          latencies_.push_back(position_ + frame - emittedAt_);
+          pending_ = false;
+          break;
+        }
+      }
+    }
+    // One impulse in flight at a time, so a late echo is never matched to the wrong impulse.
+    if (!pending_) {
+      for (size_t channel = 0; channel < channels; ++channel) {
+        output[channel] = 1.0f;
+      }
+      emittedAt_ = position_;
+      pending_ = true;
+    }
+    position_ += frames;
+    recorded_.store(static_cast<uint32_t>(callbackTimes_.size()), std::memory_order_release);
+  }
+
+  uint32_t sampleRate_ = 0u;
+  uint32_t bufferFrames_ = 0u;
+  uint32_t maxCallbacks_ = 0u;
+  std::vector<std::chrono::steady_clock::time_point> callbackTimes_;
+  std::vector<uint64_t> latencies_;
+  uint64_t position_ = 0u;
+  uint64_t emittedAt_ = 0u;
+  bool pending_ = false;
+  uint32_t inputUnderruns_ = 0u;
+  std::atomic<uint32_t> recorded_{0u};
+};
+
+} // namespace PrimeHost
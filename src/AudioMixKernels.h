@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PRIMEHOST_MIX_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PRIMEHOST_MIX_NEON 1
+#endif
+
+namespace PrimeHost {
+
+inline void mixScaledScalar(float* dst, const float* src, size_t count, float gain) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] += src[i] * gain;
+  }
+}
+
+// dst[i] += src[i] * gain over `count` samples. The layout is irrelevant as long as both buffers
+// share it, so this is the fast path for streams whose channel count matches the device.
+inline void mixScaled(float* dst, const float* src, size_t count, float gain) {
+  size_t i = 0;
+#if defined(PRIMEHOST_MIX_SSE)
+  const __m128 g = _mm_set1_ps(gain);
+  for (; i + 8u <= count; i += 8u) {
+    __m128 d0 = _mm_loadu_ps(dst + i);
+    __m128 d1 = _mm_loadu_ps(dst + i + 4u);
+    __m128 s0 = _mm_loadu_ps(src + i);
+    __m128 s1 = _mm_loadu_ps(src + i + 4u);
+    _mm_storeu_ps(dst + i, _mm_add_ps(d0, _mm_mul_ps(s0, g)));
+    _mm_storeu_ps(dst + i + 4u, _mm_add_ps(d1, _mm_mul_ps(s1, g)));
+  }
+#elif defined(PRIMEHOST_MIX_NEON)
+  const float32x4_t g = vdupq_n_f32(gain);
+  for (; i + 8u <= count; i += 8u) {
+    float32x4_t d0 = vld1q_f32(dst + i);
+    float32x4_t d1 = vld1q_f32(dst + i + 4u);
+    vst1q_f32(dst + i, vmlaq_f32(d0, vld1q_f32(src + i), g));
+    vst1q_f32(dst + i + 4u, vmlaq_f32(d1, vld1q_f32(src + i + 4u), g));
+  }
+#endif
+  mixScaledScalar(dst + i, src + i, count - i, gain);
+}
+
+// General mix path: linear gain ramp from startGain to endGain across the buffer, with channel
+// mapping from an interleaved source into an interleaved destination. Mono sources are copied to
+// every destination channel; otherwise source channel c feeds destination channel c and surplus
+// channels on either side are skipped.
+inline void mixMapped(float* dst,
+                      uint32_t dstChannels,
+                      const float* src,
+                      uint32_t srcChannels,
+                      size_t frames,
+                      float startGain,
+                      float endGain) {
+  if (frames == 0u || dstChannels == 0u || srcChannels == 0u) {
+    return;
+  }
+  const float step = (endGain - startGain) / static_cast<float>(frames);
+  const uint32_t shared = srcChannels < dstChannels ? srcChannels : dstChannels;
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const float gain = startGain + step * static_cast<float>(frame + 1u);
+    float* out = dst + frame * dstChannels;
+    const float* in = src + frame * srcChannels;
+    if (srcChannels == 1u) {
+      const float sample = in[0] * gain;
+      for (uint32_t c = 0; c < dstChannels; ++c) {
+        out[c] += sample;
+      }
+      continue;
+    }
+    for (uint32_t c = 0; c < shared; ++c) {
+      out[c] += in[c] * gain;
+    }
+  }
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,208 @@
+#include "AudioMixer.h"
+
+#include "AudioMixKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace PrimeHost {
+namespace {
+
+constexpr uint32_t kMaxStreamChannels = 8u;
+
+bool valid_gain(float gain) {
+  return std::isfinite(gain) && gain >= 0.0f;
+}
+
+uint64_t make_stream_id(size_t index, uint32_t generation) {
+  return (static_cast<uint64_t>(generation) << 32u) | static_cast<uint64_t>(index + 1u);
+}
+
+} // namespace
+
+void AudioMixer::prepare(uint32_t deviceChannels, uint32_t maxFrames, uint32_t sampleRate) {
+  channels_ = deviceChannels;
+  maxFrames_ = maxFrames;
+  sampleRate_ = sampleRate;
+  scratch_.assign(static_cast<size_t>(maxFrames) * kMaxStreamChannels, 0.0f);
+}
+
+void AudioMixer::release() {
+  channels_ = 0u;
+  maxFrames_ = 0u;
+  sampleRate_ = 0u;
+  scratch_.clear();
+}
+
+HostResult<AudioMixStreamId> AudioMixer::addStream(const AudioMixStreamConfig& config,
+                                                   AudioCallback callback,
+                                                   void* userData) {
+  if (!callback) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (config.channels == 0u || config.channels > kMaxStreamChannels) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (!valid_gain(config.gain)) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    Slot& slot = slots_[i];
+    if (slot.active.load()) {
+      continue;
+    }
+    slot.generation += 1u;
+    slot.callback = callback;
+    slot.userData = userData;
+    slot.channels = config.channels;
+    slot.targetGain.store(config.gain, std::memory_order_relaxed);
+    slot.currentGain = config.gain;
+    slot.callbackCount.store(0u, std::memory_order_relaxed);
+    slot.lastNs.store(0, std::memory_order_relaxed);
+    slot.maxNs.store(0, std::memory_order_relaxed);
+    slot.totalNs.store(0, std::memory_order_relaxed);
+    slot.lastLoad.store(0.0f, std::memory_order_relaxed);
+    slot.active.store(true);
+    activeCount_.fetch_add(1u);
+    return make_stream_id(i, slot.generation);
+  }
+  return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+}
+
+HostStatus AudioMixer::removeStream(AudioMixStreamId streamId) {
+  Slot* slot = findSlot(streamId);
+  if (!slot) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  slot->active.store(false);
+  activeCount_.fetch_sub(1u);
+  // The render thread may still be inside this slot's callback; wait it out so the caller can
+  // release userData as soon as we return.
+  waitForRenderPass();
+  slot->callback = nullptr;
+  slot->userData = nullptr;
+  return {};
+}
+
+HostStatus AudioMixer::setStreamGain(AudioMixStreamId streamId, float gain) {
+  Slot* slot = findSlot(streamId);
+  if (!slot) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (!valid_gain(gain)) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  slot->targetGain.store(gain, std::memory_order_relaxed);
+  return {};
+}
+
+HostResult<AudioMixStreamStats> AudioMixer::streamStats(AudioMixStreamId streamId) const {
+  const Slot* slot = findSlot(streamId);
+  if (!slot) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  AudioMixStreamStats stats{};
+  stats.callbackCount = slot->callbackCount.load(std::memory_order_relaxed);
+  stats.lastCallbackTime = std::chrono::nanoseconds(slot->lastNs.load(std::memory_order_relaxed));
+  stats.maxCallbackTime = std::chrono::nanoseconds(slot->maxNs.load(std::memory_order_relaxed));
+  stats.totalCallbackTime = std::chrono::nanoseconds(slot->totalNs.load(std::memory_order_relaxed));
+  stats.lastLoad = slot->lastLoad.load(std::memory_order_relaxed);
+  return stats;
+}
+
+uint32_t AudioMixer::activeStreamCount() const {
+  return activeCount_.load(std::memory_order_relaxed);
+}
+
+void AudioMixer::render(std::span<float> interleaved, const AudioCallbackContext& ctx) {
+  if (activeCount_.load(std::memory_order_relaxed) == 0u) {
+    return;
+  }
+  if (channels_ == 0u || maxFrames_ == 0u || scratch_.empty()) {
+    return;
+  }
+  renderEpoch_.fetch_add(1u);
+
+  const size_t frames = interleaved.size() / channels_;
+  for (Slot& slot : slots_) {
+    if (!slot.active.load()) {
+      continue;
+    }
+    const float startGain = slot.currentGain;
+    const float endGain = slot.targetGain.load(std::memory_order_relaxed);
+    const float gainStep = frames > 0u ? (endGain - startGain) / static_cast<float>(frames) : 0.0f;
+    int64_t elapsedNs = 0;
+
+    size_t offset = 0u;
+    while (offset < frames) {
+      const size_t chunk = std::min(frames - offset, static_cast<size_t>(maxFrames_));
+      const size_t sampleCount = chunk * slot.channels;
+      float* source = scratch_.data();
+      std::memset(source, 0, sampleCount * sizeof(float));
+
+      AudioCallbackContext streamCtx = ctx;
+      streamCtx.requestedFrames = static_cast<uint32_t>(chunk);
+      auto begin = std::chrono::steady_clock::now();
+      slot.callback(std::span<float>(source, sampleCount), streamCtx, slot.userData);
+      auto end = std::chrono::steady_clock::now();
+      elapsedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+      float* target = interleaved.data() + offset * channels_;
+      const float chunkStart = startGain + gainStep * static_cast<float>(offset);
+      const float chunkEnd = startGain + gainStep * static_cast<float>(offset + chunk);
+      if (slot.channels == channels_ && chunkStart == chunkEnd) {
+        mixScaled(target, source, sampleCount, chunkStart);
+      } else {
+        mixMapped(target, channels_, source, slot.channels, chunk, chunkStart, chunkEnd);
+      }
+      offset += chunk;
+    }
+    slot.currentGain = endGain;
+
+    slot.callbackCount.fetch_add(1u, std::memory_order_relaxed);
+    slot.lastNs.store(elapsedNs, std::memory_order_relaxed);
+    slot.totalNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+    if (elapsedNs > slot.maxNs.load(std::memory_order_relaxed)) {
+      slot.maxNs.store(elapsedNs, std::memory_order_relaxed);
+    }
+    if (sampleRate_ > 0u && frames > 0u) {
+      const double budgetNs = static_cast<double>(frames) * 1'000'000'000.0 / sampleRate_;
+      slot.lastLoad.store(static_cast<float>(static_cast<double>(elapsedNs) / budgetNs),
+                          std::memory_order_relaxed);
+    }
+  }
+
+  renderEpoch_.fetch_add(1u);
+}
+
+AudioMixer::Slot* AudioMixer::findSlot(AudioMixStreamId streamId) {
+  return const_cast<Slot*>(static_cast<const AudioMixer*>(this)->findSlot(streamId));
+}
+
+const AudioMixer::Slot* AudioMixer::findSlot(AudioMixStreamId streamId) const {
+  const uint64_t index = streamId & 0xFFFFFFFFu;
+  const uint32_t generation = static_cast<uint32_t>(streamId >> 32u);
+  if (index == 0u || index > slots_.size()) {
+    return nullptr;
+  }
+  const Slot& slot = slots_[index - 1u];
+  if (!slot.active.load() || slot.generation != generation) {
+    return nullptr;
+  }
+  return &slot;
+}
+
+void AudioMixer::waitForRenderPass() const {
+  const uint64_t epoch = renderEpoch_.load();
+  if ((epoch & 1u) == 0u) {
+    return;
+  }
+  while (renderEpoch_.load() == epoch) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace PrimeHost
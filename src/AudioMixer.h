@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PrimeHost/Audio.h"
+
+namespace PrimeHost {
+
+// Mixes up to AudioMaxMixStreams logical streams into a device buffer on the render thread.
+// Control calls (prepare/addStream/removeStream/setStreamGain) must come from one thread;
+// render() may run concurrently on the audio thread and never allocates or locks.
+class AudioMixer {
+public:
+  AudioMixer() = default;
+  AudioMixer(const AudioMixer&) = delete;
+  AudioMixer& operator=(const AudioMixer&) = delete;
+
+  // Sizes the scratch buffer for the device stream. Must not overlap a render() call.
+  void prepare(uint32_t deviceChannels, uint32_t maxFrames, uint32_t sampleRate);
+  void release();
+
+  HostResult<AudioMixStreamId> addStream(const AudioMixStreamConfig& config,
+                                         AudioCallback callback,
+                                         void* userData);
+  HostStatus removeStream(AudioMixStreamId streamId);
+  HostStatus setStreamGain(AudioMixStreamId streamId, float gain);
+  HostResult<AudioMixStreamStats> streamStats(AudioMixStreamId streamId) const;
+  uint32_t activeStreamCount() const;
+
+  // Adds every active stream into `interleaved`, which holds device-channel frames.
+  void render(std::span<float> interleaved, const AudioCallbackContext& ctx);
+
+private:
+  struct Slot {
+    std::atomic<bool> active{false};
+    uint32_t generation = 0u;
+    AudioCallback callback = nullptr;
+    void* userData = nullptr;
+    uint16_t channels = 0u;
+    std::atomic<float> targetGain{1.0f};
+    float currentGain = 1.0f;
+    std::atomic<uint64_t> callbackCount{0u};
+    std::atomic<int64_t> lastNs{0};
+    std::atomic<int64_t> maxNs{0};
+    std::atomic<int64_t> totalNs{0};
+    std::atomic<float> lastLoad{0.0f};
+  };
+
+  Slot* findSlot(AudioMixStreamId streamId);
+  const Slot* findSlot(AudioMixStreamId streamId) const;
+  void waitForRenderPass() const;
+
+  std::array<Slot, AudioMaxMixStreams> slots_{};
+  std::vector<float> scratch_;
+  uint32_t channels_ = 0u;
+  uint32_t maxFrames_ = 0u;
+  uint32_t sampleRate_ = 0u;
+  std::atomic<uint32_t> activeCount_{0u};
+  std::atomic<uint64_t> renderEpoch_{0u};
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,278 @@
+#include "PrimeHost/AudioWorkers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace PrimeHost {
+namespace {
+
+void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+bool promote_current_thread(std::chrono::nanoseconds period) {
+#if defined(__APPLE__)
+  mach_timebase_info_data_t timebase{};
+  mach_timebase_info(&timebase);
+  if (timebase.numer == 0u || period.count() <= 0) {
+    return false;
+  }
+  const double ticksPerNs = static_cast<double>(timebase.denom) / timebase.numer;
+  thread_time_constraint_policy_data_t policy{};
+  policy.period = static_cast<uint32_t>(period.count() * ticksPerNs);
+  policy.computation = policy.period / 2u;
+  policy.constraint = policy.period;
+  policy.preemptible = 1;
+  return thread_policy_set(mach_thread_self(),
+                           THREAD_TIME_CONSTRAINT_POLICY,
+                           reinterpret_cast<thread_policy_t>(&policy),
+                           THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+#elif defined(__linux__)
+  (void)period;
+  sched_param param{};
+  param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO) / 2);
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+  (void)period;
+  return false;
+#endif
+}
+
+// claim_ packs the dispatch generation (16 bits) and job count (16 bits) above a 32-bit ticket.
+// A claim is one fetch_add on the whole word, so it finishes in a bounded number of steps however
+// many threads contend (wait-free). The returned word carries the generation and count of the
+// dispatch the ticket belongs to, and a ticket at or past the count claims nothing. Each thread
+// overshoots the count at most once per wake-up, far from carrying out of the 32-bit ticket before
+// the next dispatch resets it.
+constexpr uint64_t pack_claim(uint64_t generation, uint64_t count, uint64_t next) {
+  return ((generation & 0xFFFFu) << 48u) | (count << 32u) | next;
+}
+
+constexpr uint32_t claim_count(uint64_t claim) {
+  return static_cast<uint32_t>((claim >> 32u) & 0xFFFFu);
+}
+
+constexpr uint32_t claim_next(uint64_t claim) {
+  return static_cast<uint32_t>(claim & 0xFFFFFFFFu);
+}
+
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+class AudioWorkerPoolImpl final : public AudioWorkerPool {
+public:
+  explicit AudioWorkerPoolImpl(const AudioWorkerPoolConfig& config) : config_(config) {
+    uint32_t count = config.workerCount;
+    if (count == 0u) {
+      const uint32_t hardware = std::thread::hardware_concurrency();
+      count = hardware > 1u ? hardware - 1u : 1u;
+    }
+    count = std::min(count, AudioMaxWorkers);
+    workers_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      workers_.emplace_back([this]() { runWorker(); });
+    }
+  }
+
+  ~AudioWorkerPoolImpl() override {
+    stop_.store(true, std::memory_order_release);
+    wake_.fetch_add(1u, std::memory_order_release);
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  uint32_t workerCount() const override {
+    return static_cast<uint32_t>(workers_.size());
+  }
+
+  HostResult<AudioDispatchResult> dispatch(uint32_t jobCount,
+                                           AudioJob job,
+                                           void* userData,
+                                           std::chrono::steady_clock::time_point deadline) override {
+    if (!job || jobCount > AudioMaxJobsPerDispatch) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    AudioDispatchResult result{};
+    if (jobCount == 0u) {
+      return result;
+    }
+    const int64_t startNs = now_ns();
+    job_ = job;
+    userData_ = userData;
+    deadlineNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    done_.store(0u, std::memory_order_relaxed);
+    completed_.store(0u, std::memory_order_relaxed);
+    late_.store(0u, std::memory_order_relaxed);
+    dropped_.store(0u, std::memory_order_relaxed);
+    ++generation_;
+    claim_.store(pack_claim(generation_, jobCount, 0u), std::memory_order_release);
+    wake_.fetch_add(1u, std::memory_order_release);
+    wake_.notify_all();
+
+    runJobs();
+    // Jobs started by descheduled workers cannot be abandoned, since their output is read once
+    // dispatch returns. Waiting past the deadline is reported as overrun instead.
+    while (done_.load(std::memory_order_acquire) < jobCount) {
+      cpu_relax();
+    }
+
+    const int64_t endNs = now_ns();
+    result.completed = completed_.load(std::memory_order_relaxed);
+    result.late = late_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.elapsed = std::chrono::nanoseconds(endNs - startNs);
+    result.overrun = std::chrono::nanoseconds(std::max<int64_t>(endNs - deadlineNs_, 0));
+
+    dispatchCount_.fetch_add(1u, std::memory_order_relaxed);
+    jobsCompleted_.fetch_add(result.completed, std::memory_order_relaxed);
+    jobsLate_.fetch_add(result.late, std::memory_order_relaxed);
+    jobsDropped_.fetch_add(result.dropped, std::memory_order_relaxed);
+    if (result.late > 0u || result.dropped > 0u || result.overrun.count() > 0) {
+      deadlineMisses_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    if (result.overrun.count() > 0) {
+      overruns_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    if (result.overrun.count() > maxOverrunNs_.load(std::memory_order_relaxed)) {
+      maxOverrunNs_.store(result.overrun.count(), std::memory_order_relaxed);
+    }
+    const int64_t elapsed = result.elapsed.count();
+    lastDispatchNs_.store(elapsed, std::memory_order_relaxed);
+    if (elapsed > maxDispatchNs_.load(std::memory_order_relaxed)) {
+      maxDispatchNs_.store(elapsed, std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  AudioWorkerStats stats() const override {
+    AudioWorkerStats stats{};
+    stats.workerCount = workerCount();
+    stats.realtimeWorkers = realtimeWorkers_.load(std::memory_order_relaxed);
+    stats.dispatchCount = dispatchCount_.load(std::memory_order_relaxed);
+    stats.jobsCompleted = jobsCompleted_.load(std::memory_order_relaxed);
+    stats.jobsLate = jobsLate_.load(std::memory_order_relaxed);
+    stats.jobsDropped = jobsDropped_.load(std::memory_order_relaxed);
+    stats.deadlineMisses = deadlineMisses_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.maxOverrun = std::chrono::nanoseconds(maxOverrunNs_.load(std::memory_order_relaxed));
+    stats.lastDispatchTime = std::chrono::nanoseconds(lastDispatchNs_.load(std::memory_order_relaxed));
+    stats.maxDispatchTime = std::chrono::nanoseconds(maxDispatchNs_.load(std::memory_order_relaxed));
+    return stats;
+  }
+
+  void resetStats() override {
+    dispatchCount_.store(0u, std::memory_order_relaxed);
+    jobsCompleted_.store(0u, std::memory_order_relaxed);
+    jobsLate_.store(0u, std::memory_order_relaxed);
+    jobsDropped_.store(0u, std::memory_order_relaxed);
+    deadlineMisses_.store(0u, std::memory_order_relaxed);
+    overruns_.store(0u, std::memory_order_relaxed);
+    maxOverrunNs_.store(0, std::memory_order_relaxed);
+    lastDispatchNs_.store(0, std::memory_order_relaxed);
+    maxDispatchNs_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  void runJobs() {
+    // Skip the fetch_add when the current dispatch is already fully claimed.
+    const uint64_t current = claim_.load(std::memory_order_acquire);
+    if (claim_next(current) >= claim_count(current)) {
+      return;
+    }
+    for (;;) {
+      const uint64_t claim = claim_.fetch_add(1u, std::memory_order_acq_rel);
+      if (claim_next(claim) >= claim_count(claim)) {
+        return;
+      }
+      // A live ticket belongs to the dispatch whose release store the fetch_add read, even if it
+      // started after `current` was loaded, so job_/userData_/deadlineNs_ are that dispatch's. The
+      // claim keeps it waiting until done_.
+      if (now_ns() > deadlineNs_) {
+        dropped_.fetch_add(1u, std::memory_order_relaxed);
+      } else {
+        job_(claim_next(claim), userData_);
+        completed_.fetch_add(1u, std::memory_order_relaxed);
+        if (now_ns() > deadlineNs_) {
+          late_.fetch_add(1u, std::memory_order_relaxed);
+        }
+      }
+      done_.fetch_add(1u, std::memory_order_release);
+    }
+  }
+
+  void runWorker() {
+    if (config_.realtimePriority && promote_current_thread(config_.period)) {
+      realtimeWorkers_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    uint32_t seen = wake_.load(std::memory_order_acquire);
+    while (!stop_.load(std::memory_order_acquire)) {
+      runJobs();
+      for (uint32_t spin = 0; spin < config_.spinIterations; ++spin) {
+        if (wake_.load(std::memory_order_acquire) != seen) {
+          break;
+        }
+        cpu_relax();
+      }
+      wake_.wait(seen, std::memory_order_acquire);
+      seen = wake_.load(std::memory_order_acquire);
+    }
+  }
+
+  AudioWorkerPoolConfig config_{};
+  std::vector<std::thread> workers_;
+
+  AudioJob job_ = nullptr;
+  void* userData_ = nullptr;
+  int64_t deadlineNs_ = 0;
+  uint64_t generation_ = 0u;
+  alignas(64) std::atomic<uint64_t> claim_{0u};
+  alignas(64) std::atomic<uint32_t> done_{0u};
+  std::atomic<uint32_t> completed_{0u};
+  std::atomic<uint32_t> late_{0u};
+  std::atomic<uint32_t> dropped_{0u};
+  alignas(64) std::atomic<uint32_t> wake_{0u};
+  std::atomic<bool> stop_{false};
+
+  std::atomic<uint32_t> realtimeWorkers_{0u};
+  std::atomic<uint64_t> dispatchCount_{0u};
+  std::atomic<uint64_t> jobsCompleted_{0u};
+  std::atomic<uint64_t> jobsLate_{0u};
+  std::atomic<uint64_t> jobsDropped_{0u};
+  std::atomic<uint64_t> deadlineMisses_{0u};
+  std::atomic<uint64_t> overruns_{0u};
+  std::atomic<int64_t> maxOverrunNs_{0};
+  std::atomic<int64_t> lastDispatchNs_{0};
+  std::atomic<int64_t> maxDispatchNs_{0};
+};
+
+} // namespace
+
+HostResult<std::unique_ptr<AudioWorkerPool>> createAudioWorkerPool(const AudioWorkerPoolConfig& config) {
+  return std::make_unique<AudioWorkerPoolImpl>(config);
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "PrimeHost/JobSystem.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace PrimeHost {
+
+// Logical CPUs split into performance and efficiency classes. Homogeneous machines report every
+// CPU as performance.
+struct CoreTopology {
+  uint32_t performanceCores = 0u;
+  uint32_t efficiencyCores = 0u;
+  // CPU ids per class where threads can be pinned (Linux); empty where the OS only takes hints.
+  std::vector<uint32_t> performanceCpus;
+  std::vector<uint32_t> efficiencyCpus;
+
+  bool hybrid() const { return performanceCores != 0u && efficiencyCores != 0u; }
+};
+
+struct CpuCapacity {
+  uint32_t cpu = 0u;
+  // Relative speed: cpu_capacity on ARM, maximum frequency elsewhere.
+  uint64_t capacity = 0u;
+};
+
+// Cores within 85% of the fastest count as performance cores. The margin absorbs the turbo spread
+// between performance cores (favored cores boost a few percent higher), while efficiency cores sit
+// at roughly 40-75% of the fastest on current hybrid parts.
+inline CoreTopology classifyCores(std::span<const CpuCapacity> cpus) {
+  CoreTopology topology{};
+  uint64_t fastest = 0u;
+  for (const CpuCapacity& cpu : cpus) {
+    fastest = std::max(fastest, cpu.capacity);
+  }
+  for (const CpuCapacity& cpu : cpus) {
+    const bool performance = cpu.capacity * 100u >= fastest * 85u;
+    (performance ? topology.performanceCpus : topology.efficiencyCpus).push_back(cpu.cpu);
+  }
+  topology.performanceCores = static_cast<uint32_t>(topology.performanceCpus.size());
+  topology.efficiencyCores = static_cast<uint32_t>(topology.efficiencyCpus.size());
+  return topology;
+}
+
+#if defined(__linux__)
+inline uint64_t readSysfsNumber(const std::string& path) {
+  std::ifstream file(path);
+  uint64_t value = 0u;
+  file >> value;
+  return file ? value : 0u;
+}
+#endif
+
+inline CoreTopology queryCoreTopology() {
+  CoreTopology topology{};
+#if defined(__APPLE__)
+  int levels = 0;
+  size_t size = sizeof(levels);
+  if (sysctlbyname("hw.nperflevels", &levels, &size, nullptr, 0) == 0 && levels >= 2) {
+    int performance = 0;
+    int efficiency = 0;
+    size = sizeof(performance);
+    sysctlbyname("hw.perflevel0.logicalcpu", &performance, &size, nullptr, 0);
+    size = sizeof(efficiency);
+    sysctlbyname("hw.perflevel1.logicalcpu", &efficiency, &size, nullptr, 0);
+    topology.performanceCores = static_cast<uint32_t>(std::max(performance, 0));
+    topology.efficiencyCores = static_cast<uint32_t>(std::max(efficiency, 0));
+  }
+#elif defined(__linux__)
+  // Only CPUs this process may run on, so taskset and cgroup limits are respected.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  const long configured = sysconf(_SC_NPROCESSORS_CONF);
+  std::vector<CpuCapacity> cpus;
+  bool measured = true;
+  for (long cpu = 0; cpu < configured && cpu < CPU_SETSIZE; ++cpu) {
+    if (haveMask && !CPU_ISSET(cpu, &allowed)) {
+      continue;
+    }
+    const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    uint64_t capacity = readSysfsNumber(base + "/cpu_capacity");
+    if (capacity == 0u) {
+      capacity = readSysfsNumber(base + "/cpufreq/cpuinfo_max_freq");
+    }
+    measured = measured && capacity != 0u;
+    cpus.push_back(CpuCapacity{static_cast<uint32_t>(cpu), capacity});
+  }
+  if (measured && !cpus.empty()) {
+    topology = classifyCores(cpus);
+  } else {
+    topology.performanceCores = static_cast<uint32_t>(cpus.size());
+  }
+#endif
+  if (topology.performanceCores == 0u && topology.efficiencyCores == 0u) {
+    topology.performanceCores = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return topology;
+}
+
+// Steers the calling thread toward `coreClass`: QoS classes on macOS, CPU affinity on hybrid
+// Linux machines. Returns false when the platform offers neither or the class is absent.
+inline bool placeCurrentThread(const CoreTopology& topology, CoreClass coreClass) {
+  if (coreClass == CoreClass::Any) {
+    return false;
+  }
+#if defined(__APPLE__)
+  // User-initiated work is scheduled on performance cores first; background work is confined to
+  // efficiency cores.
+  if (!topology.hybrid()) {
+    return false;
+  }
+  const qos_class_t qos = coreClass == CoreClass::Performance ? QOS_CLASS_USER_INITIATED : QOS_CLASS_BACKGROUND;
+  return pthread_set_qos_class_self_np(qos, 0) == 0;
+#elif defined(__linux__)
+  const std::vector<uint32_t>& cpus =
+      coreClass == CoreClass::Performance ? topology.performanceCpus : topology.efficiencyCpus;
+  if (!topology.hybrid() || cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (uint32_t cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)topology;
+  return false;
+#endif
+}
+
+} // namespace PrimeHost
@@ -1,23 +1,37 @@
 #pragma once
 
+#include <array>
 #include <cctype>
-#include <string>
+#include <cstddef>
 #include <string_view>
 
 namespace PrimeHost {
-namespace detail {
 
-inline std::string normalizeDeviceName(std::string_view name) {
-  std::string normalized;
-  normalized.reserve(name.size());
+// Lowercased alphanumeric words separated by single spaces. Stored inline so matching never
+// allocates; HID product strings are well under the limit and longer names are truncated.
+struct NormalizedDeviceName {
+  static constexpr size_t Capacity = 256u;
+
+  std::array<char, Capacity> chars{};
+  size_t size = 0u;
+
+  std::string_view view() const { return {chars.data(), size}; }
+};
+
+inline NormalizedDeviceName normalizeDeviceName(std::string_view name) {
+  NormalizedDeviceName normalized;
   bool pendingSpace = false;
   for (char ch : name) {
     unsigned char value = static_cast<unsigned char>(ch);
     if (std::isalnum(value)) {
-      if (pendingSpace && !normalized.empty()) {
-        normalized.push_back(' ');
+      const size_t needed = pendingSpace && normalized.size > 0u ? 2u : 1u;
+      if (normalized.size + needed > normalized.chars.size()) {
+        break;
+      }
+      if (needed == 2u) {
+        normalized.chars[normalized.size++] = ' ';
       }
-      normalized.push_back(static_cast<char>(std::tolower(value)));
+      normalized.chars[normalized.size++] = static_cast<char>(std::tolower(value));
       pendingSpace = false;
     } else {
       pendingSpace = true;
@@ -26,7 +40,9 @@ inline std::string normalizeDeviceName(std::string_view name) {
   return normalized;
 }
 
-inline int countSharedTokens(const std::string& left, const std::string& right) {
+namespace detail {
+
+inline int countSharedTokens(std::string_view left, std::string_view right) {
   if (left.empty() || right.empty()) {
     return 0;
   }
@@ -34,13 +50,12 @@ inline int countSharedTokens(const std::string& left, const std::string& right)
   std::size_t start = 0;
   while (start < left.size()) {
     std::size_t end = left.find(' ', start);
-    if (end == std::string::npos) {
+    if (end == std::string_view::npos) {
       end = left.size();
     }
     std::size_t length = end - start;
     if (length >= 3) {
-      std::string_view token(left.data() + start, length);
-      if (right.find(token) != std::string::npos) {
+      if (right.find(left.substr(start, length)) != std::string_view::npos) {
         shared += 1;
       }
     }
@@ -51,12 +66,9 @@ inline int countSharedTokens(const std::string& left, const std::string& right)
 
 } // namespace detail
 
-inline int deviceNameMatchScore(std::string_view candidate, std::string_view reference) {
-  if (candidate.empty() || reference.empty()) {
-    return 0;
-  }
-  std::string normalizedCandidate = detail::normalizeDeviceName(candidate);
-  std::string normalizedReference = detail::normalizeDeviceName(reference);
+inline int deviceNameMatchScore(const NormalizedDeviceName& candidate, const NormalizedDeviceName& reference) {
+  std::string_view normalizedCandidate = candidate.view();
+  std::string_view normalizedReference = reference.view();
   if (normalizedCandidate.empty() || normalizedReference.empty()) {
     return 0;
   }
@@ -64,16 +76,32 @@ inline int deviceNameMatchScore(std::string_view candidate, std::string_view ref
     return 100;
   }
   if (normalizedCandidate.size() < normalizedReference.size()) {
-    if (normalizedReference.find(normalizedCandidate) != std::string::npos) {
+    if (normalizedReference.find(normalizedCandidate) != std::string_view::npos) {
       return 80;
     }
-  } else if (normalizedCandidate.find(normalizedReference) != std::string::npos) {
+  } else if (normalizedCandidate.find(normalizedReference) != std::string_view::npos) {
     return 80;
   }
   int sharedTokens = detail::countSharedTokens(normalizedCandidate, normalizedReference);
   return sharedTokens * 10;
 }
 
+// Use this overload when scoring one name against many references, so the candidate is only
+// normalized once.
+inline int deviceNameMatchScore(const NormalizedDeviceName& candidate, std::string_view reference) {
+  if (reference.empty()) {
+    return 0;
+  }
+  return deviceNameMatchScore(candidate, normalizeDeviceName(reference));
+}
+
+inline int deviceNameMatchScore(std::string_view candidate, std::string_view reference) {
+  if (candidate.empty() || reference.empty()) {
+    return 0;
+  }
+  return deviceNameMatchScore(normalizeDeviceName(candidate), normalizeDeviceName(reference));
+}
+
 inline bool deviceNameMatches(std::string_view candidate, std::string_view reference) {
   return deviceNameMatchScore(candidate, reference) > 0;
 }
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+#include "PerfectHashUtil.h"
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace PrimeHost {
+
+struct DisplayRecord {
+  DisplayInfo info{};
+  DisplayHdrInfo hdr{};
+};
+
+// Immutable display topology at one point in time. Lookup by id probes an open-addressed table
+// at most half full, so it is O(1) regardless of how many displays are attached.
+class DisplaySnapshot {
+public:
+  DisplaySnapshot() = default;
+
+  DisplaySnapshot(std::vector<DisplayRecord> records, uint64_t generation)
+      : records_(std::move(records)), generation_(generation) {
+    slots_.assign(std::bit_ceil(records_.size() * 2u + 1u), EmptySlot);
+    const size_t mask = slots_.size() - 1u;
+    for (size_t i = 0; i < records_.size(); ++i) {
+      size_t slot = perfectHashMix(records_[i].info.displayId, 0u) & mask;
+      while (slots_[slot] != EmptySlot) {
+        slot = (slot + 1u) & mask;
+      }
+      slots_[slot] = static_cast<uint32_t>(i);
+    }
+  }
+
+  // Bumped on every published topology, so callers can tell whether a cached copy is current.
+  uint64_t generation() const { return generation_; }
+  std::span<const DisplayRecord> records() const { return records_; }
+
+  const DisplayRecord* find(uint32_t displayId) const {
+    if (records_.empty()) {
+      return nullptr;
+    }
+    const size_t mask = slots_.size() - 1u;
+    for (size_t slot = perfectHashMix(displayId, 0u) & mask; slots_[slot] != EmptySlot;
+         slot = (slot + 1u) & mask) {
+      const DisplayRecord& record = records_[slots_[slot]];
+      if (record.info.displayId == displayId) {
+        return &record;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  static constexpr uint32_t EmptySlot = UINT32_MAX;
+
+  std::vector<DisplayRecord> records_;
+  std::vector<uint32_t> slots_;
+  uint64_t generation_ = 0u;
+};
+
+inline DisplayFieldMask changedDisplayFields(const DisplayRecord& before, const DisplayRecord& after) {
+  DisplayFieldMask fields = 0u;
+  const DisplayInfo& a = before.info;
+  const DisplayInfo& b = after.info;
+  if (a.x != b.x || a.y != b.y || a.width != b.width || a.height != b.height) {
+    fields |= static_cast<DisplayFieldMask>(DisplayField::Bounds);
+  }
+  if (a.scale != b.scale) {
+    fields |= static_cast<DisplayFieldMask>(DisplayField::Scale);
+  }
+  if (a.refreshRate != b.refreshRate) {
+    fields |= static_cast<DisplayFieldMask>(DisplayField::RefreshRate);
+  }
+  if (a.isPrimary != b.isPrimary) {
+    fields |= static_cast<DisplayFieldMask>(DisplayField::Primary);
+  }
+  if (before.hdr.supportsHdr != after.hdr.supportsHdr || before.hdr.maxEdr != after.hdr.maxEdr ||
+      before.hdr.maxEdrPotential != after.hdr.maxEdrPotential) {
+    fields |= static_cast<DisplayFieldMask>(DisplayField::Hdr);
+  }
+  return fields;
+}
+
+// Appends the changes that turn `before` into `after`: removals in `before` order, then additions
+// and changes in `after` order.
+inline void diffDisplaySnapshots(const DisplaySnapshot& before,
+                                 const DisplaySnapshot& after,
+                                 std::vector<DisplayEvent>& out) {
+  for (const DisplayRecord& record : before.records()) {
+    if (!after.find(record.info.displayId)) {
+      out.push_back(DisplayEvent{record.info.displayId, DisplayChange::Removed, 0u});
+    }
+  }
+  for (const DisplayRecord& record : after.records()) {
+    const DisplayRecord* previous = before.find(record.info.displayId);
+    if (!previous) {
+      out.push_back(DisplayEvent{record.info.displayId, DisplayChange::Added, 0u});
+    } else if (const DisplayFieldMask fields = changedDisplayFields(*previous, record); fields != 0u) {
+      out.push_back(DisplayEvent{record.info.displayId, DisplayChange::Changed, fields});
+    }
+  }
+}
+
+// Pins the snapshot that was current when it was taken. Superseded snapshots are freed only while
+// no reader is alive, so hold one just long enough to copy out what is needed.
+class DisplaySnapshotReader {
+public:
+  DisplaySnapshotReader(const DisplaySnapshotReader&) = delete;
+  DisplaySnapshotReader& operator=(const DisplaySnapshotReader&) = delete;
+  ~DisplaySnapshotReader() { readers_.fetch_sub(1u, std::memory_order_release); }
+
+  const DisplaySnapshot& operator*() const { return *snapshot_; }
+  const DisplaySnapshot* operator->() const { return snapshot_; }
+
+private:
+  friend class DisplayCache;
+
+  // The count goes up before the pointer is loaded (both seq_cst), so a writer that sees no
+  // readers after swapping the pointer knows every later reader loads the new snapshot.
+  DisplaySnapshotReader(std::atomic<uint32_t>& readers, const std::atomic<const DisplaySnapshot*>& current)
+      : readers_(readers) {
+    readers_.fetch_add(1u, std::memory_order_seq_cst);
+    snapshot_ = current.load(std::memory_order_seq_cst);
+  }
+
+  std::atomic<uint32_t>& readers_;
+  const DisplaySnapshot* snapshot_ = nullptr;
+};
+
+// Host-owned cache of the display topology. Readers pin the current snapshot without locking; the
+// platform rebuilds it when the system reports a reconfiguration or an EDR headroom change.
+// Superseded snapshots wait in a retired list and are freed by the next publish that finds no
+// reader alive, so frequent brightness changes do not accumulate snapshots.
+class DisplayCache {
+public:
+  DisplayCache() {
+    owned_ = std::make_unique<const DisplaySnapshot>();
+    current_.store(owned_.get(), std::memory_order_release);
+  }
+
+  DisplaySnapshotReader read() const { return DisplaySnapshotReader(readers_, current_); }
+
+  // Installs a new topology and appends the resulting changes to `changes`. Returns false, leaving
+  // the current snapshot in place, when nothing differs.
+  bool publish(std::vector<DisplayRecord> records, std::vector<DisplayEvent>& changes) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    DisplaySnapshot next(std::move(records), owned_->generation() + 1u);
+    const size_t firstChange = changes.size();
+    diffDisplaySnapshots(*owned_, next, changes);
+    if (changes.size() != firstChange) {
+      retired_.push_back(std::move(owned_));
+      owned_ = std::make_unique<const DisplaySnapshot>(std::move(next));
+      current_.store(owned_.get(), std::memory_order_seq_cst);
+    }
+    if (readers_.load(std::memory_order_seq_cst) == 0u) {
+      retired_.clear();
+    }
+    return changes.size() != firstChange;
+  }
+
+  // Superseded snapshots not yet freed because a reader was alive at the last publish.
+  size_t retiredCount() const {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return retired_.size();
+  }
+
+private:
+  mutable std::mutex writeMutex_;
+  std::unique_ptr<const DisplaySnapshot> owned_;
+  std::vector<std::unique_ptr<const DisplaySnapshot>> retired_;
+  std::atomic<const DisplaySnapshot*> current_{nullptr};
+  mutable std::atomic<uint32_t> readers_{0u};
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,565 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include "TextBuffer.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace PrimeHost {
+
+// Binary event log: a header followed by one record per event or frame. Integers are LEB128
+// varints, signed values zigzag-encoded, and floats stored as raw little-endian IEEE bits. Record
+// times and pointer positions are deltas from the previous record, so a typical pointer move is
+// 6-8 bytes.
+//
+//   header:  "PHEL" version:u8
+//   record:  tag:u8 time-delta:zvarint [surfaceId:varint] payload
+//   tag:     type (low 4 bits) | 0x10 global scope | 0x20 has surfaceId
+//
+// A zero tag ends the log, so a file that was preallocated and never truncated still reads back
+// up to its last complete record.
+constexpr std::array<char, 4> EventLogMagic{'P', 'H', 'E', 'L'};
+constexpr uint8_t EventLogVersion = 1u;
+
+enum class EventLogRecordKind : uint8_t {
+  Event,
+  Frame,
+};
+
+struct EventLogFrame {
+  SurfaceId surfaceId{};
+  FrameTiming timing{};
+  FrameDiagnostics diagnostics{};
+};
+
+namespace EventLogDetail {
+
+static_assert(std::endian::native == std::endian::little, "event logs store floats little-endian");
+
+// Payload types from 1: the InputEvent alternatives, then the remaining Event payloads.
+constexpr uint8_t EndType = 0x00u;
+constexpr uint8_t InputTypeCount = static_cast<uint8_t>(std::variant_size_v<InputEvent>);
+constexpr uint8_t PayloadTypeCount = static_cast<uint8_t>(std::variant_size_v<decltype(Event::payload)>);
+constexpr uint8_t LastEventType = InputTypeCount + PayloadTypeCount - 1u;
+constexpr uint8_t FrameType = 0x0Fu;
+constexpr uint8_t TypeMask = 0x0Fu;
+constexpr uint8_t GlobalScope = 0x10u;
+constexpr uint8_t HasSurface = 0x20u;
+static_assert(LastEventType < FrameType);
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80u) {
+    out.push_back(static_cast<uint8_t>(value | 0x80u));
+    value >>= 7u;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline void put_zigzag(std::vector<uint8_t>& out, int64_t value) {
+  put_varint(out, (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63));
+}
+
+inline void put_float(std::vector<uint8_t>& out, float value) {
+  std::array<uint8_t, sizeof(float)> bytes{};
+  std::memcpy(bytes.data(), &value, sizeof(float));
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+inline void put_bytes(std::vector<uint8_t>& out, std::span<const char> bytes) {
+  put_varint(out, bytes.size());
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+inline uint8_t event_type(const Event& event) {
+  if (const auto* input = std::get_if<InputEvent>(&event.payload)) {
+    return static_cast<uint8_t>(input->index() + 1u);
+  }
+  return static_cast<uint8_t>(InputTypeCount + event.payload.index());
+}
+
+// Bounds-checked cursor over a log; any overrun or out-of-range value marks it failed.
+class Reader {
+public:
+  explicit Reader(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+  bool atEnd() const { return offset_ == bytes_.size(); }
+  bool failed() const { return failed_; }
+  void fail() { failed_ = true; }
+  size_t offset() const { return offset_; }
+
+  uint8_t u8() {
+    if (offset_ >= bytes_.size()) {
+      failed_ = true;
+      return 0u;
+    }
+    return bytes_[offset_++];
+  }
+
+  uint64_t varint() {
+    uint64_t value = 0u;
+    for (uint32_t shift = 0u; shift < 64u; shift += 7u) {
+      const uint8_t byte = u8();
+      value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+      if ((byte & 0x80u) == 0u) {
+        return value;
+      }
+    }
+    failed_ = true;
+    return 0u;
+  }
+
+  uint32_t varint32() {
+    const uint64_t value = varint();
+    if (value > UINT32_MAX) {
+      failed_ = true;
+      return 0u;
+    }
+    return static_cast<uint32_t>(value);
+  }
+
+  int64_t zigzag() {
+    const uint64_t value = varint();
+    return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+  }
+
+  float f32() {
+    if (bytes_.size() - offset_ < sizeof(float)) {
+      failed_ = true;
+      return 0.0f;
+    }
+    float value = 0.0f;
+    std::memcpy(&value, bytes_.data() + offset_, sizeof(float));
+    offset_ += sizeof(float);
+    return value;
+  }
+
+  // Enum stored as one byte, rejected when >= count.
+  template <typename E>
+  E enumValue(uint8_t count) {
+    const uint8_t value = u8();
+    if (value >= count) {
+      fail();
+      return E{};
+    }
+    return static_cast<E>(value);
+  }
+
+  std::string_view bytes() {
+    const uint64_t size = varint();
+    if (failed_ || size > bytes_.size() - offset_) {
+      failed_ = true;
+      return {};
+    }
+    std::string_view view(reinterpret_cast<const char*>(bytes_.data() + offset_), static_cast<size_t>(size));
+    offset_ += static_cast<size_t>(size);
+    return view;
+  }
+
+private:
+  std::span<const uint8_t> bytes_;
+  size_t offset_ = 0u;
+  bool failed_ = false;
+};
+
+} // namespace EventLogDetail
+
+inline void encodeEventLogHeader(std::vector<uint8_t>& out) {
+  for (char magic : EventLogMagic) {
+    out.push_back(static_cast<uint8_t>(magic));
+  }
+  out.push_back(EventLogVersion);
+}
+
+// Appends records to a byte vector. Keeps the previous record time and pointer position, so one
+// encoder must write a whole log and its records must be decoded in order.
+class EventLogEncoder {
+public:
+  // `text` is the buffer the event's TextSpan indexes (EventBatch::textBytes).
+  HostStatus encodeEvent(const Event& event, std::span<const char> text, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    std::span<const char> eventText;
+    if (const TextSpan* span = eventTextSpan(event)) {
+      if (static_cast<size_t>(span->offset) + span->length > text.size()) {
+        return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+      }
+      eventText = text.subspan(span->offset, span->length);
+    }
+
+    const uint8_t type = event_type(event);
+    uint8_t tag = type;
+    tag |= event.scope == Event::Scope::Global ? GlobalScope : 0u;
+    tag |= event.surfaceId ? HasSurface : 0u;
+    out.push_back(tag);
+    putTime(event.time, out);
+    if (event.surfaceId) {
+      put_varint(out, event.surfaceId->value);
+    }
+
+    if (const auto* input = std::get_if<InputEvent>(&event.payload)) {
+      std::visit([&](const auto& payload) { encodeInput(payload, eventText, out); }, *input);
+    } else if (const auto* resize = std::get_if<ResizeEvent>(&event.payload)) {
+      put_varint(out, resize->width);
+      put_varint(out, resize->height);
+      put_float(out, resize->scale);
+    } else if (const auto* drop = std::get_if<DropEvent>(&event.payload)) {
+      put_varint(out, drop->count);
+      put_bytes(out, eventText);
+    } else if (const auto* focus = std::get_if<FocusEvent>(&event.payload)) {
+      out.push_back(focus->focused ? 1u : 0u);
+    } else if (const auto* power = std::get_if<PowerEvent>(&event.payload)) {
+      out.push_back(power->lowPowerModeEnabled ? (*power->lowPowerModeEnabled ? 2u : 1u) : 0u);
+    } else if (const auto* thermal = std::get_if<ThermalEvent>(&event.payload)) {
+      out.push_back(static_cast<uint8_t>(thermal->state));
+    } else if (const auto* lifecycle = std::get_if<LifecycleEvent>(&event.payload)) {
+      out.push_back(static_cast<uint8_t>(lifecycle->phase));
+    } else if (const auto* display = std::get_if<DisplayEvent>(&event.payload)) {
+      put_varint(out, display->displayId);
+      out.push_back(static_cast<uint8_t>(display->change));
+      out.push_back(display->fields);
+    }
+    return {};
+  }
+
+  void encodeFrame(const EventLogFrame& frame, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    out.push_back(FrameType | HasSurface);
+    putTime(frame.timing.time, out);
+    put_varint(out, frame.surfaceId.value);
+    put_varint(out, frame.timing.frameIndex);
+    put_zigzag(out, frame.timing.delta.count());
+    const FrameDiagnostics& diag = frame.diagnostics;
+    put_zigzag(out, diag.targetInterval.count());
+    put_zigzag(out, diag.actualInterval.count());
+    out.push_back(static_cast<uint8_t>((diag.missedDeadline ? 1u : 0u) | (diag.wasThrottled ? 2u : 0u)));
+    put_varint(out, diag.droppedFrames);
+    put_zigzag(out, diag.acquireWait.count());
+    put_varint(out, diag.supersededFrames);
+  }
+
+private:
+  void putTime(std::chrono::steady_clock::time_point time, std::vector<uint8_t>& out) {
+    const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    EventLogDetail::put_zigzag(out, ns - lastTimeNs_);
+    lastTimeNs_ = ns;
+  }
+
+  void encodeInput(const PointerEvent& pointer, std::span<const char>, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    put_varint(out, pointer.deviceId);
+    put_varint(out, pointer.pointerId);
+    out.push_back(static_cast<uint8_t>(static_cast<uint8_t>(pointer.deviceType) |
+                                       (static_cast<uint8_t>(pointer.phase) << 2u) |
+                                       (pointer.isPrimary ? 0x10u : 0u)));
+    put_zigzag(out, static_cast<int64_t>(pointer.x) - lastX_);
+    put_zigzag(out, static_cast<int64_t>(pointer.y) - lastY_);
+    lastX_ = pointer.x;
+    lastY_ = pointer.y;
+    const std::array<const std::optional<float>*, 5> floats{
+        &pointer.pressure, &pointer.tiltX, &pointer.tiltY, &pointer.twist, &pointer.distance};
+    uint8_t present = (pointer.deltaX ? 1u : 0u) | (pointer.deltaY ? 2u : 0u);
+    for (size_t i = 0; i < floats.size(); ++i) {
+      present |= floats[i]->has_value() ? static_cast<uint8_t>(4u << i) : 0u;
+    }
+    out.push_back(present);
+    if (pointer.deltaX) {
+      put_zigzag(out, *pointer.deltaX);
+    }
+    if (pointer.deltaY) {
+      put_zigzag(out, *pointer.deltaY);
+    }
+    for (const auto* value : floats) {
+      if (value->has_value()) {
+        put_float(out, **value);
+      }
+    }
+    put_varint(out, pointer.buttonMask);
+  }
+
+  void encodeInput(const KeyEvent& key, std::span<const char>, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    put_varint(out, key.deviceId);
+    put_varint(out, key.keyCode);
+    out.push_back(key.modifiers);
+    out.push_back(static_cast<uint8_t>((key.pressed ? 1u : 0u) | (key.repeat ? 2u : 0u)));
+  }
+
+  void encodeInput(const TextEvent& text, std::span<const char> bytes, std::vector<uint8_t>& out) {
+    EventLogDetail::put_varint(out, text.deviceId);
+    EventLogDetail::put_bytes(out, bytes);
+  }
+
+  void encodeInput(const ScrollEvent& scroll, std::span<const char>, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    put_varint(out, scroll.deviceId);
+    put_float(out, scroll.deltaX);
+    put_float(out, scroll.deltaY);
+    out.push_back(scroll.isLines ? 1u : 0u);
+  }
+
+  void encodeInput(const GamepadButtonEvent& button, std::span<const char>, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    put_varint(out, button.deviceId);
+    put_varint(out, button.controlId);
+    out.push_back(static_cast<uint8_t>((button.pressed ? 1u : 0u) | (button.value ? 2u : 0u)));
+    if (button.value) {
+      put_float(out, *button.value);
+    }
+  }
+
+  void encodeInput(const GamepadAxisEvent& axis, std::span<const char>, std::vector<uint8_t>& out) {
+    using namespace EventLogDetail;
+    put_varint(out, axis.deviceId);
+    put_varint(out, axis.controlId);
+    put_float(out, axis.value);
+  }
+
+  void encodeInput(const DeviceEvent& device, std::span<const char>, std::vector<uint8_t>& out) {
+    EventLogDetail::put_varint(out, device.deviceId);
+    out.push_back(static_cast<uint8_t>(device.deviceType));
+    out.push_back(device.connected ? 1u : 0u);
+  }
+
+  int64_t lastTimeNs_ = 0;
+  int64_t lastX_ = 0;
+  int64_t lastY_ = 0;
+};
+
+// Reads records back in order. Event text is appended to a TextArena and the event's span indexes
+// it, the same layout the platform hosts queue events in.
+class EventLogDecoder {
+public:
+  explicit EventLogDecoder(std::span<const uint8_t> bytes) : reader_(bytes) {
+    for (char magic : EventLogMagic) {
+      if (reader_.u8() != static_cast<uint8_t>(magic)) {
+        valid_ = false;
+      }
+    }
+    valid_ = valid_ && reader_.u8() == EventLogVersion && !reader_.failed();
+  }
+
+  // False when the header is missing or from another version.
+  bool valid() const { return valid_; }
+
+  // Decodes the next record into `event` or `frame`. Returns nullopt at the end of the log and
+  // InvalidConfig for a corrupt or truncated record.
+  HostResult<std::optional<EventLogRecordKind>> next(Event& event, EventLogFrame& frame, TextArena& text) {
+    using namespace EventLogDetail;
+    if (!valid_) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    if (ended_ || reader_.atEnd()) {
+      return std::optional<EventLogRecordKind>{};
+    }
+    const uint8_t tag = reader_.u8();
+    const uint8_t type = tag & TypeMask;
+    if (tag == EndType) {
+      ended_ = true;
+      return std::optional<EventLogRecordKind>{};
+    }
+    lastTimeNs_ += reader_.zigzag();
+    const auto time = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(lastTimeNs_)));
+    std::optional<SurfaceId> surfaceId;
+    if ((tag & HasSurface) != 0u) {
+      surfaceId = SurfaceId{reader_.varint()};
+    }
+
+    if (type == FrameType) {
+      frame = EventLogFrame{};
+      frame.surfaceId = surfaceId.value_or(SurfaceId{});
+      frame.timing.time = time;
+      frame.timing.frameIndex = reader_.varint();
+      frame.timing.delta = std::chrono::nanoseconds(reader_.zigzag());
+      frame.diagnostics.targetInterval = std::chrono::nanoseconds(reader_.zigzag());
+      frame.diagnostics.actualInterval = std::chrono::nanoseconds(reader_.zigzag());
+      const uint8_t flags = reader_.u8();
+      frame.diagnostics.missedDeadline = (flags & 1u) != 0u;
+      frame.diagnostics.wasThrottled = (flags & 2u) != 0u;
+      frame.diagnostics.droppedFrames = reader_.varint32();
+      frame.diagnostics.acquireWait = std::chrono::nanoseconds(reader_.zigzag());
+      frame.diagnostics.supersededFrames = reader_.varint32();
+      return finish(EventLogRecordKind::Frame);
+    }
+    if (type == EndType || type > LastEventType) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+
+    event = Event{};
+    event.scope = (tag & GlobalScope) != 0u ? Event::Scope::Global : Event::Scope::Surface;
+    event.surfaceId = surfaceId;
+    event.time = time;
+    if (type <= InputTypeCount) {
+      event.payload = decodeInput(type - 1u, text);
+    } else {
+      switch (type - InputTypeCount) {
+        case 1u: {
+          ResizeEvent resize{};
+          resize.width = reader_.varint32();
+          resize.height = reader_.varint32();
+          resize.scale = reader_.f32();
+          event.payload = resize;
+          break;
+        }
+        case 2u: {
+          DropEvent drop{};
+          drop.count = reader_.varint32();
+          drop.paths = appendText(text);
+          event.payload = drop;
+          break;
+        }
+        case 3u:
+          event.payload = FocusEvent{reader_.u8() != 0u};
+          break;
+        case 4u: {
+          PowerEvent power{};
+          const uint8_t value = reader_.u8();
+          if (value != 0u) {
+            power.lowPowerModeEnabled = value == 2u;
+          }
+          event.payload = power;
+          break;
+        }
+        case 5u:
+          event.payload = ThermalEvent{reader_.enumValue<ThermalState>(5u)};
+          break;
+        case 6u:
+          event.payload = LifecycleEvent{reader_.enumValue<LifecyclePhase>(6u)};
+          break;
+        default: {
+          DisplayEvent display{};
+          display.displayId = reader_.varint32();
+          display.change = reader_.enumValue<DisplayChange>(3u);
+          display.fields = reader_.u8();
+          event.payload = display;
+          break;
+        }
+      }
+    }
+    return finish(EventLogRecordKind::Event);
+  }
+
+  size_t offset() const { return reader_.offset(); }
+
+private:
+  HostResult<std::optional<EventLogRecordKind>> finish(EventLogRecordKind kind) {
+    if (reader_.failed() || !textOk_) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    return std::optional<EventLogRecordKind>{kind};
+  }
+
+  TextSpan appendText(TextArena& text) {
+    auto span = text.append(reader_.bytes());
+    if (!span) {
+      textOk_ = false;
+      return {};
+    }
+    return *span;
+  }
+
+  InputEvent decodeInput(uint8_t type, TextArena& text) {
+    auto& r = reader_;
+    switch (type) {
+      case 0u: {
+        PointerEvent pointer{};
+        pointer.deviceId = r.varint32();
+        pointer.pointerId = r.varint32();
+        const uint8_t packed = r.u8();
+        if ((packed & 0x3u) > static_cast<uint8_t>(PointerDeviceType::Pen) || (packed & ~0x1Fu) != 0u) {
+          r.fail();
+        }
+        pointer.deviceType = static_cast<PointerDeviceType>(packed & 0x3u);
+        pointer.phase = static_cast<PointerPhase>((packed >> 2u) & 0x3u);
+        pointer.isPrimary = (packed & 0x10u) != 0u;
+        lastX_ += r.zigzag();
+        lastY_ += r.zigzag();
+        pointer.x = static_cast<int32_t>(lastX_);
+        pointer.y = static_cast<int32_t>(lastY_);
+        const uint8_t present = r.u8();
+        if ((present & 1u) != 0u) {
+          pointer.deltaX = static_cast<int32_t>(r.zigzag());
+        }
+        if ((present & 2u) != 0u) {
+          pointer.deltaY = static_cast<int32_t>(r.zigzag());
+        }
+        const std::array<std::optional<float>*, 5> floats{
+            &pointer.pressure, &pointer.tiltX, &pointer.tiltY, &pointer.twist, &pointer.distance};
+        for (size_t i = 0; i < floats.size(); ++i) {
+          if ((present & (4u << i)) != 0u) {
+            *floats[i] = r.f32();
+          }
+        }
+        pointer.buttonMask = r.varint32();
+        return pointer;
+      }
+      case 1u: {
+        KeyEvent key{};
+        key.deviceId = r.varint32();
+        key.keyCode = r.varint32();
+        key.modifiers = r.u8();
+        const uint8_t flags = r.u8();
+        key.pressed = (flags & 1u) != 0u;
+        key.repeat = (flags & 2u) != 0u;
+        return key;
+      }
+      case 2u: {
+        TextEvent textEvent{};
+        textEvent.deviceId = r.varint32();
+        textEvent.text = appendText(text);
+        return textEvent;
+      }
+      case 3u: {
+        ScrollEvent scroll{};
+        scroll.deviceId = r.varint32();
+        scroll.deltaX = r.f32();
+        scroll.deltaY = r.f32();
+        scroll.isLines = r.u8() != 0u;
+        return scroll;
+      }
+      case 4u: {
+        GamepadButtonEvent button{};
+        button.deviceId = r.varint32();
+        button.controlId = r.varint32();
+        const uint8_t flags = r.u8();
+        button.pressed = (flags & 1u) != 0u;
+        if ((flags & 2u) != 0u) {
+          button.value = r.f32();
+        }
+        return button;
+      }
+      case 5u: {
+        GamepadAxisEvent axis{};
+        axis.deviceId = r.varint32();
+        axis.controlId = r.varint32();
+        axis.value = r.f32();
+        return axis;
+      }
+      default: {
+        DeviceEvent device{};
+        device.deviceId = r.varint32();
+        device.deviceType = r.enumValue<DeviceType>(5u);
+        device.connected = r.u8() != 0u;
+        return device;
+      }
+    }
+  }
+
+  EventLogDetail::Reader reader_;
+  bool valid_ = true;
+  bool ended_ = false;
+  bool textOk_ = true;
+  int64_t lastTimeNs_ = 0;
+  int64_t lastX_ = 0;
+  int64_t lastY_ = 0;
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,748 @@
+#include "PrimeHost/Replay.h"
+#include "PrimeHost/FrameCapture.h"
+#include "PrimeHost/ImageEncode.h"
+
+#include "EventLog.h"
+#include "FramePixelStorage.h"
+#include "GamepadResponse.h"
+#include "MappedFile.h"
+#include "SizeUtil.h"
+#include "TextBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace PrimeHost {
+namespace {
+
+constexpr size_t RecorderInitialCapacity = 1u << 20u;
+constexpr uint32_t ReplayDisplayId = 1u;
+constexpr std::chrono::nanoseconds ReplayDisplayInterval{16'666'667};
+
+class EventRecorderImpl final : public EventRecorder {
+public:
+  explicit EventRecorderImpl(MappedFile file) : file_(std::move(file)) {
+    encodeEventLogHeader(scratch_);
+    append(encoder_);
+  }
+
+  ~EventRecorderImpl() override { file_.truncate(size_); }
+
+  HostStatus recordEvents(const EventBatch& batch) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const EventLogEncoder saved = encoder_;
+    HostStatus status{};
+    size_t encoded = 0u;
+    for (const Event& event : batch.events) {
+      status = encoder_.encodeEvent(event, batch.textBytes, scratch_);
+      if (!status) {
+        break;
+      }
+      ++encoded;
+    }
+    if (auto appended = append(saved); !appended) {
+      droppedRecords_ += batch.events.size();
+      return appended;
+    }
+    droppedRecords_ += batch.events.size() - encoded;
+    return status;
+  }
+
+  HostStatus recordFrame(SurfaceId surfaceId,
+                         const FrameTiming& timing,
+                         const FrameDiagnostics& diagnostics) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const EventLogEncoder saved = encoder_;
+    encoder_.encodeFrame(EventLogFrame{surfaceId, timing, diagnostics}, scratch_);
+    if (auto appended = append(saved); !appended) {
+      ++droppedRecords_;
+      return appended;
+    }
+    return {};
+  }
+
+  HostStatus flush() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.flush(size_);
+  }
+
+  uint64_t bytesWritten() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+  uint64_t droppedRecords() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return droppedRecords_;
+  }
+
+private:
+  // Copies the encoded records into the mapping. The mapping is zero past size_, which reads back
+  // as the end of the log. When the file cannot grow, the records are discarded and the encoder
+  // goes back to `saved`, so later records stay relative to the last record actually written.
+  HostStatus append(const EventLogEncoder& saved) {
+    if (scratch_.empty()) {
+      return {};
+    }
+    if (auto status = file_.reserve(size_ + scratch_.size()); !status) {
+      scratch_.clear();
+      encoder_ = saved;
+      return status;
+    }
+    std::memcpy(file_.bytes().data() + size_, scratch_.data(), scratch_.size());
+    size_ += scratch_.size();
+    scratch_.clear();
+    return {};
+  }
+
+  mutable std::mutex mutex_;
+  MappedFile file_;
+  size_t size_ = 0u;
+  EventLogEncoder encoder_;
+  std::vector<uint8_t> scratch_;
+  uint64_t droppedRecords_ = 0u;
+};
+
+struct ReplaySurface {
+  SurfaceSize size{};
+  SurfacePoint position{};
+  float scale = 1.0f;
+  FrameConfig frameConfig{};
+  FramePixelStorage pixels;
+  // Size and row pitch of the last presented frame; empty until the first present.
+  ImageSize shownSize{};
+  uint32_t shownStride = 0u;
+  std::shared_ptr<FrameCaptureSink> captureSink;
+};
+
+class ReplayHostImpl final : public ReplayHost {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ReplayHostImpl(double speed,
+                 std::vector<Event> events,
+                 std::vector<EventLogFrame> frames,
+                 std::vector<EventLogRecordKind> order,
+                 TextArena text)
+      : speed_(speed),
+        events_(std::move(events)),
+        frames_(std::move(frames)),
+        order_(std::move(order)),
+        text_(std::move(text)) {
+    for (size_t i = 0, e = 0, f = 0; i < order_.size(); ++i) {
+      std::optional<SurfaceId> surfaceId;
+      Clock::time_point time{};
+      if (order_[i] == EventLogRecordKind::Event) {
+        surfaceId = events_[e].surfaceId;
+        time = events_[e++].time;
+      } else {
+        surfaceId = frames_[f].surfaceId;
+        time = frames_[f++].timing.time;
+      }
+      if (i == 0u) {
+        origin_ = time;
+      }
+      if (surfaceId && surfaceId->isValid() &&
+          std::find(recordedSurfaces_.begin(), recordedSurfaces_.end(), surfaceId->value) ==
+              recordedSurfaces_.end()) {
+        recordedSurfaces_.push_back(surfaceId->value);
+        nextSurfaceId_ = std::max(nextSurfaceId_, surfaceId->value + 1u);
+      }
+    }
+  }
+
+  bool finished() const override { return nextRecord_ == order_.size(); }
+  uint64_t replayedEvents() const override { return nextEvent_; }
+  uint64_t replayedFrames() const override { return nextFrame_; }
+
+  HostResult<HostCapabilities> hostCapabilities() const override {
+    HostCapabilities caps{};
+    caps.supportsHeadless = true;
+    return caps;
+  }
+
+  HostResult<SurfaceCapabilities> surfaceCapabilities(SurfaceId surfaceId) const override {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    SurfaceCapabilities caps{};
+    caps.minBufferCount = 2u;
+    caps.maxBufferCount = 3u;
+    caps.presentModes = (1u << static_cast<uint32_t>(PresentMode::LowLatency)) |
+                        (1u << static_cast<uint32_t>(PresentMode::Smooth)) |
+                        (1u << static_cast<uint32_t>(PresentMode::Uncapped));
+    caps.colorFormats = (1u << static_cast<uint32_t>(ColorFormat::B8G8R8A8_UNORM));
+    return caps;
+  }
+
+  HostResult<DeviceInfo> deviceInfo(uint32_t) const override {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+
+  HostResult<DeviceCapabilities> deviceCapabilities(uint32_t) const override {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+
+  HostResult<size_t> devices(std::span<DeviceInfo>) const override { return static_cast<size_t>(0u); }
+
+  HostResult<size_t> displays(std::span<DisplayInfo> outDisplays) const override {
+    if (outDisplays.empty()) {
+      return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+    }
+    outDisplays[0] = replayDisplay();
+    return static_cast<size_t>(1u);
+  }
+
+  HostResult<DisplayInfo> displayInfo(uint32_t displayId) const override {
+    if (displayId != ReplayDisplayId) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
+    }
+    return replayDisplay();
+  }
+
+  HostResult<DisplayHdrInfo> displayHdrInfo(uint32_t displayId) const override {
+    if (displayId != ReplayDisplayId) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
+    }
+    return DisplayHdrInfo{};
+  }
+
+  HostResult<uint32_t> surfaceDisplay(SurfaceId surfaceId) const override {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return ReplayDisplayId;
+  }
+
+  HostStatus setSurfaceDisplay(SurfaceId surfaceId, uint32_t displayId) override {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    if (displayId != ReplayDisplayId) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
+    }
+    return {};
+  }
+
+  HostResult<SurfaceId> createSurface(const SurfaceConfig& config) override {
+    if (config.width == 0u || config.height == 0u) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    uint64_t id = 0u;
+    while (nextRecordedSurface_ < recordedSurfaces_.size() && id == 0u) {
+      const uint64_t recorded = recordedSurfaces_[nextRecordedSurface_++];
+      id = surfaces_.contains(recorded) ? 0u : recorded;
+    }
+    if (id == 0u) {
+      id = nextSurfaceId_++;
+    }
+    ReplaySurface surface{};
+    surface.size = SurfaceSize{config.width, config.height};
+    surfaces_.emplace(id, std::move(surface));
+    return SurfaceId{id};
+  }
+
+  HostStatus destroySurface(SurfaceId surfaceId) override {
+    if (surfaces_.erase(surfaceId.value) == 0u) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return {};
+  }
+
+  HostResult<EventBatch> pollEvents(const EventBuffer& buffer) override {
+    if (buffer.events.empty() || buffer.events.data() == nullptr) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    if (!buffer.textBytes.empty() && buffer.textBytes.data() == nullptr) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    const Clock::time_point now = startClock();
+    pump(now);
+
+    const std::span<const Event> due = dueEvents(now);
+    const std::span<const Event> queued = due.first(std::min(buffer.events.size(), due.size()));
+    const size_t count = eventsFittingText(queued, buffer.textBytes.size());
+    std::copy_n(queued.begin(), count, buffer.events.begin());
+    auto textBytes = copyEventText(buffer.events.first(count), text_, buffer.textBytes);
+    if (!textBytes) {
+      return std::unexpected(textBytes.error());
+    }
+    for (Event& event : buffer.events.first(count)) {
+      event.time = replayTime(event.time);
+      applyEvent(event);
+    }
+    nextEvent_ += count;
+    nextRecord_ += count;
+
+    EventBatch batch{};
+    batch.events = std::span<const Event>(buffer.events.data(), count);
+    batch.textBytes = std::span<const char>(buffer.textBytes.data(), *textBytes);
+    batch.pending = eventBufferSize(dueEvents(now));
+    return batch;
+  }
+
+  HostResult<EventBufferSize> pendingEventsSize() const override {
+    return eventBufferSize(dueEvents(started_ ? Clock::now() : Clock::time_point{}));
+  }
+
+  // Returns once a record has been delivered or events are ready to poll, the log has ended, or
+  // wakeEvents was called.
+  HostStatus waitEvents() override {
+    for (;;) {
+      const Clock::time_point now = startClock();
+      if (pump(now) || finished() || !dueEvents(now).empty()) {
+        return {};
+      }
+      std::unique_lock<std::mutex> lock(wakeMutex_);
+      const bool woken = wakeCondition_.wait_until(lock, nextRecordTime(), [this]() { return wakeRequested_; });
+      if (woken) {
+        wakeRequested_ = false;
+        return {};
+      }
+    }
+  }
+
+  HostStatus wakeEvents() override {
+    {
+      std::lock_guard<std::mutex> lock(wakeMutex_);
+      wakeRequested_ = true;
+    }
+    wakeCondition_.notify_one();
+    return {};
+  }
+
+  HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    const auto widthPx = static_cast<uint32_t>(std::lround(surface->size.width * surface->scale));
+    const auto heightPx = static_cast<uint32_t>(std::lround(surface->size.height * surface->scale));
+    const FrameBufferPolicy& policy = surface->frameConfig.bufferPolicy;
+    auto stride = frameBufferStride(widthPx, policy.layout);
+    auto total = stride ? checkedSizeMul(*stride, heightPx) : std::nullopt;
+    if (!total || !surface->pixels.resize(*total, policy)) {
+      return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+    }
+    FrameBuffer buffer{};
+    buffer.size = ImageSize{widthPx, heightPx};
+    buffer.stride = *stride;
+    buffer.colorFormat = surface->frameConfig.colorFormat;
+    buffer.scale = surface->scale;
+    buffer.pixels = surface->pixels.span();
+    return buffer;
+  }
+
+  HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId, Clock::time_point) override {
+    return acquireFrameBuffer(surfaceId);
+  }
+
+  HostStatus presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& buffer) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    if (buffer.pixels.data() != surface->pixels.data()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    surface->shownSize = buffer.size;
+    surface->shownStride = buffer.stride;
+    if (surface->captureSink) {
+      surface->captureSink->submit(imageView(buffer));
+    }
+    return {};
+  }
+
+  // Frames come from the log, so requests only need a live surface.
+  HostStatus requestFrame(SurfaceId surfaceId, bool) override { return checkSurface(surfaceId); }
+
+  HostStatus setFrameConfig(SurfaceId surfaceId, const FrameConfig& config) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    surface->frameConfig = config;
+    return {};
+  }
+
+  HostResult<FrameConfig> frameConfig(SurfaceId surfaceId) const override {
+    const ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return surface->frameConfig;
+  }
+
+  HostResult<std::optional<std::chrono::nanoseconds>> displayInterval(SurfaceId surfaceId) const override {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return std::optional<std::chrono::nanoseconds>{ReplayDisplayInterval};
+  }
+
+  HostStatus setSurfaceTitle(SurfaceId surfaceId, Utf8TextView) override { return checkSurface(surfaceId); }
+
+  HostResult<SurfaceSize> surfaceSize(SurfaceId surfaceId) const override {
+    const ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return surface->size;
+  }
+
+  HostStatus setSurfaceSize(SurfaceId surfaceId, uint32_t width, uint32_t height) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    if (width == 0u || height == 0u) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    surface->size = SurfaceSize{width, height};
+    return {};
+  }
+
+  HostResult<SurfacePoint> surfacePosition(SurfaceId surfaceId) const override {
+    const ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return surface->position;
+  }
+
+  HostStatus setSurfacePosition(SurfaceId surfaceId, int32_t x, int32_t y) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    surface->position = SurfacePoint{x, y};
+    return {};
+  }
+
+  HostResult<SafeAreaInsets> surfaceSafeAreaInsets(SurfaceId surfaceId) const override {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return SafeAreaInsets{};
+  }
+
+  HostStatus setCursorShape(SurfaceId surfaceId, CursorShape) override { return checkSurface(surfaceId); }
+  HostStatus setCursorImage(SurfaceId surfaceId, const CursorImage&) override { return checkSurface(surfaceId); }
+  HostStatus setCursorVisible(SurfaceId surfaceId, bool) override { return checkSurface(surfaceId); }
+  HostStatus setSurfaceIcon(SurfaceId surfaceId, const WindowIcon&) override { return checkSurface(surfaceId); }
+  HostStatus setSurfaceMinimized(SurfaceId surfaceId, bool) override { return checkSurface(surfaceId); }
+  HostStatus setSurfaceMaximized(SurfaceId surfaceId, bool) override { return checkSurface(surfaceId); }
+  HostStatus setSurfaceFullscreen(SurfaceId surfaceId, bool) override { return checkSurface(surfaceId); }
+
+  HostResult<size_t> clipboardTextSize() const override { return unsupported<size_t>(); }
+  HostResult<Utf8TextView> clipboardText(std::span<char>) const override { return unsupported<Utf8TextView>(); }
+  HostStatus setClipboardText(Utf8TextView) override { return unsupported<void>(); }
+  HostResult<size_t> clipboardPathsTextSize() const override { return unsupported<size_t>(); }
+  HostResult<size_t> clipboardPathsCount() const override { return unsupported<size_t>(); }
+  HostResult<ClipboardPathsResult> clipboardPaths(std::span<TextSpan>, std::span<char>) const override {
+    return unsupported<ClipboardPathsResult>();
+  }
+  HostResult<std::optional<ImageSize>> clipboardImageSize() const override {
+    return unsupported<std::optional<ImageSize>>();
+  }
+  HostResult<ClipboardImageResult> clipboardImage(std::span<uint8_t>) const override {
+    return unsupported<ClipboardImageResult>();
+  }
+  HostStatus setClipboardImage(const ImageData&) override { return unsupported<void>(); }
+  HostStatus writeSurfaceScreenshot(SurfaceId surfaceId, Utf8TextView path, const ScreenshotConfig&) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    if (!imageFileFormatForPath(path)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    const ImageSize size = surface->shownSize;
+    const uint32_t stride = surface->shownStride;
+    if (size.width == 0u || surface->pixels.size() < static_cast<size_t>(stride) * size.height) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    return writeImageFile(ImageView{size, stride, ColorFormat::B8G8R8A8_UNORM, surface->pixels.span()}, path);
+  }
+  HostStatus setSurfaceCaptureSink(SurfaceId surfaceId, std::shared_ptr<FrameCaptureSink> sink) override {
+    ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    surface->captureSink = std::move(sink);
+    return {};
+  }
+  HostResult<FileDialogResult> fileDialog(const FileDialogConfig&, std::span<char>) const override {
+    return unsupported<FileDialogResult>();
+  }
+  HostResult<size_t> fileDialogPaths(const FileDialogConfig&, std::span<TextSpan>, std::span<char>) const override {
+    return unsupported<size_t>();
+  }
+  HostResult<size_t> appPathSize(AppPathType) const override { return unsupported<size_t>(); }
+  HostResult<Utf8TextView> appPath(AppPathType, std::span<char>) const override {
+    return unsupported<Utf8TextView>();
+  }
+
+  HostResult<float> surfaceScale(SurfaceId surfaceId) const override {
+    const ReplaySurface* surface = findSurface(surfaceId);
+    if (!surface) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return surface->scale;
+  }
+
+  HostStatus setSurfaceMinSize(SurfaceId surfaceId, uint32_t, uint32_t) override { return checkSurface(surfaceId); }
+  HostStatus setSurfaceMaxSize(SurfaceId surfaceId, uint32_t, uint32_t) override { return checkSurface(surfaceId); }
+
+  HostStatus setGamepadRumble(const GamepadRumble&) override { return unsupported<void>(); }
+
+  HostResult<GamepadState> gamepadState(uint32_t) const override {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+
+  HostStatus setGamepadInputConfig(const GamepadInputConfig& config) override {
+    return validateGamepadInputConfig(config);
+  }
+
+  HostResult<PermissionStatus> checkPermission(PermissionType) const override {
+    return unsupported<PermissionStatus>();
+  }
+  HostResult<PermissionStatus> requestPermission(PermissionType) override { return unsupported<PermissionStatus>(); }
+  HostResult<uint64_t> beginIdleSleepInhibit(Utf8TextView) override { return unsupported<uint64_t>(); }
+  HostStatus endIdleSleepInhibit(uint64_t) override { return unsupported<void>(); }
+  HostStatus setGamepadLight(uint32_t, float, float, float) override { return unsupported<void>(); }
+  HostResult<LocaleInfo> localeInfo() const override { return unsupported<LocaleInfo>(); }
+  HostResult<Utf8TextView> imeLanguageTag() const override { return unsupported<Utf8TextView>(); }
+
+  HostStatus setImeCompositionRect(SurfaceId surfaceId, int32_t, int32_t, int32_t, int32_t) override {
+    return checkSurface(surfaceId);
+  }
+
+  HostResult<uint64_t> beginBackgroundTask(Utf8TextView) override { return unsupported<uint64_t>(); }
+  HostStatus endBackgroundTask(uint64_t) override { return unsupported<void>(); }
+  HostResult<uint64_t> createTrayItem(Utf8TextView) override { return unsupported<uint64_t>(); }
+  HostStatus updateTrayItemTitle(uint64_t, Utf8TextView) override { return unsupported<void>(); }
+  HostStatus removeTrayItem(uint64_t) override { return unsupported<void>(); }
+
+  HostStatus setRelativePointerCapture(SurfaceId surfaceId, bool) override {
+    if (auto status = checkSurface(surfaceId); !status) {
+      return status;
+    }
+    return unsupported<void>();
+  }
+
+  HostStatus setRawInputConfig(const RawInputConfig& config) override {
+    return config.enabled ? unsupported<void>() : HostStatus{};
+  }
+
+  HostResult<RawInputBatch> drainRawInput(std::span<RawInputSample>) override { return RawInputBatch{}; }
+
+  HostStatus setLogCallback(LogCallback) override { return {}; }
+
+  HostStatus setCallbacks(Callbacks callbacks) override {
+    callbacks_ = std::move(callbacks);
+    return {};
+  }
+
+private:
+  template <typename T>
+  static HostResult<T> unsupported() {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+
+  static DisplayInfo replayDisplay() {
+    DisplayInfo info{};
+    info.displayId = ReplayDisplayId;
+    info.width = 1920u;
+    info.height = 1080u;
+    info.refreshRate = 60.0f;
+    info.isPrimary = true;
+    return info;
+  }
+
+  ReplaySurface* findSurface(SurfaceId surfaceId) {
+    auto it = surfaces_.find(surfaceId.value);
+    return it == surfaces_.end() ? nullptr : &it->second;
+  }
+
+  const ReplaySurface* findSurface(SurfaceId surfaceId) const {
+    auto it = surfaces_.find(surfaceId.value);
+    return it == surfaces_.end() ? nullptr : &it->second;
+  }
+
+  HostStatus checkSurface(SurfaceId surfaceId) const {
+    if (!findSurface(surfaceId)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    return {};
+  }
+
+  Clock::time_point startClock() {
+    const Clock::time_point now = Clock::now();
+    if (!started_) {
+      started_ = true;
+      start_ = now;
+    }
+    return now;
+  }
+
+  // Maps a recorded time onto the replay clock.
+  Clock::time_point replayTime(Clock::time_point recorded) const {
+    const auto offset = recorded - origin_;
+    if (speed_ <= 0.0 || speed_ == 1.0) {
+      return start_ + offset;
+    }
+    return start_ + std::chrono::duration_cast<Clock::duration>(offset / speed_);
+  }
+
+  // When the record at the cursor becomes due; unpaced replays make everything due at once.
+  Clock::time_point nextRecordTime() const {
+    if (finished()) {
+      return Clock::time_point::max();
+    }
+    if (speed_ <= 0.0) {
+      return start_;
+    }
+    return replayTime(order_[nextRecord_] == EventLogRecordKind::Event ? events_[nextEvent_].time
+                                                                        : frames_[nextFrame_].timing.time);
+  }
+
+  // Due events from the cursor up to the next frame record; they are contiguous in events_.
+  std::span<const Event> dueEvents(Clock::time_point now) const {
+    size_t count = 0u;
+    while (nextRecord_ + count < order_.size() && order_[nextRecord_ + count] == EventLogRecordKind::Event &&
+           (speed_ <= 0.0 || replayTime(events_[nextEvent_ + count].time) <= now)) {
+      ++count;
+    }
+    return std::span<const Event>(events_.data() + nextEvent_, count);
+  }
+
+  // Delivers due frames, and due events when an onEvents callback is installed. Returns true when
+  // anything was delivered.
+  bool pump(Clock::time_point now) {
+    bool delivered = false;
+    while (!finished()) {
+      if (order_[nextRecord_] == EventLogRecordKind::Frame) {
+        if (nextRecordTime() > now) {
+          break;
+        }
+        EventLogFrame frame = frames_[nextFrame_++];
+        ++nextRecord_;
+        frame.timing.time = replayTime(frame.timing.time);
+        if (callbacks_.onFrame) {
+          callbacks_.onFrame(frame.surfaceId, frame.timing, frame.diagnostics);
+        }
+        delivered = true;
+        continue;
+      }
+      if (!callbacks_.onEvents) {
+        break;
+      }
+      const std::span<const Event> due = dueEvents(now);
+      if (due.empty()) {
+        break;
+      }
+      // Spans already index into text_, so the callback reads it in place.
+      callbackEvents_.assign(due.begin(), due.end());
+      for (Event& event : callbackEvents_) {
+        event.time = replayTime(event.time);
+        applyEvent(event);
+      }
+      nextEvent_ += due.size();
+      nextRecord_ += due.size();
+      callbacks_.onEvents(EventBatch{callbackEvents_, text_.bytes()});
+      delivered = true;
+    }
+    return delivered;
+  }
+
+  // Keeps headless surfaces in step with the recording so frame buffers match its sizes.
+  void applyEvent(const Event& event) {
+    const auto* resize = std::get_if<ResizeEvent>(&event.payload);
+    if (!resize || !event.surfaceId) {
+      return;
+    }
+    if (ReplaySurface* surface = findSurface(*event.surfaceId)) {
+      surface->size = SurfaceSize{resize->width, resize->height};
+      surface->scale = resize->scale;
+    }
+  }
+
+  double speed_ = 1.0;
+  std::vector<Event> events_;
+  std::vector<EventLogFrame> frames_;
+  std::vector<EventLogRecordKind> order_;
+  TextArena text_;
+  size_t nextRecord_ = 0u;
+  size_t nextEvent_ = 0u;
+  size_t nextFrame_ = 0u;
+  bool started_ = false;
+  Clock::time_point start_{};
+  Clock::time_point origin_{};
+  std::vector<Event> callbackEvents_;
+
+  std::vector<uint64_t> recordedSurfaces_;
+  size_t nextRecordedSurface_ = 0u;
+  uint64_t nextSurfaceId_ = 1u;
+  std::unordered_map<uint64_t, ReplaySurface> surfaces_;
+  Callbacks callbacks_;
+
+  std::mutex wakeMutex_;
+  std::condition_variable wakeCondition_;
+  bool wakeRequested_ = false;
+};
+
+} // namespace
+
+HostResult<std::unique_ptr<EventRecorder>> createEventRecorder(Utf8TextView path) {
+  if (path.empty()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  auto file = MappedFile::createWrite(std::string(path), RecorderInitialCapacity);
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+  return std::unique_ptr<EventRecorder>(std::make_unique<EventRecorderImpl>(std::move(*file)));
+}
+
+HostResult<std::unique_ptr<ReplayHost>> createReplayHost(const ReplayConfig& config) {
+  if (config.path.empty() || !std::isfinite(config.speed) || config.speed < 0.0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  auto file = MappedFile::openRead(config.path);
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+
+  // Decode everything up front so playback never touches the file or allocates per record.
+  EventLogDecoder decoder(file->bytes());
+  std::vector<Event> events;
+  std::vector<EventLogFrame> frames;
+  std::vector<EventLogRecordKind> order;
+  TextArena text;
+  Event event{};
+  EventLogFrame frame{};
+  for (;;) {
+    auto kind = decoder.next(event, frame, text);
+    if (!kind) {
+      return std::unexpected(kind.error());
+    }
+    if (!*kind) {
+      break;
+    }
+    order.push_back(**kind);
+    if (**kind == EventLogRecordKind::Event) {
+      events.push_back(event);
+    } else {
+      frames.push_back(frame);
+    }
+  }
+  return std::unique_ptr<ReplayHost>(std::make_unique<ReplayHostImpl>(
+      config.speed, std::move(events), std::move(frames), std::move(order), std::move(text)));
+}
+
+} // namespace PrimeHost
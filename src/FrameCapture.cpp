@@ -0,0 +1,350 @@
+#include "PrimeHost/FrameCapture.h"
+
+#include "SizeUtil.h"
+#include "SpscRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PrimeHost {
+namespace {
+
+constexpr uint32_t MaxCaptureQueueDepth = 64u;
+
+struct CaptureFrame {
+  // Tightly packed BGRA, sized on first use and reused while the frame size holds.
+  std::vector<uint8_t> pixels;
+  ImageSize size{};
+  uint64_t index = 0u;
+
+  ImageView view() const { return ImageView{size, size.width * 4u, ColorFormat::B8G8R8A8_UNORM, pixels}; }
+};
+
+// Full-range BT.601 (JPEG) coefficients in 8-bit fixed point, written as Y, Cb and Cr planes.
+void bgra_to_yuv444(const CaptureFrame& frame, uint8_t* out) {
+  const size_t count = static_cast<size_t>(frame.size.width) * frame.size.height;
+  uint8_t* y = out;
+  uint8_t* cb = out + count;
+  uint8_t* cr = out + count * 2u;
+  const uint8_t* px = frame.pixels.data();
+  for (size_t i = 0; i < count; ++i, px += 4) {
+    const int b = px[0];
+    const int g = px[1];
+    const int r = px[2];
+    y[i] = static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+    cb[i] = static_cast<uint8_t>(std::clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 0, 255));
+    cr[i] = static_cast<uint8_t>(std::clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 0, 255));
+  }
+}
+
+void bgra_to_rgba(const CaptureFrame& frame, uint8_t* out) {
+  const size_t count = static_cast<size_t>(frame.size.width) * frame.size.height;
+  const uint8_t* px = frame.pixels.data();
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t bgra = 0u;
+    std::memcpy(&bgra, px + i * 4u, sizeof(bgra));
+    const uint32_t rgba = (bgra & 0xFF00FF00u) | ((bgra >> 16u) & 0xFFu) | ((bgra & 0xFFu) << 16u);
+    std::memcpy(out + i * 4u, &rgba, sizeof(rgba));
+  }
+}
+
+class FrameCaptureSinkImpl final : public FrameCaptureSink {
+public:
+  FrameCaptureSinkImpl(FrameCaptureConfig config, std::ofstream stream)
+    : config_(std::move(config)), stream_(std::move(stream)), frames_(config_.queueDepth) {
+    free_.reset(config_.queueDepth);
+    ready_.reset(config_.queueDepth);
+    for (uint32_t i = 0; i < config_.queueDepth; ++i) {
+      free_.push(i);
+    }
+    if (config_.format != FrameCaptureFormat::ImageSequence) {
+      staging_.reserve(config_.writeBufferBytes);
+    }
+    writer_ = std::thread([this]() { run(); });
+  }
+
+  ~FrameCaptureSinkImpl() override {
+    stopping_.store(true, std::memory_order_release);
+    signal();
+    writer_.join();
+  }
+
+  HostStatus submit(const ImageView& image) override {
+    const uint64_t index = presented_.fetch_add(1u, std::memory_order_relaxed);
+    if (failed_.load(std::memory_order_acquire)) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    if (index % config_.frameStep != 0u) {
+      decimated_.fetch_add(1u, std::memory_order_relaxed);
+      return {};
+    }
+    if (!accepts(image)) {
+      rejected_.fetch_add(1u, std::memory_order_relaxed);
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    uint32_t slot = 0u;
+    if (!free_.pop(slot)) {
+      dropped_.fetch_add(1u, std::memory_order_relaxed);
+      return {};
+    }
+    CaptureFrame& frame = frames_[slot];
+    const size_t rowBytes = static_cast<size_t>(image.size.width) * 4u;
+    frame.size = image.size;
+    frame.index = index;
+    frame.pixels.resize(rowBytes * image.size.height);
+    for (uint32_t y = 0; y < image.size.height; ++y) {
+      const uint8_t* row = image.pixels.data() + static_cast<size_t>(y) * image.stride;
+      std::memcpy(frame.pixels.data() + y * rowBytes, row, rowBytes);
+    }
+    ready_.push(slot);
+    signal();
+    return {};
+  }
+
+  HostStatus flush() override {
+    const uint64_t ticket = flushRequested_.fetch_add(1u, std::memory_order_acq_rel) + 1u;
+    signal();
+    for (uint64_t done = flushCompleted_.load(std::memory_order_acquire); done < ticket;
+         done = flushCompleted_.load(std::memory_order_acquire)) {
+      flushCompleted_.wait(done, std::memory_order_acquire);
+    }
+    if (failed_.load(std::memory_order_acquire)) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    return {};
+  }
+
+  FrameCaptureStats stats() const override {
+    FrameCaptureStats stats{};
+    stats.presented = presented_.load(std::memory_order_relaxed);
+    stats.decimated = decimated_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  // Producer side. Streams keep the size of their first frame.
+  bool accepts(const ImageView& image) {
+    if (image.colorFormat != ColorFormat::B8G8R8A8_UNORM || image.size.width == 0u || image.size.height == 0u) {
+      return false;
+    }
+    auto rowBytes = checkedSizeMul(image.size.width, 4u);
+    auto lastRow = checkedSizeMul(image.stride, image.size.height - 1u);
+    if (!rowBytes || !lastRow || image.stride < *rowBytes || *lastRow > SIZE_MAX - *rowBytes ||
+        image.pixels.size() < *lastRow + *rowBytes) {
+      return false;
+    }
+    if (config_.format == FrameCaptureFormat::ImageSequence) {
+      return true;
+    }
+    if (streamSize_.width == 0u) {
+      streamSize_ = image.size;
+    }
+    return image.size.width == streamSize_.width && image.size.height == streamSize_.height;
+  }
+
+  void signal() {
+    wake_.fetch_add(1u, std::memory_order_release);
+    wake_.notify_one();
+  }
+
+  void run() {
+    for (;;) {
+      const uint32_t seen = wake_.load(std::memory_order_acquire);
+      // Read the flush ticket before draining, so frames submitted ahead of it are written first.
+      const uint64_t requested = flushRequested_.load(std::memory_order_acquire);
+      bool worked = false;
+      uint32_t slot = 0u;
+      while (ready_.pop(slot)) {
+        write(frames_[slot]);
+        free_.push(slot);
+        worked = true;
+      }
+      if (requested != flushCompleted_.load(std::memory_order_relaxed)) {
+        flushStream();
+        flushCompleted_.store(requested, std::memory_order_release);
+        flushCompleted_.notify_all();
+      }
+      if (stopping_.load(std::memory_order_acquire)) {
+        if (ready_.size() == 0u) {
+          break;
+        }
+        continue;
+      }
+      if (!worked) {
+        wake_.wait(seen, std::memory_order_acquire);
+      }
+    }
+    flushStream();
+  }
+
+  void write(const CaptureFrame& frame) {
+    if (failed_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    const size_t count = static_cast<size_t>(frame.size.width) * frame.size.height;
+    switch (config_.format) {
+      case FrameCaptureFormat::Y4m: {
+        if (!headerWritten_) {
+          char header[128];
+          const int length = std::snprintf(header,
+                                           sizeof(header),
+                                           "YUV4MPEG2 W%u H%u F%u:%u Ip A1:1 C444 XCOLORRANGE=FULL\n",
+                                           frame.size.width,
+                                           frame.size.height,
+                                           config_.frameRateNumerator,
+                                           config_.frameRateDenominator * config_.frameStep);
+          append(reinterpret_cast<const uint8_t*>(header), static_cast<size_t>(length));
+          headerWritten_ = true;
+        }
+        static constexpr char FrameTag[] = "FRAME\n";
+        append(reinterpret_cast<const uint8_t*>(FrameTag), sizeof(FrameTag) - 1u);
+        scratch_.resize(count * 3u);
+        bgra_to_yuv444(frame, scratch_.data());
+        append(scratch_.data(), scratch_.size());
+        break;
+      }
+      case FrameCaptureFormat::Rgba:
+        scratch_.resize(count * 4u);
+        bgra_to_rgba(frame, scratch_.data());
+        append(scratch_.data(), scratch_.size());
+        break;
+      case FrameCaptureFormat::ImageSequence:
+        writeImage(frame);
+        break;
+    }
+    if (!failed_.load(std::memory_order_relaxed)) {
+      written_.fetch_add(1u, std::memory_order_relaxed);
+    }
+  }
+
+  void writeImage(const CaptureFrame& frame) {
+    auto bound = maxEncodedImageSize(frame.size, config_.image);
+    if (!bound) {
+      failed_.store(true, std::memory_order_release);
+      return;
+    }
+    if (scratch_.size() < *bound) {
+      scratch_.resize(*bound);
+    }
+    auto size = encodeImage(frame.view(), scratch_, config_.image);
+    if (!size) {
+      failed_.store(true, std::memory_order_release);
+      return;
+    }
+    char name[48];
+    std::snprintf(name,
+                  sizeof(name),
+                  "frame_%06llu.%s",
+                  static_cast<unsigned long long>(frame.index),
+                  config_.image.format == ImageFileFormat::Qoi ? "qoi" : "png");
+    std::ofstream file(std::filesystem::path(config_.path) / name, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(scratch_.data()), static_cast<std::streamsize>(*size));
+    if (!file) {
+      failed_.store(true, std::memory_order_release);
+      return;
+    }
+    bytesWritten_.fetch_add(*size, std::memory_order_relaxed);
+  }
+
+  // Stream output is gathered in `staging_` and written in writeBufferBytes pieces; frames larger
+  // than the buffer go straight through.
+  void append(const uint8_t* data, size_t size) {
+    if (staging_.size() + size > config_.writeBufferBytes) {
+      writeStaging();
+    }
+    if (size >= config_.writeBufferBytes) {
+      writeStream(data, size);
+    } else {
+      staging_.insert(staging_.end(), data, data + size);
+    }
+    bytesWritten_.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  void writeStaging() {
+    if (!staging_.empty()) {
+      writeStream(staging_.data(), staging_.size());
+      staging_.clear();
+    }
+  }
+
+  void writeStream(const uint8_t* data, size_t size) {
+    stream_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!stream_) {
+      failed_.store(true, std::memory_order_release);
+    }
+  }
+
+  void flushStream() {
+    if (config_.format == FrameCaptureFormat::ImageSequence) {
+      return;
+    }
+    writeStaging();
+    stream_.flush();
+    if (!stream_) {
+      failed_.store(true, std::memory_order_release);
+    }
+  }
+
+  FrameCaptureConfig config_;
+  std::ofstream stream_;
+  std::vector<CaptureFrame> frames_;
+  // Slot indices: free_ flows writer -> producer, ready_ producer -> writer.
+  SpscRing<uint32_t> free_;
+  SpscRing<uint32_t> ready_;
+  ImageSize streamSize_{};
+
+  // Writer thread state.
+  std::vector<uint8_t> staging_;
+  std::vector<uint8_t> scratch_;
+  bool headerWritten_ = false;
+
+  std::atomic<uint32_t> wake_{0u};
+  std::atomic<uint64_t> flushRequested_{0u};
+  std::atomic<uint64_t> flushCompleted_{0u};
+  std::atomic<bool> stopping_{false};
+  std::atomic<bool> failed_{false};
+  std::atomic<uint64_t> presented_{0u};
+  std::atomic<uint64_t> decimated_{0u};
+  std::atomic<uint64_t> dropped_{0u};
+  std::atomic<uint64_t> rejected_{0u};
+  std::atomic<uint64_t> written_{0u};
+  std::atomic<uint64_t> bytesWritten_{0u};
+  std::thread writer_;
+};
+
+} // namespace
+
+HostResult<std::shared_ptr<FrameCaptureSink>> createFrameCaptureSink(const FrameCaptureConfig& config) {
+  if (config.path.empty() || config.frameStep == 0u || config.queueDepth == 0u ||
+      config.queueDepth > MaxCaptureQueueDepth || config.writeBufferBytes == 0u || config.frameRateNumerator == 0u ||
+      config.frameRateDenominator == 0u) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  std::ofstream stream;
+  if (config.format == FrameCaptureFormat::ImageSequence) {
+    std::error_code error;
+    std::filesystem::create_directories(config.path, error);
+    if (error || !std::filesystem::is_directory(config.path, error)) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+  } else {
+    stream.open(config.path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+  }
+  return std::make_shared<FrameCaptureSinkImpl>(config, std::move(stream));
+}
+
+} // namespace PrimeHost
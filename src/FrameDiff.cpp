@@ -0,0 +1,150 @@
+#include "PrimeHost/FrameDiff.h"
+
+#include "ParallelFor.h"
+#include "PixelDiffKernels.h"
+#include "SizeUtil.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace PrimeHost {
+namespace {
+
+// Opaque red as stored in memory for each channel order.
+constexpr uint32_t BgraHighlight = 0xFFFF0000u;
+constexpr uint32_t RgbaHighlight = 0xFF0000FFu;
+
+struct DiffSource {
+  ImageSize size;
+  uint32_t stride = 0u;
+  std::span<const uint8_t> pixels;
+};
+
+bool valid_source(const DiffSource& source) {
+  if (source.size.width == 0u || source.size.height == 0u) {
+    return false;
+  }
+  auto rowBytes = checkedSizeMul(source.size.width, 4u);
+  auto lastRow = checkedSizeMul(source.stride, source.size.height - 1u);
+  return rowBytes && lastRow && source.stride >= *rowBytes && *lastRow <= SIZE_MAX - *rowBytes &&
+         source.pixels.size() >= *lastRow + *rowBytes;
+}
+
+struct TileStats {
+  uint64_t differing = 0u;
+  uint32_t maxDelta = 0u;
+  uint32_t minX = UINT32_MAX;
+  uint32_t minY = UINT32_MAX;
+  uint32_t maxX = 0u;
+  uint32_t maxY = 0u;
+};
+
+DiffRect union_rect(const DiffRect& a, const DiffRect& b) {
+  if (a.width == 0u) {
+    return b;
+  }
+  const uint32_t x0 = std::min(a.x, b.x);
+  const uint32_t y0 = std::min(a.y, b.y);
+  const uint32_t x1 = std::max(a.x + a.width, b.x + b.width);
+  const uint32_t y1 = std::max(a.y + a.height, b.y + b.height);
+  return DiffRect{x0, y0, x1 - x0, y1 - y0};
+}
+
+HostResult<FrameDiffResult> diff_sources(const DiffSource& expected,
+                                         const DiffSource& actual,
+                                         const FrameDiffConfig& config,
+                                         const FrameDiffOutput& output,
+                                         uint32_t highlight) {
+  if (!valid_source(expected) || !valid_source(actual) || expected.size.width != actual.size.width ||
+      expected.size.height != actual.size.height || config.tileSize == 0u) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const uint32_t width = expected.size.width;
+  const uint32_t height = expected.size.height;
+  const size_t diffRowBytes = static_cast<size_t>(width) * 4u;
+  if (!output.diffImage.empty() && output.diffImage.size() / diffRowBytes < height) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+  const uint32_t tileSize = std::min(config.tileSize, std::max(width, height));
+  const uint32_t tilesX = (width + tileSize - 1u) / tileSize;
+  const uint32_t tilesY = (height + tileSize - 1u) / tileSize;
+  std::vector<TileStats> tiles(static_cast<size_t>(tilesX) * tilesY);
+
+  PixelDiffParams params{};
+  params.threshold = config.threshold;
+  params.channelMask = config.compareAlpha ? 0xFFFFFFFFu : 0x00FFFFFFu;
+  params.highlight = highlight;
+  uint8_t* diffImage = output.diffImage.empty() ? nullptr : output.diffImage.data();
+
+  // Each task owns one row of tiles, so tile stats need no synchronization.
+  parallelFor(tilesY, imageWorkThreads(config.threadCount), config.executor, [&](uint32_t ty) {
+    TileStats* row = tiles.data() + static_cast<size_t>(ty) * tilesX;
+    const uint32_t y0 = ty * tileSize;
+    const uint32_t y1 = std::min(y0 + tileSize, height);
+    for (uint32_t y = y0; y < y1; ++y) {
+      const uint8_t* a = expected.pixels.data() + static_cast<size_t>(y) * expected.stride;
+      const uint8_t* b = actual.pixels.data() + static_cast<size_t>(y) * actual.stride;
+      uint8_t* diff = diffImage ? diffImage + static_cast<size_t>(y) * diffRowBytes : nullptr;
+      for (uint32_t tx = 0; tx < tilesX; ++tx) {
+        const uint32_t x0 = tx * tileSize;
+        const uint32_t count = std::min(tileSize, width - x0);
+        const size_t offset = static_cast<size_t>(x0) * 4u;
+        const PixelDiffRun run = diffPixels(a + offset, b + offset, diff ? diff + offset : nullptr, count, params);
+        TileStats& tile = row[tx];
+        tile.maxDelta = std::max(tile.maxDelta, run.maxDelta);
+        if (run.differing != 0u) {
+          tile.differing += run.differing;
+          tile.minX = std::min(tile.minX, x0 + run.first);
+          tile.maxX = std::max(tile.maxX, x0 + run.last);
+          tile.minY = std::min(tile.minY, y);
+          tile.maxY = y;
+        }
+      }
+    }
+  });
+
+  FrameDiffResult result{};
+  for (const TileStats& tile : tiles) {
+    result.maxChannelDelta = std::max(result.maxChannelDelta, tile.maxDelta);
+    if (tile.differing == 0u) {
+      continue;
+    }
+    const DiffRect rect{tile.minX, tile.minY, tile.maxX - tile.minX + 1u, tile.maxY - tile.minY + 1u};
+    if (result.differingTiles < output.tiles.size()) {
+      output.tiles[result.differingTiles] = rect;
+    }
+    ++result.differingTiles;
+    result.differingPixels += tile.differing;
+    result.bounds = union_rect(result.bounds, rect);
+  }
+  return result;
+}
+
+} // namespace
+
+HostResult<FrameDiffResult> diffImages(const ImageView& expected,
+                                       const ImageView& actual,
+                                       const FrameDiffConfig& config,
+                                       const FrameDiffOutput& output) {
+  if (expected.colorFormat != actual.colorFormat) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return diff_sources(DiffSource{expected.size, expected.stride, expected.pixels},
+                      DiffSource{actual.size, actual.stride, actual.pixels},
+                      config,
+                      output,
+                      BgraHighlight);
+}
+
+HostResult<FrameDiffResult> diffImages(const ImageData& expected,
+                                       const ImageData& actual,
+                                       const FrameDiffConfig& config,
+                                       const FrameDiffOutput& output) {
+  return diff_sources(DiffSource{expected.size, expected.size.width * 4u, expected.pixels},
+                      DiffSource{actual.size, actual.size.width * 4u, actual.pixels},
+                      config,
+                      output,
+                      RgbaHighlight);
+}
+
+} // namespace PrimeHost
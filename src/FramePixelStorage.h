@@ -0,0 +1,143 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace PrimeHost {
+
+constexpr size_t FrameRowAlignment = 64u;
+constexpr size_t HugePageSize = size_t{2u} << 20u;
+
+// Row pitch for `width` BGRA pixels. Padded rows start on a cache line and the pitch is an odd
+// number of lines (gcd(pitch, 4 KiB) == 64), so a column walk spreads over every cache set
+// instead of revisiting a few every 2-64 rows.
+inline std::optional<uint32_t> frameBufferStride(uint32_t width, FrameBufferLayout layout) {
+  const uint64_t packed = static_cast<uint64_t>(width) * 4u;
+  uint64_t stride = packed;
+  if (layout == FrameBufferLayout::Padded) {
+    stride = (packed + FrameRowAlignment - 1u) / FrameRowAlignment * FrameRowAlignment;
+    if ((stride / FrameRowAlignment) % 2u == 0u) {
+      stride += FrameRowAlignment;
+    }
+  }
+  if (stride > UINT32_MAX) {
+    return std::nullopt;
+  }
+  return static_cast<uint32_t>(stride);
+}
+
+// Page-aligned anonymous mapping backing one frame buffer. The mapping only grows: a resize that
+// fits reuses it, so resizing a surface down and back up does not reallocate. POSIX only.
+class FramePixelStorage {
+public:
+  FramePixelStorage() = default;
+  FramePixelStorage(const FramePixelStorage&) = delete;
+  FramePixelStorage& operator=(const FramePixelStorage&) = delete;
+
+  FramePixelStorage(FramePixelStorage&& other) noexcept { swap(other); }
+  FramePixelStorage& operator=(FramePixelStorage&& other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~FramePixelStorage() { release(); }
+
+  // Sizes the storage to `bytes`. Contents survive when the size and policy are unchanged and
+  // read as zero otherwise. New mappings come zeroed from the OS and are touched here unless
+  // `policy.firstTouch` leaves that to the render threads, so the pages land on their NUMA node.
+  bool resize(size_t bytes, const FrameBufferPolicy& policy) {
+    if (bytes == size_ && policy.hugePages == hugePages_ && data_) {
+      return true;
+    }
+    if (bytes <= capacity_ && policy.hugePages == hugePages_ && data_) {
+      std::memset(data_, 0, bytes);
+      size_ = bytes;
+      return true;
+    }
+    release();
+    if (bytes == 0u) {
+      return true;
+    }
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t granule = policy.hugePages ? HugePageSize : page;
+    if (bytes > SIZE_MAX - granule * 2u) {
+      return false;
+    }
+    const size_t capacity = (bytes + granule - 1u) / granule * granule;
+    // Huge pages need a 2 MiB aligned range: over-map by one huge page and trim both ends.
+    const size_t mapped = policy.hugePages ? capacity + HugePageSize : capacity;
+    void* base = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      return false;
+    }
+    auto* data = static_cast<uint8_t*>(base);
+    if (policy.hugePages) {
+      const uintptr_t address = reinterpret_cast<uintptr_t>(base);
+      const uintptr_t aligned = (address + HugePageSize - 1u) & ~(static_cast<uintptr_t>(HugePageSize) - 1u);
+      const size_t head = aligned - address;
+      if (head != 0u) {
+        ::munmap(base, head);
+      }
+      const size_t tail = mapped - head - capacity;
+      if (tail != 0u) {
+        ::munmap(data + head + capacity, tail);
+      }
+      data += head;
+#if defined(MADV_HUGEPAGE)
+      ::madvise(data, capacity, MADV_HUGEPAGE);
+#endif
+    }
+    data_ = data;
+    capacity_ = capacity;
+    size_ = bytes;
+    hugePages_ = policy.hugePages;
+    if (!policy.firstTouch) {
+      std::memset(data_, 0, size_);
+    }
+    return true;
+  }
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  std::span<uint8_t> span() { return {data_, size_}; }
+  std::span<const uint8_t> span() const { return {data_, size_}; }
+
+private:
+  void release() {
+    if (data_) {
+      ::munmap(data_, capacity_);
+    }
+    data_ = nullptr;
+    capacity_ = 0u;
+    size_ = 0u;
+    hugePages_ = false;
+  }
+
+  void swap(FramePixelStorage& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(hugePages_, other.hugePages_);
+  }
+
+  uint8_t* data_ = nullptr;
+  size_t capacity_ = 0u;
+  size_t size_ = 0u;
+  bool hugePages_ = false;
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace PrimeHost {
+
+enum class FramePriority : uint8_t {
+  Focused,
+  Visible,
+  Background,
+};
+
+struct FrameSchedulerConfig {
+  // Slowest cadence Background surfaces are throttled to.
+  std::chrono::nanoseconds backgroundInterval = std::chrono::milliseconds(100);
+  // Occluded surfaces tick at most this often; zero pauses them until they are uncovered.
+  std::chrono::nanoseconds occludedInterval = std::chrono::seconds(1);
+};
+
+// Independent frame deadlines for continuous surfaces. Each surface keeps its own interval and
+// phase, due surfaces come out in priority order (then join order), and nextWake() tells the loop
+// when to wake next instead of ticking at the fastest surface's rate. Time is always passed in, so
+// tests drive it with a virtual clock. Main thread only.
+class FrameScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit FrameScheduler(FrameSchedulerConfig config = {}) : config_(config) {}
+
+  // Adds a surface or changes its interval. A zero interval makes the surface due on every
+  // collectDue call, for display-paced surfaces that follow the tick itself. New surfaces that
+  // share an interval with existing ones are staggered across it so their frames do not land on
+  // the same tick; existing surfaces keep their phase.
+  void setSurface(uint64_t surfaceId, std::chrono::nanoseconds interval, Clock::time_point now) {
+    if (Entry* entry = find(surfaceId)) {
+      entry->interval = std::max(interval, std::chrono::nanoseconds(0));
+      pullIn(*entry);
+      return;
+    }
+    Entry entry{};
+    entry.surfaceId = surfaceId;
+    entry.interval = std::max(interval, std::chrono::nanoseconds(0));
+    entry.order = nextOrder_++;
+    entry.lastFrame = now;
+    entry.deadline = now;
+    if (entry.interval.count() > 0) {
+      const auto peers = std::count_if(entries_.begin(), entries_.end(), [&](const Entry& other) {
+        return other.interval == entry.interval;
+      });
+      entry.deadline += entry.interval * peers / (peers + 1);
+    }
+    entries_.push_back(entry);
+    sortEntries();
+  }
+
+  bool removeSurface(uint64_t surfaceId) {
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& entry) {
+      return entry.surfaceId == surfaceId;
+    });
+    if (it == entries_.end()) {
+      return false;
+    }
+    entries_.erase(it);
+    return true;
+  }
+
+  // Raising the priority or uncovering a surface pulls its deadline in to the faster cadence.
+  void setPriority(uint64_t surfaceId, FramePriority priority) {
+    Entry* entry = find(surfaceId);
+    if (!entry || entry->priority == priority) {
+      return;
+    }
+    entry->priority = priority;
+    pullIn(*entry);
+    sortEntries();
+  }
+
+  void setOccluded(uint64_t surfaceId, bool occluded) {
+    if (Entry* entry = find(surfaceId)) {
+      entry->occluded = occluded;
+      pullIn(*entry);
+    }
+  }
+
+  bool contains(uint64_t surfaceId) const {
+    return std::any_of(entries_.begin(), entries_.end(), [&](const Entry& entry) {
+      return entry.surfaceId == surfaceId;
+    });
+  }
+
+  size_t size() const { return entries_.size(); }
+
+  // Earliest deadline over surfaces that are not paused; nullopt means nothing needs a wake.
+  std::optional<Clock::time_point> nextWake() const {
+    std::optional<Clock::time_point> wake;
+    for (const Entry& entry : entries_) {
+      if (paused(entry)) {
+        continue;
+      }
+      if (!wake || entry.deadline < *wake) {
+        wake = entry.deadline;
+      }
+    }
+    return wake;
+  }
+
+  // Writes the surfaces due by `now + tolerance` to `out` in priority order and advances their
+  // deadlines by one interval. A surface that fell more than an interval behind restarts from
+  // `now` rather than firing a burst to catch up. Due surfaces that do not fit in `out` stay due.
+  size_t collectDue(Clock::time_point now, std::chrono::nanoseconds tolerance, std::span<uint64_t> out) {
+    size_t count = 0u;
+    for (Entry& entry : entries_) {
+      if (count == out.size()) {
+        break;
+      }
+      if (paused(entry) || entry.deadline > now + tolerance) {
+        continue;
+      }
+      out[count++] = entry.surfaceId;
+      const auto interval = effectiveInterval(entry);
+      entry.lastFrame = now;
+      entry.deadline += interval;
+      if (entry.deadline <= now) {
+        // Zero-interval surfaces still move past `now`, so they fire once per call.
+        entry.deadline = now + std::max(interval, std::chrono::nanoseconds(1));
+      }
+    }
+    return count;
+  }
+
+private:
+  struct Entry {
+    uint64_t surfaceId = 0u;
+    std::chrono::nanoseconds interval{0};
+    Clock::time_point deadline{};
+    Clock::time_point lastFrame{};
+    FramePriority priority = FramePriority::Visible;
+    bool occluded = false;
+    uint64_t order = 0u;
+  };
+
+  std::chrono::nanoseconds effectiveInterval(const Entry& entry) const {
+    std::chrono::nanoseconds interval = entry.interval;
+    if (entry.priority == FramePriority::Background) {
+      interval = std::max(interval, config_.backgroundInterval);
+    }
+    if (entry.occluded) {
+      interval = std::max(interval, config_.occludedInterval);
+    }
+    return interval;
+  }
+
+  bool paused(const Entry& entry) const {
+    return entry.occluded && config_.occludedInterval.count() <= 0;
+  }
+
+  void pullIn(Entry& entry) {
+    entry.deadline = std::min(entry.deadline, entry.lastFrame + effectiveInterval(entry));
+  }
+
+  Entry* find(uint64_t surfaceId) {
+    for (Entry& entry : entries_) {
+      if (entry.surfaceId == surfaceId) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  void sortEntries() {
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& left, const Entry& right) {
+      if (left.priority != right.priority) {
+        return left.priority < right.priority;
+      }
+      return left.order < right.order;
+    });
+  }
+
+  FrameSchedulerConfig config_{};
+  std::vector<Entry> entries_;
+  uint64_t nextOrder_ = 0u;
+};
+
+} // namespace PrimeHost
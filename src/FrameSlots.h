@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace PrimeHost {
+
+enum class FrameSlotState : uint32_t {
+  Free,
+  Acquired,
+  Pending,
+  InFlight,
+};
+
+// Ownership of a surface's framebuffer slots, shared by the render thread (acquire, submit,
+// release, post), the display thread (takePosted), the GPU completion thread (complete) and anyone
+// polling state. Each transition is one
+// compare-exchange on the slot, so a slot's pixels belong to exactly one side at a time. Only
+// complete() and close() ever touch a mutex, and only while the render thread is blocked in
+// acquireUntil. acquire/acquireUntil/submit/release/resize come from one thread at a time.
+class FrameSlotTable {
+public:
+  static constexpr uint32_t MaxSlots = 4u;
+
+  // Changes the slot count. Fails unless every slot is Free, so GPU work never sees its slot
+  // disappear.
+  bool resize(uint32_t count) {
+    if (count == 0u || count > MaxSlots || !idle()) {
+      return false;
+    }
+    count_.store(count, std::memory_order_release);
+    cursor_ = 0u;
+    return true;
+  }
+
+  uint32_t count() const { return count_.load(std::memory_order_acquire); }
+
+  // Free -> Acquired, searching round robin from the slot after the last one handed out.
+  std::optional<uint32_t> acquire() {
+    const uint32_t count = this->count();
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t index = (cursor_ + i) % count;
+      if (transition(index, FrameSlotState::Free, FrameSlotState::Acquired)) {
+        cursor_ = (index + 1u) % count;
+        return index;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Like acquire(), but holds back while `maxInFlight` slots are on the GPU (0 means no limit) and
+  // blocks until a completion frees one, `deadline` passes or close() is called.
+  std::optional<uint32_t> acquireUntil(std::chrono::steady_clock::time_point deadline, uint32_t maxInFlight) {
+    if (auto index = tryAcquire(maxInFlight)) {
+      return index;
+    }
+    waiters_.fetch_add(1u, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::optional<uint32_t> index;
+    {
+      std::unique_lock<std::mutex> lock(waitMutex_);
+      while (!(index = tryAcquire(maxInFlight)) && !closed()) {
+        if (waitCv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+          index = tryAcquire(maxInFlight);
+          break;
+        }
+      }
+    }
+    waiters_.fetch_sub(1u, std::memory_order_relaxed);
+    return index;
+  }
+
+  // Free -> Acquired for one particular slot, e.g. to pin the last shown frame while it is read back.
+  bool acquireSlot(uint32_t index) { return transition(index, FrameSlotState::Free, FrameSlotState::Acquired); }
+
+  // Acquired -> InFlight, before handing the slot to the GPU.
+  bool submit(uint32_t index) { return transition(index, FrameSlotState::Acquired, FrameSlotState::InFlight); }
+
+  // Mailbox present: Acquired -> Pending, replacing the frame still waiting in the mailbox. The
+  // replaced frame goes back to Free and counts as superseded.
+  bool post(uint32_t index) {
+    if (!transition(index, FrameSlotState::Acquired, FrameSlotState::Pending)) {
+      return false;
+    }
+    const uint32_t previous = mailbox_.exchange(index, std::memory_order_acq_rel);
+    if (previous != NoSlot && transition(previous, FrameSlotState::Pending, FrameSlotState::Free)) {
+      superseded_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  // Display side of the mailbox: Pending -> InFlight for the newest posted frame, if any.
+  std::optional<uint32_t> takePosted() {
+    const uint32_t index = mailbox_.exchange(NoSlot, std::memory_order_acq_rel);
+    if (index == NoSlot || !transition(index, FrameSlotState::Pending, FrameSlotState::InFlight)) {
+      return std::nullopt;
+    }
+    return index;
+  }
+
+  // Frames replaced in the mailbox before they were shown since the last call.
+  uint32_t takeSuperseded() { return superseded_.exchange(0u, std::memory_order_relaxed); }
+
+  // Acquired -> Free, for slots presented synchronously, abandoned or unpinned.
+  bool release(uint32_t index) {
+    if (!transition(index, FrameSlotState::Acquired, FrameSlotState::Free)) {
+      return false;
+    }
+    wakeWaiters();
+    return true;
+  }
+
+  // InFlight -> Free. Safe from any thread, typically a GPU completion handler.
+  bool complete(uint32_t index) {
+    if (!transition(index, FrameSlotState::InFlight, FrameSlotState::Free)) {
+      return false;
+    }
+    wakeWaiters();
+    return true;
+  }
+
+  // Wakes a blocked acquireUntil for good; used when the surface goes away.
+  void close() {
+    closed_.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(waitMutex_);
+    waitCv_.notify_all();
+  }
+
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  uint32_t inFlight() const {
+    uint32_t total = 0u;
+    for (uint32_t i = 0; i < MaxSlots; ++i) {
+      total += state(i) == FrameSlotState::InFlight ? 1u : 0u;
+    }
+    return total;
+  }
+
+  FrameSlotState state(uint32_t index) const {
+    if (index >= MaxSlots) {
+      return FrameSlotState::Free;
+    }
+    return static_cast<FrameSlotState>(states_[index].load(std::memory_order_acquire));
+  }
+
+  bool idle() const {
+    for (uint32_t i = 0; i < MaxSlots; ++i) {
+      if (state(i) != FrameSlotState::Free) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::optional<uint32_t> tryAcquire(uint32_t maxInFlight) {
+    if (closed() || (maxInFlight != 0u && inFlight() >= maxInFlight)) {
+      return std::nullopt;
+    }
+    return acquire();
+  }
+
+  // Pairs with the fence in acquireUntil: either the waiter sees the freed slot before sleeping or
+  // this side sees the waiter and notifies under the mutex.
+  void wakeWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0u) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(waitMutex_);
+    waitCv_.notify_all();
+  }
+
+  bool transition(uint32_t index, FrameSlotState from, FrameSlotState to) {
+    if (index >= count()) {
+      return false;
+    }
+    uint32_t expected = static_cast<uint32_t>(from);
+    return states_[index].compare_exchange_strong(
+        expected, static_cast<uint32_t>(to), std::memory_order_acq_rel, std::memory_order_acquire);
+  }
+
+  std::array<std::atomic<uint32_t>, MaxSlots> states_{};
+  std::atomic<uint32_t> count_{0u};
+  static constexpr uint32_t NoSlot = UINT32_MAX;
+
+  std::atomic<uint32_t> mailbox_{NoSlot};
+  std::atomic<uint32_t> superseded_{0u};
+  std::atomic<uint32_t> waiters_{0u};
+  std::atomic<bool> closed_{false};
+  std::mutex waitMutex_;
+  std::condition_variable waitCv_;
+  uint32_t cursor_ = 0u;
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,237 @@
+#include "GamepadMapping.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace PrimeHost {
+namespace {
+
+struct MappingTarget {
+  std::string_view name;
+  bool toAxis = false;
+  uint32_t controlId = 0u;
+};
+
+constexpr std::array<MappingTarget, 22> kTargets{{
+    {"a", false, static_cast<uint32_t>(GamepadButtonId::South)},
+    {"b", false, static_cast<uint32_t>(GamepadButtonId::East)},
+    {"x", false, static_cast<uint32_t>(GamepadButtonId::West)},
+    {"y", false, static_cast<uint32_t>(GamepadButtonId::North)},
+    {"leftshoulder", false, static_cast<uint32_t>(GamepadButtonId::LeftBumper)},
+    {"rightshoulder", false, static_cast<uint32_t>(GamepadButtonId::RightBumper)},
+    {"back", false, static_cast<uint32_t>(GamepadButtonId::Back)},
+    {"start", false, static_cast<uint32_t>(GamepadButtonId::Start)},
+    {"guide", false, static_cast<uint32_t>(GamepadButtonId::Guide)},
+    {"leftstick", false, static_cast<uint32_t>(GamepadButtonId::LeftStick)},
+    {"rightstick", false, static_cast<uint32_t>(GamepadButtonId::RightStick)},
+    {"dpup", false, static_cast<uint32_t>(GamepadButtonId::DpadUp)},
+    {"dpdown", false, static_cast<uint32_t>(GamepadButtonId::DpadDown)},
+    {"dpleft", false, static_cast<uint32_t>(GamepadButtonId::DpadLeft)},
+    {"dpright", false, static_cast<uint32_t>(GamepadButtonId::DpadRight)},
+    {"misc1", false, static_cast<uint32_t>(GamepadButtonId::Misc)},
+    {"leftx", true, static_cast<uint32_t>(GamepadAxisId::LeftX)},
+    {"lefty", true, static_cast<uint32_t>(GamepadAxisId::LeftY)},
+    {"rightx", true, static_cast<uint32_t>(GamepadAxisId::RightX)},
+    {"righty", true, static_cast<uint32_t>(GamepadAxisId::RightY)},
+    {"lefttrigger", true, static_cast<uint32_t>(GamepadAxisId::LeftTrigger)},
+    {"righttrigger", true, static_cast<uint32_t>(GamepadAxisId::RightTrigger)},
+}};
+
+std::optional<uint8_t> parse_index(std::string_view text) {
+  unsigned value = 0u;
+  auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc{} || end != text.data() + text.size() || value > 0xFFu) {
+    return std::nullopt;
+  }
+  return static_cast<uint8_t>(value);
+}
+
+bool parse_source(std::string_view source, GamepadBinding& binding) {
+  if (!source.empty() && (source.front() == '+' || source.front() == '-')) {
+    binding.inputRange = source.front() == '+' ? 1 : -1;
+    source.remove_prefix(1u);
+  }
+  if (!source.empty() && source.back() == '~') {
+    binding.invert = true;
+    source.remove_suffix(1u);
+  }
+  if (source.size() < 2u) {
+    return false;
+  }
+  const char kind = source.front();
+  source.remove_prefix(1u);
+  if (kind == 'b' || kind == 'a') {
+    auto index = parse_index(source);
+    if (!index) {
+      return false;
+    }
+    binding.kind = kind == 'b' ? GamepadInputKind::Button : GamepadInputKind::Axis;
+    binding.index = *index;
+    return kind == 'a' || (binding.inputRange == 0 && !binding.invert);
+  }
+  if (kind == 'h') {
+    const size_t dot = source.find('.');
+    if (dot == std::string_view::npos) {
+      return false;
+    }
+    auto index = parse_index(source.substr(0u, dot));
+    auto mask = parse_index(source.substr(dot + 1u));
+    if (!index || !mask || *mask == 0u || *mask > 0x0Fu) {
+      return false;
+    }
+    binding.kind = GamepadInputKind::Hat;
+    binding.index = *index;
+    binding.hatMask = *mask;
+    return binding.inputRange == 0 && !binding.invert;
+  }
+  return false;
+}
+
+// 3: exact GUID, 2: bus/vendor/product, 1: vendor/product, 0: no match.
+int match_score(const GamepadGuid& candidate, const GamepadGuid& wanted) {
+  if (candidate.vendor() != wanted.vendor() || candidate.product() != wanted.product() ||
+      candidate.vendor() == 0u) {
+    return candidate == wanted ? 3 : 0;
+  }
+  if (candidate == wanted) {
+    return 3;
+  }
+  return candidate.bus() == wanted.bus() ? 2 : 1;
+}
+
+uint32_t product_key(const GamepadGuid& guid) {
+  return (static_cast<uint32_t>(guid.vendor()) << 16u) | guid.product();
+}
+
+} // namespace
+
+HostResult<GamepadMapping> parseGamepadMapping(std::string_view line, std::string_view platform) {
+  while (!line.empty() && (line.back() == '\r' || line.back() == '\n' || line.back() == ' ')) {
+    line.remove_suffix(1u);
+  }
+  const size_t guidEnd = line.find(',');
+  const size_t nameEnd = guidEnd == std::string_view::npos ? guidEnd : line.find(',', guidEnd + 1u);
+  if (nameEnd == std::string_view::npos) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  auto guid = parseGamepadGuid(line.substr(0u, guidEnd));
+  if (!guid) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  GamepadMapping mapping{};
+  mapping.guid = *guid;
+  mapping.name = std::string(line.substr(guidEnd + 1u, nameEnd - guidEnd - 1u));
+
+  std::string_view rest = line.substr(nameEnd + 1u);
+  while (!rest.empty()) {
+    const size_t end = std::min(rest.find(','), rest.size());
+    std::string_view field = rest.substr(0u, end);
+    rest.remove_prefix(std::min(end + 1u, rest.size()));
+    const size_t colon = field.find(':');
+    if (field.empty() || colon == std::string_view::npos) {
+      continue;
+    }
+    std::string_view target = field.substr(0u, colon);
+    std::string_view source = field.substr(colon + 1u);
+    if (target == "platform") {
+      if (!platform.empty() && source != platform) {
+        return std::unexpected(HostError{HostErrorCode::Unsupported});
+      }
+      continue;
+    }
+    GamepadBinding binding{};
+    if (!target.empty() && (target.front() == '+' || target.front() == '-')) {
+      binding.outputRange = target.front() == '+' ? 1 : -1;
+      target.remove_prefix(1u);
+    }
+    auto it = std::find_if(kTargets.begin(), kTargets.end(), [&](const MappingTarget& candidate) {
+      return candidate.name == target;
+    });
+    if (it == kTargets.end()) {
+      // crc, hint, paddles, touchpad and other SDL extras have no PrimeHost control.
+      continue;
+    }
+    binding.toAxis = it->toAxis;
+    binding.controlId = it->controlId;
+    if ((binding.outputRange != 0 && !binding.toAxis) || !parse_source(source, binding)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    if (mapping.bindingCount == mapping.bindings.size()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    mapping.bindings[mapping.bindingCount++] = binding;
+  }
+  return mapping;
+}
+
+size_t GamepadMappingDb::importMappings(std::string_view text, std::string_view platform) {
+  size_t added = 0u;
+  while (!text.empty()) {
+    const size_t end = std::min(text.find('\n'), text.size());
+    std::string_view line = text.substr(0u, end);
+    text.remove_prefix(std::min(end + 1u, text.size()));
+    while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+      line.remove_prefix(1u);
+    }
+    if (line.empty() || line.front() == '#') {
+      continue;
+    }
+    auto mapping = parseGamepadMapping(line, platform);
+    if (!mapping) {
+      continue;
+    }
+    auto existing = importedByGuid_.find(mapping->guid);
+    if (existing != importedByGuid_.end()) {
+      imported_[existing->second] = std::move(*mapping);
+    } else {
+      importedByGuid_.emplace(mapping->guid, imported_.size());
+      importedByProduct_.emplace(product_key(mapping->guid), imported_.size());
+      imported_.push_back(std::move(*mapping));
+    }
+    ++added;
+  }
+  return added;
+}
+
+std::optional<GamepadMapping> GamepadMappingDb::find(const GamepadGuid& guid) const {
+  if (auto exact = importedByGuid_.find(guid); exact != importedByGuid_.end()) {
+    return imported_[exact->second];
+  }
+  const GamepadMapping* bestImported = nullptr;
+  int bestScore = 0;
+  auto [begin, end] = importedByProduct_.equal_range(product_key(guid));
+  for (auto it = begin; it != end; ++it) {
+    const int score = match_score(imported_[it->second].guid, guid);
+    if (score > bestScore) {
+      bestScore = score;
+      bestImported = &imported_[it->second];
+    }
+  }
+
+  // Only the built-in lines for this vendor/product are scored, and only the winner is parsed.
+  const std::span<const GamepadGuid> builtinGuids = builtinGamepadGuids();
+  const BuiltinGamepadLines lines = findBuiltinGamepadLines(guid.vendor(), guid.product());
+  size_t bestBuiltin = 0u;
+  int bestBuiltinScore = 0;
+  for (uint16_t line : lines.indices) {
+    // A vendor fallback ranks below any vendor/product match and needs the same bus.
+    const int score = lines.vendorFallback ? (builtinGuids[line].bus() == guid.bus() ? 1 : 0)
+                                           : match_score(builtinGuids[line], guid);
+    if (score > bestBuiltinScore) {
+      bestBuiltinScore = score;
+      bestBuiltin = line;
+    }
+  }
+  if (bestImported && bestScore >= bestBuiltinScore) {
+    return *bestImported;
+  }
+  if (bestBuiltinScore > 0) {
+    auto mapping = parseGamepadMapping(builtinGamepadMappings()[bestBuiltin], {});
+    if (mapping) {
+      return std::move(*mapping);
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PrimeHost/Host.h"
+
+namespace PrimeHost {
+
+// Control IDs at or above this base carry a raw platform index (base + index) for devices without
+// a mapping.
+constexpr uint32_t GamepadRawControlBase = 0x100u;
+constexpr size_t GamepadMaxBindings = 32u;
+
+// SDL joystick GUID: little-endian bus, vendor, product and version, each followed by 16 zero bits.
+struct GamepadGuid {
+  std::array<uint8_t, 16> bytes{};
+
+  constexpr uint16_t bus() const { return field(0u); }
+  constexpr uint16_t vendor() const { return field(4u); }
+  constexpr uint16_t product() const { return field(8u); }
+  constexpr uint16_t version() const { return field(12u); }
+
+  constexpr bool operator==(const GamepadGuid&) const = default;
+
+private:
+  constexpr uint16_t field(size_t offset) const {
+    return static_cast<uint16_t>(bytes[offset] | (bytes[offset + 1u] << 8u));
+  }
+};
+
+namespace GamepadMappingDetail {
+
+constexpr int hexDigit(char ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  if (ch >= 'A' && ch <= 'F') {
+    return ch - 'A' + 10;
+  }
+  return -1;
+}
+
+} // namespace GamepadMappingDetail
+
+constexpr GamepadGuid makeGamepadGuid(uint16_t bus, uint16_t vendor, uint16_t product, uint16_t version) {
+  GamepadGuid guid{};
+  const uint16_t fields[4] = {bus, vendor, product, version};
+  for (size_t i = 0; i < 4u; ++i) {
+    guid.bytes[i * 4u] = static_cast<uint8_t>(fields[i] & 0xFFu);
+    guid.bytes[i * 4u + 1u] = static_cast<uint8_t>(fields[i] >> 8u);
+  }
+  return guid;
+}
+
+constexpr std::optional<GamepadGuid> parseGamepadGuid(std::string_view hex) {
+  GamepadGuid guid{};
+  if (hex.size() != guid.bytes.size() * 2u) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < guid.bytes.size(); ++i) {
+    const int high = GamepadMappingDetail::hexDigit(hex[i * 2u]);
+    const int low = GamepadMappingDetail::hexDigit(hex[i * 2u + 1u]);
+    if (high < 0 || low < 0) {
+      return std::nullopt;
+    }
+    guid.bytes[i] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return guid;
+}
+
+struct GamepadGuidHash {
+  size_t operator()(const GamepadGuid& guid) const {
+    uint64_t hash = 0xCBF29CE484222325u;
+    for (uint8_t byte : guid.bytes) {
+      hash = (hash ^ byte) * 0x100000001B3u;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+enum class GamepadInputKind : uint8_t {
+  Button,
+  Axis,
+  Hat,
+};
+
+// One `target:source` pair of an SDL mapping, e.g. `lefttrigger:a2`, `dpup:h0.1` or `+leftx:-a0`.
+struct GamepadBinding {
+  GamepadInputKind kind = GamepadInputKind::Button;
+  uint8_t index = 0u;
+  // Hat sources: SDL hat bits (1 up, 2 right, 4 down, 8 left).
+  uint8_t hatMask = 0u;
+  // Axis sources: 0 uses the full range, +1/-1 only the positive/negative half.
+  int8_t inputRange = 0;
+  bool invert = false;
+  // True when controlId is a GamepadAxisId, false for a GamepadButtonId.
+  bool toAxis = false;
+  // Axis targets: 0 drives the full axis, +1/-1 only its positive/negative half.
+  int8_t outputRange = 0;
+  uint32_t controlId = 0u;
+};
+
+struct GamepadMapping {
+  GamepadGuid guid{};
+  std::string name;
+  std::array<GamepadBinding, GamepadMaxBindings> bindings{};
+  uint32_t bindingCount = 0u;
+
+  std::span<const GamepadBinding> activeBindings() const { return {bindings.data(), bindingCount}; }
+};
+
+// Parses one gamecontrollerdb.txt line. Returns Unsupported for lines tagged with a different
+// `platform:` and InvalidConfig for malformed lines. Unknown targets (paddles, touchpad) are skipped.
+HostResult<GamepadMapping> parseGamepadMapping(std::string_view line, std::string_view platform = "Linux");
+
+// Compiled-in mappings, in gamecontrollerdb.txt format.
+std::span<const std::string_view> builtinGamepadMappings();
+// GUID column of builtinGamepadMappings(), decoded at compile time.
+std::span<const GamepadGuid> builtinGamepadGuids();
+
+// Positions in builtinGamepadMappings() of the lines for one vendor/product pair (one per bus),
+// found through a compile-time perfect hash. For an unknown pair from a vendor whose pads all share
+// one Linux layout, the lines of a representative pad are returned with `vendorFallback` set.
+struct BuiltinGamepadLines {
+  std::span<const uint16_t> indices;
+  bool vendorFallback = false;
+};
+BuiltinGamepadLines findBuiltinGamepadLines(uint16_t vendor, uint16_t product);
+
+// Mapping lookup used at connect time: imported mappings first, then the compiled-in table. An
+// exact GUID match wins; otherwise bus, vendor and product must match, then vendor and product,
+// then (built-in only) the vendor fallback on the same bus.
+class GamepadMappingDb {
+public:
+  // Imports mappings in gamecontrollerdb.txt format and returns how many were added. Comments,
+  // blank lines and other platforms are skipped. A later import replaces an earlier one for the
+  // same GUID.
+  size_t importMappings(std::string_view text, std::string_view platform = "Linux");
+  std::optional<GamepadMapping> find(const GamepadGuid& guid) const;
+  size_t importedCount() const { return imported_.size(); }
+
+private:
+  std::vector<GamepadMapping> imported_;
+  std::unordered_map<GamepadGuid, size_t, GamepadGuidHash> importedByGuid_;
+  // Vendor/product key -> imported_ indices, for the partial matches.
+  std::unordered_multimap<uint32_t, size_t> importedByProduct_;
+};
+
+} // namespace PrimeHost
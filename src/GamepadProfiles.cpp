@@ -1,9 +1,10 @@
 #include "GamepadProfiles.h"
 
+#include "PerfectHashUtil.h"
+#include "TokenMatchUtil.h"
+
 #include <array>
-#include <cctype>
 #include <cstdint>
-#include <string>
 
 namespace PrimeHost {
 namespace {
@@ -16,6 +17,7 @@ constexpr GamepadProfile kEightBitDoProfile{"8bitdo", true};
 constexpr GamepadProfile kF310Profile{"f310", true};
 constexpr GamepadProfile kF710Profile{"f710", true};
 
+// Name tokens in priority order: the first token found in a device name wins.
 constexpr std::array<GamepadProfile, 7> kProfiles{{
     kXboxProfile,
     kDualShockProfile,
@@ -32,64 +34,100 @@ struct GamepadVendorProfile {
   GamepadProfile profile{};
 };
 
-constexpr std::array<GamepadVendorProfile, 19> kVendorProfiles{{
+constexpr std::array<GamepadVendorProfile, 33> kProductProfiles{{
     {0x045E, 0x028E, kXboxProfile}, // Xbox 360 Controller
+    {0x045E, 0x028F, kXboxProfile}, // Xbox 360 Wireless Controller
+    {0x045E, 0x0719, kXboxProfile}, // Xbox 360 Wireless Receiver
     {0x045E, 0x02D1, kXboxProfile}, // Xbox One Controller
     {0x045E, 0x02DD, kXboxProfile}, // Xbox One Controller (FW 2015)
     {0x045E, 0x02E0, kXboxProfile}, // Xbox One Wireless Controller
     {0x045E, 0x02E3, kXboxProfile}, // Xbox One Elite Controller
     {0x045E, 0x02EA, kXboxProfile}, // Xbox One S Controller
+    {0x045E, 0x0B00, kXboxProfile}, // Xbox Elite Series 2 Controller
     {0x045E, 0x0B12, kXboxProfile}, // Xbox Series X|S Controller
-    {0x045E, 0u, kXboxProfile}, // Microsoft (fallback)
+    {0x054C, 0x0268, kDualShockProfile}, // DualShock 3
     {0x054C, 0x05C4, kDualShockProfile}, // DualShock 4 (CUH-ZCT1x)
     {0x054C, 0x09CC, kDualShockProfile}, // DualShock 4 (CUH-ZCT2x)
+    {0x054C, 0x0BA0, kDualShockProfile}, // DualShock 4 USB Wireless Adaptor
     {0x054C, 0x0CE6, kDualSenseProfile}, // DualSense
-    {0x054C, 0u, kDualShockProfile}, // Sony (fallback)
+    {0x054C, 0x0DF2, kDualSenseProfile}, // DualSense Edge
     {0x057E, 0x2009, kSwitchProProfile}, // Switch Pro Controller
-    {0x057E, 0u, kSwitchProProfile}, // Nintendo (fallback)
     {0x046D, 0xC21D, kF310Profile}, // Logitech F310 (XInput)
+    {0x046D, 0xC21E, kF310Profile}, // Logitech F510 (XInput)
     {0x046D, 0xC21F, kF710Profile}, // Logitech F710 (XInput)
-    {0x046D, 0u, kF310Profile}, // Logitech (fallback)
+    {0x046D, 0xC242, kXboxProfile}, // Logitech ChillStream
     {0x2DC8, 0x6000, kEightBitDoProfile}, // 8BitDo SF30 Pro
-    {0x2DC8, 0u, kEightBitDoProfile}, // 8BitDo (fallback)
+    {0x0738, 0x4716, kXboxProfile}, // Mad Catz Wired Xbox 360 Controller
+    {0x0738, 0x4726, kXboxProfile}, // Mad Catz Xbox 360 Controller
+    {0x1BAD, 0xF016, kXboxProfile}, // Mad Catz Xbox 360 Controller
+    {0x0E6F, 0x0213, kXboxProfile}, // Afterglow Gamepad for Xbox 360
+    {0x0E6F, 0x02A0, kXboxProfile}, // PDP Xbox One Controller
+    {0x0E6F, 0x0139, kXboxProfile}, // Afterglow Prismatic Wired Controller
+    {0x24C6, 0x5300, kXboxProfile}, // PowerA Mini Pro Ex
+    {0x24C6, 0x543A, kXboxProfile}, // PowerA Xbox One Wired Controller
+    {0x0F0D, 0x0067, kXboxProfile}, // HORIPAD ONE
+    {0x1532, 0x0A03, kXboxProfile}, // Razer Wildcat
+    {0x28DE, 0x11FF, kXboxProfile}, // Steam Virtual Gamepad
 }};
 
-} // namespace
+// Used when the product is unknown but the vendor only makes one kind of pad layout.
+constexpr std::array<GamepadVendorProfile, 5> kVendorFallbacks{{
+    {0x045E, 0u, kXboxProfile}, // Microsoft
+    {0x054C, 0u, kDualShockProfile}, // Sony
+    {0x057E, 0u, kSwitchProProfile}, // Nintendo
+    {0x046D, 0u, kF310Profile}, // Logitech
+    {0x2DC8, 0u, kEightBitDoProfile}, // 8BitDo
+}};
 
-std::optional<GamepadProfile> findGamepadProfile(std::string_view name) {
-  if (name.empty()) {
-    return std::nullopt;
+constexpr uint32_t vidpid_key(uint16_t vendorId, uint16_t productId) {
+  return (static_cast<uint32_t>(vendorId) << 16u) | productId;
+}
+
+template <size_t N>
+constexpr PerfectHashTable<N> make_vidpid_hash(const std::array<GamepadVendorProfile, N>& profiles) {
+  std::array<uint32_t, N> keys{};
+  for (size_t i = 0; i < N; ++i) {
+    keys[i] = vidpid_key(profiles[i].vendorId, profiles[i].productId);
   }
-  std::string lower;
-  lower.reserve(name.size());
-  for (char ch : name) {
-    lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+  return PerfectHashTable<N>(keys);
+}
+
+constexpr auto kProductHash = make_vidpid_hash(kProductProfiles);
+constexpr auto kVendorHash = make_vidpid_hash(kVendorFallbacks);
+static_assert(kProductHash.valid(), "duplicate VID/PID in kProductProfiles");
+static_assert(kVendorHash.valid(), "duplicate vendor in kVendorFallbacks");
+
+constexpr std::array<std::string_view, kProfiles.size()> kProfileTokens = [] {
+  std::array<std::string_view, kProfiles.size()> tokens{};
+  for (size_t i = 0; i < kProfiles.size(); ++i) {
+    tokens[i] = kProfiles[i].token;
   }
+  return tokens;
+}();
+constexpr TokenMatcher<kProfileTokens.size(), tokenMatcherStateCount(kProfileTokens)> kProfileMatcher(kProfileTokens);
+static_assert(kProfileMatcher.valid(), "profile tokens must be lowercase letters, digits and spaces");
 
-  for (const auto& profile : kProfiles) {
-    if (lower.find(profile.token) != std::string::npos) {
-      return profile;
-    }
+} // namespace
+
+std::optional<GamepadProfile> findGamepadProfile(std::string_view name) {
+  auto index = kProfileMatcher.firstMatch(name);
+  if (!index) {
+    return std::nullopt;
   }
-  return std::nullopt;
+  return kProfiles[*index];
 }
 
 std::optional<GamepadProfile> findGamepadProfile(uint16_t vendorId,
                                                  uint16_t productId,
                                                  std::string_view name) {
   if (vendorId != 0u) {
-    for (const auto& vendorProfile : kVendorProfiles) {
-      if (vendorProfile.vendorId != vendorId || vendorProfile.productId == 0u) {
-        continue;
-      }
-      if (vendorProfile.productId == productId) {
-        return vendorProfile.profile;
+    if (productId != 0u) {
+      if (auto index = kProductHash.find(vidpid_key(vendorId, productId))) {
+        return kProductProfiles[*index].profile;
       }
     }
-    for (const auto& vendorProfile : kVendorProfiles) {
-      if (vendorProfile.vendorId == vendorId && vendorProfile.productId == 0u) {
-        return vendorProfile.profile;
-      }
+    if (auto index = kVendorHash.find(vidpid_key(vendorId, 0u))) {
+      return kVendorFallbacks[*index].profile;
     }
   }
   return findGamepadProfile(name);
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PRIMEHOST_GAMEPAD_SSE 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRIMEHOST_GAMEPAD_NEON 1
+#endif
+
+namespace PrimeHost {
+
+inline HostStatus validateGamepadInputConfig(const GamepadInputConfig& config) {
+  auto unit = [](float value) { return std::isfinite(value) && value >= 0.0f && value < 1.0f; };
+  if (!unit(config.stickDeadzone) || !unit(config.stickOuterDeadzone) || !unit(config.triggerDeadzone) ||
+      config.stickDeadzone + config.stickOuterDeadzone >= 1.0f) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (!std::isfinite(config.responseExpo) || config.responseExpo < 0.0f || config.responseExpo > 1.0f) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (!std::isfinite(config.axisEventThreshold) || config.axisEventThreshold < 0.0f) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return {};
+}
+
+namespace detail {
+
+// The six axes are processed as four lanes: left stick, right stick, left trigger, right trigger.
+// Triggers are one-dimensional sticks with y = 0 and no outer deadzone.
+struct GamepadResponseLanes {
+  float x[4];
+  float y[4];
+  float deadzone[4];
+  float span[4];
+};
+
+inline GamepadResponseLanes gamepadResponseLanes(const float* raw, const GamepadInputConfig& config) {
+  const float stickSpan = 1.0f - config.stickDeadzone - config.stickOuterDeadzone;
+  const float triggerSpan = 1.0f - config.triggerDeadzone;
+  return GamepadResponseLanes{
+      {raw[0], raw[2], raw[4], raw[5]},
+      {raw[1], raw[3], 0.0f, 0.0f},
+      {config.stickDeadzone, config.stickDeadzone, config.triggerDeadzone, config.triggerDeadzone},
+      {stickSpan, stickSpan, triggerSpan, triggerSpan},
+  };
+}
+
+inline void storeGamepadResponseLanes(const float* x, const float* y, float* out) {
+  out[0] = x[0];
+  out[1] = y[0];
+  out[2] = x[1];
+  out[3] = y[1];
+  out[4] = x[2];
+  out[5] = x[3];
+}
+
+} // namespace detail
+
+// Reference path for applyGamepadResponse.
+inline void applyGamepadResponseScalar(const float* raw, float* out, const GamepadInputConfig& config) {
+  const detail::GamepadResponseLanes lanes = detail::gamepadResponseLanes(raw, config);
+  const float expo = config.responseExpo;
+  float x[4];
+  float y[4];
+  for (int lane = 0; lane < 4; ++lane) {
+    const float magnitude = std::sqrt(lanes.x[lane] * lanes.x[lane] + lanes.y[lane] * lanes.y[lane]);
+    const float t = std::clamp((magnitude - lanes.deadzone[lane]) / lanes.span[lane], 0.0f, 1.0f);
+    const float curved = t * (1.0f - expo) + t * t * t * expo;
+    const float scale = curved / std::max(magnitude, 1e-6f);
+    x[lane] = lanes.x[lane] * scale;
+    y[lane] = lanes.y[lane] * scale;
+  }
+  detail::storeGamepadResponseLanes(x, y, out);
+}
+
+// Radial deadzone and response curve over all six axes (GamepadAxisId order) in one pass. Raw
+// values must already be clamped to their axis range and the config validated. Stick direction is
+// preserved and the processed magnitude never exceeds 1.
+inline void applyGamepadResponse(const float* raw, float* out, const GamepadInputConfig& config) {
+#if defined(PRIMEHOST_GAMEPAD_SSE)
+  const detail::GamepadResponseLanes lanes = detail::gamepadResponseLanes(raw, config);
+  const __m128 x = _mm_loadu_ps(lanes.x);
+  const __m128 y = _mm_loadu_ps(lanes.y);
+  const __m128 magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+  __m128 t = _mm_div_ps(_mm_sub_ps(magnitude, _mm_loadu_ps(lanes.deadzone)), _mm_loadu_ps(lanes.span));
+  t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  const __m128 expo = _mm_set1_ps(config.responseExpo);
+  const __m128 cubic = _mm_mul_ps(_mm_mul_ps(t, t), _mm_mul_ps(t, expo));
+  const __m128 curved = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_set1_ps(1.0f), expo)), cubic);
+  const __m128 scale = _mm_div_ps(curved, _mm_max_ps(magnitude, _mm_set1_ps(1e-6f)));
+  float outX[4];
+  float outY[4];
+  _mm_storeu_ps(outX, _mm_mul_ps(x, scale));
+  _mm_storeu_ps(outY, _mm_mul_ps(y, scale));
+  detail::storeGamepadResponseLanes(outX, outY, out);
+#elif defined(PRIMEHOST_GAMEPAD_NEON)
+  const detail::GamepadResponseLanes lanes = detail::gamepadResponseLanes(raw, config);
+  const float32x4_t x = vld1q_f32(lanes.x);
+  const float32x4_t y = vld1q_f32(lanes.y);
+  const float32x4_t magnitude = vsqrtq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)));
+  float32x4_t t = vdivq_f32(vsubq_f32(magnitude, vld1q_f32(lanes.deadzone)), vld1q_f32(lanes.span));
+  t = vminq_f32(vmaxq_f32(t, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+  const float32x4_t expo = vdupq_n_f32(config.responseExpo);
+  const float32x4_t cubic = vmulq_f32(vmulq_f32(t, t), vmulq_f32(t, expo));
+  const float32x4_t curved = vaddq_f32(vmulq_f32(t, vsubq_f32(vdupq_n_f32(1.0f), expo)), cubic);
+  const float32x4_t scale = vdivq_f32(curved, vmaxq_f32(magnitude, vdupq_n_f32(1e-6f)));
+  float outX[4];
+  float outY[4];
+  vst1q_f32(outX, vmulq_f32(x, scale));
+  vst1q_f32(outY, vmulq_f32(y, scale));
+  detail::storeGamepadResponseLanes(outX, outY, out);
+#else
+  applyGamepadResponseScalar(raw, out, config);
+#endif
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include "GamepadResponse.h"
+#include "PlatformInputUtil.h"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace PrimeHost {
+
+// Per-device gamepad state with one writer (the input thread) and any number of readers. The
+// writer keeps a private working copy and publishes it into the older of two seqlock-protected
+// slots, so readers copy the latest state without locks and only retry if they race two
+// consecutive publishes.
+class GamepadStateBlock {
+public:
+  explicit GamepadStateBlock(uint32_t deviceId) {
+    working_.deviceId = deviceId;
+    publish();
+  }
+
+  GamepadStateBlock(const GamepadStateBlock&) = delete;
+  GamepadStateBlock& operator=(const GamepadStateBlock&) = delete;
+
+  // Writer side.
+  void setButton(uint32_t controlId,
+                 bool pressed,
+                 std::optional<float> value,
+                 std::chrono::steady_clock::time_point time) {
+    if (controlId >= GamepadButtonCount) {
+      return;
+    }
+    const uint32_t bit = 1u << controlId;
+    working_.buttons = pressed ? (working_.buttons | bit) : (working_.buttons & ~bit);
+    working_.buttonValues[controlId] = value.value_or(pressed ? 1.0f : 0.0f);
+    working_.time = time;
+    publish();
+  }
+
+  // Updates one raw axis and publishes the reprocessed state. Returns a mask of the axes whose
+  // processed value should be reported as an event: any change with a zero threshold, otherwise a
+  // move of at least `axisEventThreshold` since the last report or a return to rest or full scale.
+  uint32_t setAxis(uint32_t controlId,
+                   float value,
+                   const GamepadInputConfig& config,
+                   std::chrono::steady_clock::time_point time) {
+    if (controlId >= GamepadAxisCount) {
+      return 0u;
+    }
+    working_.rawAxes[controlId] = clampGamepadAxisValue(controlId, value);
+    working_.time = time;
+    applyGamepadResponse(working_.rawAxes.data(), working_.axes.data(), config);
+    publish();
+
+    uint32_t report = 0u;
+    for (uint32_t axis = 0; axis < GamepadAxisCount; ++axis) {
+      const float current = working_.axes[axis];
+      const float previous = reported_[axis];
+      if (current == previous) {
+        continue;
+      }
+      const bool endpoint = current == 0.0f || std::abs(current) == 1.0f;
+      if (config.axisEventThreshold <= 0.0f || endpoint ||
+          std::abs(current - previous) >= config.axisEventThreshold) {
+        reported_[axis] = current;
+        report |= 1u << axis;
+      }
+    }
+    return report;
+  }
+
+  // Reprocesses the current raw axes, e.g. after the deadzone settings change.
+  void applyConfig(const GamepadInputConfig& config) {
+    applyGamepadResponse(working_.rawAxes.data(), working_.axes.data(), config);
+    reported_ = working_.axes;
+    publish();
+  }
+
+  // Writer-side view of the latest state.
+  const GamepadState& current() const { return working_; }
+
+  // Reader side; safe from any thread.
+  GamepadState snapshot() const {
+    std::array<uint64_t, Words> words{};
+    for (;;) {
+      const Slot& slot = slots_[published_.load(std::memory_order_acquire)];
+      const uint64_t before = slot.version.load(std::memory_order_acquire);
+      if ((before & 1u) != 0u) {
+        continue;
+      }
+      for (size_t i = 0; i < Words; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.version.load(std::memory_order_relaxed) == before) {
+        break;
+      }
+    }
+    // GamepadState has member initializers, so it is trivially copyable but not trivial.
+    GamepadState state;
+    std::memcpy(static_cast<void*>(&state), words.data(), sizeof(GamepadState));
+    return state;
+  }
+
+private:
+  static_assert(std::is_trivially_copyable_v<GamepadState>);
+  static constexpr size_t Words = (sizeof(GamepadState) + sizeof(uint64_t) - 1u) / sizeof(uint64_t);
+
+  struct Slot {
+    std::atomic<uint64_t> version{0u};
+    std::array<std::atomic<uint64_t>, Words> words{};
+  };
+
+  void publish() {
+    ++working_.sequence;
+    std::array<uint64_t, Words> words{};
+    std::memcpy(words.data(), &working_, sizeof(GamepadState));
+
+    const uint32_t next = published_.load(std::memory_order_relaxed) ^ 1u;
+    Slot& slot = slots_[next];
+    const uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < Words; ++i) {
+      slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store(version + 2u, std::memory_order_release);
+    published_.store(next, std::memory_order_release);
+  }
+
+  GamepadState working_{};
+  std::array<float, GamepadAxisCount> reported_{};
+  std::array<Slot, 2> slots_{};
+  std::atomic<uint32_t> published_{0u};
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,746 @@
+#include "PrimeHost/ImageEncode.h"
+
+#include "ParallelFor.h"
+#include "SizeUtil.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace PrimeHost {
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "image encoder loads pixels little-endian");
+
+// PNG rows are filtered and deflated in independent bands of about this many bytes. Each band is
+// its own IDAT chunk and ends on a byte boundary, so bands compress in parallel and concatenate
+// into one zlib stream. The band size depends only on the image, so output is thread-count stable.
+constexpr size_t PngBandTargetBytes = 1u << 20u;
+constexpr size_t StoredBlockMax = 65535u;
+constexpr size_t PngChunkOverhead = 12u;
+constexpr size_t PngHeaderBytes = 8u + PngChunkOverhead + 13u;
+constexpr size_t PngTrailerBytes = (PngChunkOverhead + 4u) + PngChunkOverhead;
+constexpr std::array<uint8_t, 8> PngSignature{0x89u, 'P', 'N', 'G', 0x0Du, 0x0Au, 0x1Au, 0x0Au};
+constexpr std::array<uint8_t, 2> ZlibHeader{0x78u, 0x01u};
+constexpr size_t QoiHeaderBytes = 14u;
+constexpr std::array<uint8_t, 8> QoiEnd{0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u};
+
+uint32_t load32(const uint8_t* data) {
+  uint32_t value = 0u;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t load64(const uint8_t* data) {
+  uint64_t value = 0u;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void store_be32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24u);
+  out[1] = static_cast<uint8_t>(value >> 16u);
+  out[2] = static_cast<uint8_t>(value >> 8u);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+// CRC-32 with the PNG/zlib polynomial, eight bytes per step.
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr CrcTables make_crc_tables() {
+  CrcTables tables{};
+  for (uint32_t n = 0; n < 256u; ++n) {
+    uint32_t c = n;
+    for (int k = 0; k < 8; ++k) {
+      c = (c & 1u) != 0u ? 0xEDB88320u ^ (c >> 1u) : c >> 1u;
+    }
+    tables[0][n] = c;
+  }
+  for (uint32_t n = 0; n < 256u; ++n) {
+    for (size_t k = 1; k < tables.size(); ++k) {
+      tables[k][n] = (tables[k - 1][n] >> 8u) ^ tables[0][tables[k - 1][n] & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+constexpr CrcTables CrcTable = make_crc_tables();
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t size) {
+  const auto& t = CrcTable;
+  while (size >= 8u) {
+    const uint32_t lo = load32(data) ^ crc;
+    const uint32_t hi = load32(data + 4);
+    crc = t[7][lo & 0xFFu] ^ t[6][(lo >> 8u) & 0xFFu] ^ t[5][(lo >> 16u) & 0xFFu] ^ t[4][lo >> 24u] ^
+          t[3][hi & 0xFFu] ^ t[2][(hi >> 8u) & 0xFFu] ^ t[1][(hi >> 16u) & 0xFFu] ^ t[0][hi >> 24u];
+    data += 8;
+    size -= 8u;
+  }
+  while (size-- > 0u) {
+    crc = t[0][(crc ^ *data++) & 0xFFu] ^ (crc >> 8u);
+  }
+  return crc;
+}
+
+constexpr uint32_t AdlerBase = 65521u;
+
+uint32_t adler32_update(uint32_t adler, const uint8_t* data, size_t size) {
+  uint32_t a = adler & 0xFFFFu;
+  uint32_t b = adler >> 16u;
+  while (size > 0u) {
+    // Largest run before b can overflow 32 bits.
+    const size_t chunk = std::min<size_t>(size, 5552u);
+    for (size_t i = 0; i < chunk; ++i) {
+      a += data[i];
+      b += a;
+    }
+    a %= AdlerBase;
+    b %= AdlerBase;
+    data += chunk;
+    size -= chunk;
+  }
+  return a | (b << 16u);
+}
+
+// Adler-32 of two concatenated buffers from their separate checksums (zlib's adler32_combine).
+uint32_t adler32_combine(uint32_t first, uint32_t second, size_t secondSize) {
+  const uint32_t rem = static_cast<uint32_t>(secondSize % AdlerBase);
+  uint32_t sum1 = first & 0xFFFFu;
+  uint32_t sum2 = static_cast<uint32_t>((static_cast<uint64_t>(rem) * sum1) % AdlerBase);
+  sum1 += (second & 0xFFFFu) + AdlerBase - 1u;
+  sum2 += (first >> 16u) + (second >> 16u) + AdlerBase - rem;
+  if (sum1 >= AdlerBase) {
+    sum1 -= AdlerBase;
+  }
+  if (sum1 >= AdlerBase) {
+    sum1 -= AdlerBase;
+  }
+  if (sum2 >= (AdlerBase << 1u)) {
+    sum2 -= (AdlerBase << 1u);
+  }
+  if (sum2 >= AdlerBase) {
+    sum2 -= AdlerBase;
+  }
+  return sum1 | (sum2 << 16u);
+}
+
+// Deflate fixed Huffman codes, bit-reversed for the LSB-first bit writer.
+struct HuffmanCode {
+  uint32_t bits = 0u;
+  uint32_t length = 0u;
+};
+
+constexpr uint32_t reverse_bits(uint32_t value, uint32_t count) {
+  uint32_t result = 0u;
+  for (uint32_t i = 0; i < count; ++i) {
+    result = (result << 1u) | ((value >> i) & 1u);
+  }
+  return result;
+}
+
+constexpr HuffmanCode fixed_literal_code(uint32_t symbol) {
+  if (symbol < 144u) {
+    return {reverse_bits(0x30u + symbol, 8u), 8u};
+  }
+  if (symbol < 256u) {
+    return {reverse_bits(0x190u + symbol - 144u, 9u), 9u};
+  }
+  if (symbol < 280u) {
+    return {reverse_bits(symbol - 256u, 7u), 7u};
+  }
+  return {reverse_bits(0xC0u + symbol - 280u, 8u), 8u};
+}
+
+constexpr std::array<uint16_t, 29> LengthBase{3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                              31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> LengthExtra{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                              2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> DistanceBase{1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                                33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> DistanceExtra{0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr size_t MinMatch = 4u;
+constexpr size_t MaxMatch = 258u;
+constexpr size_t WindowSize = 32768u;
+
+// Literal, length and distance codes with their extra bits folded in, so each is one put().
+struct FixedTables {
+  std::array<HuffmanCode, 256> literals{};
+  std::array<HuffmanCode, MaxMatch + 1u> lengths{};
+  std::array<uint8_t, 512> distanceLow{};
+  std::array<uint8_t, 256> distanceHigh{};
+  HuffmanCode endOfBlock{};
+};
+
+constexpr FixedTables make_fixed_tables() {
+  FixedTables tables{};
+  for (uint32_t symbol = 0; symbol < 256u; ++symbol) {
+    tables.literals[symbol] = fixed_literal_code(symbol);
+  }
+  tables.endOfBlock = fixed_literal_code(256u);
+  for (uint32_t code = 0; code < LengthBase.size(); ++code) {
+    const uint32_t end = code + 1u < LengthBase.size() ? LengthBase[code + 1u] : MaxMatch + 1u;
+    for (uint32_t length = LengthBase[code]; length < end && length <= MaxMatch; ++length) {
+      const HuffmanCode symbol = fixed_literal_code(257u + code);
+      const uint32_t extra = length - LengthBase[code];
+      tables.lengths[length] = {symbol.bits | (extra << symbol.length), symbol.length + LengthExtra[code]};
+    }
+  }
+  // Distance code lookup as in zlib: direct for distances up to 512, by 128-byte steps above.
+  for (uint32_t code = 0; code < DistanceBase.size(); ++code) {
+    const uint32_t end = code + 1u < DistanceBase.size() ? DistanceBase[code + 1u] : WindowSize + 1u;
+    for (uint32_t distance = DistanceBase[code]; distance < end; ++distance) {
+      if (distance <= 512u) {
+        tables.distanceLow[distance - 1u] = static_cast<uint8_t>(code);
+      } else {
+        tables.distanceHigh[(distance - 1u) >> 7u] = static_cast<uint8_t>(code);
+      }
+    }
+  }
+  return tables;
+}
+
+constexpr FixedTables Fixed = make_fixed_tables();
+
+class BitWriter {
+public:
+  BitWriter(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+  void put(uint32_t bits, uint32_t count) {
+    buffer_ |= static_cast<uint64_t>(bits) << count_;
+    count_ += count;
+    if (count_ >= 32u) {
+      if (size_ + 4u > capacity_) {
+        overflow_ = true;
+      } else {
+        const auto word = static_cast<uint32_t>(buffer_);
+        std::memcpy(out_ + size_, &word, sizeof(word));
+        size_ += 4u;
+      }
+      buffer_ >>= 32u;
+      count_ -= 32u;
+    }
+  }
+
+  void alignToByte() {
+    while (count_ > 0u) {
+      if (size_ + 1u > capacity_) {
+        overflow_ = true;
+      } else {
+        out_[size_++] = static_cast<uint8_t>(buffer_);
+      }
+      buffer_ >>= 8u;
+      count_ = count_ > 8u ? count_ - 8u : 0u;
+    }
+  }
+
+  void putByte(uint8_t value) {
+    if (size_ + 1u > capacity_) {
+      overflow_ = true;
+      return;
+    }
+    out_[size_++] = value;
+  }
+
+  // True once the output would have gone past `capacity`.
+  bool overflow() const { return overflow_; }
+  size_t size() const { return size_; }
+
+private:
+  uint8_t* out_ = nullptr;
+  size_t capacity_ = 0u;
+  size_t size_ = 0u;
+  uint64_t buffer_ = 0u;
+  uint32_t count_ = 0u;
+  bool overflow_ = false;
+};
+
+size_t match_length(const uint8_t* a, const uint8_t* b, size_t limit) {
+  size_t length = 0u;
+  while (length + 8u <= limit) {
+    const uint64_t diff = load64(a + length) ^ load64(b + length);
+    if (diff != 0u) {
+      return length + static_cast<size_t>(std::countr_zero(diff)) / 8u;
+    }
+    length += 8u;
+  }
+  while (length < limit && a[length] == b[length]) {
+    ++length;
+  }
+  return length;
+}
+
+size_t stored_deflate_size(size_t size) {
+  return size + 5u * std::max<size_t>(1u, (size + StoredBlockMax - 1u) / StoredBlockMax);
+}
+
+// One fixed-Huffman block over `in` with a single-probe hash (zlib level 1 style). Non-final bands
+// end with an empty stored block so the next band starts byte aligned. Returns 0 when the result
+// would not fit in `capacity`, in which case the band is stored instead.
+constexpr uint32_t HashBits = 15u;
+constexpr uint32_t NoPosition = UINT32_MAX;
+
+size_t deflate_fixed(const uint8_t* in,
+                     size_t size,
+                     bool final,
+                     uint8_t* out,
+                     size_t capacity,
+                     std::vector<uint32_t>& head) {
+  head.assign(size_t{1} << HashBits, NoPosition);
+  BitWriter writer(out, capacity);
+  writer.put(final ? 1u : 0u, 1u);
+  writer.put(1u, 2u);
+  size_t i = 0u;
+  while (i + MinMatch <= size && !writer.overflow()) {
+    const uint32_t value = load32(in + i);
+    const uint32_t hash = (value * 2654435761u) >> (32u - HashBits);
+    const uint32_t candidate = head[hash];
+    head[hash] = static_cast<uint32_t>(i);
+    if (candidate != NoPosition && i - candidate <= WindowSize && load32(in + candidate) == value) {
+      const size_t limit = std::min(MaxMatch, size - i);
+      const size_t length = MinMatch + match_length(in + candidate + MinMatch, in + i + MinMatch, limit - MinMatch);
+      const auto distance = static_cast<uint32_t>(i - candidate);
+      const HuffmanCode& lengthCode = Fixed.lengths[length];
+      writer.put(lengthCode.bits, lengthCode.length);
+      const uint32_t code =
+          distance <= 512u ? Fixed.distanceLow[distance - 1u] : Fixed.distanceHigh[(distance - 1u) >> 7u];
+      writer.put(reverse_bits(code, 5u) | ((distance - DistanceBase[code]) << 5u), 5u + DistanceExtra[code]);
+      i += length;
+      if (i + MinMatch <= size) {
+        // Seed the position just before the next probe so runs keep matching at short distances.
+        const uint32_t last = load32(in + i - 1u);
+        head[(last * 2654435761u) >> (32u - HashBits)] = static_cast<uint32_t>(i - 1u);
+      }
+      continue;
+    }
+    const HuffmanCode& literal = Fixed.literals[in[i]];
+    writer.put(literal.bits, literal.length);
+    ++i;
+  }
+  for (; i < size; ++i) {
+    const HuffmanCode& literal = Fixed.literals[in[i]];
+    writer.put(literal.bits, literal.length);
+  }
+  writer.put(Fixed.endOfBlock.bits, Fixed.endOfBlock.length);
+  if (!final) {
+    writer.put(0u, 3u);
+    writer.alignToByte();
+    writer.putByte(0x00u);
+    writer.putByte(0x00u);
+    writer.putByte(0xFFu);
+    writer.putByte(0xFFu);
+  } else {
+    writer.alignToByte();
+  }
+  return writer.overflow() ? 0u : writer.size();
+}
+
+size_t deflate_stored(const uint8_t* in, size_t size, bool final, uint8_t* out) {
+  size_t written = 0u;
+  size_t offset = 0u;
+  do {
+    const size_t chunk = std::min(size - offset, StoredBlockMax);
+    const bool last = final && offset + chunk == size;
+    out[written++] = last ? 1u : 0u;
+    out[written++] = static_cast<uint8_t>(chunk);
+    out[written++] = static_cast<uint8_t>(chunk >> 8u);
+    out[written++] = static_cast<uint8_t>(~chunk);
+    out[written++] = static_cast<uint8_t>(~chunk >> 8u);
+    std::memcpy(out + written, in + offset, chunk);
+    written += chunk;
+    offset += chunk;
+  } while (offset < size);
+  return written;
+}
+
+HostStatus validate_image(const ImageView& image) {
+  if (image.colorFormat != ColorFormat::B8G8R8A8_UNORM || image.size.width == 0u || image.size.height == 0u ||
+      image.size.width > 0x7FFFFFFFu || image.size.height > 0x7FFFFFFFu) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  auto rowBytes = checkedSizeMul(image.size.width, 4u);
+  auto lastRow = checkedSizeMul(image.stride, image.size.height - 1u);
+  if (!rowBytes || !lastRow || image.stride < *rowBytes || *lastRow > SIZE_MAX - *rowBytes ||
+      image.pixels.size() < *lastRow + *rowBytes) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return {};
+}
+
+struct PngLayout {
+  uint32_t bytesPerPixel = 0u;
+  size_t rowBytes = 0u;
+  uint32_t rowsPerBand = 0u;
+  uint32_t bandCount = 0u;
+};
+
+PngLayout png_layout(ImageSize size, bool alpha) {
+  PngLayout layout{};
+  layout.bytesPerPixel = alpha ? 4u : 3u;
+  layout.rowBytes = 1u + static_cast<size_t>(size.width) * layout.bytesPerPixel;
+  layout.rowsPerBand = static_cast<uint32_t>(
+      std::clamp<size_t>(PngBandTargetBytes / layout.rowBytes, 1u, size.height));
+  layout.bandCount = (size.height + layout.rowsPerBand - 1u) / layout.rowsPerBand;
+  return layout;
+}
+
+// Largest IDAT chunk a band can produce: the stored fallback plus the zlib header on band 0.
+size_t png_band_capacity(const PngLayout& layout, uint32_t rows, bool first) {
+  return PngChunkOverhead + (first ? ZlibHeader.size() : 0u) + stored_deflate_size(rows * layout.rowBytes);
+}
+
+// BGRA to RGBA or RGB.
+void swizzle_row(const uint8_t* src, uint8_t* dst, uint32_t width, bool alpha) {
+  if (alpha) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const uint32_t bgra = load32(src + x * 4u);
+      const uint32_t rgba = (bgra & 0xFF00FF00u) | ((bgra >> 16u) & 0xFFu) | ((bgra & 0xFFu) << 16u);
+      std::memcpy(dst + x * 4u, &rgba, sizeof(rgba));
+    }
+    return;
+  }
+  for (uint32_t x = 0; x < width; ++x) {
+    dst[x * 3u] = src[x * 4u + 2u];
+    dst[x * 3u + 1u] = src[x * 4u + 1u];
+    dst[x * 3u + 2u] = src[x * 4u];
+  }
+}
+
+// Filters one row with Sub or Up, whichever has the smaller sum of absolute residuals (the usual
+// minimum-sum heuristic, restricted to the two filters that pay off on UI content).
+void filter_row(const uint8_t* cur, const uint8_t* prev, size_t bytes, uint32_t bpp, uint8_t* out) {
+  uint32_t subCost = 0u;
+  uint32_t upCost = 0u;
+  for (size_t i = 0; i < bytes; ++i) {
+    const auto sub = static_cast<int8_t>(cur[i] - (i >= bpp ? cur[i - bpp] : 0u));
+    const auto up = static_cast<int8_t>(cur[i] - prev[i]);
+    subCost += static_cast<uint32_t>(sub < 0 ? -sub : sub);
+    upCost += static_cast<uint32_t>(up < 0 ? -up : up);
+  }
+  if (upCost <= subCost) {
+    out[0] = 2u;
+    for (size_t i = 0; i < bytes; ++i) {
+      out[1u + i] = static_cast<uint8_t>(cur[i] - prev[i]);
+    }
+    return;
+  }
+  out[0] = 1u;
+  for (size_t i = 0; i < bpp && i < bytes; ++i) {
+    out[1u + i] = cur[i];
+  }
+  for (size_t i = bpp; i < bytes; ++i) {
+    out[1u + i] = static_cast<uint8_t>(cur[i] - cur[i - bpp]);
+  }
+}
+
+struct PngBand {
+  std::unique_ptr<uint8_t[]> chunk;
+  size_t size = 0u;
+  size_t rawSize = 0u;
+  uint32_t adler = 1u;
+};
+
+void encode_png_band(const ImageView& image,
+                     const ImageEncodeConfig& config,
+                     const PngLayout& layout,
+                     uint32_t band,
+                     PngBand& out) {
+  const uint32_t y0 = band * layout.rowsPerBand;
+  const uint32_t y1 = std::min(y0 + layout.rowsPerBand, image.size.height);
+  const size_t pixelBytes = layout.rowBytes - 1u;
+  const bool alpha = config.alpha;
+
+  out.rawSize = (y1 - y0) * layout.rowBytes;
+  auto filtered = std::make_unique_for_overwrite<uint8_t[]>(out.rawSize);
+  std::vector<uint8_t> prev(pixelBytes, 0u);
+  std::vector<uint8_t> cur(pixelBytes);
+  if (y0 > 0u) {
+    const uint8_t* above = image.pixels.data() + static_cast<size_t>(y0 - 1u) * image.stride;
+    swizzle_row(above, prev.data(), image.size.width, alpha);
+  }
+  for (uint32_t y = y0; y < y1; ++y) {
+    swizzle_row(image.pixels.data() + static_cast<size_t>(y) * image.stride, cur.data(), image.size.width, alpha);
+    filter_row(cur.data(), prev.data(), pixelBytes, layout.bytesPerPixel, filtered.get() + (y - y0) * layout.rowBytes);
+    std::swap(prev, cur);
+  }
+  out.adler = adler32_update(1u, filtered.get(), out.rawSize);
+
+  const bool first = band == 0u;
+  const bool final = band + 1u == layout.bandCount;
+  const size_t capacity = png_band_capacity(layout, y1 - y0, first);
+  out.chunk = std::make_unique_for_overwrite<uint8_t[]>(capacity);
+  uint8_t* data = out.chunk.get() + 8u;
+  size_t size = 0u;
+  if (first) {
+    std::memcpy(data, ZlibHeader.data(), ZlibHeader.size());
+    size += ZlibHeader.size();
+  }
+  const size_t storedSize = stored_deflate_size(out.rawSize);
+  size_t deflated = 0u;
+  if (config.pngCompression == PngCompression::Fast) {
+    std::vector<uint32_t> head;
+    deflated = deflate_fixed(filtered.get(), out.rawSize, final, data + size, storedSize, head);
+  }
+  if (deflated == 0u) {
+    deflated = deflate_stored(filtered.get(), out.rawSize, final, data + size);
+  }
+  size += deflated;
+
+  store_be32(out.chunk.get(), static_cast<uint32_t>(size));
+  std::memcpy(out.chunk.get() + 4u, "IDAT", 4u);
+  const uint32_t crc = crc32_update(0xFFFFFFFFu, out.chunk.get() + 4u, size + 4u) ^ 0xFFFFFFFFu;
+  store_be32(out.chunk.get() + 8u + size, crc);
+  out.size = size + PngChunkOverhead;
+}
+
+size_t write_chunk(uint8_t* out, const char* type, const uint8_t* data, uint32_t size) {
+  store_be32(out, size);
+  std::memcpy(out + 4u, type, 4u);
+  if (size > 0u) {
+    std::memcpy(out + 8u, data, size);
+  }
+  const uint32_t crc = crc32_update(0xFFFFFFFFu, out + 4u, size + 4u) ^ 0xFFFFFFFFu;
+  store_be32(out + 8u + size, crc);
+  return PngChunkOverhead + size;
+}
+
+HostResult<size_t> encode_png(const ImageView& image, std::span<uint8_t> out, const ImageEncodeConfig& config) {
+  const PngLayout layout = png_layout(image.size, config.alpha);
+  std::vector<PngBand> bands(layout.bandCount);
+  parallelFor(layout.bandCount, imageWorkThreads(config.threadCount), config.executor, [&](uint32_t band) {
+    encode_png_band(image, config, layout, band, bands[band]);
+  });
+
+  size_t total = PngHeaderBytes + PngTrailerBytes;
+  for (const PngBand& band : bands) {
+    total += band.size;
+  }
+  if (total > out.size()) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+
+  uint8_t* cursor = out.data();
+  std::memcpy(cursor, PngSignature.data(), PngSignature.size());
+  cursor += PngSignature.size();
+  std::array<uint8_t, 13> header{};
+  store_be32(header.data(), image.size.width);
+  store_be32(header.data() + 4u, image.size.height);
+  header[8] = 8u;
+  header[9] = config.alpha ? 6u : 2u;
+  cursor += write_chunk(cursor, "IHDR", header.data(), static_cast<uint32_t>(header.size()));
+
+  uint32_t adler = 1u;
+  for (const PngBand& band : bands) {
+    std::memcpy(cursor, band.chunk.get(), band.size);
+    cursor += band.size;
+    adler = adler32_combine(adler, band.adler, band.rawSize);
+  }
+  std::array<uint8_t, 4> trailer{};
+  store_be32(trailer.data(), adler);
+  cursor += write_chunk(cursor, "IDAT", trailer.data(), static_cast<uint32_t>(trailer.size()));
+  cursor += write_chunk(cursor, "IEND", nullptr, 0u);
+  return static_cast<size_t>(cursor - out.data());
+}
+
+// QOI is one stateful stream, so it is encoded on the calling thread; it is already several times
+// faster than PNG per core.
+HostResult<size_t> encode_qoi(const ImageView& image, std::span<uint8_t> out, const ImageEncodeConfig& config) {
+  auto bound = maxEncodedImageSize(image.size, config);
+  if (!bound) {
+    return std::unexpected(bound.error());
+  }
+  if (out.size() < *bound) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+  uint8_t* p = out.data();
+  std::memcpy(p, "qoif", 4u);
+  store_be32(p + 4u, image.size.width);
+  store_be32(p + 8u, image.size.height);
+  p[12] = config.alpha ? 4u : 3u;
+  p[13] = 0u;
+  p += QoiHeaderBytes;
+
+  struct Rgba {
+    uint8_t r = 0u;
+    uint8_t g = 0u;
+    uint8_t b = 0u;
+    uint8_t a = 255u;
+    bool operator==(const Rgba&) const = default;
+  };
+  std::array<Rgba, 64> index{};
+  for (Rgba& entry : index) {
+    entry.a = 0u;
+  }
+  Rgba previous{};
+  uint32_t run = 0u;
+  const uint8_t alphaMask = config.alpha ? 0u : 255u;
+  for (uint32_t y = 0; y < image.size.height; ++y) {
+    const uint8_t* row = image.pixels.data() + static_cast<size_t>(y) * image.stride;
+    for (uint32_t x = 0; x < image.size.width; ++x) {
+      const uint8_t* src = row + x * 4u;
+      const Rgba px{src[2], src[1], src[0], static_cast<uint8_t>(src[3] | alphaMask)};
+      if (px == previous) {
+        ++run;
+        if (run == 62u) {
+          *p++ = static_cast<uint8_t>(0xC0u | (run - 1u));
+          run = 0u;
+        }
+        continue;
+      }
+      if (run > 0u) {
+        *p++ = static_cast<uint8_t>(0xC0u | (run - 1u));
+        run = 0u;
+      }
+      const uint32_t slot = (px.r * 3u + px.g * 5u + px.b * 7u + px.a * 11u) % 64u;
+      if (index[slot] == px) {
+        *p++ = static_cast<uint8_t>(slot);
+      } else {
+        index[slot] = px;
+        if (px.a == previous.a) {
+          const auto dr = static_cast<int8_t>(px.r - previous.r);
+          const auto dg = static_cast<int8_t>(px.g - previous.g);
+          const auto db = static_cast<int8_t>(px.b - previous.b);
+          const int drDg = dr - dg;
+          const int dbDg = db - dg;
+          if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            *p++ = static_cast<uint8_t>(0x40u | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+          } else if (dg >= -32 && dg <= 31 && drDg >= -8 && drDg <= 7 && dbDg >= -8 && dbDg <= 7) {
+            *p++ = static_cast<uint8_t>(0x80u | (dg + 32));
+            *p++ = static_cast<uint8_t>(((drDg + 8) << 4) | (dbDg + 8));
+          } else {
+            *p++ = 0xFEu;
+            *p++ = px.r;
+            *p++ = px.g;
+            *p++ = px.b;
+          }
+        } else {
+          *p++ = 0xFFu;
+          *p++ = px.r;
+          *p++ = px.g;
+          *p++ = px.b;
+          *p++ = px.a;
+        }
+      }
+      previous = px;
+    }
+  }
+  if (run > 0u) {
+    *p++ = static_cast<uint8_t>(0xC0u | (run - 1u));
+  }
+  std::memcpy(p, QoiEnd.data(), QoiEnd.size());
+  p += QoiEnd.size();
+  return static_cast<size_t>(p - out.data());
+}
+
+char ascii_lower(char ch) {
+  return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+bool has_extension(Utf8TextView path, Utf8TextView extension) {
+  if (path.size() < extension.size()) {
+    return false;
+  }
+  const Utf8TextView tail = path.substr(path.size() - extension.size());
+  return std::equal(tail.begin(), tail.end(), extension.begin(), [](char a, char b) { return ascii_lower(a) == b; });
+}
+
+} // namespace
+
+HostResult<CapturedImage> captureImage(const ImageView& image) {
+  if (auto status = validate_image(image); !status) {
+    return std::unexpected(status.error());
+  }
+  CapturedImage captured{};
+  captured.size = image.size;
+  captured.colorFormat = image.colorFormat;
+  const size_t rowBytes = static_cast<size_t>(image.size.width) * 4u;
+  captured.pixels.resize(rowBytes * image.size.height);
+  for (uint32_t y = 0; y < image.size.height; ++y) {
+    const uint8_t* row = image.pixels.data() + static_cast<size_t>(y) * image.stride;
+    std::memcpy(captured.pixels.data() + y * rowBytes, row, rowBytes);
+  }
+  return captured;
+}
+
+HostResult<size_t> maxEncodedImageSize(ImageSize size, const ImageEncodeConfig& config) {
+  if (size.width == 0u || size.height == 0u || size.width > 0x7FFFFFFFu || size.height > 0x7FFFFFFFu) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (config.format == ImageFileFormat::Qoi) {
+    auto pixels = checkedSizeMul(size.width, size.height);
+    auto body = pixels ? checkedSizeMul(*pixels, config.alpha ? 5u : 4u) : std::nullopt;
+    if (!body || *body > SIZE_MAX - QoiHeaderBytes - QoiEnd.size()) {
+      return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+    }
+    return QoiHeaderBytes + *body + QoiEnd.size();
+  }
+  auto rowPixels = checkedSizeMul(size.width, config.alpha ? 4u : 3u);
+  auto raw = rowPixels ? checkedSizeMul(*rowPixels + 1u, size.height) : std::nullopt;
+  if (!raw || *raw > SIZE_MAX / 2u) {
+    return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+  }
+  const PngLayout layout = png_layout(size, config.alpha);
+  size_t total = PngHeaderBytes + PngTrailerBytes;
+  for (uint32_t band = 0; band < layout.bandCount; ++band) {
+    const uint32_t rows = std::min(layout.rowsPerBand, size.height - band * layout.rowsPerBand);
+    total += png_band_capacity(layout, rows, band == 0u);
+  }
+  return total;
+}
+
+HostResult<size_t> encodeImage(const ImageView& image, std::span<uint8_t> out, const ImageEncodeConfig& config) {
+  if (auto status = validate_image(image); !status) {
+    return std::unexpected(status.error());
+  }
+  if (config.format == ImageFileFormat::Qoi) {
+    return encode_qoi(image, out, config);
+  }
+  return encode_png(image, out, config);
+}
+
+std::optional<ImageFileFormat> imageFileFormatForPath(Utf8TextView path) {
+  if (has_extension(path, ".png")) {
+    return ImageFileFormat::Png;
+  }
+  if (has_extension(path, ".qoi")) {
+    return ImageFileFormat::Qoi;
+  }
+  return std::nullopt;
+}
+
+HostStatus writeImageFile(const ImageView& image, Utf8TextView path, const ImageEncodeConfig& config) {
+  auto format = imageFileFormatForPath(path);
+  if (!format) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  ImageEncodeConfig resolved = config;
+  resolved.format = *format;
+  if (auto status = validate_image(image); !status) {
+    return status;
+  }
+  auto bound = maxEncodedImageSize(image.size, resolved);
+  if (!bound) {
+    return std::unexpected(bound.error());
+  }
+  auto buffer = std::make_unique_for_overwrite<uint8_t[]>(*bound);
+  auto size = encodeImage(image, std::span<uint8_t>(buffer.get(), *bound), resolved);
+  if (!size) {
+    return std::unexpected(size.error());
+  }
+  std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  file.write(reinterpret_cast<const char*>(buffer.get()), static_cast<std::streamsize>(*size));
+  if (!file) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  return {};
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,361 @@
+#include "PrimeHost/JobSystem.h"
+
+#include "CoreTopology.h"
+#include "WorkStealingDeque.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace PrimeHost {
+namespace {
+
+// Helper slots per worker deque; enough for several nested levels of full-width calls.
+constexpr size_t DequeCapacity = 256u;
+// Spins before a caller waiting on stolen helpers yields (workers) or parks (other threads).
+constexpr uint32_t WaitSpins = 256u;
+
+void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// One parallelFor call, owned by the caller's stack frame. Its helpers are pointers to it in the
+// deques; whichever thread takes one claims indices from `next` until none are left.
+struct ForJob {
+  const std::function<void(uint32_t)>* task = nullptr;
+  uint32_t count = 0u;
+  std::atomic<uint64_t> next{0u};
+  // Helpers handed out and not yet finished. The caller returns only once it reaches zero, so a
+  // helper's final decrement is its last access to the job; wake-ups go through the pool.
+  std::atomic<uint32_t> pending{0u};
+};
+
+class JobSystemImpl;
+
+// The pool and worker index of the current thread, if it is a worker.
+thread_local JobSystemImpl* currentSystem = nullptr;
+thread_local uint32_t currentWorker = 0u;
+
+uint32_t default_worker_count(const CoreTopology& topology, CoreClass coreClass) {
+  uint32_t cores = topology.performanceCores + topology.efficiencyCores;
+  if (topology.hybrid() && coreClass == CoreClass::Performance) {
+    cores = topology.performanceCores;
+  } else if (topology.hybrid() && coreClass == CoreClass::Efficiency) {
+    // The caller usually runs elsewhere, so efficiency workers get every efficiency core.
+    return topology.efficiencyCores;
+  }
+  return cores > 1u ? cores - 1u : 1u;
+}
+
+class JobSystemImpl final : public JobSystem {
+public:
+  JobSystemImpl(const JobSystemConfig& config, CoreTopology topology)
+      : config_(config), topology_(std::move(topology)) {
+    uint32_t count = config.workerCount;
+    if (count == 0u) {
+      count = default_worker_count(topology_, config.coreClass);
+    }
+    workerCount_ = std::clamp(count, 1u, JobMaxWorkers);
+    workers_ = std::make_unique<Worker[]>(workerCount_);
+    for (uint32_t i = 0; i < workerCount_; ++i) {
+      workers_[i].thread = std::thread([this, i]() { runWorker(i); });
+    }
+  }
+
+  ~JobSystemImpl() override {
+    stop_.store(true);
+    wake_.fetch_add(1u);
+    wake_.notify_all();
+    for (uint32_t i = 0; i < workerCount_; ++i) {
+      workers_[i].thread.join();
+    }
+  }
+
+  uint32_t concurrency() const override { return workerCount_ + 1u; }
+
+  void parallelFor(uint32_t count, uint32_t maxConcurrency, const std::function<void(uint32_t)>& task) override {
+    if (count == 0u) {
+      return;
+    }
+    parallelForCalls_.fetch_add(1u, std::memory_order_relaxed);
+    uint32_t helpers = std::min(workerCount_, count - 1u);
+    if (maxConcurrency != 0u) {
+      helpers = std::min(helpers, maxConcurrency - 1u);
+    }
+    ForJob job{};
+    job.task = &task;
+    job.count = count;
+    if (helpers == 0u) {
+      runJob(job);
+      return;
+    }
+
+    job.pending.store(helpers, std::memory_order_relaxed);
+    Worker* self = currentSystem == this ? &workers_[currentWorker] : nullptr;
+    uint32_t offered = 0u;
+    if (self) {
+      while (offered < helpers && self->deque.push(&job)) {
+        ++offered;
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(injectedMutex_);
+      injected_.insert(injected_.end(), helpers, &job);
+      injectedCount_.fetch_add(helpers);
+      offered = helpers;
+    }
+    // Helpers that did not fit in a full deque are simply never offered.
+    uint32_t unclaimed = helpers - offered;
+    if (offered != 0u) {
+      wakeWorkers();
+    }
+
+    runJob(job);
+
+    // Every index is claimed; take back the helpers nobody picked up.
+    if (self) {
+      while (ForJob* item = self->deque.pop()) {
+        if (item != &job) {
+          // Ours were all taken; this one belongs to an enclosing call.
+          self->deque.push(item);
+          break;
+        }
+        ++unclaimed;
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(injectedMutex_);
+      const auto before = injected_.size();
+      std::erase(injected_, &job);
+      const auto removed = static_cast<uint32_t>(before - injected_.size());
+      injectedCount_.fetch_sub(removed);
+      unclaimed += removed;
+    }
+    if (unclaimed != 0u) {
+      job.pending.fetch_sub(unclaimed, std::memory_order_relaxed);
+    }
+    // The rest are running on other threads and finish their last claimed index.
+    if (self) {
+      helpWhileWaiting(job);
+    } else {
+      parkUntilDone(job);
+    }
+  }
+
+  JobSystemStats stats() const override {
+    JobSystemStats stats{};
+    stats.workerCount = workerCount_;
+    stats.placedWorkers = placedWorkers_.load(std::memory_order_relaxed);
+    stats.parallelForCalls = parallelForCalls_.load(std::memory_order_relaxed);
+    stats.tasksExecuted = tasksExecuted_.load(std::memory_order_relaxed);
+    stats.steals = steals_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  struct Worker {
+    WorkStealingDeque<ForJob> deque{DequeCapacity};
+    std::thread thread;
+  };
+
+  void runJob(ForJob& job) {
+    uint64_t ran = 0u;
+    for (uint64_t i = job.next.fetch_add(1u, std::memory_order_relaxed); i < job.count;
+         i = job.next.fetch_add(1u, std::memory_order_relaxed)) {
+      (*job.task)(static_cast<uint32_t>(i));
+      ++ran;
+    }
+    tasksExecuted_.fetch_add(ran, std::memory_order_relaxed);
+  }
+
+  void runHelper(ForJob* job) {
+    runJob(*job);
+    if (job->pending.fetch_sub(1u) == 1u) {
+      helpersDone_.fetch_add(1u);
+      if (parkedCallers_.load() != 0u) {
+        helpersDone_.notify_all();
+      }
+    }
+  }
+
+  // A worker waiting on its stolen helpers runs other queued helpers instead of idling.
+  void helpWhileWaiting(ForJob& job) {
+    uint32_t seed = currentWorker * 2654435761u + 1u;
+    uint32_t spins = 0u;
+    while (job.pending.load(std::memory_order_acquire) != 0u) {
+      if (ForJob* other = findWork(currentWorker, seed)) {
+        runHelper(other);
+        spins = 0u;
+      } else if (spins++ < WaitSpins) {
+        cpu_relax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  // A thread outside the pool has nothing to steal, so it parks until a last helper finishes.
+  void parkUntilDone(ForJob& job) {
+    for (uint32_t spin = 0; spin < WaitSpins; ++spin) {
+      if (job.pending.load(std::memory_order_acquire) == 0u) {
+        return;
+      }
+      cpu_relax();
+    }
+    // Same handshake as the worker sleep: announce, sample the counter, then re-check.
+    parkedCallers_.fetch_add(1u);
+    while (true) {
+      const uint32_t observed = helpersDone_.load();
+      if (job.pending.load() == 0u) {
+        break;
+      }
+      helpersDone_.wait(observed);
+    }
+    parkedCallers_.fetch_sub(1u);
+  }
+
+  ForJob* findWork(uint32_t index, uint32_t& seed) {
+    if (ForJob* job = workers_[index].deque.pop()) {
+      return job;
+    }
+    // Start at a random victim so thieves spread out instead of all hitting worker 0.
+    seed = seed * 1664525u + 1013904223u;
+    const uint32_t start = (seed >> 8u) % workerCount_;
+    for (uint32_t i = 0; i < workerCount_; ++i) {
+      const uint32_t victim = (start + i) % workerCount_;
+      if (victim == index) {
+        continue;
+      }
+      if (ForJob* job = workers_[victim].deque.steal()) {
+        steals_.fetch_add(1u, std::memory_order_relaxed);
+        return job;
+      }
+    }
+    if (injectedCount_.load() != 0u) {
+      std::lock_guard<std::mutex> lock(injectedMutex_);
+      if (!injected_.empty()) {
+        ForJob* job = injected_.front();
+        injected_.pop_front();
+        injectedCount_.fetch_sub(1u);
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  bool hasWork() const {
+    if (injectedCount_.load() != 0u) {
+      return true;
+    }
+    for (uint32_t i = 0; i < workerCount_; ++i) {
+      if (!workers_[i].deque.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void wakeWorkers() {
+    wake_.fetch_add(1u);
+    if (sleepers_.load() != 0u) {
+      wake_.notify_all();
+    }
+  }
+
+  void runWorker(uint32_t index) {
+    currentSystem = this;
+    currentWorker = index;
+    if (placeCurrentThread(topology_, config_.coreClass)) {
+      placedWorkers_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    uint32_t seed = index * 2654435761u + 1u;
+    while (true) {
+      if (ForJob* job = findWork(index, seed)) {
+        runHelper(job);
+        continue;
+      }
+      bool found = false;
+      for (uint32_t spin = 0; spin < config_.spinIterations && !found; ++spin) {
+        cpu_relax();
+        found = hasWork();
+      }
+      if (found) {
+        continue;
+      }
+      // Announce the sleep before the last check, so a parallelFor that pushes after the check
+      // sees a sleeper and notifies.
+      sleepers_.fetch_add(1u);
+      const uint32_t observed = wake_.load();
+      if (!stop_.load() && !hasWork()) {
+        wake_.wait(observed);
+      }
+      sleepers_.fetch_sub(1u);
+      if (stop_.load()) {
+        return;
+      }
+    }
+  }
+
+  JobSystemConfig config_;
+  CoreTopology topology_;
+  uint32_t workerCount_ = 0u;
+  std::unique_ptr<Worker[]> workers_;
+  std::mutex injectedMutex_;
+  // Helpers offered by threads outside the pool.
+  std::deque<ForJob*> injected_;
+  std::atomic<uint32_t> injectedCount_{0u};
+  std::atomic<uint32_t> wake_{0u};
+  std::atomic<uint32_t> sleepers_{0u};
+  // Bumped whenever a job's last helper finishes, for callers parked outside the pool.
+  std::atomic<uint32_t> helpersDone_{0u};
+  std::atomic<uint32_t> parkedCallers_{0u};
+  std::atomic<bool> stop_{false};
+  std::atomic<uint32_t> placedWorkers_{0u};
+  std::atomic<uint64_t> parallelForCalls_{0u};
+  std::atomic<uint64_t> tasksExecuted_{0u};
+  std::atomic<uint64_t> steals_{0u};
+};
+
+std::mutex& default_executor_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::shared_ptr<JobExecutor>& default_executor() {
+  static std::shared_ptr<JobExecutor> executor;
+  return executor;
+}
+
+} // namespace
+
+HostResult<std::shared_ptr<JobSystem>> createJobSystem(const JobSystemConfig& config) {
+  return std::make_shared<JobSystemImpl>(config, queryCoreTopology());
+}
+
+std::shared_ptr<JobExecutor> defaultJobExecutor() {
+  std::lock_guard<std::mutex> lock(default_executor_mutex());
+  std::shared_ptr<JobExecutor>& executor = default_executor();
+  if (!executor) {
+    executor = std::make_shared<JobSystemImpl>(JobSystemConfig{}, queryCoreTopology());
+  }
+  return executor;
+}
+
+void setDefaultJobExecutor(std::shared_ptr<JobExecutor> executor) {
+  std::shared_ptr<JobExecutor> previous;
+  {
+    std::lock_guard<std::mutex> lock(default_executor_mutex());
+    previous = std::exchange(default_executor(), std::move(executor));
+  }
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace PrimeHost {
+
+// Single-writer/single-reader mailbox that always yields the newest value (a triple buffer). The
+// writer fills its back buffer and swaps it into the middle; the reader swaps the middle out only
+// when it holds something new. Both sides are wait-free and each buffer has exactly one owner at a
+// time, so T needs no atomics of its own.
+template <typename T>
+class LatestValue {
+public:
+  // Writer side.
+  void publish(const T& value) {
+    buffers_[back_] = value;
+    const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | FreshBit), std::memory_order_acq_rel);
+    back_ = previous & IndexMask;
+  }
+
+  // Reader side. Returns false, leaving `out` untouched, when nothing was published since the
+  // last call.
+  bool consume(T& out) {
+    if ((middle_.load(std::memory_order_relaxed) & FreshBit) == 0u) {
+      return false;
+    }
+    const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & IndexMask;
+    out = buffers_[front_];
+    return true;
+  }
+
+private:
+  static constexpr uint8_t IndexMask = 0x3u;
+  static constexpr uint8_t FreshBit = 0x4u;
+
+  std::array<T, 3> buffers_{};
+  std::atomic<uint8_t> middle_{1u};
+  uint8_t back_ = 0u;
+  uint8_t front_ = 2u;
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace PrimeHost {
+
+// A file mapped into memory, either read-only or as a growable write target. Writers reserve space
+// ahead of the data (the file is extended with ftruncate and remapped) and truncate() trims the
+// unused tail once the final size is known. POSIX only.
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept { swap(other); }
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { close(); }
+
+  static HostResult<MappedFile> openRead(const std::string& path) {
+    MappedFile file;
+    file.fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file.fd_ < 0) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    struct stat info {};
+    if (::fstat(file.fd_, &info) != 0) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    file.size_ = static_cast<size_t>(info.st_size);
+    if (file.size_ > 0u) {
+      void* data = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, file.fd_, 0);
+      if (data == MAP_FAILED) {
+        return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+      }
+      file.data_ = static_cast<uint8_t*>(data);
+      ::madvise(data, file.size_, MADV_SEQUENTIAL);
+    }
+    return file;
+  }
+
+  // Creates or replaces `path` and maps `capacity` zeroed bytes of it for writing.
+  static HostResult<MappedFile> createWrite(const std::string& path, size_t capacity) {
+    MappedFile file;
+    file.fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file.fd_ < 0) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    file.writable_ = true;
+    auto status = file.reserve(std::max<size_t>(capacity, 1u));
+    if (!status) {
+      return std::unexpected(status.error());
+    }
+    return file;
+  }
+
+  // Grows a writable mapping to at least `capacity` bytes, doubling so appends stay amortized.
+  HostStatus reserve(size_t capacity) {
+    if (!writable_) {
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+    if (capacity <= size_) {
+      return {};
+    }
+    const size_t grown = std::max(capacity, size_ * 2u);
+    if (::ftruncate(fd_, static_cast<off_t>(grown)) != 0) {
+      return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+    }
+    unmap();
+    void* data = ::mmap(nullptr, grown, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    data_ = static_cast<uint8_t*>(data);
+    size_ = grown;
+    return {};
+  }
+
+  // Starts writeback of the first `size` bytes without waiting for it.
+  HostStatus flush(size_t size) {
+    if (!data_ || size == 0u) {
+      return {};
+    }
+    if (::msync(data_, std::min(size, size_), MS_ASYNC) != 0) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    return {};
+  }
+
+  // Sets the final file length; the mapping is released first.
+  HostStatus truncate(size_t size) {
+    if (!writable_) {
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+    unmap();
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    writable_ = false;
+    return {};
+  }
+
+  bool isOpen() const { return fd_ >= 0; }
+  size_t size() const { return size_; }
+  std::span<uint8_t> bytes() { return {data_, data_ ? size_ : 0u}; }
+  std::span<const uint8_t> bytes() const { return {data_, data_ ? size_ : 0u}; }
+
+private:
+  void unmap() {
+    if (data_) {
+      ::munmap(data_, size_);
+      data_ = nullptr;
+    }
+    size_ = 0u;
+  }
+
+  void close() {
+    unmap();
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    writable_ = false;
+  }
+
+  void swap(MappedFile& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(writable_, other.writable_);
+  }
+
+  int fd_ = -1;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0u;
+  bool writable_ = false;
+};
+
+} // namespace PrimeHost
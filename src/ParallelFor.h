@@ -0,0 +1,49 @@
+#pragma once
+
+#include "PrimeHost/JobSystem.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace PrimeHost {
+
+// Upper bound for the default thread count of image-sized work (encoding, diffing); beyond this
+// the passes are memory bound.
+constexpr uint32_t MaxImageWorkThreads = 8u;
+
+// `requested`, or for 0 the hardware thread count capped at MaxImageWorkThreads.
+inline uint32_t imageWorkThreads(uint32_t requested) {
+  if (requested != 0u) {
+    return requested;
+  }
+  return std::max(1u, std::min(std::thread::hardware_concurrency(), MaxImageWorkThreads));
+}
+
+// Runs task(i) for i in [0, count) on up to `threads` threads, the caller included, through
+// `executor` or, when null, the default job executor. Single-threaded runs stay on the caller.
+template <typename Task>
+void parallelFor(uint32_t count, uint32_t threads, JobExecutor* executor, Task&& task) {
+  threads = std::min(threads, count);
+  if (threads <= 1u) {
+    for (uint32_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+  const std::function<void(uint32_t)> run = [&task](uint32_t i) { task(i); };
+  if (executor) {
+    executor->parallelFor(count, threads, run);
+    return;
+  }
+  defaultJobExecutor()->parallelFor(count, threads, run);
+}
+
+template <typename Task>
+void parallelFor(uint32_t count, uint32_t threads, Task&& task) {
+  parallelFor(count, threads, nullptr, std::forward<Task>(task));
+}
+
+} // namespace PrimeHost
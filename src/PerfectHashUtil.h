@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace PrimeHost {
+
+constexpr uint32_t perfectHashMix(uint32_t key, uint32_t seed) {
+  uint32_t h = key ^ (seed * 0x9E3779B9u);
+  h ^= h >> 16u;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13u;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16u;
+  return h;
+}
+
+// Static perfect hash over distinct 32-bit keys, built at compile time with hash-and-displace:
+// keys are grouped into buckets and each bucket, largest first, gets the first seed that sends all
+// of its keys to free slots. Lookup is two hashes and one key compare. valid() is false when the
+// keys contain duplicates, so tables should be checked with static_assert.
+template <size_t N>
+class PerfectHashTable {
+public:
+  static_assert(N > 0u, "PerfectHashTable needs at least one key");
+  static constexpr size_t BucketCount = N / 4u + 1u;
+  static constexpr size_t SlotCount = std::bit_ceil(N + N / 4u + 1u);
+  static constexpr uint32_t EmptySlot = UINT32_MAX;
+  static constexpr uint32_t MaxSeed = 1u << 16u;
+
+  constexpr explicit PerfectHashTable(const std::array<uint32_t, N>& keys) {
+    indices_.fill(EmptySlot);
+
+    std::array<uint32_t, N> bucketOf{};
+    std::array<uint32_t, BucketCount + 1u> bucketStart{};
+    for (size_t i = 0; i < N; ++i) {
+      bucketOf[i] = perfectHashMix(keys[i], 0u) % BucketCount;
+      ++bucketStart[bucketOf[i] + 1u];
+    }
+    size_t largest = 0u;
+    for (size_t b = 0; b < BucketCount; ++b) {
+      largest = bucketStart[b + 1u] > largest ? bucketStart[b + 1u] : largest;
+      bucketStart[b + 1u] += bucketStart[b];
+    }
+    std::array<uint32_t, N> order{};
+    std::array<uint32_t, BucketCount> fill{};
+    for (size_t i = 0; i < N; ++i) {
+      order[bucketStart[bucketOf[i]] + fill[bucketOf[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // Equal keys share a bucket; reject them before the seed search would spin on them.
+    for (size_t b = 0; b < BucketCount; ++b) {
+      for (uint32_t i = bucketStart[b]; i < bucketStart[b + 1u]; ++i) {
+        for (uint32_t j = bucketStart[b]; j < i; ++j) {
+          if (keys[order[i]] == keys[order[j]]) {
+            return;
+          }
+        }
+      }
+    }
+
+    std::array<uint32_t, N> slots{};
+    for (size_t size = largest; size > 0u; --size) {
+      for (size_t b = 0; b < BucketCount; ++b) {
+        const uint32_t begin = bucketStart[b];
+        if (bucketStart[b + 1u] - begin != size) {
+          continue;
+        }
+        uint32_t seed = 1u;
+        for (; seed < MaxSeed; ++seed) {
+          bool placed = true;
+          for (size_t k = 0; k < size && placed; ++k) {
+            slots[k] = perfectHashMix(keys[order[begin + k]], seed) & static_cast<uint32_t>(SlotCount - 1u);
+            placed = indices_[slots[k]] == EmptySlot;
+            for (size_t j = 0; j < k && placed; ++j) {
+              placed = slots[j] != slots[k];
+            }
+          }
+          if (placed) {
+            break;
+          }
+        }
+        if (seed == MaxSeed) {
+          return;
+        }
+        seeds_[b] = seed;
+        for (size_t k = 0; k < size; ++k) {
+          keys_[slots[k]] = keys[order[begin + k]];
+          indices_[slots[k]] = order[begin + k];
+        }
+      }
+    }
+    valid_ = true;
+  }
+
+  constexpr bool valid() const { return valid_; }
+
+  // Position of `key` in the array the table was built from.
+  constexpr std::optional<uint32_t> find(uint32_t key) const {
+    const uint32_t bucket = perfectHashMix(key, 0u) % BucketCount;
+    const uint32_t slot = perfectHashMix(key, seeds_[bucket]) & static_cast<uint32_t>(SlotCount - 1u);
+    if (indices_[slot] == EmptySlot || keys_[slot] != key) {
+      return std::nullopt;
+    }
+    return indices_[slot];
+  }
+
+private:
+  std::array<uint32_t, BucketCount> seeds_{};
+  std::array<uint32_t, SlotCount> keys_{};
+  std::array<uint32_t, SlotCount> indices_{};
+  bool valid_ = false;
+};
+
+} // namespace PrimeHost
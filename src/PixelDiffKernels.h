@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PRIMEHOST_DIFF_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRIMEHOST_DIFF_NEON 1
+#endif
+
+namespace PrimeHost {
+
+// Per-run result of comparing two rows of 4-byte pixels. `first`/`last` index the first and last
+// differing pixel and are only meaningful when `differing` is non-zero.
+struct PixelDiffRun {
+  uint32_t differing = 0u;
+  uint32_t maxDelta = 0u;
+  uint32_t first = 0u;
+  uint32_t last = 0u;
+};
+
+struct PixelDiffParams {
+  // A pixel differs when any compared channel's absolute delta exceeds this.
+  uint8_t threshold = 0u;
+  // Byte mask over one pixel's channels (little-endian); 0x00FFFFFF skips the fourth channel.
+  uint32_t channelMask = 0xFFFFFFFFu;
+  // Written to `diff` for differing pixels; others get their per-channel delta, opaque.
+  uint32_t highlight = 0xFFFF0000u;
+};
+
+inline void notePixelDiff(PixelDiffRun& run, uint32_t index) {
+  if (run.differing == 0u) {
+    run.first = index;
+  }
+  run.last = index;
+  ++run.differing;
+}
+
+inline void diffPixelsScalar(const uint8_t* a,
+                             const uint8_t* b,
+                             uint8_t* diff,
+                             uint32_t begin,
+                             uint32_t count,
+                             const PixelDiffParams& params,
+                             PixelDiffRun& run) {
+  for (uint32_t i = begin; i < count; ++i) {
+    uint32_t delta = 0u;
+    uint32_t over = 0u;
+    for (uint32_t c = 0; c < 4u; ++c) {
+      const int d = static_cast<int>(a[i * 4u + c]) - static_cast<int>(b[i * 4u + c]);
+      const bool compared = ((params.channelMask >> (c * 8u)) & 0xFFu) != 0u;
+      const uint32_t magnitude = compared ? static_cast<uint32_t>(d < 0 ? -d : d) : 0u;
+      delta |= magnitude << (c * 8u);
+      run.maxDelta = std::max(run.maxDelta, magnitude);
+      over |= magnitude > params.threshold ? 1u : 0u;
+    }
+    if (over != 0u) {
+      notePixelDiff(run, i);
+    }
+    if (diff) {
+      const uint32_t value = over != 0u ? params.highlight : (delta | 0xFF000000u);
+      std::memcpy(diff + i * 4u, &value, sizeof(value));
+    }
+  }
+}
+
+// Compares `count` pixels of `a` and `b`, optionally writing the diff visualization to `diff`.
+// Channel order does not matter as long as both inputs share it.
+inline PixelDiffRun diffPixels(const uint8_t* a,
+                               const uint8_t* b,
+                               uint8_t* diff,
+                               uint32_t count,
+                               const PixelDiffParams& params) {
+  PixelDiffRun run{};
+  uint32_t i = 0u;
+#if defined(PRIMEHOST_DIFF_SSE2)
+  const __m128i mask = _mm_set1_epi32(static_cast<int>(params.channelMask));
+  const __m128i threshold = _mm_set1_epi8(static_cast<char>(params.threshold));
+  const __m128i highlight = _mm_set1_epi32(static_cast<int>(params.highlight));
+  const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i maxDelta = zero;
+  for (; i + 4u <= count; i += 4u) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i * 4u));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i * 4u));
+    const __m128i delta = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)), mask);
+    maxDelta = _mm_max_epu8(maxDelta, delta);
+    const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(delta, threshold), zero);
+    const uint32_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(same))) ^ 0xFu;
+    if (bits != 0u) {
+      if (run.differing == 0u) {
+        run.first = i + static_cast<uint32_t>(std::countr_zero(bits));
+      }
+      run.last = i + 31u - static_cast<uint32_t>(std::countl_zero(bits));
+      run.differing += static_cast<uint32_t>(std::popcount(bits));
+    }
+    if (diff) {
+      const __m128i shaded = _mm_or_si128(_mm_and_si128(same, _mm_or_si128(delta, opaque)),
+                                          _mm_andnot_si128(same, highlight));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(diff + i * 4u), shaded);
+    }
+  }
+  alignas(16) uint8_t lanes[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(lanes), maxDelta);
+  run.maxDelta = *std::max_element(lanes, lanes + 16);
+#elif defined(PRIMEHOST_DIFF_NEON)
+  const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(params.channelMask));
+  const uint8x16_t threshold = vdupq_n_u8(params.threshold);
+  const uint32x4_t highlight = vdupq_n_u32(params.highlight);
+  const uint32x4_t opaque = vdupq_n_u32(0xFF000000u);
+  uint8x16_t maxDelta = vdupq_n_u8(0u);
+  for (; i + 4u <= count; i += 4u) {
+    const uint8x16_t delta = vandq_u8(vabdq_u8(vld1q_u8(a + i * 4u), vld1q_u8(b + i * 4u)), mask);
+    maxDelta = vmaxq_u8(maxDelta, delta);
+    const uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(delta, threshold));
+    const uint32x4_t differs = vtstq_u32(over, over);
+    const uint64_t bits = vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(differs)), 0);
+    if (bits != 0u) {
+      if (run.differing == 0u) {
+        run.first = i + static_cast<uint32_t>(std::countr_zero(bits)) / 16u;
+      }
+      run.last = i + (63u - static_cast<uint32_t>(std::countl_zero(bits))) / 16u;
+      run.differing += static_cast<uint32_t>(std::popcount(bits)) / 16u;
+    }
+    if (diff) {
+      const uint32x4_t shaded = vbslq_u32(differs, highlight, vorrq_u32(vreinterpretq_u32_u8(delta), opaque));
+      vst1q_u8(diff + i * 4u, vreinterpretq_u8_u32(shaded));
+    }
+  }
+  run.maxDelta = vmaxvq_u8(maxDelta);
+#endif
+  diffPixelsScalar(a, b, diff, i, count, params, run);
+  return run;
+}
+
+} // namespace PrimeHost
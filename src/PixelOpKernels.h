@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PRIMEHOST_PIXEL_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRIMEHOST_PIXEL_NEON 1
+#endif
+
+namespace PrimeHost {
+
+// Row kernels over 4-byte pixels with alpha in the fourth byte (BGRA8 or RGBA8). Rows need no
+// particular alignment. Each SIMD kernel has a scalar twin that produces identical bytes.
+
+inline void fillPixelsScalar(uint8_t* row, uint32_t begin, uint32_t count, uint32_t value) {
+  for (uint32_t i = begin; i < count; ++i) {
+    std::memcpy(row + static_cast<size_t>(i) * 4u, &value, sizeof(value));
+  }
+}
+
+inline void fillPixels(uint8_t* row, uint32_t count, uint32_t value) {
+#if defined(PRIMEHOST_PIXEL_SSE2) || defined(PRIMEHOST_PIXEL_NEON)
+  if (count >= 4u) {
+#if defined(PRIMEHOST_PIXEL_SSE2)
+    const __m128i v = _mm_set1_epi32(static_cast<int>(value));
+    auto store = [&](uint32_t i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + static_cast<size_t>(i) * 4u), v);
+    };
+#else
+    const uint8x16_t v = vreinterpretq_u8_u32(vdupq_n_u32(value));
+    auto store = [&](uint32_t i) { vst1q_u8(row + static_cast<size_t>(i) * 4u, v); };
+#endif
+    for (uint32_t i = 0u; i + 4u <= count; i += 4u) {
+      store(i);
+    }
+    // The tail rewrites up to three pixels of the last full vector.
+    store(count - 4u);
+    return;
+  }
+#endif
+  fillPixelsScalar(row, 0u, count, value);
+}
+
+// Rounded x / 255 for x in [0, 255 * 255].
+inline uint32_t divide255(uint32_t x) {
+  x += 128u;
+  return (x + (x >> 8u)) >> 8u;
+}
+
+// Premultiplied source-over: dst = src + dst * (255 - src.a) / 255, saturating.
+inline void blendPixelsScalar(uint8_t* dst, const uint8_t* src, uint32_t begin, uint32_t count) {
+  for (uint32_t i = begin; i < count; ++i) {
+    uint8_t* d = dst + static_cast<size_t>(i) * 4u;
+    const uint8_t* s = src + static_cast<size_t>(i) * 4u;
+    const uint32_t inverse = 255u - s[3];
+    for (uint32_t c = 0; c < 4u; ++c) {
+      d[c] = static_cast<uint8_t>(std::min(255u, s[c] + divide255(d[c] * inverse)));
+    }
+  }
+}
+
+inline void blendPixels(uint8_t* dst, const uint8_t* src, uint32_t count) {
+  uint32_t i = 0u;
+#if defined(PRIMEHOST_PIXEL_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  const __m128i ones = _mm_set1_epi16(255);
+  const __m128i half = _mm_set1_epi16(128);
+  auto scale = [&](__m128i d, __m128i s) {
+    // Two pixels per register as 16-bit lanes; broadcast each pixel's alpha across its lanes.
+    __m128i inverse = _mm_sub_epi16(ones, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF));
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(d, inverse), half);
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+  };
+  for (; i + 4u <= count; i += 4u) {
+    uint8_t* d = dst + static_cast<size_t>(i) * 4u;
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + static_cast<size_t>(i) * 4u));
+    const int alpha = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask));
+    if (alpha == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d), s);
+      continue;
+    }
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d));
+    const __m128i lo = scale(_mm_unpacklo_epi8(v, zero), _mm_unpacklo_epi8(s, zero));
+    const __m128i hi = scale(_mm_unpackhi_epi8(v, zero), _mm_unpackhi_epi8(s, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+  }
+#elif defined(PRIMEHOST_PIXEL_NEON)
+  for (; i + 8u <= count; i += 8u) {
+    uint8_t* d = dst + static_cast<size_t>(i) * 4u;
+    const uint8x8x4_t s = vld4_u8(src + static_cast<size_t>(i) * 4u);
+    uint8x8x4_t v = vld4_u8(d);
+    const uint8x8_t inverse = vmvn_u8(s.val[3]);
+    for (int c = 0; c < 4; ++c) {
+      const uint16x8_t t = vmull_u8(v.val[c], inverse);
+      v.val[c] = vqadd_u8(s.val[c], vraddhn_u16(t, vrshrq_n_u16(t, 8)));
+    }
+    vst4_u8(d, v);
+  }
+#endif
+  blendPixelsScalar(dst, src, i, count);
+}
+
+// Horizontal sample for bilinear scaling: pixel `x0` and its right neighbour, with the neighbour
+// weighted `fx` out of 256.
+struct BilinearTap {
+  uint32_t x0 = 0u;
+  uint32_t fx = 0u;
+};
+
+// Bilinear row from source rows `top` and `bottom` (bottom weighted `fy` of 256). Every tap reads
+// x0 and x0 + 1, so the source must be at least two pixels wide.
+inline void bilinearRowScalar(uint8_t* dst,
+                              const uint8_t* top,
+                              const uint8_t* bottom,
+                              const BilinearTap* taps,
+                              uint32_t begin,
+                              uint32_t count,
+                              uint32_t fy) {
+  for (uint32_t i = begin; i < count; ++i) {
+    const uint8_t* t = top + static_cast<size_t>(taps[i].x0) * 4u;
+    const uint8_t* b = bottom + static_cast<size_t>(taps[i].x0) * 4u;
+    const uint32_t fx = taps[i].fx;
+    for (uint32_t c = 0; c < 4u; ++c) {
+      const uint32_t left = (t[c] * (256u - fy) + b[c] * fy + 128u) >> 8u;
+      const uint32_t right = (t[c + 4u] * (256u - fy) + b[c + 4u] * fy + 128u) >> 8u;
+      dst[static_cast<size_t>(i) * 4u + c] = static_cast<uint8_t>((left * (256u - fx) + right * fx + 128u) >> 8u);
+    }
+  }
+}
+
+inline void bilinearRow(uint8_t* dst,
+                        const uint8_t* top,
+                        const uint8_t* bottom,
+                        const BilinearTap* taps,
+                        uint32_t count,
+                        uint32_t fy) {
+  uint32_t i = 0u;
+#if defined(PRIMEHOST_PIXEL_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i half = _mm_set1_epi16(128);
+  const __m128i topWeight = _mm_set1_epi16(static_cast<short>(256u - fy));
+  const __m128i bottomWeight = _mm_set1_epi16(static_cast<short>(fy));
+  for (; i < count; ++i) {
+    const size_t offset = static_cast<size_t>(taps[i].x0) * 4u;
+    // Lanes 0-3 hold the left pixel, 4-7 the right one. Products stay within 255 * 256.
+    const __m128i t = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(top + offset)), zero);
+    const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bottom + offset)), zero);
+    const __m128i column = _mm_srli_epi16(
+        _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(t, topWeight), _mm_mullo_epi16(b, bottomWeight)), half), 8);
+    const uint32_t fx = taps[i].fx;
+    const __m128i weights = _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<short>(256u - fx)),
+                                               _mm_set1_epi16(static_cast<short>(fx)));
+    const __m128i weighted = _mm_mullo_epi16(column, weights);
+    const __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(weighted, _mm_srli_si128(weighted, 8)), half), 8);
+    const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(sum, zero));
+    std::memcpy(dst + static_cast<size_t>(i) * 4u, &packed, sizeof(packed));
+  }
+#endif
+  bilinearRowScalar(dst, top, bottom, taps, i, count, fy);
+}
+
+} // namespace PrimeHost
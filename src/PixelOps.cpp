@@ -0,0 +1,210 @@
+#include "PrimeHost/PixelOps.h"
+
+#include "ParallelFor.h"
+#include "PixelOpKernels.h"
+#include "SizeUtil.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace PrimeHost {
+namespace {
+
+// Below this many pixels the work is shorter than waking threads for it.
+constexpr uint64_t MinParallelPixels = 256u * 1024u;
+
+struct PixelSurface {
+  ImageSize size;
+  uint32_t stride = 0u;
+  ColorFormat colorFormat = ColorFormat::B8G8R8A8_UNORM;
+  size_t bytes = 0u;
+
+  bool valid() const {
+    if (size.width == 0u || size.height == 0u || colorFormat != ColorFormat::B8G8R8A8_UNORM) {
+      return false;
+    }
+    auto rowBytes = checkedSizeMul(size.width, 4u);
+    auto lastRow = checkedSizeMul(stride, size.height - 1u);
+    return rowBytes && lastRow && stride >= *rowBytes && *lastRow <= SIZE_MAX - *rowBytes &&
+           bytes >= *lastRow + *rowBytes;
+  }
+};
+
+PixelSurface surface_of(const FrameBuffer& buffer) {
+  return PixelSurface{buffer.size, buffer.stride, buffer.colorFormat, buffer.pixels.size()};
+}
+
+PixelSurface surface_of(const ImageView& image) {
+  return PixelSurface{image.size, image.stride, image.colorFormat, image.pixels.size()};
+}
+
+// Intersection of a rect with [0, width) x [0, height).
+struct Clip {
+  uint32_t x0 = 0u;
+  uint32_t y0 = 0u;
+  uint32_t x1 = 0u;
+  uint32_t y1 = 0u;
+
+  bool empty() const { return x1 <= x0 || y1 <= y0; }
+  uint32_t width() const { return x1 - x0; }
+  uint32_t height() const { return y1 - y0; }
+};
+
+Clip clip_rect(const PixelRect& rect, ImageSize size) {
+  const int64_t x0 = std::max<int64_t>(rect.x, 0);
+  const int64_t y0 = std::max<int64_t>(rect.y, 0);
+  const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(rect.x) + rect.width, size.width);
+  const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(rect.y) + rect.height, size.height);
+  if (x1 <= x0 || y1 <= y0) {
+    return Clip{};
+  }
+  return Clip{static_cast<uint32_t>(x0), static_cast<uint32_t>(y0), static_cast<uint32_t>(x1),
+              static_cast<uint32_t>(y1)};
+}
+
+uint32_t pixel_value(PixelColor color) {
+  const uint8_t bytes[4] = {color.b, color.g, color.r, color.a};
+  uint32_t value = 0u;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+// Calls band(begin, end) over [0, rows) in bands of rowsPerTask, in parallel when the area is
+// large enough. Bands never share a row, so kernels write without synchronization.
+template <typename Band>
+void run_bands(uint32_t rows, uint32_t width, const PixelOpsConfig& config, Band&& band) {
+  const uint32_t rowsPerTask = std::max(config.rowsPerTask, 1u);
+  const uint32_t tasks = (rows + rowsPerTask - 1u) / rowsPerTask;
+  if (tasks <= 1u || static_cast<uint64_t>(rows) * width < MinParallelPixels) {
+    band(0u, rows);
+    return;
+  }
+  auto task = [&](uint32_t index) {
+    const uint32_t begin = index * rowsPerTask;
+    band(begin, std::min(begin + rowsPerTask, rows));
+  };
+  parallelFor(tasks, imageWorkThreads(config.threadCount), config.executor, task);
+}
+
+uint8_t* target_row(const FrameBuffer& target, uint32_t y, uint32_t x) {
+  return target.pixels.data() + static_cast<size_t>(y) * target.stride + static_cast<size_t>(x) * 4u;
+}
+
+const uint8_t* source_row(const ImageView& source, uint32_t y, uint32_t x) {
+  return source.pixels.data() + static_cast<size_t>(y) * source.stride + static_cast<size_t>(x) * 4u;
+}
+
+// Source pixel whose center is nearest to the center of target pixel `index` of `count`.
+uint32_t nearest_sample(uint64_t index, uint64_t count, uint32_t sourceCount) {
+  return static_cast<uint32_t>(((2u * index + 1u) * sourceCount) / (2u * count));
+}
+
+// Pixel-center position of target pixel `index` in the source, as x0 and the weight of x0 + 1.
+BilinearTap bilinear_sample(uint64_t index, uint64_t count, uint32_t sourceCount) {
+  const int64_t position = static_cast<int64_t>(((2u * index + 1u) * sourceCount * 256u) / (2u * count)) - 128;
+  if (position <= 0) {
+    return BilinearTap{0u, 0u};
+  }
+  const auto x0 = static_cast<uint32_t>(position >> 8);
+  if (x0 >= sourceCount - 1u) {
+    return BilinearTap{sourceCount - 2u, 256u};
+  }
+  return BilinearTap{x0, static_cast<uint32_t>(position & 0xFF)};
+}
+
+} // namespace
+
+HostStatus clearFrameBuffer(const FrameBuffer& target, PixelColor color, const PixelOpsConfig& config) {
+  return fillRect(target, PixelRect{0, 0, target.size.width, target.size.height}, color, config);
+}
+
+HostStatus fillRect(const FrameBuffer& target, const PixelRect& rect, PixelColor color, const PixelOpsConfig& config) {
+  if (!surface_of(target).valid()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const Clip clip = clip_rect(rect, target.size);
+  if (clip.empty()) {
+    return {};
+  }
+  const uint32_t value = pixel_value(color);
+  run_bands(clip.height(), clip.width(), config, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t row = begin; row < end; ++row) {
+      fillPixels(target_row(target, clip.y0 + row, clip.x0), clip.width(), value);
+    }
+  });
+  return {};
+}
+
+HostStatus blendImage(const FrameBuffer& target,
+                      const ImageView& source,
+                      int32_t x,
+                      int32_t y,
+                      const PixelOpsConfig& config) {
+  if (!surface_of(target).valid() || !surface_of(source).valid()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const Clip clip = clip_rect(PixelRect{x, y, source.size.width, source.size.height}, target.size);
+  if (clip.empty()) {
+    return {};
+  }
+  const auto sourceX = static_cast<uint32_t>(static_cast<int64_t>(clip.x0) - x);
+  const auto sourceY = static_cast<uint32_t>(static_cast<int64_t>(clip.y0) - y);
+  run_bands(clip.height(), clip.width(), config, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t row = begin; row < end; ++row) {
+      blendPixels(target_row(target, clip.y0 + row, clip.x0), source_row(source, sourceY + row, sourceX),
+                  clip.width());
+    }
+  });
+  return {};
+}
+
+HostStatus scaleImage(const FrameBuffer& target,
+                      const PixelRect& rect,
+                      const ImageView& source,
+                      ScaleFilter filter,
+                      const PixelOpsConfig& config) {
+  if (!surface_of(target).valid() || !surface_of(source).valid()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const Clip clip = clip_rect(rect, target.size);
+  if (clip.empty()) {
+    return {};
+  }
+  // Offsets of the clipped area inside the unclipped rect, which defines the sampling grid.
+  const auto offsetX = static_cast<uint64_t>(static_cast<int64_t>(clip.x0) - rect.x);
+  const auto offsetY = static_cast<uint64_t>(static_cast<int64_t>(clip.y0) - rect.y);
+  const uint32_t width = clip.width();
+
+  if (filter == ScaleFilter::Bilinear && source.size.width >= 2u && source.size.height >= 2u) {
+    std::vector<BilinearTap> taps(width);
+    for (uint32_t i = 0; i < width; ++i) {
+      taps[i] = bilinear_sample(offsetX + i, rect.width, source.size.width);
+    }
+    run_bands(clip.height(), width, config, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t row = begin; row < end; ++row) {
+        const BilinearTap tap = bilinear_sample(offsetY + row, rect.height, source.size.height);
+        bilinearRow(target_row(target, clip.y0 + row, clip.x0), source_row(source, tap.x0, 0u),
+                    source_row(source, tap.x0 + 1u, 0u), taps.data(), width, tap.fx);
+      }
+    });
+    return {};
+  }
+
+  std::vector<uint32_t> columns(width);
+  for (uint32_t i = 0; i < width; ++i) {
+    columns[i] = nearest_sample(offsetX + i, rect.width, source.size.width);
+  }
+  run_bands(clip.height(), width, config, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t row = begin; row < end; ++row) {
+      const uint8_t* from = source_row(source, nearest_sample(offsetY + row, rect.height, source.size.height), 0u);
+      uint8_t* to = target_row(target, clip.y0 + row, clip.x0);
+      for (uint32_t i = 0; i < width; ++i) {
+        std::memcpy(to + static_cast<size_t>(i) * 4u, from + static_cast<size_t>(columns[i]) * 4u, 4u);
+      }
+    }
+  });
+  return {};
+}
+
+} // namespace PrimeHost
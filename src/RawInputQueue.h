@@ -0,0 +1,58 @@
+#pragma once
+
+#include "PrimeHost/Host.h"
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <span>
+
+namespace PrimeHost {
+
+constexpr uint32_t RawInputMaxCapacity = 1u << 20u;
+
+inline HostStatus validateRawInputConfig(const RawInputConfig& config) {
+  if (config.enabled && (config.capacity == 0u || config.capacity > RawInputMaxCapacity)) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return {};
+}
+
+// Hand-off from the raw-input thread to the frame loop. push() never blocks or allocates; when
+// the ring is full the sample is dropped and counted, so the reader keeps the oldest unread
+// samples in order.
+class RawInputQueue {
+public:
+  // Not thread-safe: call only while the producer is stopped.
+  void reset(size_t capacity) {
+    ring_.reset(capacity);
+    dropped_.store(0u, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return ring_.capacity(); }
+  size_t size() const { return ring_.size(); }
+
+  // Producer side.
+  bool push(const RawInputSample& sample) {
+    if (ring_.push(sample)) {
+      return true;
+    }
+    dropped_.fetch_add(1u, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Consumer side. The batch aliases the front of `out`.
+  RawInputBatch drain(std::span<RawInputSample> out) {
+    const size_t count = ring_.pop(out);
+    RawInputBatch batch{};
+    batch.samples = std::span<const RawInputSample>(out.data(), count);
+    batch.droppedSamples = dropped_.exchange(0u, std::memory_order_relaxed);
+    return batch;
+  }
+
+private:
+  SpscRing<RawInputSample> ring_;
+  std::atomic<uint64_t> dropped_{0u};
+};
+
+} // namespace PrimeHost
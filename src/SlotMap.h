@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PrimeHost {
+
+// Dense map from 64-bit handles to owned values. A handle packs a slot index (low 32 bits, biased
+// by one so no handle is zero) with that slot's generation (high 32 bits); the generation moves on
+// every erase, so a stale handle misses instead of reaching a newer value. Lookup is two array
+// reads. Entries stay contiguous in insertion order, which makes iteration cache-friendly and its
+// order independent of the handle values. Values are held by unique_ptr so their addresses
+// survive other inserts and erases. Erase is linear in the entry count; it is expected to be rare.
+template <typename T>
+class SlotMap {
+public:
+  using Handle = uint64_t;
+
+  struct Entry {
+    Handle handle = 0u;
+    std::unique_ptr<T> value;
+  };
+
+  // Handle the next insert returns, for values that need to know their own handle.
+  Handle nextHandle() const {
+    if (!freeSlots_.empty()) {
+      const uint32_t index = freeSlots_.back();
+      return makeHandle(index, slots_[index].generation);
+    }
+    return makeHandle(static_cast<uint32_t>(slots_.size()), 1u);
+  }
+
+  Handle insert(std::unique_ptr<T> value) {
+    const Handle handle = nextHandle();
+    const uint32_t index = slotIndex(handle);
+    if (!freeSlots_.empty()) {
+      freeSlots_.pop_back();
+    } else {
+      slots_.push_back(Slot{1u, NoEntry});
+    }
+    slots_[index].entry = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(Entry{handle, std::move(value)});
+    return handle;
+  }
+
+  T* find(Handle handle) {
+    const Slot* slot = slotFor(handle);
+    return slot ? entries_[slot->entry].value.get() : nullptr;
+  }
+
+  const T* find(Handle handle) const {
+    const Slot* slot = slotFor(handle);
+    return slot ? entries_[slot->entry].value.get() : nullptr;
+  }
+
+  bool contains(Handle handle) const { return slotFor(handle) != nullptr; }
+
+  // Removes the value and hands it back, so callers can destroy it outside any lock they hold.
+  std::unique_ptr<T> erase(Handle handle) {
+    if (!slotFor(handle)) {
+      return nullptr;
+    }
+    Slot& slot = slots_[slotIndex(handle)];
+    const uint32_t position = slot.entry;
+    std::unique_ptr<T> value = std::move(entries_[position].value);
+    entries_.erase(entries_.begin() + position);
+    for (uint32_t i = position; i < entries_.size(); ++i) {
+      slots_[slotIndex(entries_[i].handle)].entry = i;
+    }
+    slot.entry = NoEntry;
+    // Generation 0 is skipped so a handle can never be zero even once a slot wraps.
+    slot.generation = slot.generation == UINT32_MAX ? 1u : slot.generation + 1u;
+    freeSlots_.push_back(slotIndex(handle));
+    return value;
+  }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  auto begin() { return entries_.begin(); }
+  auto end() { return entries_.end(); }
+  auto begin() const { return entries_.begin(); }
+  auto end() const { return entries_.end(); }
+
+private:
+  static constexpr uint32_t NoEntry = UINT32_MAX;
+
+  struct Slot {
+    uint32_t generation = 1u;
+    uint32_t entry = NoEntry;
+  };
+
+  static Handle makeHandle(uint32_t index, uint32_t generation) {
+    return (static_cast<Handle>(generation) << 32u) | (static_cast<Handle>(index) + 1u);
+  }
+
+  static uint32_t slotIndex(Handle handle) { return static_cast<uint32_t>(handle) - 1u; }
+
+  const Slot* slotFor(Handle handle) const {
+    const uint32_t index = slotIndex(handle);
+    if (index >= slots_.size()) {
+      return nullptr;
+    }
+    const Slot& slot = slots_[index];
+    if (slot.entry == NoEntry || slot.generation != static_cast<uint32_t>(handle >> 32u)) {
+      return nullptr;
+    }
+    return &slot;
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> freeSlots_;
+};
+
+} // namespace PrimeHost
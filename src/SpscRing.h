@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace PrimeHost {
+
+// Single-producer/single-consumer ring over trivially copyable values. Storage is sized once in
+// reset(); push/pop are wait-free and never allocate, so both ends may run on real-time threads.
+template <typename T>
+class SpscRing {
+public:
+  // Not thread-safe: call only while neither end is active.
+  void reset(size_t capacity) {
+    size_t rounded = 1u;
+    while (rounded < capacity) {
+      rounded <<= 1u;
+    }
+    storage_.assign(capacity == 0u ? 0u : rounded, T{});
+    mask_ = storage_.empty() ? 0u : storage_.size() - 1u;
+    head_.store(0u, std::memory_order_relaxed);
+    tail_.store(0u, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return storage_.size(); }
+
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  size_t push(std::span<const T> values) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t count = std::min(values.size(), storage_.size() - (tail - head));
+    for (size_t i = 0; i < count; ++i) {
+      storage_[(tail + i) & mask_] = values[i];
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  bool push(const T& value) { return push(std::span<const T>(&value, 1u)) == 1u; }
+
+  size_t pop(std::span<T> out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    const size_t count = std::min(out.size(), tail - head);
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = storage_[(head + i) & mask_];
+    }
+    head_.store(head + count, std::memory_order_release);
+    return count;
+  }
+
+  bool pop(T& value) { return pop(std::span<T>(&value, 1u)) == 1u; }
+
+private:
+  std::vector<T> storage_;
+  size_t mask_ = 0u;
+  alignas(64) std::atomic<size_t> head_{0u};
+  alignas(64) std::atomic<size_t> tail_{0u};
+};
+
+} // namespace PrimeHost
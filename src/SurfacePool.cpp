@@ -0,0 +1,162 @@
+#include "PrimeHost/SurfacePool.h"
+
+#include "SizeUtil.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <unordered_map>
+#include <vector>
+
+namespace PrimeHost {
+namespace {
+
+constexpr size_t SizeClassCount = 64u;
+
+struct PooledSurface {
+  SurfaceId surfaceId{};
+  // Largest frame the surface has been sized for, which the host's storage already covers.
+  size_t capacityBytes = 0u;
+  bool inUse = false;
+};
+
+uint32_t size_class(size_t bytes) {
+  return static_cast<uint32_t>(std::bit_width(bytes - 1u));
+}
+
+class HeadlessSurfacePoolImpl final : public HeadlessSurfacePool {
+public:
+  HeadlessSurfacePoolImpl(Host& host, const SurfacePoolConfig& config) : host_(host), config_(config) {}
+
+  ~HeadlessSurfacePoolImpl() override {
+    for (const PooledSurface& surface : surfaces_) {
+      if (surface.surfaceId.isValid()) {
+        host_.destroySurface(surface.surfaceId);
+      }
+    }
+  }
+
+  HostResult<SurfaceId> acquire(uint32_t width, uint32_t height) override {
+    auto area = checkedSizeMul(width, height);
+    auto bytes = area ? checkedSizeMul(*area, static_cast<size_t>(4u)) : std::nullopt;
+    if (!bytes || *bytes == 0u) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    const uint32_t sizeClass = size_class(*bytes);
+    // The exact class first, then the next one up, whose storage always covers the request.
+    for (uint32_t candidate = sizeClass; candidate < SizeClassCount && candidate <= sizeClass + 1u; ++candidate) {
+      std::vector<uint32_t>& idle = idle_[candidate];
+      while (!idle.empty()) {
+        const uint32_t index = idle.back();
+        idle.pop_back();
+        --stats_.idle;
+        PooledSurface& surface = surfaces_[index];
+        if (!host_.setSurfaceSize(surface.surfaceId, width, height)) {
+          // Destroyed behind the pool's back; forget it and try the next one.
+          forget(index);
+          continue;
+        }
+        surface.inUse = true;
+        surface.capacityBytes = std::max(surface.capacityBytes, *bytes);
+        ++stats_.reused;
+        ++stats_.inUse;
+        return surface.surfaceId;
+      }
+    }
+
+    auto created = host_.createSurface(SurfaceConfig{width, height, false, true, std::nullopt});
+    if (!created) {
+      return std::unexpected(created.error());
+    }
+    uint32_t index = 0u;
+    if (!freeRecords_.empty()) {
+      index = freeRecords_.back();
+      freeRecords_.pop_back();
+    } else {
+      index = static_cast<uint32_t>(surfaces_.size());
+      surfaces_.emplace_back();
+    }
+    surfaces_[index] = PooledSurface{*created, *bytes, true};
+    records_[created->value] = index;
+    ++stats_.created;
+    ++stats_.inUse;
+    return *created;
+  }
+
+  HostStatus acquire(uint32_t width, uint32_t height, std::span<SurfaceId> surfaces) override {
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+      auto surface = acquire(width, height);
+      if (!surface) {
+        for (size_t j = 0; j < i; ++j) {
+          release(surfaces[j]);
+          surfaces[j] = SurfaceId{};
+        }
+        return std::unexpected(surface.error());
+      }
+      surfaces[i] = *surface;
+    }
+    return {};
+  }
+
+  HostStatus release(SurfaceId surfaceId) override {
+    auto it = records_.find(surfaceId.value);
+    if (it == records_.end() || !surfaces_[it->second].inUse) {
+      return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+    }
+    const uint32_t index = it->second;
+    PooledSurface& surface = surfaces_[index];
+    surface.inUse = false;
+    --stats_.inUse;
+    std::vector<uint32_t>& idle = idle_[size_class(surface.capacityBytes)];
+    if (idle.size() >= config_.maxIdlePerClass) {
+      destroy(index);
+      return {};
+    }
+    idle.push_back(index);
+    ++stats_.idle;
+    return {};
+  }
+
+  void trim() override {
+    for (std::vector<uint32_t>& idle : idle_) {
+      for (uint32_t index : idle) {
+        destroy(index);
+      }
+      stats_.idle -= static_cast<uint32_t>(idle.size());
+      idle.clear();
+    }
+  }
+
+  SurfacePoolStats stats() const override { return stats_; }
+
+private:
+  void destroy(uint32_t index) {
+    host_.destroySurface(surfaces_[index].surfaceId);
+    ++stats_.destroyed;
+    forget(index);
+  }
+
+  // Drops the record of a surface that is in no idle list.
+  void forget(uint32_t index) {
+    records_.erase(surfaces_[index].surfaceId.value);
+    surfaces_[index] = PooledSurface{};
+    freeRecords_.push_back(index);
+  }
+
+  Host& host_;
+  SurfacePoolConfig config_;
+  std::vector<PooledSurface> surfaces_;
+  std::vector<uint32_t> freeRecords_;
+  std::unordered_map<uint64_t, uint32_t> records_;
+  std::array<std::vector<uint32_t>, SizeClassCount> idle_{};
+  SurfacePoolStats stats_{};
+};
+
+} // namespace
+
+HostResult<std::unique_ptr<HeadlessSurfacePool>> createHeadlessSurfacePool(Host& host,
+                                                                           const SurfacePoolConfig& config) {
+  return std::make_unique<HeadlessSurfacePoolImpl>(host, config);
+}
+
+} // namespace PrimeHost
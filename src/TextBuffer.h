@@ -2,8 +2,10 @@
 
 #include "PrimeHost/Host.h"
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 namespace PrimeHost {
 
@@ -38,4 +40,121 @@ struct TextBufferWriter {
   }
 };
 
+// Host-owned store for the text of queued events. Queued TextEvent/DropEvent spans index into the
+// arena rather than each event owning a string, and text is appended in queue order, so the text
+// of any run of queued events is one contiguous region. reset() and discardFront() keep the
+// capacity, so once the arena has grown to the largest burst, enqueueing text stops allocating.
+class TextArena {
+public:
+  static constexpr size_t MaxBytes = static_cast<size_t>(std::numeric_limits<uint32_t>::max());
+
+  HostResult<TextSpan> append(std::string_view text) {
+    if (text.size() > MaxBytes - bytes_.size()) {
+      return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+    }
+    TextSpan span{static_cast<uint32_t>(bytes_.size()), static_cast<uint32_t>(text.size())};
+    bytes_.insert(bytes_.end(), text.begin(), text.end());
+    return span;
+  }
+
+  // Span covering everything appended since `offset`, e.g. several paths joined in place.
+  TextSpan spanFrom(size_t offset) const {
+    return TextSpan{static_cast<uint32_t>(offset), static_cast<uint32_t>(bytes_.size() - offset)};
+  }
+
+  // Removes the first `count` bytes; spans past them must be moved down by `count`.
+  void discardFront(size_t count) {
+    count = std::min(count, bytes_.size());
+    bytes_.erase(bytes_.begin(), bytes_.begin() + static_cast<std::ptrdiff_t>(count));
+  }
+
+  void reset() { bytes_.clear(); }
+
+  std::span<const char> bytes() const { return {bytes_.data(), bytes_.size()}; }
+  size_t size() const { return bytes_.size(); }
+  size_t capacity() const { return bytes_.capacity(); }
+
+private:
+  std::vector<char> bytes_;
+};
+
+// The text span of a TextEvent or DropEvent, or nullptr for payloads without text.
+inline TextSpan* eventTextSpan(Event& event) {
+  if (auto* input = std::get_if<InputEvent>(&event.payload)) {
+    if (auto* text = std::get_if<TextEvent>(input)) {
+      return &text->text;
+    }
+    return nullptr;
+  }
+  if (auto* drop = std::get_if<DropEvent>(&event.payload)) {
+    return &drop->paths;
+  }
+  return nullptr;
+}
+
+inline const TextSpan* eventTextSpan(const Event& event) {
+  return eventTextSpan(const_cast<Event&>(event));
+}
+
+// Arena byte range [first, second) referenced by `events`; empty when none carry text.
+inline std::pair<size_t, size_t> eventTextRange(std::span<const Event> events) {
+  size_t begin = std::numeric_limits<size_t>::max();
+  size_t end = 0u;
+  for (const Event& event : events) {
+    if (const TextSpan* span = eventTextSpan(event)) {
+      begin = std::min<size_t>(begin, span->offset);
+      end = std::max<size_t>(end, static_cast<size_t>(span->offset) + span->length);
+    }
+  }
+  return begin < end ? std::pair<size_t, size_t>{begin, end} : std::pair<size_t, size_t>{0u, 0u};
+}
+
+// Number of leading `events` whose combined text fits in `capacity` bytes.
+inline size_t eventsFittingText(std::span<const Event> events, size_t capacity) {
+  size_t begin = std::numeric_limits<size_t>::max();
+  size_t end = 0u;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const TextSpan* span = eventTextSpan(events[i]);
+    if (!span) {
+      continue;
+    }
+    const size_t nextBegin = std::min<size_t>(begin, span->offset);
+    const size_t nextEnd = std::max<size_t>(end, static_cast<size_t>(span->offset) + span->length);
+    if (nextEnd > nextBegin && nextEnd - nextBegin > capacity) {
+      return i;
+    }
+    begin = nextBegin;
+    end = nextEnd;
+  }
+  return events.size();
+}
+
+inline EventBufferSize eventBufferSize(std::span<const Event> events) {
+  const auto [begin, end] = eventTextRange(events);
+  return EventBufferSize{events.size(), end - begin};
+}
+
+// Moves every text span in `events` down by `delta` bytes.
+inline void rebaseEventText(std::span<Event> events, size_t delta) {
+  for (Event& event : events) {
+    if (TextSpan* span = eventTextSpan(event)) {
+      span->offset = span->offset >= delta ? static_cast<uint32_t>(span->offset - delta) : 0u;
+    }
+  }
+}
+
+// Copies the arena text of `events` into `out` with one memcpy and rebases their spans onto it.
+// Returns the number of bytes written; `events` are left untouched on BufferTooSmall.
+inline HostResult<size_t> copyEventText(std::span<Event> events, const TextArena& arena, std::span<char> out) {
+  const auto [begin, end] = eventTextRange(events);
+  if (end - begin > out.size()) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+  if (end > begin) {
+    std::memcpy(out.data(), arena.bytes().data() + begin, end - begin);
+  }
+  rebaseEventText(events, begin);
+  return end - begin;
+}
+
 } // namespace PrimeHost
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace PrimeHost {
+
+// Case-folded symbol classes: a-z, 0-9, space, then everything else.
+constexpr size_t TokenMatchAlphabet = 38u;
+constexpr uint8_t TokenMatchOtherClass = 37u;
+
+constexpr uint8_t tokenMatchClass(char ch) {
+  if (ch >= 'a' && ch <= 'z') {
+    return static_cast<uint8_t>(ch - 'a');
+  }
+  if (ch >= 'A' && ch <= 'Z') {
+    return static_cast<uint8_t>(ch - 'A');
+  }
+  if (ch >= '0' && ch <= '9') {
+    return static_cast<uint8_t>(26 + (ch - '0'));
+  }
+  return ch == ' ' ? 36u : TokenMatchOtherClass;
+}
+
+template <size_t PatternCount>
+constexpr size_t tokenMatcherStateCount(const std::array<std::string_view, PatternCount>& patterns) {
+  size_t states = 1u;
+  for (std::string_view pattern : patterns) {
+    states += pattern.size();
+  }
+  return states;
+}
+
+// Case-insensitive multi-token substring matcher built at compile time (Aho-Corasick). A single
+// pass over the text reports every token it contains, without copying or lowercasing the text.
+// Tokens may only use letters, digits and spaces; valid() is false otherwise.
+template <size_t PatternCount, size_t MaxStates>
+class TokenMatcher {
+public:
+  static_assert(PatternCount > 0u && PatternCount <= 64u, "TokenMatcher supports 1 to 64 tokens");
+  static_assert(MaxStates < UINT16_MAX, "TokenMatcher state count must fit in 16 bits");
+
+  constexpr explicit TokenMatcher(const std::array<std::string_view, PatternCount>& patterns) {
+    constexpr uint16_t NoState = UINT16_MAX;
+    for (auto& row : next_) {
+      row.fill(NoState);
+    }
+    size_t stateCount = 1u;
+    for (size_t i = 0; i < PatternCount; ++i) {
+      if (patterns[i].empty()) {
+        return;
+      }
+      uint16_t state = 0u;
+      for (char ch : patterns[i]) {
+        const uint8_t symbol = tokenMatchClass(ch);
+        if (symbol == TokenMatchOtherClass || stateCount == MaxStates) {
+          return;
+        }
+        if (next_[state][symbol] == NoState) {
+          next_[state][symbol] = static_cast<uint16_t>(stateCount++);
+        }
+        state = next_[state][symbol];
+      }
+      output_[state] |= uint64_t{1} << i;
+    }
+
+    // Breadth-first pass turning the trie into a DFA: missing edges follow the failure link and
+    // each state inherits the matches of its longest proper suffix.
+    std::array<uint16_t, MaxStates> queue{};
+    std::array<uint16_t, MaxStates> fail{};
+    size_t head = 0u;
+    size_t tail = 0u;
+    for (auto& edge : next_[0]) {
+      if (edge == NoState) {
+        edge = 0u;
+      } else {
+        fail[edge] = 0u;
+        queue[tail++] = edge;
+      }
+    }
+    while (head < tail) {
+      const uint16_t state = queue[head++];
+      for (size_t symbol = 0; symbol < TokenMatchAlphabet; ++symbol) {
+        uint16_t& edge = next_[state][symbol];
+        if (edge == NoState) {
+          edge = next_[fail[state]][symbol];
+        } else {
+          fail[edge] = next_[fail[state]][symbol];
+          output_[edge] |= output_[fail[edge]];
+          queue[tail++] = edge;
+        }
+      }
+    }
+    valid_ = true;
+  }
+
+  constexpr bool valid() const { return valid_; }
+
+  // Bit i is set when token i occurs in `text`.
+  constexpr uint64_t matchMask(std::string_view text) const {
+    uint64_t mask = 0u;
+    uint16_t state = 0u;
+    for (char ch : text) {
+      state = next_[state][tokenMatchClass(ch)];
+      mask |= output_[state];
+    }
+    return mask;
+  }
+
+  // Lowest-index token found in `text`, so earlier tokens take priority.
+  constexpr std::optional<uint32_t> firstMatch(std::string_view text) const {
+    const uint64_t mask = matchMask(text);
+    if (mask == 0u) {
+      return std::nullopt;
+    }
+    return static_cast<uint32_t>(std::countr_zero(mask));
+  }
+
+private:
+  std::array<std::array<uint16_t, TokenMatchAlphabet>, MaxStates> next_{};
+  std::array<uint64_t, MaxStates> output_{};
+  bool valid_ = false;
+};
+
+} // namespace PrimeHost
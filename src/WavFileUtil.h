@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "PrimeHost/Host.h"
+
+namespace PrimeHost {
+
+struct WavAudio {
+  uint32_t sampleRate = 0u;
+  uint16_t channels = 0u;
+  std::vector<float> samples; // interleaved
+};
+
+namespace WavDetail {
+
+constexpr uint16_t FormatPcm = 1u;
+constexpr uint16_t FormatFloat = 3u;
+constexpr uint16_t FormatExtensible = 0xFFFEu;
+
+inline uint16_t read_u16(const uint8_t* data) {
+  return static_cast<uint16_t>(data[0] | (data[1] << 8u));
+}
+
+inline uint32_t read_u32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8u) |
+         (static_cast<uint32_t>(data[2]) << 16u) | (static_cast<uint32_t>(data[3]) << 24u);
+}
+
+inline void write_u16(std::vector<uint8_t>& out, uint16_t value) {
+  out.push_back(static_cast<uint8_t>(value & 0xFFu));
+  out.push_back(static_cast<uint8_t>(value >> 8u));
+}
+
+inline void write_u32(std::vector<uint8_t>& out, uint32_t value) {
+  for (uint32_t shift = 0; shift < 32u; shift += 8u) {
+    out.push_back(static_cast<uint8_t>((value >> shift) & 0xFFu));
+  }
+}
+
+inline void write_tag(std::vector<uint8_t>& out, const char (&tag)[5]) {
+  for (size_t i = 0; i < 4u; ++i) {
+    out.push_back(static_cast<uint8_t>(tag[i]));
+  }
+}
+
+} // namespace WavDetail
+
+// Decodes RIFF/WAVE with 16-bit PCM or 32-bit float samples (plain or extensible headers).
+inline HostResult<WavAudio> decodeWav(std::span<const uint8_t> bytes) {
+  using namespace WavDetail;
+  if (bytes.size() < 12u || std::memcmp(bytes.data(), "RIFF", 4u) != 0 ||
+      std::memcmp(bytes.data() + 8u, "WAVE", 4u) != 0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  uint16_t format = 0u;
+  uint16_t bitsPerSample = 0u;
+  WavAudio audio{};
+  std::span<const uint8_t> data;
+  size_t offset = 12u;
+  while (offset + 8u <= bytes.size()) {
+    const uint8_t* chunk = bytes.data() + offset;
+    const uint32_t chunkSize = read_u32(chunk + 4u);
+    if (chunkSize > bytes.size() - offset - 8u) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    if (std::memcmp(chunk, "fmt ", 4u) == 0 && chunkSize >= 16u) {
+      format = read_u16(chunk + 8u);
+      audio.channels = read_u16(chunk + 10u);
+      audio.sampleRate = read_u32(chunk + 12u);
+      bitsPerSample = read_u16(chunk + 22u);
+      if (format == FormatExtensible && chunkSize >= 26u) {
+        format = read_u16(chunk + 32u);
+      }
+    } else if (std::memcmp(chunk, "data", 4u) == 0) {
+      data = bytes.subspan(offset + 8u, chunkSize);
+    }
+    offset += 8u + chunkSize + (chunkSize & 1u);
+  }
+  if (audio.channels == 0u || audio.sampleRate == 0u || data.empty()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (format == FormatPcm && bitsPerSample == 16u) {
+    audio.samples.resize(data.size() / 2u);
+    for (size_t i = 0; i < audio.samples.size(); ++i) {
+      const auto value = static_cast<int16_t>(read_u16(data.data() + i * 2u));
+      audio.samples[i] = static_cast<float>(value) / 32768.0f;
+    }
+  } else if (format == FormatFloat && bitsPerSample == 32u) {
+    audio.samples.resize(data.size() / 4u);
+    std::memcpy(audio.samples.data(), data.data(), audio.samples.size() * sizeof(float));
+  } else {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+  audio.samples.resize(audio.samples.size() - audio.samples.size() % audio.channels);
+  return audio;
+}
+
+inline std::vector<uint8_t> encodeWavFloat32(const WavAudio& audio) {
+  using namespace WavDetail;
+  const auto dataBytes = static_cast<uint32_t>(audio.samples.size() * sizeof(float));
+  std::vector<uint8_t> out;
+  out.reserve(44u + dataBytes);
+  write_tag(out, "RIFF");
+  write_u32(out, 36u + dataBytes);
+  write_tag(out, "WAVE");
+  write_tag(out, "fmt ");
+  write_u32(out, 16u);
+  write_u16(out, FormatFloat);
+  write_u16(out, audio.channels);
+  write_u32(out, audio.sampleRate);
+  write_u32(out, audio.sampleRate * audio.channels * 4u);
+  write_u16(out, static_cast<uint16_t>(audio.channels * 4u));
+  write_u16(out, 32u);
+  write_tag(out, "data");
+  write_u32(out, dataBytes);
+  const auto* raw = reinterpret_cast<const uint8_t*>(audio.samples.data());
+  out.insert(out.end(), raw, raw + dataBytes);
+  return out;
+}
+
+inline HostResult<WavAudio> readWavFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return decodeWav(bytes);
+}
+
+inline HostStatus writeWavFile(const std::filesystem::path& path, const WavAudio& audio) {
+  std::vector<uint8_t> bytes = encodeWavFloat32(audio);
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  if (!file) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  return {};
+}
+
+} // namespace PrimeHost
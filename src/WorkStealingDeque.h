@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace PrimeHost {
+
+// Fixed-capacity Chase-Lev deque of pointers (Lê et al., "Correct and Efficient Work-Stealing for
+// Weak Memory Models"). The owning thread pushes and pops at the bottom; any thread may steal
+// from the top. Slots are written with release and read with acquire so a stolen pointer carries
+// what the owner wrote before pushing it. A full deque rejects the push and the caller runs the
+// work itself, so the buffer never has to grow. Capacity must be a power of two.
+template <typename T>
+class WorkStealingDeque {
+public:
+  explicit WorkStealingDeque(size_t capacity)
+      : mask_(static_cast<int64_t>(capacity) - 1), slots_(std::make_unique<std::atomic<T*>[]>(capacity)) {}
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Owner only.
+  bool push(T* item) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top > mask_) {
+      return false;
+    }
+    slots_[bottom & mask_].store(item, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Owner only. Returns the most recently pushed item, or null when empty or when a thief took
+  // the last one.
+  T* pop() {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = slots_[bottom & mask_].load(std::memory_order_acquire);
+    if (top == bottom) {
+      // Last item: race thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Any thread. Returns the oldest item, or null when empty or when another thread won it.
+  T* steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    T* item = slots_[top & mask_].load(std::memory_order_acquire);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  bool empty() const {
+    return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+  }
+
+private:
+  const int64_t mask_;
+  std::unique_ptr<std::atomic<T*>[]> slots_;
+  alignas(64) std::atomic<int64_t> top_{0};
+  alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+} // namespace PrimeHost
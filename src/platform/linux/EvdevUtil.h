@@ -0,0 +1,96 @@
+#pragma once
+
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <time.h>
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+#include "PlatformTimeUtil.h"
+
+namespace PrimeHost {
+
+// What a backend learns about an evdev node at connect time (EVIOCGID/EVIOCGNAME/EVIOCGBIT/
+// EVIOCGABS). Tests fill it in by hand for recorded-event stand-ins.
+struct EvdevDeviceInfo {
+  std::string name;
+  uint16_t bus = 0u;
+  uint16_t vendor = 0u;
+  uint16_t product = 0u;
+  uint16_t version = 0u;
+  std::bitset<KEY_CNT> keys;
+  std::bitset<REL_CNT> relative;
+  std::bitset<ABS_CNT> axes;
+  std::array<input_absinfo, ABS_CNT> absInfo{};
+};
+
+template <size_t Bits>
+bool queryEvdevBits(int fd, uint32_t type, std::bitset<Bits>& out) {
+  constexpr size_t LongBits = sizeof(unsigned long) * CHAR_BIT;
+  unsigned long words[(Bits + LongBits - 1u) / LongBits] = {};
+  if (ioctl(fd, EVIOCGBIT(type, sizeof(words)), words) < 0) {
+    return false;
+  }
+  for (size_t bit = 0; bit < Bits; ++bit) {
+    out[bit] = (words[bit / LongBits] >> (bit % LongBits)) & 1u;
+  }
+  return true;
+}
+
+// Fills `info` from an open evdev node. Returns false for nodes that are not evdev devices.
+inline bool readEvdevDeviceInfo(int fd, EvdevDeviceInfo& info) {
+  input_id id{};
+  char name[256] = {};
+  std::bitset<EV_CNT> types;
+  if (ioctl(fd, EVIOCGID, &id) < 0 || ioctl(fd, EVIOCGNAME(sizeof(name) - 1u), name) < 0 ||
+      !queryEvdevBits(fd, 0u, types)) {
+    return false;
+  }
+  if (types[EV_KEY] && !queryEvdevBits(fd, EV_KEY, info.keys)) {
+    return false;
+  }
+  if (types[EV_REL] && !queryEvdevBits(fd, EV_REL, info.relative)) {
+    return false;
+  }
+  if (types[EV_ABS] && queryEvdevBits(fd, EV_ABS, info.axes)) {
+    for (uint32_t code = 0; code < ABS_CNT; ++code) {
+      if (info.axes[code] && ioctl(fd, EVIOCGABS(code), &info.absInfo[code]) < 0) {
+        info.axes[code] = false;
+      }
+    }
+  }
+  info.name = name;
+  info.bus = id.bustype;
+  info.vendor = id.vendor;
+  info.product = id.product;
+  info.version = id.version;
+  return true;
+}
+
+// Switches event timestamps from CLOCK_REALTIME to CLOCK_MONOTONIC, the clock steady_clock uses.
+inline bool useMonotonicEvdevClock(int fd) {
+  int clock = CLOCK_MONOTONIC;
+  return ioctl(fd, EVIOCSCLOCKID, &clock) == 0;
+}
+
+inline double monotonicUptimeSeconds() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+// Maps an evdev timestamp onto steady_clock the same way macOS maps NSEvent uptimes.
+inline std::chrono::steady_clock::time_point evdevEventTime(const input_event& event,
+                                                             double uptimeSeconds,
+                                                             std::chrono::steady_clock::time_point now) {
+  const double eventSeconds =
+      static_cast<double>(event.input_event_sec) + static_cast<double>(event.input_event_usec) * 1e-6;
+  return steadyTimeFromUptime(eventSeconds, uptimeSeconds, now);
+}
+
+} // namespace PrimeHost
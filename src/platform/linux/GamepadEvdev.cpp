@@ -0,0 +1,591 @@
+#include "platform/linux/GamepadEvdev.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace PrimeHost {
+namespace {
+
+constexpr size_t kLongBits = sizeof(unsigned long) * CHAR_BIT;
+
+bool is_hat(uint32_t code) {
+  return code >= ABS_HAT0X && code <= ABS_HAT3Y;
+}
+
+bool is_trigger(uint32_t controlId) {
+  return controlId == static_cast<uint32_t>(GamepadAxisId::LeftTrigger) ||
+         controlId == static_cast<uint32_t>(GamepadAxisId::RightTrigger);
+}
+
+bool is_vertical(uint32_t controlId) {
+  return controlId == static_cast<uint32_t>(GamepadAxisId::LeftY) ||
+         controlId == static_cast<uint32_t>(GamepadAxisId::RightY);
+}
+
+void emit_device(GamepadEventSink sink, void* userData, uint32_t deviceId, bool connected) {
+  if (!sink) {
+    return;
+  }
+  DeviceEvent event{};
+  event.deviceId = deviceId;
+  event.deviceType = DeviceType::Gamepad;
+  event.connected = connected;
+  sink(InputEvent{event}, userData);
+}
+
+} // namespace
+
+EvdevGamepad::EvdevGamepad(uint32_t deviceId, const EvdevDeviceInfo& info, std::optional<GamepadMapping> mapping)
+    : deviceId_(deviceId) {
+  keyToButton_.fill(NoIndex);
+  absToAxis_.fill(NoIndex);
+  absPresent_ = info.axes;
+
+  // SDL numbers joystick/gamepad buttons first, then the BTN_MISC block.
+  auto addButton = [&](uint32_t code) {
+    if (info.keys[code] && buttonCount_ < NoIndex) {
+      keyToButton_[code] = static_cast<uint8_t>(buttonCount_++);
+    }
+  };
+  for (uint32_t code = BTN_JOYSTICK; code < KEY_CNT; ++code) {
+    addButton(code);
+  }
+  for (uint32_t code = BTN_MISC; code < BTN_JOYSTICK; ++code) {
+    addButton(code);
+  }
+  for (uint32_t code = 0; code < ABS_CNT; ++code) {
+    if (!info.axes[code]) {
+      continue;
+    }
+    if (is_hat(code)) {
+      hatCount_ = std::max(hatCount_, (code - ABS_HAT0X) / 2u + 1u);
+      const int32_t value = info.absInfo[code].value;
+      hatAxes_[(code - ABS_HAT0X) / 2u][(code - ABS_HAT0X) % 2u] = static_cast<int8_t>((value > 0) - (value < 0));
+      continue;
+    }
+    const uint32_t axis = axisCount_++;
+    absToAxis_[code] = static_cast<uint8_t>(axis);
+    axisMin_[axis] = info.absInfo[code].minimum;
+    axisMax_[axis] = info.absInfo[code].maximum;
+    axisValue_[axis] = normalize(static_cast<uint8_t>(axis), info.absInfo[code].value);
+  }
+
+  if (mapping) {
+    mapping_ = std::move(*mapping);
+    mapped_ = true;
+  } else if (info.keys[BTN_GAMEPAD]) {
+    bindKernelLayout(info);
+    mapped_ = true;
+  }
+  mapping_.guid = makeGamepadGuid(info.bus, info.vendor, info.product, info.version);
+  if (mapping_.name.empty()) {
+    mapping_.name = info.name;
+  }
+  seedBindings();
+}
+
+bool EvdevGamepad::looksLikeGamepad(const EvdevDeviceInfo& info) {
+  if (info.keys[BTN_GAMEPAD]) {
+    return true;
+  }
+  bool joystickButton = false;
+  for (uint32_t code = BTN_JOYSTICK; code < BTN_GAMEPAD; ++code) {
+    joystickButton = joystickButton || info.keys[code];
+  }
+  return joystickButton && info.axes[ABS_X] && info.axes[ABS_Y];
+}
+
+uint32_t EvdevGamepad::handle(const input_event& event, GamepadEventSink sink, void* userData) {
+  if (event.type == EV_KEY && event.code < KEY_CNT) {
+    const uint8_t index = keyToButton_[event.code];
+    const bool pressed = event.value != 0;
+    if (index == NoIndex || buttonState_[index] == pressed) {
+      return 0u;
+    }
+    buttonState_[index] = pressed;
+    if (mapped_) {
+      return updateBindings(GamepadInputKind::Button, index, sink, userData);
+    }
+    GamepadButtonEvent out{};
+    out.deviceId = deviceId_;
+    out.controlId = GamepadRawControlBase + index;
+    out.pressed = pressed;
+    sink(InputEvent{out}, userData);
+    return 1u;
+  }
+  if (event.type != EV_ABS || event.code >= ABS_CNT || !absPresent_[event.code]) {
+    return 0u;
+  }
+  if (is_hat(event.code)) {
+    const uint32_t hat = (event.code - ABS_HAT0X) / 2u;
+    const uint32_t component = (event.code - ABS_HAT0X) % 2u;
+    const auto direction = static_cast<int8_t>((event.value > 0) - (event.value < 0));
+    if (hatAxes_[hat][component] == direction) {
+      return 0u;
+    }
+    hatAxes_[hat][component] = direction;
+    if (mapped_) {
+      return updateBindings(GamepadInputKind::Hat, static_cast<uint8_t>(hat), sink, userData);
+    }
+    GamepadAxisEvent out{};
+    out.deviceId = deviceId_;
+    out.controlId = GamepadRawControlBase + axisCount_ + hat * 2u + component;
+    out.value = direction;
+    sink(InputEvent{out}, userData);
+    return 1u;
+  }
+  const uint8_t axis = absToAxis_[event.code];
+  const float value = normalize(axis, event.value);
+  if (axisValue_[axis] == value) {
+    return 0u;
+  }
+  axisValue_[axis] = value;
+  if (mapped_) {
+    return updateBindings(GamepadInputKind::Axis, axis, sink, userData);
+  }
+  GamepadAxisEvent out{};
+  out.deviceId = deviceId_;
+  out.controlId = GamepadRawControlBase + axis;
+  out.value = value;
+  sink(InputEvent{out}, userData);
+  return 1u;
+}
+
+void EvdevGamepad::bindKernelLayout(const EvdevDeviceInfo& info) {
+  // Documented kernel gamepad layout (Documentation/input/gamepad.rst). BTN_X/BTN_Y follow the
+  // Xbox labels, matching SDL's fallback for unknown evdev gamepads.
+  auto bindButton = [&](uint32_t code, GamepadButtonId id) {
+    if (keyToButton_[code] == NoIndex || mapping_.bindingCount == mapping_.bindings.size()) {
+      return;
+    }
+    GamepadBinding& binding = mapping_.bindings[mapping_.bindingCount++];
+    binding.kind = GamepadInputKind::Button;
+    binding.index = keyToButton_[code];
+    binding.controlId = static_cast<uint32_t>(id);
+  };
+  auto bindAxis = [&](uint32_t code, GamepadAxisId id) {
+    if (absToAxis_[code] == NoIndex || mapping_.bindingCount == mapping_.bindings.size()) {
+      return false;
+    }
+    GamepadBinding& binding = mapping_.bindings[mapping_.bindingCount++];
+    binding.kind = GamepadInputKind::Axis;
+    binding.index = absToAxis_[code];
+    binding.toAxis = true;
+    binding.controlId = static_cast<uint32_t>(id);
+    return true;
+  };
+  bindButton(BTN_A, GamepadButtonId::South);
+  bindButton(BTN_B, GamepadButtonId::East);
+  bindButton(BTN_X, GamepadButtonId::West);
+  bindButton(BTN_Y, GamepadButtonId::North);
+  bindButton(BTN_TL, GamepadButtonId::LeftBumper);
+  bindButton(BTN_TR, GamepadButtonId::RightBumper);
+  bindButton(BTN_SELECT, GamepadButtonId::Back);
+  bindButton(BTN_START, GamepadButtonId::Start);
+  bindButton(BTN_MODE, GamepadButtonId::Guide);
+  bindButton(BTN_THUMBL, GamepadButtonId::LeftStick);
+  bindButton(BTN_THUMBR, GamepadButtonId::RightStick);
+  bindButton(BTN_DPAD_UP, GamepadButtonId::DpadUp);
+  bindButton(BTN_DPAD_DOWN, GamepadButtonId::DpadDown);
+  bindButton(BTN_DPAD_LEFT, GamepadButtonId::DpadLeft);
+  bindButton(BTN_DPAD_RIGHT, GamepadButtonId::DpadRight);
+  bindAxis(ABS_X, GamepadAxisId::LeftX);
+  bindAxis(ABS_Y, GamepadAxisId::LeftY);
+  bindAxis(ABS_RX, GamepadAxisId::RightX);
+  bindAxis(ABS_RY, GamepadAxisId::RightY);
+  for (auto [axisCode, buttonCode, id] : {std::tuple{ABS_Z, BTN_TL2, GamepadAxisId::LeftTrigger},
+                                          std::tuple{ABS_RZ, BTN_TR2, GamepadAxisId::RightTrigger}}) {
+    if (!bindAxis(axisCode, id) && keyToButton_[buttonCode] != NoIndex &&
+        mapping_.bindingCount < mapping_.bindings.size()) {
+      GamepadBinding& binding = mapping_.bindings[mapping_.bindingCount++];
+      binding.kind = GamepadInputKind::Button;
+      binding.index = keyToButton_[buttonCode];
+      binding.toAxis = true;
+      binding.controlId = static_cast<uint32_t>(id);
+    }
+  }
+  if (info.axes[ABS_HAT0X] && info.axes[ABS_HAT0Y]) {
+    const std::pair<uint8_t, GamepadButtonId> hatBindings[] = {{1u, GamepadButtonId::DpadUp},
+                                                              {2u, GamepadButtonId::DpadRight},
+                                                              {4u, GamepadButtonId::DpadDown},
+                                                              {8u, GamepadButtonId::DpadLeft}};
+    for (auto [mask, id] : hatBindings) {
+      if (mapping_.bindingCount == mapping_.bindings.size()) {
+        break;
+      }
+      GamepadBinding& binding = mapping_.bindings[mapping_.bindingCount++];
+      binding.kind = GamepadInputKind::Hat;
+      binding.index = 0u;
+      binding.hatMask = mask;
+      binding.controlId = static_cast<uint32_t>(id);
+    }
+  }
+}
+
+float EvdevGamepad::normalize(uint8_t axis, int32_t value) const {
+  const int64_t minimum = axisMin_[axis];
+  const int64_t maximum = axisMax_[axis];
+  if (maximum <= minimum) {
+    return static_cast<float>((value > 0) - (value < 0));
+  }
+  const double scaled = 2.0 * static_cast<double>(value - minimum) / static_cast<double>(maximum - minimum) - 1.0;
+  return static_cast<float>(std::clamp(scaled, -1.0, 1.0));
+}
+
+float EvdevGamepad::bindingValue(const GamepadBinding& binding) const {
+  float input = 0.0f;
+  bool fullRange = false;
+  switch (binding.kind) {
+    case GamepadInputKind::Button:
+      input = binding.index < buttonCount_ && buttonState_[binding.index] ? 1.0f : 0.0f;
+      break;
+    case GamepadInputKind::Hat: {
+      if (binding.index >= hatCount_) {
+        break;
+      }
+      const auto& hat = hatAxes_[binding.index];
+      const uint8_t bits = static_cast<uint8_t>((hat[1] < 0 ? 1u : 0u) | (hat[0] > 0 ? 2u : 0u) |
+                                                (hat[1] > 0 ? 4u : 0u) | (hat[0] < 0 ? 8u : 0u));
+      input = (bits & binding.hatMask) != 0u ? 1.0f : 0.0f;
+      break;
+    }
+    case GamepadInputKind::Axis:
+      if (binding.index >= axisCount_) {
+        break;
+      }
+      input = binding.invert ? -axisValue_[binding.index] : axisValue_[binding.index];
+      if (binding.inputRange > 0) {
+        input = std::clamp(input, 0.0f, 1.0f);
+      } else if (binding.inputRange < 0) {
+        input = std::clamp(-input, 0.0f, 1.0f);
+      } else {
+        fullRange = true;
+      }
+      break;
+  }
+
+  if (!binding.toAxis) {
+    return input > 0.5f ? 1.0f : 0.0f;
+  }
+  float output = input;
+  if (is_trigger(binding.controlId)) {
+    output = fullRange ? (input + 1.0f) * 0.5f : input;
+  } else if (binding.outputRange != 0) {
+    output = static_cast<float>(binding.outputRange) * (fullRange ? (input + 1.0f) * 0.5f : input);
+  }
+  // evdev reports down as positive; PrimeHost sticks are up-positive on every platform.
+  return is_vertical(binding.controlId) ? -output : output;
+}
+
+uint32_t EvdevGamepad::updateBindings(GamepadInputKind kind, uint8_t index, GamepadEventSink sink, void* userData) {
+  uint32_t emitted = 0u;
+  for (uint32_t i = 0; i < mapping_.bindingCount; ++i) {
+    const GamepadBinding& binding = mapping_.bindings[i];
+    if (binding.kind != kind || binding.index != index) {
+      continue;
+    }
+    const float value = bindingValue(binding);
+    if (value == bindingState_[i]) {
+      continue;
+    }
+    bindingState_[i] = value;
+    if (binding.toAxis) {
+      GamepadAxisEvent out{};
+      out.deviceId = deviceId_;
+      out.controlId = binding.controlId;
+      out.value = value;
+      sink(InputEvent{out}, userData);
+    } else {
+      GamepadButtonEvent out{};
+      out.deviceId = deviceId_;
+      out.controlId = binding.controlId;
+      out.pressed = value > 0.0f;
+      if (kind == GamepadInputKind::Axis) {
+        out.value = std::clamp(std::abs(axisValue_[index]), 0.0f, 1.0f);
+      }
+      sink(InputEvent{out}, userData);
+    }
+    ++emitted;
+  }
+  return emitted;
+}
+
+void EvdevGamepad::seedBindings() {
+  for (uint32_t i = 0; i < mapping_.bindingCount; ++i) {
+    bindingState_[i] = bindingValue(mapping_.bindings[i]);
+  }
+}
+
+LinuxGamepadBackend::LinuxGamepadBackend() = default;
+
+LinuxGamepadBackend::~LinuxGamepadBackend() {
+  stop();
+}
+
+HostStatus LinuxGamepadBackend::start(GamepadEventSink sink, void* userData, bool scanDevices) {
+  if (!sink) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  stop();
+  sink_ = sink;
+  userData_ = userData;
+  epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd_ < 0) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  if (!scanDevices) {
+    return {};
+  }
+  notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (notifyFd_ >= 0) {
+    // New nodes may appear before udev fixes their permissions, so retry on IN_ATTRIB too.
+    if (inotify_add_watch(notifyFd_, "/dev/input", IN_CREATE | IN_ATTRIB) < 0) {
+      close(notifyFd_);
+      notifyFd_ = -1;
+    } else {
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.ptr = nullptr;
+      epoll_ctl(epollFd_, EPOLL_CTL_ADD, notifyFd_, &event);
+    }
+  }
+  this->scanDevices();
+  return {};
+}
+
+void LinuxGamepadBackend::stop() {
+  while (!devices_.empty()) {
+    closeDevice(devices_.begin(), false);
+  }
+  if (notifyFd_ >= 0) {
+    close(notifyFd_);
+    notifyFd_ = -1;
+  }
+  if (epollFd_ >= 0) {
+    close(epollFd_);
+    epollFd_ = -1;
+  }
+}
+
+HostResult<uint32_t> LinuxGamepadBackend::addDevice(int fd, const EvdevDeviceInfo& info) {
+  if (epollFd_ < 0 || fd < 0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  std::optional<GamepadMapping> mapping;
+  if (info.vendor != 0u) {
+    mapping = mappings_.find(makeGamepadGuid(info.bus, info.vendor, info.product, info.version));
+  }
+  const uint32_t deviceId = nextDeviceId_++;
+  Device& device = devices_.emplace_back(Device{fd, {}, EvdevGamepad(deviceId, info, std::move(mapping))});
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.ptr = &device;
+  if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    devices_.pop_back();
+    close(fd);
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  emit_device(sink_, userData_, deviceId, true);
+  return deviceId;
+}
+
+HostStatus LinuxGamepadBackend::removeDevice(uint32_t deviceId) {
+  auto it = std::find_if(devices_.begin(), devices_.end(), [&](const Device& device) {
+    return device.pad.deviceId() == deviceId;
+  });
+  if (it == devices_.end()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  closeDevice(it, true);
+  return {};
+}
+
+HostResult<uint32_t> LinuxGamepadBackend::poll(std::chrono::milliseconds timeout) {
+  if (epollFd_ < 0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  epoll_event ready[16];
+  const int count = epoll_wait(epollFd_, ready, 16, static_cast<int>(timeout.count()));
+  if (count < 0) {
+    if (errno == EINTR) {
+      return 0u;
+    }
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  uint32_t emitted = 0u;
+  for (int i = 0; i < count; ++i) {
+    if (!ready[i].data.ptr) {
+      emitted += drainNotify();
+      continue;
+    }
+    auto* device = static_cast<Device*>(ready[i].data.ptr);
+    bool alive = true;
+    emitted += readDevice(*device, alive);
+    if (!alive) {
+      auto it = std::find_if(devices_.begin(), devices_.end(), [&](const Device& candidate) {
+        return &candidate == device;
+      });
+      closeDevice(it, true);
+      ++emitted;
+    }
+  }
+  return emitted;
+}
+
+const EvdevGamepad* LinuxGamepadBackend::device(uint32_t deviceId) const {
+  for (const Device& device : devices_) {
+    if (device.pad.deviceId() == deviceId) {
+      return &device.pad;
+    }
+  }
+  return nullptr;
+}
+
+void LinuxGamepadBackend::scanDevices() {
+  DIR* dir = opendir("/dev/input");
+  if (!dir) {
+    return;
+  }
+  while (dirent* entry = readdir(dir)) {
+    if (std::strncmp(entry->d_name, "event", 5u) == 0) {
+      openPath(std::string("/dev/input/") + entry->d_name);
+    }
+  }
+  closedir(dir);
+}
+
+bool LinuxGamepadBackend::openPath(const std::string& path) {
+  for (const Device& device : devices_) {
+    if (device.path == path) {
+      return false;
+    }
+  }
+  const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  EvdevDeviceInfo info{};
+  if (!readEvdevDeviceInfo(fd, info)) {
+    close(fd);
+    return false;
+  }
+  if (!EvdevGamepad::looksLikeGamepad(info)) {
+    close(fd);
+    return false;
+  }
+  if (!addDevice(fd, info)) {
+    return false;
+  }
+  devices_.back().path = path;
+  // Buttons already held at connect are reported once through the resync path.
+  resync(devices_.back());
+  return true;
+}
+
+uint32_t LinuxGamepadBackend::readDevice(Device& device, bool& alive) {
+  uint32_t emitted = 0u;
+  for (;;) {
+    const ssize_t bytes = read(device.fd, readBuffer_.data(), sizeof(readBuffer_));
+    if (bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      alive = errno == EAGAIN || errno == EWOULDBLOCK;
+      return emitted;
+    }
+    if (bytes == 0) {
+      alive = false;
+      return emitted;
+    }
+    const size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+    for (size_t i = 0; i < count; ++i) {
+      const input_event& event = readBuffer_[i];
+      if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+        device.dropped = true;
+        continue;
+      }
+      if (device.dropped) {
+        // Events up to the next report are incomplete; rebuild state from the device instead.
+        if (event.type == EV_SYN && event.code == SYN_REPORT) {
+          device.dropped = false;
+          emitted += resync(device);
+        }
+        continue;
+      }
+      emitted += device.pad.handle(event, sink_, userData_);
+    }
+  }
+}
+
+uint32_t LinuxGamepadBackend::resync(Device& device) {
+  unsigned long keys[(KEY_CNT + kLongBits - 1u) / kLongBits] = {};
+  if (ioctl(device.fd, EVIOCGKEY(sizeof(keys)), keys) < 0) {
+    return 0u;
+  }
+  uint32_t emitted = 0u;
+  input_event event{};
+  event.type = EV_KEY;
+  for (uint32_t code = BTN_MISC; code < KEY_CNT; ++code) {
+    event.code = static_cast<uint16_t>(code);
+    event.value = static_cast<int32_t>((keys[code / kLongBits] >> (code % kLongBits)) & 1u);
+    emitted += device.pad.handle(event, sink_, userData_);
+  }
+  event.type = EV_ABS;
+  for (uint32_t code = 0; code < ABS_CNT; ++code) {
+    input_absinfo info{};
+    if (ioctl(device.fd, EVIOCGABS(code), &info) < 0) {
+      continue;
+    }
+    event.code = static_cast<uint16_t>(code);
+    event.value = info.value;
+    emitted += device.pad.handle(event, sink_, userData_);
+  }
+  return emitted;
+}
+
+uint32_t LinuxGamepadBackend::drainNotify() {
+  uint32_t connected = 0u;
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const ssize_t bytes = read(notifyFd_, buffer, sizeof(buffer));
+    if (bytes <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < bytes;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      if (event->len > 0u && std::strncmp(event->name, "event", 5u) == 0) {
+        connected += openPath(std::string("/dev/input/") + event->name) ? 1u : 0u;
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+  }
+  return connected;
+}
+
+void LinuxGamepadBackend::closeDevice(std::list<Device>::iterator it, bool emit) {
+  if (it == devices_.end()) {
+    return;
+  }
+  if (epollFd_ >= 0) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->fd, nullptr);
+  }
+  close(it->fd);
+  const uint32_t deviceId = it->pad.deviceId();
+  devices_.erase(it);
+  if (emit) {
+    emit_device(sink_, userData_, deviceId, false);
+  }
+}
+
+} // namespace PrimeHost
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "PrimeHost/Host.h"
+#include "GamepadMapping.h"
+#include "platform/linux/EvdevUtil.h"
+
+namespace PrimeHost {
+
+using GamepadEventSink = void (*)(const InputEvent& event, void* userData);
+
+// Translates one device's evdev events into gamepad events. Raw buttons, axes and hats are
+// numbered the way SDL numbers them, so gamecontrollerdb mappings apply unchanged. Devices
+// without a database entry that follow the kernel gamepad layout get a built-in mapping; anything
+// else reports raw indices from GamepadRawControlBase. Never allocates after construction.
+class EvdevGamepad {
+public:
+  static constexpr uint8_t NoIndex = 0xFFu;
+  static constexpr uint32_t MaxHats = 4u;
+
+  EvdevGamepad(uint32_t deviceId, const EvdevDeviceInfo& info, std::optional<GamepadMapping> mapping);
+
+  static bool looksLikeGamepad(const EvdevDeviceInfo& info);
+
+  uint32_t deviceId() const { return deviceId_; }
+  bool mapped() const { return mapped_; }
+  const GamepadMapping& mapping() const { return mapping_; }
+  uint32_t buttonCount() const { return buttonCount_; }
+  uint32_t axisCount() const { return axisCount_; }
+  uint32_t hatCount() const { return hatCount_; }
+
+  // Returns the number of events emitted.
+  uint32_t handle(const input_event& event, GamepadEventSink sink, void* userData);
+
+private:
+  void bindKernelLayout(const EvdevDeviceInfo& info);
+  float normalize(uint8_t axis, int32_t value) const;
+  float bindingValue(const GamepadBinding& binding) const;
+  uint32_t updateBindings(GamepadInputKind kind, uint8_t index, GamepadEventSink sink, void* userData);
+  void seedBindings();
+
+  uint32_t deviceId_ = 0u;
+  bool mapped_ = false;
+  GamepadMapping mapping_{};
+  std::array<float, GamepadMaxBindings> bindingState_{};
+
+  std::array<uint8_t, KEY_CNT> keyToButton_{};
+  std::array<uint8_t, ABS_CNT> absToAxis_{};
+  uint32_t buttonCount_ = 0u;
+  uint32_t axisCount_ = 0u;
+  uint32_t hatCount_ = 0u;
+  std::array<int32_t, ABS_CNT> axisMin_{};
+  std::array<int32_t, ABS_CNT> axisMax_{};
+  std::array<float, ABS_CNT> axisValue_{};
+  std::bitset<ABS_CNT> absPresent_;
+  std::array<bool, NoIndex> buttonState_{};
+  std::array<std::array<int8_t, 2>, MaxHats> hatAxes_{};
+};
+
+// epoll-driven evdev reader. Watches /dev/input with inotify for hot-plug and emits
+// DeviceEvent/GamepadButtonEvent/GamepadAxisEvent through a plain function pointer. Reads go
+// into a fixed buffer, so the poll loop does not allocate per event.
+class LinuxGamepadBackend {
+public:
+  LinuxGamepadBackend();
+  ~LinuxGamepadBackend();
+
+  LinuxGamepadBackend(const LinuxGamepadBackend&) = delete;
+  LinuxGamepadBackend& operator=(const LinuxGamepadBackend&) = delete;
+
+  // Creates the epoll set. With `scanDevices`, also opens every gamepad under /dev/input and
+  // watches for new ones.
+  HostStatus start(GamepadEventSink sink, void* userData, bool scanDevices = true);
+  void stop();
+
+  // Adopts an already-open, non-blocking descriptor that yields `input_event` records. Used for
+  // evdev nodes found by the scan and, in tests, for pipes replaying recorded events.
+  HostResult<uint32_t> addDevice(int fd, const EvdevDeviceInfo& info);
+  HostStatus removeDevice(uint32_t deviceId);
+
+  // Waits up to `timeout` for input and dispatches it. Returns the number of events emitted.
+  HostResult<uint32_t> poll(std::chrono::milliseconds timeout);
+
+  GamepadMappingDb& mappings() { return mappings_; }
+  const EvdevGamepad* device(uint32_t deviceId) const;
+
+private:
+  struct Device {
+    int fd = -1;
+    std::string path;
+    EvdevGamepad pad;
+    // Set by SYN_DROPPED; events are skipped until the next SYN_REPORT, then state is re-read.
+    bool dropped = false;
+  };
+
+  void scanDevices();
+  bool openPath(const std::string& path);
+  uint32_t readDevice(Device& device, bool& alive);
+  uint32_t resync(Device& device);
+  uint32_t drainNotify();
+  void closeDevice(std::list<Device>::iterator it, bool emit);
+
+  GamepadMappingDb mappings_;
+  GamepadEventSink sink_ = nullptr;
+  void* userData_ = nullptr;
+  int epollFd_ = -1;
+  int notifyFd_ = -1;
+  uint32_t nextDeviceId_ = 1u;
+  std::list<Device> devices_;
+  std::array<input_event, 64> readBuffer_{};
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,432 @@
+#include "platform/linux/RawInputEvdev.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace PrimeHost {
+namespace {
+
+constexpr uint64_t kStopToken = 0u;
+constexpr uint64_t kNotifyToken = UINT64_MAX;
+
+// High-resolution wheels report 120 units per detent alongside the legacy REL_WHEEL counts.
+constexpr float kHiResWheelUnits = 120.0f;
+
+int mouse_button_bit(uint32_t code) {
+  switch (code) {
+    case BTN_LEFT:
+      return 0;
+    case BTN_RIGHT:
+      return 1;
+    case BTN_MIDDLE:
+      return 2;
+    case BTN_SIDE:
+      return 3;
+    case BTN_EXTRA:
+      return 4;
+    default:
+      return -1;
+  }
+}
+
+int pen_button_bit(uint32_t code) {
+  switch (code) {
+    case BTN_TOUCH:
+      return 0;
+    case BTN_STYLUS:
+      return 1;
+    case BTN_STYLUS2:
+      return 2;
+    default:
+      return -1;
+  }
+}
+
+bool is_pen(const EvdevDeviceInfo& info) {
+  return info.keys[BTN_TOOL_PEN] && info.axes[ABS_X] && info.axes[ABS_Y];
+}
+
+} // namespace
+
+EvdevRawPointer::EvdevRawPointer(uint32_t deviceId, const EvdevDeviceInfo& info)
+    : deviceId_(deviceId), absInfo_(info.absInfo) {
+  sample_.deviceId = deviceId;
+  sample_.deviceType = is_pen(info) ? RawInputDeviceType::Pen : RawInputDeviceType::Mouse;
+  hiResWheel_ = info.relative[REL_WHEEL_HI_RES];
+  hiResHWheel_ = info.relative[REL_HWHEEL_HI_RES];
+}
+
+bool EvdevRawPointer::looksLikePointer(const EvdevDeviceInfo& info) {
+  if (is_pen(info)) {
+    return true;
+  }
+  return info.relative[REL_X] && info.relative[REL_Y] && info.keys[BTN_LEFT];
+}
+
+bool EvdevRawPointer::handle(const input_event& event,
+                             double uptimeSeconds,
+                             std::chrono::steady_clock::time_point now,
+                             RawInputSample& out) {
+  const bool pen = sample_.deviceType == RawInputDeviceType::Pen;
+  switch (event.type) {
+    case EV_REL:
+      switch (event.code) {
+        case REL_X:
+          sample_.deltaX += event.value;
+          break;
+        case REL_Y:
+          sample_.deltaY += event.value;
+          break;
+        case REL_WHEEL:
+          if (hiResWheel_) {
+            return false;
+          }
+          sample_.scrollY += static_cast<float>(event.value);
+          break;
+        case REL_HWHEEL:
+          if (hiResHWheel_) {
+            return false;
+          }
+          sample_.scrollX += static_cast<float>(event.value);
+          break;
+        case REL_WHEEL_HI_RES:
+          sample_.scrollY += static_cast<float>(event.value) / kHiResWheelUnits;
+          break;
+        case REL_HWHEEL_HI_RES:
+          sample_.scrollX += static_cast<float>(event.value) / kHiResWheelUnits;
+          break;
+        default:
+          return false;
+      }
+      changed_ = true;
+      return false;
+    case EV_KEY: {
+      if (pen && (event.code == BTN_TOOL_PEN || event.code == BTN_TOOL_RUBBER)) {
+        inRange_ = event.value != 0;
+        if (!inRange_) {
+          sample_.buttons = 0u;
+          sample_.pressure = 0.0f;
+        }
+        changed_ = true;
+        return false;
+      }
+      const int bit = pen ? pen_button_bit(event.code) : mouse_button_bit(event.code);
+      if (bit < 0) {
+        return false;
+      }
+      const uint32_t mask = 1u << static_cast<uint32_t>(bit);
+      sample_.buttons = event.value != 0 ? (sample_.buttons | mask) : (sample_.buttons & ~mask);
+      changed_ = true;
+      return false;
+    }
+    case EV_ABS:
+      if (!pen) {
+        return false;
+      }
+      switch (event.code) {
+        case ABS_X:
+          sample_.x = normalize(event.code, event.value);
+          break;
+        case ABS_Y:
+          sample_.y = normalize(event.code, event.value);
+          break;
+        case ABS_PRESSURE:
+          sample_.pressure = normalize(event.code, event.value);
+          break;
+        case ABS_TILT_X:
+          sample_.tiltX = normalizeTilt(event.code, event.value);
+          break;
+        case ABS_TILT_Y:
+          sample_.tiltY = normalizeTilt(event.code, event.value);
+          break;
+        default:
+          return false;
+      }
+      changed_ = true;
+      return false;
+    case EV_SYN:
+      if (event.code != SYN_REPORT || !changed_) {
+        return false;
+      }
+      sample_.time = evdevEventTime(event, uptimeSeconds, now);
+      out = sample_;
+      resetPending();
+      return true;
+    default:
+      return false;
+  }
+}
+
+void EvdevRawPointer::resetPending() {
+  sample_.deltaX = 0;
+  sample_.deltaY = 0;
+  sample_.scrollX = 0.0f;
+  sample_.scrollY = 0.0f;
+  changed_ = false;
+}
+
+float EvdevRawPointer::normalize(uint32_t code, int32_t value) const {
+  const input_absinfo& info = absInfo_[code];
+  if (info.maximum <= info.minimum) {
+    return 0.0f;
+  }
+  const float t = static_cast<float>(value - info.minimum) / static_cast<float>(info.maximum - info.minimum);
+  return std::clamp(t, 0.0f, 1.0f);
+}
+
+float EvdevRawPointer::normalizeTilt(uint32_t code, int32_t value) const {
+  return absInfo_[code].maximum > absInfo_[code].minimum ? normalize(code, value) * 2.0f - 1.0f : 0.0f;
+}
+
+LinuxRawInputReader::LinuxRawInputReader() = default;
+
+LinuxRawInputReader::~LinuxRawInputReader() {
+  stop();
+}
+
+HostStatus LinuxRawInputReader::start(RawInputQueue& queue, bool scanDevices) {
+  stop();
+  queue_ = &queue;
+  epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+  stopFd_ = eventfd(0u, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epollFd_ < 0 || stopFd_ < 0) {
+    stop();
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = kStopToken;
+  if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, stopFd_, &event) < 0) {
+    stop();
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  if (scanDevices) {
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd_ >= 0) {
+      // New nodes may appear before udev fixes their permissions, so retry on IN_ATTRIB too.
+      event.data.u64 = kNotifyToken;
+      if (inotify_add_watch(notifyFd_, "/dev/input", IN_CREATE | IN_ATTRIB) < 0 ||
+          epoll_ctl(epollFd_, EPOLL_CTL_ADD, notifyFd_, &event) < 0) {
+        close(notifyFd_);
+        notifyFd_ = -1;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    this->scanDevices();
+  }
+  thread_ = std::thread([this]() { run(); });
+  return {};
+}
+
+void LinuxRawInputReader::stop() {
+  if (thread_.joinable()) {
+    const uint64_t one = 1u;
+    [[maybe_unused]] ssize_t written = write(stopFd_, &one, sizeof(one));
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!devices_.empty()) {
+    closeDevice(devices_.begin());
+  }
+  for (int* fd : {&notifyFd_, &stopFd_, &epollFd_}) {
+    if (*fd >= 0) {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+  queue_ = nullptr;
+}
+
+HostResult<uint32_t> LinuxRawInputReader::addDevice(int fd, const EvdevDeviceInfo& info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return adopt(fd, info);
+}
+
+HostStatus LinuxRawInputReader::removeDevice(uint32_t deviceId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::find_if(devices_.begin(), devices_.end(), [&](const Device& device) {
+    return device.pointer.deviceId() == deviceId;
+  });
+  if (it == devices_.end()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  closeDevice(it);
+  return {};
+}
+
+void LinuxRawInputReader::setGrab(bool grab) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  grab_ = grab;
+  for (const Device& device : devices_) {
+    ioctl(device.fd, EVIOCGRAB, grab ? 1 : 0);
+  }
+}
+
+HostResult<uint32_t> LinuxRawInputReader::adopt(int fd, const EvdevDeviceInfo& info) {
+  if (epollFd_ < 0 || fd < 0) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const uint32_t deviceId = nextDeviceId_++;
+  devices_.emplace_back(Device{fd, {}, EvdevRawPointer(deviceId, info)});
+  epoll_event event{};
+  event.events = EPOLLIN;
+  // Wake-ups carry the id rather than a pointer, so a device removed while the thread is between
+  // epoll_wait and the lock is simply not found.
+  event.data.u64 = deviceId;
+  if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    devices_.pop_back();
+    close(fd);
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  if (grab_) {
+    ioctl(fd, EVIOCGRAB, 1);
+  }
+  return deviceId;
+}
+
+void LinuxRawInputReader::run() {
+  epoll_event ready[16];
+  for (;;) {
+    const int count = epoll_wait(epollFd_, ready, 16, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < count; ++i) {
+      const uint64_t token = ready[i].data.u64;
+      if (token == kStopToken) {
+        return;
+      }
+      if (token == kNotifyToken) {
+        drainNotify();
+        continue;
+      }
+      auto it = std::find_if(devices_.begin(), devices_.end(), [&](const Device& device) {
+        return device.pointer.deviceId() == token;
+      });
+      if (it == devices_.end()) {
+        continue;
+      }
+      bool alive = true;
+      readDevice(*it, alive);
+      if (!alive) {
+        closeDevice(it);
+      }
+    }
+  }
+}
+
+void LinuxRawInputReader::scanDevices() {
+  DIR* dir = opendir("/dev/input");
+  if (!dir) {
+    return;
+  }
+  while (dirent* entry = readdir(dir)) {
+    if (std::strncmp(entry->d_name, "event", 5u) == 0) {
+      openPath(std::string("/dev/input/") + entry->d_name);
+    }
+  }
+  closedir(dir);
+}
+
+bool LinuxRawInputReader::openPath(const std::string& path) {
+  for (const Device& device : devices_) {
+    if (device.path == path) {
+      return false;
+    }
+  }
+  const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  EvdevDeviceInfo info{};
+  if (!readEvdevDeviceInfo(fd, info) || !EvdevRawPointer::looksLikePointer(info)) {
+    close(fd);
+    return false;
+  }
+  useMonotonicEvdevClock(fd);
+  if (!adopt(fd, info)) {
+    return false;
+  }
+  devices_.back().path = path;
+  return true;
+}
+
+void LinuxRawInputReader::readDevice(Device& device, bool& alive) {
+  for (;;) {
+    const ssize_t bytes = read(device.fd, readBuffer_.data(), sizeof(readBuffer_));
+    if (bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      alive = errno == EAGAIN || errno == EWOULDBLOCK;
+      return;
+    }
+    if (bytes == 0) {
+      alive = false;
+      return;
+    }
+    // One clock pair per read keeps the samples of a burst in device order.
+    const double uptime = monotonicUptimeSeconds();
+    const auto now = std::chrono::steady_clock::now();
+    const size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+    for (size_t i = 0; i < count; ++i) {
+      const input_event& event = readBuffer_[i];
+      if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+        device.dropped = true;
+        continue;
+      }
+      if (device.dropped) {
+        // The kernel ring overflowed; the partial report is unusable, so resume at the next one.
+        if (event.type == EV_SYN && event.code == SYN_REPORT) {
+          device.dropped = false;
+          device.pointer.resetPending();
+        }
+        continue;
+      }
+      RawInputSample sample;
+      if (device.pointer.handle(event, uptime, now, sample)) {
+        queue_->push(sample);
+      }
+    }
+  }
+}
+
+void LinuxRawInputReader::drainNotify() {
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const ssize_t bytes = read(notifyFd_, buffer, sizeof(buffer));
+    if (bytes <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < bytes;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      if (event->len > 0u && std::strncmp(event->name, "event", 5u) == 0) {
+        openPath(std::string("/dev/input/") + event->name);
+      }
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+  }
+}
+
+void LinuxRawInputReader::closeDevice(std::list<Device>::iterator it) {
+  if (epollFd_ >= 0) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->fd, nullptr);
+  }
+  close(it->fd);
+  devices_.erase(it);
+}
+
+} // namespace PrimeHost
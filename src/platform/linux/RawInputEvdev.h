@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "PrimeHost/Host.h"
+#include "RawInputQueue.h"
+#include "platform/linux/EvdevUtil.h"
+
+namespace PrimeHost {
+
+// Folds one pointer device's evdev events into RawInputSamples, one per SYN_REPORT. Mice report
+// EV_REL counts and BTN_LEFT/RIGHT/MIDDLE/SIDE/EXTRA; pens report ABS_X/Y/PRESSURE/TILT_X/TILT_Y
+// while a BTN_TOOL_PEN/RUBBER tool is in range, with BTN_TOUCH as the tip.
+class EvdevRawPointer {
+public:
+  EvdevRawPointer(uint32_t deviceId, const EvdevDeviceInfo& info);
+
+  static bool looksLikePointer(const EvdevDeviceInfo& info);
+
+  uint32_t deviceId() const { return deviceId_; }
+  RawInputDeviceType deviceType() const { return sample_.deviceType; }
+
+  // Returns true when `event` completes a sample, which is then copied to `out`. Reports with no
+  // motion, button change or pen contact produce no sample.
+  bool handle(const input_event& event,
+              double uptimeSeconds,
+              std::chrono::steady_clock::time_point now,
+              RawInputSample& out);
+
+  // Discards the partial report after SYN_DROPPED.
+  void resetPending();
+
+private:
+  float normalize(uint32_t code, int32_t value) const;
+  float normalizeTilt(uint32_t code, int32_t value) const;
+
+  uint32_t deviceId_ = 0u;
+  RawInputSample sample_{};
+  bool changed_ = false;
+  bool inRange_ = false;
+  bool hiResWheel_ = false;
+  bool hiResHWheel_ = false;
+  std::array<input_absinfo, ABS_CNT> absInfo_{};
+};
+
+// Reader thread for high-rate mice and pens. Blocks in epoll on every pointer node under
+// /dev/input and pushes samples straight into a RawInputQueue, so device-rate input never waits
+// on the UI loop and the thread does not allocate per event.
+class LinuxRawInputReader {
+public:
+  LinuxRawInputReader();
+  ~LinuxRawInputReader();
+
+  LinuxRawInputReader(const LinuxRawInputReader&) = delete;
+  LinuxRawInputReader& operator=(const LinuxRawInputReader&) = delete;
+
+  // Starts the reader thread. `queue` must outlive stop(). With `scanDevices`, also opens every
+  // pointer device under /dev/input and watches for new ones.
+  HostStatus start(RawInputQueue& queue, bool scanDevices = true);
+  void stop();
+  bool running() const { return thread_.joinable(); }
+
+  // Adopts an already-open, non-blocking descriptor that yields `input_event` records; safe while
+  // the thread runs. Used for scanned nodes and, in tests, for pipes replaying recorded events.
+  HostResult<uint32_t> addDevice(int fd, const EvdevDeviceInfo& info);
+  HostStatus removeDevice(uint32_t deviceId);
+
+  // EVIOCGRAB on every device, including ones connected later. Used while relative pointer
+  // capture is active so the compositor does not also move the cursor.
+  void setGrab(bool grab);
+
+private:
+  struct Device {
+    int fd = -1;
+    std::string path;
+    EvdevRawPointer pointer;
+    bool dropped = false;
+  };
+
+  void run();
+  // The helpers below expect `mutex_` to be held.
+  HostResult<uint32_t> adopt(int fd, const EvdevDeviceInfo& info);
+  void scanDevices();
+  bool openPath(const std::string& path);
+  void readDevice(Device& device, bool& alive);
+  void drainNotify();
+  void closeDevice(std::list<Device>::iterator it);
+
+  RawInputQueue* queue_ = nullptr;
+  int epollFd_ = -1;
+  int stopFd_ = -1;
+  int notifyFd_ = -1;
+  uint32_t nextDeviceId_ = 1u;
+  bool grab_ = false;
+  std::mutex mutex_;
+  std::list<Device> devices_;
+  std::thread thread_;
+  std::array<input_event, 64> readBuffer_{};
+};
+
+} // namespace PrimeHost
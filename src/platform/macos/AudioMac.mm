@@ -5,10 +5,16 @@
 #include "PrimeHost/Audio.h"
 #include "PrimeHost/AudioConfigDefaults.h"
 #include "PrimeHost/AudioConfigValidation.h"
+#include "AudioDeviceSwitch.h"
+#include "AudioMixer.h"
+#include "SpscRing.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -22,15 +28,54 @@ struct AudioDeviceRecord {
   std::string nameStorage;
 };
 
+class AudioHostMac;
+
+// One HAL output unit bound to a device. A stream owns two so it can open the new default
+// device next to the old one and crossfade between them.
+struct AudioOutputLane {
+  AudioHostMac* host = nullptr;
+  uint32_t index = 0u;
+  AudioComponentInstance unit = nullptr;
+  AudioDeviceId deviceId = 0;
+  uint32_t sampleRate = 0u;
+  bool interleaved = true;
+  SampleFormat sampleFormat = SampleFormat::Float32;
+  uint32_t bytesPerSample = 0u;
+  uint32_t scratchFrames = 0u;
+  std::vector<float> scratchInterleaved;
+};
+
+// A HAL unit with only its input element enabled. Capture streams hand each pulled buffer to the
+// capture callback; duplex streams queue it for the output callback instead.
+struct AudioInputUnit {
+  AudioHostMac* host = nullptr;
+  AudioComponentInstance unit = nullptr;
+  AudioDeviceId deviceId = 0;
+  uint32_t sampleRate = 0u;
+  uint32_t channels = 0u;
+  uint32_t maxFrames = 0u;
+  bool duplex = false;
+  uint64_t frameIndex = 0u;
+  std::vector<float> scratch;
+};
+
 class AudioHostMac final : public AudioHost {
 public:
   AudioHostMac() {
+    for (uint32_t i = 0; i < lanes_.size(); ++i) {
+      lanes_[i].host = this;
+      lanes_[i].index = i;
+    }
+    capture_.host = this;
+    duplexInput_.host = this;
+    duplexInput_.duplex = true;
     installDeviceListeners();
     refreshDevices(false);
   }
 
   ~AudioHostMac() override {
     removeDeviceListeners();
+    closeCaptureStream();
     closeStream();
   }
 
@@ -73,225 +118,207 @@ public:
                         const AudioStreamConfig& config,
                         AudioCallback callback,
                         void* userData) override {
-    refreshDevices(false);
-    if (devices_.find(deviceId) == devices_.end()) {
-      return std::unexpected(HostError{HostErrorCode::InvalidDevice});
-    }
-    if (!callback) {
+    closeDuplexInput();
+    return openOutputStream(deviceId, config, callback, userData);
+  }
+
+  HostStatus startStream() override {
+    AudioOutputLane& lane = lanes_[switcher_.currentLane()];
+    if (!lane.unit) {
       return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    AudioStreamConfig resolved = resolveAudioStreamConfig(config);
-    auto validation = validateAudioStreamConfig(resolved);
-    if (!validation) {
-      return validation;
-    }
-    if (config.format.format != SampleFormat::Float32 && config.format.format != SampleFormat::Int16) {
-      return std::unexpected(HostError{HostErrorCode::Unsupported});
-    }
-
-    closeStream();
-
-    AudioComponentDescription desc{};
-    desc.componentType = kAudioUnitType_Output;
-    desc.componentSubType = kAudioUnitSubType_HALOutput;
-    desc.componentManufacturer = kAudioUnitManufacturer_Apple;
-
-    AudioComponent component = AudioComponentFindNext(nullptr, &desc);
-    if (!component) {
+    if (duplexInput_.unit && AudioOutputUnitStart(duplexInput_.unit) != noErr) {
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
-
-    AudioComponentInstance unit = nullptr;
-    if (AudioComponentInstanceNew(component, &unit) != noErr) {
+    if (AudioOutputUnitStart(lane.unit) != noErr) {
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
+    streamRunning_ = true;
+    return {};
+  }
 
-    UInt32 enableIO = 1u;
-    if (AudioUnitSetProperty(unit,
-                             kAudioOutputUnitProperty_EnableIO,
-                             kAudioUnitScope_Output,
-                             0,
-                             &enableIO,
-                             sizeof(enableIO)) != noErr) {
-      AudioComponentInstanceDispose(unit);
-      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  HostStatus stopStream() override {
+    AudioOutputLane& lane = lanes_[switcher_.currentLane()];
+    if (!lane.unit) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    enableIO = 0u;
-    AudioUnitSetProperty(unit,
-                         kAudioOutputUnitProperty_EnableIO,
-                         kAudioUnitScope_Input,
-                         1,
-                         &enableIO,
-                         sizeof(enableIO));
-
-    AudioDeviceID coreId = static_cast<AudioDeviceID>(deviceId);
-    if (AudioUnitSetProperty(unit,
-                             kAudioOutputUnitProperty_CurrentDevice,
-                             kAudioUnitScope_Global,
-                             0,
-                             &coreId,
-                             sizeof(coreId)) != noErr) {
-      AudioComponentInstanceDispose(unit);
+    AudioOutputLane& other = lanes_[switcher_.incomingLane()];
+    if (other.unit) {
+      AudioOutputUnitStop(other.unit);
+    }
+    if (AudioOutputUnitStop(lane.unit) != noErr) {
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
-
-    UInt32 maxFrames = std::max(resolved.bufferFrames, resolved.periodFrames);
-    if (maxFrames == 0u) {
-      maxFrames = 512u;
+    if (duplexInput_.unit) {
+      AudioOutputUnitStop(duplexInput_.unit);
     }
-    AudioUnitSetProperty(unit,
-                         kAudioUnitProperty_MaximumFramesPerSlice,
-                         kAudioUnitScope_Global,
-                         0,
-                         &maxFrames,
-                         sizeof(maxFrames));
+    streamRunning_ = false;
+    // Both units are stopped, so a switch in flight can be resolved without the render threads.
+    if (auto settled = switcher_.settle()) {
+      finishDeviceSwitch(*settled);
+    }
+    return {};
+  }
 
-    const bool interleaved = resolved.format.interleaved;
-    const bool isFloat = resolved.format.format == SampleFormat::Float32;
-    const uint32_t bitsPerChannel = isFloat ? 32u : 16u;
-    const uint32_t bytesPerSample = bitsPerChannel / 8u;
-    const uint32_t bytesPerFrame = interleaved ? bytesPerSample * resolved.format.channels : bytesPerSample;
+  HostStatus closeStream() override {
+    closeDuplexInput();
+    return closeOutputStream();
+  }
 
-    AudioStreamBasicDescription format{};
-    format.mSampleRate = static_cast<Float64>(resolved.format.sampleRate);
-    format.mFormatID = kAudioFormatLinearPCM;
-    format.mFormatFlags = static_cast<AudioFormatFlags>(kAudioFormatFlagsNativeEndian);
-    format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsPacked);
-    if (isFloat) {
-      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsFloat);
-    } else {
-      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsSignedInteger);
-    }
-    if (!interleaved) {
-      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsNonInterleaved);
+  HostResult<AudioStreamConfig> activeConfig() const override {
+    if (!lanes_[switcher_.currentLane()].unit) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    format.mFramesPerPacket = 1;
-    format.mChannelsPerFrame = resolved.format.channels;
-    format.mBitsPerChannel = bitsPerChannel;
-    format.mBytesPerFrame = bytesPerFrame;
-    format.mBytesPerPacket = format.mBytesPerFrame * format.mFramesPerPacket;
+    return activeConfig_;
+  }
 
-    if (AudioUnitSetProperty(unit,
-                             kAudioUnitProperty_StreamFormat,
-                             kAudioUnitScope_Input,
-                             0,
-                             &format,
-                             sizeof(format)) != noErr) {
-      AudioComponentInstanceDispose(unit);
-      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  HostResult<size_t> inputDevices(std::span<AudioDeviceInfo> outDevices) const override {
+    refreshDevices(false);
+    if (outDevices.empty()) {
+      return inputOrder_.size();
+    }
+    if (outDevices.size() < inputOrder_.size()) {
+      return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+    }
+    size_t count = 0u;
+    for (AudioDeviceId deviceId : inputOrder_) {
+      auto it = inputs_.find(deviceId);
+      if (it != inputs_.end()) {
+        outDevices[count++] = it->second.info;
+      }
     }
+    return count;
+  }
 
-    AURenderCallbackStruct render{};
-    render.inputProc = &AudioHostMac::renderCallback;
-    render.inputProcRefCon = this;
-    if (AudioUnitSetProperty(unit,
-                             kAudioUnitProperty_SetRenderCallback,
-                             kAudioUnitScope_Input,
-                             0,
-                             &render,
-                             sizeof(render)) != noErr) {
-      AudioComponentInstanceDispose(unit);
-      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  HostResult<AudioDeviceInfo> inputDeviceInfo(AudioDeviceId deviceId) const override {
+    refreshDevices(false);
+    auto it = inputs_.find(deviceId);
+    if (it == inputs_.end()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDevice});
     }
+    return it->second.info;
+  }
 
-    if (AudioUnitInitialize(unit) != noErr) {
-      AudioComponentInstanceDispose(unit);
-      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  HostResult<AudioDeviceId> defaultInputDevice() const override {
+    refreshDevices(false);
+    if (defaultInputDevice_ == 0) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
     }
+    return defaultInputDevice_;
+  }
 
-    unit_ = unit;
-    callback_ = callback;
-    userData_ = userData;
-    activeConfig_ = resolved;
-    activeDevice_ = deviceId;
-    activeChannels_ = config.format.channels;
-    frameIndex_ = 0u;
-    outputInterleaved_ = interleaved;
-    outputSampleFormat_ = config.format.format;
-    bytesPerSample_ = bytesPerSample;
-    scratchFrames_ = maxFrames;
-    AudioStreamBasicDescription actualFormat{};
-    UInt32 actualSize = sizeof(actualFormat);
-    if (AudioUnitGetProperty(unit_,
-                             kAudioUnitProperty_StreamFormat,
-                             kAudioUnitScope_Input,
-                             0,
-                             &actualFormat,
-                             &actualSize) == noErr) {
-      if (actualFormat.mSampleRate > 0.0) {
-        activeConfig_.format.sampleRate = static_cast<uint32_t>(actualFormat.mSampleRate);
-      }
-      const bool actualNonInterleaved =
-          (actualFormat.mFormatFlags & kAudioFormatFlagIsNonInterleaved) == kAudioFormatFlagIsNonInterleaved;
-      activeConfig_.format.interleaved = !actualNonInterleaved;
-      outputInterleaved_ = !actualNonInterleaved;
-      if (actualFormat.mFormatFlags & kAudioFormatFlagIsFloat) {
-        activeConfig_.format.format = SampleFormat::Float32;
-        outputSampleFormat_ = SampleFormat::Float32;
-        bytesPerSample_ = 4u;
-      } else if ((actualFormat.mFormatFlags & kAudioFormatFlagIsSignedInteger) &&
-                 actualFormat.mBitsPerChannel == 16) {
-        activeConfig_.format.format = SampleFormat::Int16;
-        outputSampleFormat_ = SampleFormat::Int16;
-        bytesPerSample_ = 2u;
-      }
+  HostStatus openCaptureStream(AudioDeviceId deviceId,
+                               const AudioStreamConfig& config,
+                               AudioCaptureCallback callback,
+                               void* userData) override {
+    if (!callback) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    if (!outputInterleaved_ || outputSampleFormat_ != SampleFormat::Float32) {
-      scratchInterleaved_.assign(static_cast<size_t>(scratchFrames_) * activeChannels_, 0.0f);
-    } else {
-      scratchInterleaved_.clear();
+    AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+    auto checked = checkInputConfig(deviceId, resolved);
+    if (!checked) {
+      return checked;
+    }
+    if (duplexInput_.deviceId == deviceId) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+    }
+    closeCaptureStream();
+    auto created = createInputUnit(capture_, deviceId, resolved);
+    if (!created) {
+      return created;
     }
+    captureCallback_ = callback;
+    captureUserData_ = userData;
+    captureConfig_ = resolved;
+    captureConfig_.format.format = SampleFormat::Float32;
+    captureConfig_.format.interleaved = true;
     return {};
   }
 
-  HostStatus startStream() override {
-    if (!unit_) {
+  HostStatus startCaptureStream() override {
+    if (!capture_.unit) {
       return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    if (AudioOutputUnitStart(unit_) != noErr) {
+    if (AudioOutputUnitStart(capture_.unit) != noErr) {
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
-    streamRunning_ = true;
     return {};
   }
 
-  HostStatus stopStream() override {
-    if (!unit_) {
+  HostStatus stopCaptureStream() override {
+    if (!capture_.unit) {
       return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    if (AudioOutputUnitStop(unit_) != noErr) {
+    if (AudioOutputUnitStop(capture_.unit) != noErr) {
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
-    streamRunning_ = false;
     return {};
   }
 
-  HostStatus closeStream() override {
-    if (!unit_) {
-      return {};
-    }
-    AudioOutputUnitStop(unit_);
-    AudioUnitUninitialize(unit_);
-    AudioComponentInstanceDispose(unit_);
-    unit_ = nullptr;
-    callback_ = nullptr;
-    userData_ = nullptr;
-    activeDevice_ = 0;
-    activeChannels_ = 0u;
-    scratchInterleaved_.clear();
-    scratchFrames_ = 0u;
-    outputInterleaved_ = true;
-    outputSampleFormat_ = SampleFormat::Float32;
-    bytesPerSample_ = 0u;
-    streamRunning_ = false;
+  HostStatus closeCaptureStream() override {
+    destroyInputUnit(capture_);
+    captureCallback_ = nullptr;
+    captureUserData_ = nullptr;
     return {};
   }
 
-  HostResult<AudioStreamConfig> activeConfig() const override {
-    if (!unit_) {
+  HostResult<AudioStreamConfig> activeCaptureConfig() const override {
+    if (!capture_.unit) {
       return std::unexpected(HostError{HostErrorCode::InvalidConfig});
     }
-    return activeConfig_;
+    return captureConfig_;
+  }
+
+  HostStatus openDuplexStream(AudioDeviceId inputDeviceId,
+                              AudioDeviceId outputDeviceId,
+                              const AudioStreamConfig& config,
+                              AudioDuplexCallback callback,
+                              void* userData) override {
+    if (!callback) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+    auto checked = checkInputConfig(inputDeviceId, resolved);
+    if (!checked) {
+      return checked;
+    }
+    if (capture_.deviceId == inputDeviceId) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+    }
+    closeStream();
+    auto opened = openOutputStream(outputDeviceId, config, &AudioHostMac::renderDuplex, this);
+    if (!opened) {
+      return opened;
+    }
+    auto created = createInputUnit(duplexInput_, inputDeviceId, resolved);
+    if (!created) {
+      closeOutputStream();
+      return created;
+    }
+    // Room for several device periods so the two HAL threads can drift by a buffer or two.
+    duplexRing_.reset(static_cast<size_t>(duplexInput_.maxFrames) * 8u * duplexInput_.channels);
+    duplexBuffer_.assign(static_cast<size_t>(lanes_[0].scratchFrames) * activeChannels_, 0.0f);
+    duplexCallback_ = callback;
+    duplexUserData_ = userData;
+    return {};
+  }
+
+  HostResult<AudioMixStreamId> addMixStream(const AudioMixStreamConfig& config,
+                                            AudioCallback callback,
+                                            void* userData) override {
+    return mixer_.addStream(config, callback, userData);
+  }
+
+  HostStatus removeMixStream(AudioMixStreamId streamId) override {
+    return mixer_.removeStream(streamId);
+  }
+
+  HostStatus setMixStreamGain(AudioMixStreamId streamId, float gain) override {
+    return mixer_.setStreamGain(streamId, gain);
+  }
+
+  HostResult<AudioMixStreamStats> mixStreamStats(AudioMixStreamId streamId) const override {
+    return mixer_.streamStats(streamId);
   }
 
   HostStatus setCallbacks(AudioCallbacks callbacks) override {
@@ -301,6 +328,76 @@ public:
   }
 
 private:
+  HostStatus openOutputStream(AudioDeviceId deviceId,
+                              const AudioStreamConfig& config,
+                              AudioCallback callback,
+                              void* userData) {
+    refreshDevices(false);
+    if (devices_.find(deviceId) == devices_.end()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+    }
+    if (!callback) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+    auto validation = validateAudioStreamConfig(resolved);
+    if (!validation) {
+      return validation;
+    }
+    if (config.format.format != SampleFormat::Float32 && config.format.format != SampleFormat::Int16) {
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+
+    closeOutputStream();
+
+    AudioOutputLane& lane = lanes_[0];
+    auto created = createLaneUnit(lane, deviceId, resolved);
+    if (!created) {
+      return created;
+    }
+
+    callback_ = callback;
+    userData_ = userData;
+    activeConfig_ = resolved;
+    activeConfig_.format.sampleRate = lane.sampleRate;
+    activeConfig_.format.interleaved = lane.interleaved;
+    activeConfig_.format.format = lane.sampleFormat;
+    activeDevice_ = deviceId;
+    activeChannels_ = config.format.channels;
+    mixer_.prepare(activeChannels_, lane.scratchFrames, activeConfig_.format.sampleRate);
+    const auto crossfadeFrames = static_cast<uint32_t>(
+        std::chrono::duration<double>(resolved.crossfadeDuration).count() * activeConfig_.format.sampleRate);
+    switcher_.prepare(activeChannels_, lane.scratchFrames, crossfadeFrames, &AudioHostMac::renderSource, this);
+    return {};
+  }
+
+  HostStatus closeOutputStream() {
+    if (!lanes_[0].unit && !lanes_[1].unit) {
+      return {};
+    }
+    ++switchPollGeneration_;
+    for (AudioOutputLane& lane : lanes_) {
+      destroyLaneUnit(lane);
+    }
+    switcher_.release();
+    mixer_.release();
+    callback_ = nullptr;
+    userData_ = nullptr;
+    activeDevice_ = 0;
+    activeChannels_ = 0u;
+    streamRunning_ = false;
+    return {};
+  }
+
+  void closeDuplexInput() {
+    if (!duplexInput_.unit) {
+      return;
+    }
+    destroyInputUnit(duplexInput_);
+    duplexCallback_ = nullptr;
+    duplexUserData_ = nullptr;
+  }
+
   static OSStatus renderCallback(void* refCon,
                                  AudioUnitRenderActionFlags* flags,
                                  const AudioTimeStamp* timeStamp,
@@ -310,14 +407,15 @@ private:
     (void)flags;
     (void)timeStamp;
     (void)busNumber;
-    auto* self = static_cast<AudioHostMac*>(refCon);
-    if (!self || !ioData || ioData->mNumberBuffers == 0) {
+    auto* lane = static_cast<AudioOutputLane*>(refCon);
+    if (!lane || !lane->host || !ioData || ioData->mNumberBuffers == 0) {
       return noErr;
     }
+    AudioHostMac* self = lane->host;
     const uint32_t channels = self->activeChannels_ > 0 ? self->activeChannels_ : 1u;
-    const bool interleaved = self->outputInterleaved_;
-    const bool outputFloat = self->outputSampleFormat_ == SampleFormat::Float32;
-    const uint32_t bytesPerSample = self->bytesPerSample_ > 0 ? self->bytesPerSample_ : (outputFloat ? 4u : 2u);
+    const bool interleaved = lane->interleaved;
+    const bool outputFloat = lane->sampleFormat == SampleFormat::Float32;
+    const uint32_t bytesPerSample = lane->bytesPerSample > 0 ? lane->bytesPerSample : (outputFloat ? 4u : 2u);
 
     auto zeroBuffers = [&]() {
       for (UInt32 i = 0; i < ioData->mNumberBuffers; ++i) {
@@ -357,8 +455,8 @@ private:
     }
 
     uint32_t framesToWrite = std::min(numFrames, framesAvailable);
-    if (self->scratchFrames_ > 0) {
-      framesToWrite = std::min(framesToWrite, self->scratchFrames_);
+    if (lane->scratchFrames > 0) {
+      framesToWrite = std::min(framesToWrite, lane->scratchFrames);
     }
     if (framesToWrite == 0u) {
       zeroBuffers();
@@ -368,7 +466,7 @@ private:
     const size_t sampleCount = static_cast<size_t>(framesToWrite) * channels;
     const bool useDirect = outputFloat && interleaved;
     if (!useDirect) {
-      if (self->scratchInterleaved_.size() < sampleCount) {
+      if (lane->scratchInterleaved.size() < sampleCount) {
         zeroBuffers();
         return noErr;
       }
@@ -382,17 +480,11 @@ private:
     if (useDirect) {
       target = static_cast<float*>(ioData->mBuffers[0].mData);
     } else {
-      target = self->scratchInterleaved_.data();
+      target = lane->scratchInterleaved.data();
     }
 
-    AudioCallbackContext ctx{};
-    ctx.frameIndex = self->frameIndex_++;
-    ctx.time = std::chrono::steady_clock::now();
-    ctx.requestedFrames = framesToWrite;
-    ctx.isUnderrun = false;
-
     std::span<float> span{target, sampleCount};
-    self->callback_(span, ctx, self->userData_);
+    self->switcher_.render(lane->index, span);
 
     if (useDirect) {
       return noErr;
@@ -435,10 +527,74 @@ private:
     return noErr;
   }
 
-  static OSStatus deviceListener(AudioObjectID objectId,
-                                 UInt32 numberAddresses,
-                                 const AudioObjectPropertyAddress addresses[],
-                                 void* clientData) {
+  static void renderSource(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+    auto* self = static_cast<AudioHostMac*>(userData);
+    self->callback_(interleaved, ctx, self->userData_);
+    self->mixer_.render(interleaved, ctx);
+  }
+
+  static void renderDuplex(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+    auto* self = static_cast<AudioHostMac*>(userData);
+    const uint32_t channels = std::max(1u, self->activeChannels_);
+    std::span<float> input(self->duplexBuffer_.data(), std::min(interleaved.size(), self->duplexBuffer_.size()));
+    AudioDuplexContext duplex{};
+    duplex.output = ctx;
+    // Queued input was captured by earlier input callbacks; date it by how much is still queued.
+    const double queuedFrames = static_cast<double>(self->duplexRing_.size()) / channels;
+    duplex.inputTime = ctx.time - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                      std::chrono::duration<double>(queuedFrames / self->duplexInput_.sampleRate));
+    const size_t popped = self->duplexRing_.pop(input);
+    if (popped < input.size()) {
+      std::memset(input.data() + popped, 0, (input.size() - popped) * sizeof(float));
+    }
+    duplex.inputUnderrun = popped < interleaved.size();
+    self->duplexCallback_(input, interleaved, duplex, self->duplexUserData_);
+  }
+
+  static OSStatus inputCallback(void* refCon,
+                                AudioUnitRenderActionFlags* flags,
+                                const AudioTimeStamp* timeStamp,
+                                UInt32 busNumber,
+                                UInt32 numFrames,
+                                AudioBufferList* ioData) {
+    (void)ioData;
+    auto* input = static_cast<AudioInputUnit*>(refCon);
+    if (!input || !input->host || !input->unit || numFrames > input->maxFrames) {
+      return noErr;
+    }
+    const size_t sampleCount = static_cast<size_t>(numFrames) * input->channels;
+    AudioBufferList list{};
+    list.mNumberBuffers = 1;
+    list.mBuffers[0].mNumberChannels = input->channels;
+    list.mBuffers[0].mDataByteSize = static_cast<UInt32>(sampleCount * sizeof(float));
+    list.mBuffers[0].mData = input->scratch.data();
+    const OSStatus status = AudioUnitRender(input->unit, flags, timeStamp, busNumber, numFrames, &list);
+    std::span<const float> captured(input->scratch.data(), sampleCount);
+    AudioHostMac* self = input->host;
+    if (input->duplex) {
+      if (status == noErr) {
+        self->duplexRing_.push(captured);
+      }
+      return noErr;
+    }
+    AudioCallbackContext ctx{};
+    ctx.frameIndex = input->frameIndex++;
+    ctx.time = std::chrono::steady_clock::now();
+    ctx.requestedFrames = numFrames;
+    ctx.isUnderrun = status != noErr;
+    if (ctx.isUnderrun) {
+      std::memset(input->scratch.data(), 0, sampleCount * sizeof(float));
+    }
+    if (self->captureCallback_) {
+      self->captureCallback_(captured, ctx, self->captureUserData_);
+    }
+    return noErr;
+  }
+
+  static OSStatus deviceListener(AudioObjectID objectId,
+                                 UInt32 numberAddresses,
+                                 const AudioObjectPropertyAddress addresses[],
+                                 void* clientData) {
     (void)objectId;
     (void)numberAddresses;
     (void)addresses;
@@ -464,8 +620,14 @@ private:
     defaultAddress_.mScope = kAudioObjectPropertyScopeGlobal;
     defaultAddress_.mElement = kAudioObjectPropertyElementMain;
 
+    defaultInputAddress_.mSelector = kAudioHardwarePropertyDefaultInputDevice;
+    defaultInputAddress_.mScope = kAudioObjectPropertyScopeGlobal;
+    defaultInputAddress_.mElement = kAudioObjectPropertyElementMain;
+
     AudioObjectAddPropertyListener(kAudioObjectSystemObject, &devicesAddress_, &AudioHostMac::deviceListener, this);
     AudioObjectAddPropertyListener(kAudioObjectSystemObject, &defaultAddress_, &AudioHostMac::deviceListener, this);
+    AudioObjectAddPropertyListener(
+        kAudioObjectSystemObject, &defaultInputAddress_, &AudioHostMac::deviceListener, this);
     listenersInstalled_ = true;
   }
 
@@ -475,23 +637,41 @@ private:
     }
     AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &devicesAddress_, &AudioHostMac::deviceListener, this);
     AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &defaultAddress_, &AudioHostMac::deviceListener, this);
+    AudioObjectRemovePropertyListener(
+        kAudioObjectSystemObject, &defaultInputAddress_, &AudioHostMac::deviceListener, this);
     listenersInstalled_ = false;
   }
 
   void handleDeviceChange() {
     AudioDeviceId previousDefault = defaultDevice_;
     AudioDeviceId previousActive = activeDevice_;
-    bool hadStream = unit_ != nullptr;
+    bool hadStream = lanes_[switcher_.currentLane()].unit != nullptr;
     bool wasRunning = streamRunning_;
 
     refreshDevices(true);
 
+    if (capture_.unit && inputs_.find(capture_.deviceId) == inputs_.end()) {
+      closeCaptureStream();
+    }
+    if (duplexInput_.unit && inputs_.find(duplexInput_.deviceId) == inputs_.end()) {
+      // The output keeps running; the duplex callback sees inputUnderrun from here on.
+      AudioOutputUnitStop(duplexInput_.unit);
+    }
+
     if (!hadStream) {
       return;
     }
 
     const bool activePresent = lastDeviceIds_.find(previousActive) != lastDeviceIds_.end();
     const bool defaultChanged = (defaultDevice_ != 0 && defaultDevice_ != previousDefault);
+    if (activeConfig_.followDefaultDevice) {
+      if (defaultDevice_ == 0) {
+        closeStream();
+        return;
+      }
+      followDefaultDevice(!activePresent);
+      return;
+    }
     const bool shouldReopenToDefault = defaultChanged && previousActive == previousDefault;
 
     if (!activePresent || shouldReopenToDefault) {
@@ -511,8 +691,9 @@ private:
     void* userData = userData_;
     AudioStreamConfig config = activeConfig_;
 
-    closeStream();
-    if (!openStream(deviceId, config, callback, userData)) {
+    // The duplex input unit (if any) stays open; only the output side moves.
+    closeOutputStream();
+    if (!openOutputStream(deviceId, config, callback, userData)) {
       return false;
     }
     if (restart) {
@@ -523,13 +704,417 @@ private:
     return true;
   }
 
+  void followDefaultDevice(bool activeLost) {
+    if (switcher_.switchPending()) {
+      // Re-evaluated in finishDeviceSwitch() once the in-flight switch completes.
+      if (activeLost) {
+        AudioOutputLane& current = lanes_[switcher_.currentLane()];
+        if (current.unit) {
+          AudioOutputUnitStop(current.unit);
+        }
+        switcher_.outgoingLost();
+      }
+      return;
+    }
+    const AudioDeviceId target = defaultDevice_;
+    if (target == 0 || target == activeDevice_) {
+      return;
+    }
+    if (!streamRunning_) {
+      // Nothing is playing, so there is nothing to crossfade; reopen on the new device.
+      const AudioDeviceId from = activeDevice_;
+      if (reopenStream(target, false)) {
+        emitDeviceSwitch(from, target, AudioDeviceSwitcher::SwitchResult{});
+      }
+      return;
+    }
+
+    AudioOutputLane& incoming = lanes_[switcher_.incomingLane()];
+    auto created = createLaneUnit(incoming, target, activeConfig_);
+    if (!created || incoming.sampleRate != activeConfig_.format.sampleRate) {
+      // The crossfade needs both devices on the same timeline; fall back to a plain reopen.
+      destroyLaneUnit(incoming);
+      const AudioDeviceId from = activeDevice_;
+      if (reopenStream(target, true)) {
+        emitDeviceSwitch(from, target, AudioDeviceSwitcher::SwitchResult{});
+      }
+      return;
+    }
+
+    AudioOutputLane& current = lanes_[switcher_.currentLane()];
+    if (activeLost && current.unit) {
+      AudioOutputUnitStop(current.unit);
+    }
+    switcher_.beginSwitch(std::chrono::steady_clock::now());
+    if (activeLost) {
+      switcher_.outgoingLost();
+    }
+    if (AudioOutputUnitStart(incoming.unit) != noErr) {
+      switcher_.abortSwitch();
+      destroyLaneUnit(incoming);
+      return;
+    }
+    scheduleSwitchPoll();
+  }
+
+  void scheduleSwitchPoll() {
+    std::weak_ptr<bool> alive = alive_;
+    const uint64_t generation = switchPollGeneration_;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 2 * NSEC_PER_MSEC), dispatch_get_main_queue(), ^{
+      if (alive.expired() || generation != switchPollGeneration_) {
+        return;
+      }
+      if (auto result = switcher_.takeCompletedSwitch()) {
+        finishDeviceSwitch(*result);
+      } else if (switcher_.switchPending()) {
+        scheduleSwitchPoll();
+      }
+    });
+  }
+
+  void finishDeviceSwitch(const AudioDeviceSwitcher::SwitchResult& result) {
+    AudioOutputLane& current = lanes_[switcher_.currentLane()];
+    AudioOutputLane& outgoing = lanes_[switcher_.incomingLane()];
+    const AudioDeviceId from = outgoing.deviceId;
+    destroyLaneUnit(outgoing);
+    activeDevice_ = current.deviceId;
+    emitDeviceSwitch(from, current.deviceId, result);
+    if (lastDeviceIds_.find(activeDevice_) == lastDeviceIds_.end()) {
+      followDefaultDevice(true);
+    } else if (defaultDevice_ != 0 && defaultDevice_ != activeDevice_) {
+      followDefaultDevice(false);
+    }
+  }
+
+  void emitDeviceSwitch(AudioDeviceId from, AudioDeviceId to, const AudioDeviceSwitcher::SwitchResult& result) const {
+    if (!callbacks_.onDeviceSwitch) {
+      return;
+    }
+    AudioDeviceSwitchEvent event{};
+    event.fromDevice = from;
+    event.toDevice = to;
+    event.switchLatency = result.switchLatency;
+    event.completionTime = result.completionTime;
+    event.crossfadeFrames = result.crossfadeFrames;
+    event.crossfaded = result.crossfaded;
+    callbacks_.onDeviceSwitch(event);
+  }
+
+  HostStatus createLaneUnit(AudioOutputLane& lane, AudioDeviceId deviceId, const AudioStreamConfig& resolved) {
+    AudioComponentDescription desc{};
+    desc.componentType = kAudioUnitType_Output;
+    desc.componentSubType = kAudioUnitSubType_HALOutput;
+    desc.componentManufacturer = kAudioUnitManufacturer_Apple;
+
+    AudioComponent component = AudioComponentFindNext(nullptr, &desc);
+    if (!component) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    AudioComponentInstance unit = nullptr;
+    if (AudioComponentInstanceNew(component, &unit) != noErr) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    UInt32 enableIO = 1u;
+    if (AudioUnitSetProperty(unit,
+                             kAudioOutputUnitProperty_EnableIO,
+                             kAudioUnitScope_Output,
+                             0,
+                             &enableIO,
+                             sizeof(enableIO)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    enableIO = 0u;
+    AudioUnitSetProperty(unit,
+                         kAudioOutputUnitProperty_EnableIO,
+                         kAudioUnitScope_Input,
+                         1,
+                         &enableIO,
+                         sizeof(enableIO));
+
+    AudioDeviceID coreId = static_cast<AudioDeviceID>(deviceId);
+    if (AudioUnitSetProperty(unit,
+                             kAudioOutputUnitProperty_CurrentDevice,
+                             kAudioUnitScope_Global,
+                             0,
+                             &coreId,
+                             sizeof(coreId)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    UInt32 maxFrames = std::max(resolved.bufferFrames, resolved.periodFrames);
+    if (maxFrames == 0u) {
+      maxFrames = 512u;
+    }
+    AudioUnitSetProperty(unit,
+                         kAudioUnitProperty_MaximumFramesPerSlice,
+                         kAudioUnitScope_Global,
+                         0,
+                         &maxFrames,
+                         sizeof(maxFrames));
+
+    const bool interleaved = resolved.format.interleaved;
+    const bool isFloat = resolved.format.format == SampleFormat::Float32;
+    const uint32_t bitsPerChannel = isFloat ? 32u : 16u;
+    const uint32_t bytesPerSample = bitsPerChannel / 8u;
+    const uint32_t bytesPerFrame = interleaved ? bytesPerSample * resolved.format.channels : bytesPerSample;
+
+    AudioStreamBasicDescription format{};
+    format.mSampleRate = static_cast<Float64>(resolved.format.sampleRate);
+    format.mFormatID = kAudioFormatLinearPCM;
+    format.mFormatFlags = static_cast<AudioFormatFlags>(kAudioFormatFlagsNativeEndian);
+    format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsPacked);
+    if (isFloat) {
+      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsFloat);
+    } else {
+      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsSignedInteger);
+    }
+    if (!interleaved) {
+      format.mFormatFlags |= static_cast<AudioFormatFlags>(kAudioFormatFlagIsNonInterleaved);
+    }
+    format.mFramesPerPacket = 1;
+    format.mChannelsPerFrame = resolved.format.channels;
+    format.mBitsPerChannel = bitsPerChannel;
+    format.mBytesPerFrame = bytesPerFrame;
+    format.mBytesPerPacket = format.mBytesPerFrame * format.mFramesPerPacket;
+
+    if (AudioUnitSetProperty(unit,
+                             kAudioUnitProperty_StreamFormat,
+                             kAudioUnitScope_Input,
+                             0,
+                             &format,
+                             sizeof(format)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    AURenderCallbackStruct render{};
+    render.inputProc = &AudioHostMac::renderCallback;
+    render.inputProcRefCon = &lane;
+    if (AudioUnitSetProperty(unit,
+                             kAudioUnitProperty_SetRenderCallback,
+                             kAudioUnitScope_Input,
+                             0,
+                             &render,
+                             sizeof(render)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    if (AudioUnitInitialize(unit) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    lane.unit = unit;
+    lane.deviceId = deviceId;
+    lane.sampleRate = resolved.format.sampleRate;
+    lane.interleaved = interleaved;
+    lane.sampleFormat = resolved.format.format;
+    lane.bytesPerSample = bytesPerSample;
+    lane.scratchFrames = maxFrames;
+    AudioStreamBasicDescription actualFormat{};
+    UInt32 actualSize = sizeof(actualFormat);
+    if (AudioUnitGetProperty(unit,
+                             kAudioUnitProperty_StreamFormat,
+                             kAudioUnitScope_Input,
+                             0,
+                             &actualFormat,
+                             &actualSize) == noErr) {
+      if (actualFormat.mSampleRate > 0.0) {
+        lane.sampleRate = static_cast<uint32_t>(actualFormat.mSampleRate);
+      }
+      const bool actualNonInterleaved =
+          (actualFormat.mFormatFlags & kAudioFormatFlagIsNonInterleaved) == kAudioFormatFlagIsNonInterleaved;
+      lane.interleaved = !actualNonInterleaved;
+      if (actualFormat.mFormatFlags & kAudioFormatFlagIsFloat) {
+        lane.sampleFormat = SampleFormat::Float32;
+        lane.bytesPerSample = 4u;
+      } else if ((actualFormat.mFormatFlags & kAudioFormatFlagIsSignedInteger) &&
+                 actualFormat.mBitsPerChannel == 16) {
+        lane.sampleFormat = SampleFormat::Int16;
+        lane.bytesPerSample = 2u;
+      }
+    }
+    if (!lane.interleaved || lane.sampleFormat != SampleFormat::Float32) {
+      lane.scratchInterleaved.assign(static_cast<size_t>(lane.scratchFrames) * resolved.format.channels, 0.0f);
+    } else {
+      lane.scratchInterleaved.clear();
+    }
+    return {};
+  }
+
+  HostStatus checkInputConfig(AudioDeviceId deviceId, const AudioStreamConfig& resolved) const {
+    refreshDevices(false);
+    auto it = inputs_.find(deviceId);
+    if (it == inputs_.end()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+    }
+    auto validation = validateAudioStreamConfig(resolved);
+    if (!validation) {
+      return validation;
+    }
+    // The HAL input element does not resample, so the stream must run at the device rate.
+    if (resolved.format.format != SampleFormat::Float32 ||
+        resolved.format.sampleRate != it->second.info.preferredFormat.sampleRate) {
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+    return {};
+  }
+
+  HostStatus createInputUnit(AudioInputUnit& input, AudioDeviceId deviceId, const AudioStreamConfig& resolved) {
+    AudioComponentDescription desc{};
+    desc.componentType = kAudioUnitType_Output;
+    desc.componentSubType = kAudioUnitSubType_HALOutput;
+    desc.componentManufacturer = kAudioUnitManufacturer_Apple;
+
+    AudioComponent component = AudioComponentFindNext(nullptr, &desc);
+    if (!component) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    AudioComponentInstance unit = nullptr;
+    if (AudioComponentInstanceNew(component, &unit) != noErr) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    UInt32 enableIO = 1u;
+    if (AudioUnitSetProperty(unit,
+                             kAudioOutputUnitProperty_EnableIO,
+                             kAudioUnitScope_Input,
+                             1,
+                             &enableIO,
+                             sizeof(enableIO)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    enableIO = 0u;
+    AudioUnitSetProperty(unit,
+                         kAudioOutputUnitProperty_EnableIO,
+                         kAudioUnitScope_Output,
+                         0,
+                         &enableIO,
+                         sizeof(enableIO));
+
+    AudioDeviceID coreId = static_cast<AudioDeviceID>(deviceId);
+    if (AudioUnitSetProperty(unit,
+                             kAudioOutputUnitProperty_CurrentDevice,
+                             kAudioUnitScope_Global,
+                             0,
+                             &coreId,
+                             sizeof(coreId)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    UInt32 maxFrames = std::max(resolved.bufferFrames, resolved.periodFrames);
+    if (maxFrames == 0u) {
+      maxFrames = 512u;
+    }
+    AudioUnitSetProperty(unit,
+                         kAudioUnitProperty_MaximumFramesPerSlice,
+                         kAudioUnitScope_Global,
+                         0,
+                         &maxFrames,
+                         sizeof(maxFrames));
+
+    // Capture always delivers interleaved float; the unit converts from the device format.
+    AudioStreamBasicDescription format{};
+    format.mSampleRate = static_cast<Float64>(resolved.format.sampleRate);
+    format.mFormatID = kAudioFormatLinearPCM;
+    format.mFormatFlags = static_cast<AudioFormatFlags>(kAudioFormatFlagsNativeEndian) |
+                          static_cast<AudioFormatFlags>(kAudioFormatFlagIsPacked) |
+                          static_cast<AudioFormatFlags>(kAudioFormatFlagIsFloat);
+    format.mFramesPerPacket = 1;
+    format.mChannelsPerFrame = resolved.format.channels;
+    format.mBitsPerChannel = 32u;
+    format.mBytesPerFrame = 4u * resolved.format.channels;
+    format.mBytesPerPacket = format.mBytesPerFrame;
+    if (AudioUnitSetProperty(unit,
+                             kAudioUnitProperty_StreamFormat,
+                             kAudioUnitScope_Output,
+                             1,
+                             &format,
+                             sizeof(format)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+
+    AURenderCallbackStruct callback{};
+    callback.inputProc = &AudioHostMac::inputCallback;
+    callback.inputProcRefCon = &input;
+    if (AudioUnitSetProperty(unit,
+                             kAudioOutputUnitProperty_SetInputCallback,
+                             kAudioUnitScope_Global,
+                             0,
+                             &callback,
+                             sizeof(callback)) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+
+    // Sized before the unit can call back, so the input callback never allocates.
+    input.scratch.assign(static_cast<size_t>(maxFrames) * resolved.format.channels, 0.0f);
+    input.deviceId = deviceId;
+    input.sampleRate = resolved.format.sampleRate;
+    input.channels = resolved.format.channels;
+    input.maxFrames = maxFrames;
+    input.frameIndex = 0u;
+    if (AudioUnitInitialize(unit) != noErr) {
+      AudioComponentInstanceDispose(unit);
+      destroyInputUnit(input);
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    input.unit = unit;
+    return {};
+  }
+
+  static void destroyInputUnit(AudioInputUnit& input) {
+    if (input.unit) {
+      AudioOutputUnitStop(input.unit);
+      AudioUnitUninitialize(input.unit);
+      AudioComponentInstanceDispose(input.unit);
+    }
+    input.unit = nullptr;
+    input.deviceId = 0;
+    input.sampleRate = 0u;
+    input.channels = 0u;
+    input.maxFrames = 0u;
+    input.frameIndex = 0u;
+    input.scratch.clear();
+  }
+
+  static void destroyLaneUnit(AudioOutputLane& lane) {
+    if (lane.unit) {
+      AudioOutputUnitStop(lane.unit);
+      AudioUnitUninitialize(lane.unit);
+      AudioComponentInstanceDispose(lane.unit);
+    }
+    lane.unit = nullptr;
+    lane.deviceId = 0;
+    lane.sampleRate = 0u;
+    lane.interleaved = true;
+    lane.sampleFormat = SampleFormat::Float32;
+    lane.bytesPerSample = 0u;
+    lane.scratchFrames = 0u;
+    lane.scratchInterleaved.clear();
+  }
+
   bool refreshDevices(bool emitEvents) const {
     std::unordered_set<AudioDeviceId> previousIds = lastDeviceIds_;
+    std::unordered_set<AudioDeviceId> previousInputIds = lastInputIds_;
     AudioDeviceId previousDefault = defaultDevice_;
+    AudioDeviceId previousDefaultInput = defaultInputDevice_;
 
     devices_.clear();
     deviceOrder_.clear();
     defaultDevice_ = 0;
+    inputs_.clear();
+    inputOrder_.clear();
+    defaultInputDevice_ = 0;
 
     AudioObjectPropertyAddress defaultAddress{};
     defaultAddress.mSelector = kAudioHardwarePropertyDefaultOutputDevice;
@@ -545,6 +1130,17 @@ private:
                                    &defaultDevice) == noErr) {
       defaultDevice_ = static_cast<AudioDeviceId>(defaultDevice);
     }
+    defaultAddress.mSelector = kAudioHardwarePropertyDefaultInputDevice;
+    defaultSize = sizeof(defaultDevice);
+    defaultDevice = 0;
+    if (AudioObjectGetPropertyData(kAudioObjectSystemObject,
+                                   &defaultAddress,
+                                   0,
+                                   nullptr,
+                                   &defaultSize,
+                                   &defaultDevice) == noErr) {
+      defaultInputDevice_ = static_cast<AudioDeviceId>(defaultDevice);
+    }
 
     AudioObjectPropertyAddress devicesAddress{};
     devicesAddress.mSelector = kAudioHardwarePropertyDevices;
@@ -576,75 +1172,94 @@ private:
     }
 
     for (AudioDeviceID deviceId : deviceIds) {
-      uint32_t channelCount = outputChannelCount(deviceId);
-      if (channelCount == 0) {
-        continue;
+      const uint32_t outputChannels = channelCount(deviceId, kAudioDevicePropertyScopeOutput);
+      if (outputChannels > 0) {
+        addDeviceRecord(devices_, deviceOrder_, deviceId, outputChannels, defaultDevice_);
       }
-
-      AudioDeviceRecord record{};
-      record.info.id = static_cast<AudioDeviceId>(deviceId);
-      record.info.isDefault = (record.info.id == defaultDevice_);
-
-      record.nameStorage = deviceName(deviceId);
-      if (record.nameStorage.empty()) {
-        record.nameStorage = "Audio Device";
+      const uint32_t inputChannels = channelCount(deviceId, kAudioDevicePropertyScopeInput);
+      if (inputChannels > 0) {
+        addDeviceRecord(inputs_, inputOrder_, deviceId, inputChannels, defaultInputDevice_);
       }
+    }
 
-      record.info.preferredFormat.sampleRate = static_cast<uint32_t>(deviceSampleRate(deviceId));
-      record.info.preferredFormat.channels = static_cast<uint16_t>(channelCount);
-      record.info.preferredFormat.format = SampleFormat::Float32;
-      record.info.preferredFormat.interleaved = true;
+    std::unordered_set<AudioDeviceId> newIds(deviceOrder_.begin(), deviceOrder_.end());
+    std::unordered_set<AudioDeviceId> newInputIds(inputOrder_.begin(), inputOrder_.end());
 
-      devices_.emplace(record.info.id, record);
-      devices_[record.info.id].info.name = devices_[record.info.id].nameStorage;
-      deviceOrder_.push_back(record.info.id);
+    if (emitEvents && callbacks_.onDeviceEvent) {
+      emitDeviceChanges(previousIds, newIds, previousDefault, defaultDevice_, false);
+      emitDeviceChanges(previousInputIds, newInputIds, previousDefaultInput, defaultInputDevice_, true);
     }
 
-    std::unordered_set<AudioDeviceId> newIds;
-    newIds.reserve(devices_.size());
-    for (const auto& entry : devices_) {
-      newIds.insert(entry.first);
+    lastInputIds_ = std::move(newInputIds);
+    lastDeviceIds_ = std::move(newIds);
+    return true;
+  }
+
+  static void addDeviceRecord(std::unordered_map<AudioDeviceId, AudioDeviceRecord>& records,
+                              std::vector<AudioDeviceId>& order,
+                              AudioDeviceID deviceId,
+                              uint32_t channelCount,
+                              AudioDeviceId defaultId) {
+    AudioDeviceRecord record{};
+    record.info.id = static_cast<AudioDeviceId>(deviceId);
+    record.info.isDefault = (record.info.id == defaultId);
+
+    record.nameStorage = deviceName(deviceId);
+    if (record.nameStorage.empty()) {
+      record.nameStorage = "Audio Device";
     }
 
-    if (emitEvents && callbacks_.onDeviceEvent) {
-      for (AudioDeviceId oldId : previousIds) {
-        if (newIds.find(oldId) == newIds.end()) {
-          AudioDeviceEvent event{};
-          event.deviceId = oldId;
-          event.connected = false;
-          event.isDefault = false;
-          callbacks_.onDeviceEvent(event);
-        }
+    record.info.preferredFormat.sampleRate = static_cast<uint32_t>(deviceSampleRate(deviceId));
+    record.info.preferredFormat.channels = static_cast<uint16_t>(channelCount);
+    record.info.preferredFormat.format = SampleFormat::Float32;
+    record.info.preferredFormat.interleaved = true;
+
+    records.emplace(record.info.id, record);
+    records[record.info.id].info.name = records[record.info.id].nameStorage;
+    order.push_back(record.info.id);
+  }
+
+  void emitDeviceChanges(const std::unordered_set<AudioDeviceId>& previousIds,
+                         const std::unordered_set<AudioDeviceId>& newIds,
+                         AudioDeviceId previousDefault,
+                         AudioDeviceId defaultId,
+                         bool isInput) const {
+    for (AudioDeviceId oldId : previousIds) {
+      if (newIds.find(oldId) == newIds.end()) {
+        AudioDeviceEvent event{};
+        event.deviceId = oldId;
+        event.connected = false;
+        event.isDefault = false;
+        event.isInput = isInput;
+        callbacks_.onDeviceEvent(event);
       }
-      for (AudioDeviceId newId : newIds) {
-        if (previousIds.find(newId) == previousIds.end()) {
-          AudioDeviceEvent event{};
-          event.deviceId = newId;
-          event.connected = true;
-          event.isDefault = (newId == defaultDevice_);
-          callbacks_.onDeviceEvent(event);
-        }
+    }
+    for (AudioDeviceId newId : newIds) {
+      if (previousIds.find(newId) == previousIds.end()) {
+        AudioDeviceEvent event{};
+        event.deviceId = newId;
+        event.connected = true;
+        event.isDefault = (newId == defaultId);
+        event.isInput = isInput;
+        callbacks_.onDeviceEvent(event);
       }
-      if (defaultDevice_ != 0 && defaultDevice_ != previousDefault &&
-          newIds.find(defaultDevice_) != newIds.end()) {
-        if (previousIds.find(defaultDevice_) != previousIds.end()) {
-          AudioDeviceEvent event{};
-          event.deviceId = defaultDevice_;
-          event.connected = true;
-          event.isDefault = true;
-          callbacks_.onDeviceEvent(event);
-        }
+    }
+    if (defaultId != 0 && defaultId != previousDefault && newIds.find(defaultId) != newIds.end()) {
+      if (previousIds.find(defaultId) != previousIds.end()) {
+        AudioDeviceEvent event{};
+        event.deviceId = defaultId;
+        event.connected = true;
+        event.isDefault = true;
+        event.isInput = isInput;
+        callbacks_.onDeviceEvent(event);
       }
     }
-
-    lastDeviceIds_ = std::move(newIds);
-    return true;
   }
 
-  static uint32_t outputChannelCount(AudioDeviceID deviceId) {
+  static uint32_t channelCount(AudioDeviceID deviceId, AudioObjectPropertyScope scope) {
     AudioObjectPropertyAddress address{};
     address.mSelector = kAudioDevicePropertyStreamConfiguration;
-    address.mScope = kAudioDevicePropertyScopeOutput;
+    address.mScope = scope;
     address.mElement = kAudioObjectPropertyElementMain;
 
     UInt32 dataSize = 0;
@@ -707,25 +1322,39 @@ private:
   mutable std::vector<AudioDeviceId> deviceOrder_;
   mutable AudioDeviceId defaultDevice_ = 0;
   mutable std::unordered_set<AudioDeviceId> lastDeviceIds_;
+  mutable std::unordered_map<AudioDeviceId, AudioDeviceRecord> inputs_;
+  mutable std::vector<AudioDeviceId> inputOrder_;
+  mutable AudioDeviceId defaultInputDevice_ = 0;
+  mutable std::unordered_set<AudioDeviceId> lastInputIds_;
 
   AudioObjectPropertyAddress devicesAddress_{};
   AudioObjectPropertyAddress defaultAddress_{};
+  AudioObjectPropertyAddress defaultInputAddress_{};
   bool listenersInstalled_ = false;
   mutable AudioCallbacks callbacks_{};
 
-  AudioComponentInstance unit_ = nullptr;
+  std::array<AudioOutputLane, 2> lanes_{};
+  AudioDeviceSwitcher switcher_;
+  uint64_t switchPollGeneration_ = 0u;
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
   AudioStreamConfig activeConfig_{};
   AudioCallback callback_ = nullptr;
   void* userData_ = nullptr;
   AudioDeviceId activeDevice_ = 0;
-  uint64_t frameIndex_ = 0u;
   uint32_t activeChannels_ = 0u;
-  bool outputInterleaved_ = true;
-  SampleFormat outputSampleFormat_ = SampleFormat::Float32;
-  uint32_t bytesPerSample_ = 0u;
-  uint32_t scratchFrames_ = 0u;
-  std::vector<float> scratchInterleaved_;
+  AudioMixer mixer_;
   bool streamRunning_ = false;
+
+  AudioInputUnit capture_{};
+  AudioStreamConfig captureConfig_{};
+  AudioCaptureCallback captureCallback_ = nullptr;
+  void* captureUserData_ = nullptr;
+
+  AudioInputUnit duplexInput_{};
+  AudioDuplexCallback duplexCallback_ = nullptr;
+  void* duplexUserData_ = nullptr;
+  SpscRing<float> duplexRing_;
+  std::vector<float> duplexBuffer_;
 };
 
 } // namespace
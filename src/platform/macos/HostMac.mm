@@ -25,7 +25,10 @@
 #import <objc/message.h>
 
 #include "PrimeHost/Host.h"
+#include "PrimeHost/FrameCapture.h"
+#include "PrimeHost/ImageEncode.h"
 #include "DeviceNameMatch.h"
+#include "DisplayCache.h"
 #include "PrimeHost/FrameConfigValidation.h"
 #include "PrimeHost/FrameConfigUtil.h"
 #include "PrimeHost/FrameConfigDefaults.h"
@@ -34,17 +37,29 @@
 #include "PlatformTimeUtil.h"
 #include "FrameDiagnosticsUtil.h"
 #include "FrameLimiter.h"
+#include "FramePixelStorage.h"
+#include "FrameScheduler.h"
+#include "FrameSlots.h"
+#include "LatestValue.h"
 #include "SizeUtil.h"
+#include "SlotMap.h"
 #include "GamepadProfiles.h"
+#include "GamepadStateBlock.h"
+#include "RawInputQueue.h"
 #include "TextBuffer.h"
 
 #include <array>
+#include <atomic>
 #include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <dlfcn.h>
 #include <limits>
+#include <mach/mach_time.h>
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -77,6 +92,20 @@ constexpr uint32_t kKeyboardDeviceId = 2u;
 constexpr uint32_t kPenDeviceId = 3u;
 constexpr uint32_t kTouchDeviceId = 4u;
 
+// What the render thread needs from a surface, published by the main thread whenever the size,
+// scale or frame config changes.
+struct SurfaceRenderParams {
+  uint32_t widthPx = 0u;
+  uint32_t heightPx = 0u;
+  float scale = 1.0f;
+  uint32_t bufferCount = 2u;
+  uint32_t maxFrameLatency = 1u;
+  // Smooth/Uncapped: presents go through the slot mailbox and the main thread shows the newest.
+  bool mailbox = false;
+  ColorFormat colorFormat = ColorFormat::B8G8R8A8_UNORM;
+  FrameBufferPolicy bufferPolicy{};
+};
+
 struct SurfaceState {
   SurfaceId surfaceId{};
   NSWindow* window = nullptr;
@@ -94,18 +123,28 @@ struct SurfaceState {
   uint64_t frameIndex = 0u;
   std::optional<std::chrono::steady_clock::time_point> lastFrameTime{};
   std::optional<std::chrono::nanoseconds> displayInterval{};
+  // Set on the main thread under the exclusive surfaces lock; presents read it under the shared one.
+  std::shared_ptr<FrameCaptureSink> captureSink;
 #if defined(__OBJC__)
   struct FrameBufferSlot {
-    std::vector<uint8_t> pixels;
+    FramePixelStorage pixels;
     uint32_t width = 0u;
     uint32_t height = 0u;
     uint32_t stride = 0u;
-    bool acquired = false;
-    bool inFlight = false;
     id<MTLTexture> texture = nil;
   };
+  // Render-thread state. Slot ownership lives in `frameSlots`, which Metal completion handlers
+  // keep alive past surface destruction.
   std::vector<FrameBufferSlot> frameBuffers;
-  size_t frameBufferCursor = 0u;
+  std::shared_ptr<FrameSlotTable> frameSlots = std::make_shared<FrameSlotTable>();
+  LatestValue<SurfaceRenderParams> renderParams;
+  SurfaceRenderParams renderView{};
+  // Nanoseconds deadline acquires spent blocked, handed to the next frame callback.
+  std::atomic<int64_t> acquireWaitNs{0};
+  // Set while a main-queue presentPostedFrame is queued, so posts coalesce into one dispatch.
+  std::atomic<bool> mailboxScheduled{false};
+  // Slot of the frame a headless surface last presented, read back by writeSurfaceScreenshot.
+  std::atomic<uint32_t> shownSlot{UINT32_MAX};
 #endif
 #if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
   CADisplayLink* viewDisplayLink = nil;
@@ -160,6 +199,60 @@ std::optional<std::chrono::nanoseconds> display_interval_for_display(CGDirectDis
   return intervalFromRefreshRate(refreshRate);
 }
 
+// Current topology from CoreGraphics plus per-screen scale, refresh fallback and EDR headroom;
+// nullopt when CoreGraphics cannot list the displays.
+std::optional<std::vector<DisplayRecord>> query_display_records() {
+  uint32_t count = 0u;
+  if (CGGetActiveDisplayList(0, nullptr, &count) != kCGErrorSuccess) {
+    return std::nullopt;
+  }
+  std::vector<CGDirectDisplayID> ids(count);
+  if (count > 0u && CGGetActiveDisplayList(count, ids.data(), &count) != kCGErrorSuccess) {
+    return std::nullopt;
+  }
+  ids.resize(count);
+  const CGDirectDisplayID mainDisplay = CGMainDisplayID();
+  NSArray<NSScreen*>* screens = [NSScreen screens];
+  std::vector<DisplayRecord> records;
+  records.reserve(count);
+  for (CGDirectDisplayID id : ids) {
+    CGRect bounds = CGDisplayBounds(id);
+    DisplayRecord record{};
+    DisplayInfo& info = record.info;
+    info.displayId = static_cast<uint32_t>(id);
+    info.x = static_cast<int32_t>(std::lround(bounds.origin.x));
+    info.y = static_cast<int32_t>(std::lround(bounds.origin.y));
+    info.width = static_cast<uint32_t>(std::lround(bounds.size.width));
+    info.height = static_cast<uint32_t>(std::lround(bounds.size.height));
+    info.scale = 1.0f;
+    double fallbackRate = 0.0;
+    for (NSScreen* screen in screens) {
+      NSNumber* screenNumber = screen.deviceDescription[@"NSScreenNumber"];
+      if (screenNumber && screenNumber.unsignedIntValue == id) {
+        info.scale = static_cast<float>(screen.backingScaleFactor);
+        if (@available(macOS 10.15, *)) {
+          fallbackRate = static_cast<double>(screen.maximumFramesPerSecond);
+          record.hdr.maxEdr = static_cast<float>(screen.maximumExtendedDynamicRangeColorComponentValue);
+          record.hdr.maxEdrPotential =
+              static_cast<float>(screen.maximumPotentialExtendedDynamicRangeColorComponentValue);
+          record.hdr.supportsHdr = record.hdr.maxEdr > 1.0f || record.hdr.maxEdrPotential > 1.0f;
+        }
+        break;
+      }
+    }
+    CGDisplayModeRef mode = CGDisplayCopyDisplayMode(id);
+    if (mode) {
+      info.refreshRate = resolvedRefreshRate(CGDisplayModeGetRefreshRate(mode), fallbackRate);
+      CGDisplayModeRelease(mode);
+    } else {
+      info.refreshRate = resolvedRefreshRate(0.0, fallbackRate);
+    }
+    info.isPrimary = (id == mainDisplay);
+    records.push_back(record);
+  }
+  return records;
+}
+
 std::chrono::steady_clock::time_point event_time_for(NSEvent* event) {
   if (!event) {
     return std::chrono::steady_clock::now();
@@ -447,6 +540,7 @@ std::optional<std::pair<uint16_t, uint16_t>> hid_vidpid_match(
   if (name.empty()) {
     return std::nullopt;
   }
+  const NormalizedDeviceName normalizedName = normalizeDeviceName(name);
   int bestScore = 0;
   std::optional<std::pair<uint16_t, uint16_t>> bestMatch;
   for (const auto& entry : devices) {
@@ -458,7 +552,7 @@ std::optional<std::pair<uint16_t, uint16_t>> hid_vidpid_match(
     if (product.empty()) {
       continue;
     }
-    int score = deviceNameMatchScore(name, product);
+    int score = deviceNameMatchScore(normalizedName, product);
     if (score <= 0) {
       continue;
     }
@@ -634,6 +728,231 @@ uint32_t map_mouse_buttons(NSUInteger pressedMask) {
   return result;
 }
 
+float hid_normalized_value(IOHIDElementRef element, CFIndex value) {
+  const CFIndex minimum = IOHIDElementGetLogicalMin(element);
+  const CFIndex maximum = IOHIDElementGetLogicalMax(element);
+  if (maximum <= minimum) {
+    return 0.0f;
+  }
+  const float t = static_cast<float>(value - minimum) / static_cast<float>(maximum - minimum);
+  return std::clamp(t, 0.0f, 1.0f);
+}
+
+// Raw mouse and pen reports on a dedicated thread with its own run loop, so 1-8 kHz devices never
+// queue behind AppKit. Element values are folded into one sample per HID report (values of a
+// report share a timestamp) and pushed into a RawInputQueue. Needs Input Monitoring permission.
+class MacRawInputReader {
+public:
+  ~MacRawInputReader() { stop(); }
+
+  HostStatus start(RawInputQueue& queue) {
+    stop();
+    queue_ = &queue;
+    dispatch_semaphore_t ready = dispatch_semaphore_create(0);
+    thread_ = std::thread([this, ready]() { run(ready); });
+    dispatch_semaphore_wait(ready, DISPATCH_TIME_FOREVER);
+    if (!runLoop_) {
+      thread_.join();
+      queue_ = nullptr;
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+    }
+    return {};
+  }
+
+  void stop() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    // A queued block cannot be missed even if the thread has not entered CFRunLoopRun yet.
+    CFRunLoopPerformBlock(runLoop_, kCFRunLoopDefaultMode, ^{
+      CFRunLoopStop(CFRunLoopGetCurrent());
+    });
+    CFRunLoopWakeUp(runLoop_);
+    thread_.join();
+    CFRelease(runLoop_);
+    runLoop_ = nullptr;
+    queue_ = nullptr;
+  }
+
+private:
+  struct Device {
+    RawInputSample sample{};
+    uint64_t reportTime = 0u;
+    bool changed = false;
+  };
+
+  void run(dispatch_semaphore_t ready) {
+    mach_timebase_info_data_t timebase{};
+    mach_timebase_info(&timebase);
+    ticksToSeconds_ = static_cast<double>(timebase.numer) / static_cast<double>(timebase.denom) * 1e-9;
+
+    IOHIDManagerRef manager = IOHIDManagerCreate(kCFAllocatorDefault, kIOHIDOptionsTypeNone);
+    if (!manager) {
+      dispatch_semaphore_signal(ready);
+      return;
+    }
+    NSArray* matches = @[
+      @{@kIOHIDDeviceUsagePageKey : @(kHIDPage_GenericDesktop), @kIOHIDDeviceUsageKey : @(kHIDUsage_GD_Mouse)},
+      @{@kIOHIDDeviceUsagePageKey : @(kHIDPage_Digitizer), @kIOHIDDeviceUsageKey : @(kHIDUsage_Dig_Pen)},
+    ];
+    IOHIDManagerSetDeviceMatchingMultiple(manager, (__bridge CFArrayRef)matches);
+    IOHIDManagerRegisterDeviceMatchingCallback(manager, &MacRawInputReader::attached, this);
+    IOHIDManagerRegisterDeviceRemovalCallback(manager, &MacRawInputReader::removed, this);
+    IOHIDManagerRegisterInputValueCallback(manager, &MacRawInputReader::valueChanged, this);
+    CFRunLoopRef runLoop = CFRunLoopGetCurrent();
+    IOHIDManagerScheduleWithRunLoop(manager, runLoop, kCFRunLoopDefaultMode);
+    if (IOHIDManagerOpen(manager, kIOHIDOptionsTypeNone) != kIOReturnSuccess) {
+      IOHIDManagerUnscheduleFromRunLoop(manager, runLoop, kCFRunLoopDefaultMode);
+      CFRelease(manager);
+      dispatch_semaphore_signal(ready);
+      return;
+    }
+    // Whatever is still pending when the loop goes idle is the tail of the last report.
+    CFRunLoopObserverContext context{0, this, nullptr, nullptr, nullptr};
+    CFRunLoopObserverRef observer = CFRunLoopObserverCreate(
+        kCFAllocatorDefault, kCFRunLoopBeforeWaiting, true, 0, &MacRawInputReader::beforeWaiting, &context);
+    CFRunLoopAddObserver(runLoop, observer, kCFRunLoopDefaultMode);
+    runLoop_ = static_cast<CFRunLoopRef>(CFRetain(runLoop));
+    dispatch_semaphore_signal(ready);
+
+    CFRunLoopRun();
+
+    CFRunLoopRemoveObserver(runLoop, observer, kCFRunLoopDefaultMode);
+    CFRelease(observer);
+    IOHIDManagerUnscheduleFromRunLoop(manager, runLoop, kCFRunLoopDefaultMode);
+    IOHIDManagerClose(manager, kIOHIDOptionsTypeNone);
+    CFRelease(manager);
+    devices_.clear();
+  }
+
+  static void attached(void* context, IOReturn, void*, IOHIDDeviceRef device) {
+    auto* reader = static_cast<MacRawInputReader*>(context);
+    Device& state = reader->devices_[device];
+    state.sample.deviceId = reader->nextDeviceId_++;
+    state.sample.deviceType = hid_usage_matches(device, kHIDPage_Digitizer, kHIDUsage_Dig_Pen)
+                                  ? RawInputDeviceType::Pen
+                                  : RawInputDeviceType::Mouse;
+  }
+
+  static void removed(void* context, IOReturn, void*, IOHIDDeviceRef device) {
+    static_cast<MacRawInputReader*>(context)->devices_.erase(device);
+  }
+
+  static void beforeWaiting(CFRunLoopObserverRef, CFRunLoopActivity, void* info) {
+    auto* reader = static_cast<MacRawInputReader*>(info);
+    for (auto& entry : reader->devices_) {
+      if (entry.second.changed) {
+        reader->flush(entry.second);
+      }
+    }
+  }
+
+  static void valueChanged(void* context, IOReturn, void*, IOHIDValueRef value) {
+    auto* reader = static_cast<MacRawInputReader*>(context);
+    IOHIDElementRef element = IOHIDValueGetElement(value);
+    auto it = reader->devices_.find(IOHIDElementGetDevice(element));
+    if (it == reader->devices_.end()) {
+      return;
+    }
+    Device& device = it->second;
+    const uint64_t reportTime = IOHIDValueGetTimeStamp(value);
+    if (device.changed && reportTime != device.reportTime) {
+      reader->flush(device);
+    }
+    device.reportTime = reportTime;
+    device.changed = reader->apply(device.sample, element, IOHIDValueGetIntegerValue(value)) || device.changed;
+  }
+
+  bool apply(RawInputSample& sample, IOHIDElementRef element, CFIndex value) {
+    const bool pen = sample.deviceType == RawInputDeviceType::Pen;
+    const uint32_t usagePage = IOHIDElementGetUsagePage(element);
+    const uint32_t usage = IOHIDElementGetUsage(element);
+    auto setButton = [&](uint32_t bit) {
+      sample.buttons = value != 0 ? (sample.buttons | (1u << bit)) : (sample.buttons & ~(1u << bit));
+    };
+    if (usagePage == kHIDPage_GenericDesktop) {
+      switch (usage) {
+        case kHIDUsage_GD_X:
+          if (pen) {
+            sample.x = hid_normalized_value(element, value);
+          } else {
+            sample.deltaX += static_cast<int32_t>(value);
+          }
+          return true;
+        case kHIDUsage_GD_Y:
+          if (pen) {
+            sample.y = hid_normalized_value(element, value);
+          } else {
+            sample.deltaY += static_cast<int32_t>(value);
+          }
+          return true;
+        case kHIDUsage_GD_Wheel:
+          sample.scrollY += static_cast<float>(value);
+          return true;
+        default:
+          return false;
+      }
+    }
+    if (usagePage == kHIDPage_Consumer && usage == kHIDUsage_Csmr_ACPan) {
+      sample.scrollX += static_cast<float>(value);
+      return true;
+    }
+    if (usagePage == kHIDPage_Button && !pen && usage >= 1u && usage <= 32u) {
+      setButton(usage - 1u);
+      return true;
+    }
+    if (usagePage == kHIDPage_Digitizer && pen) {
+      switch (usage) {
+        case kHIDUsage_Dig_TipPressure:
+          sample.pressure = hid_normalized_value(element, value);
+          return true;
+        case kHIDUsage_Dig_XTilt:
+          sample.tiltX = hid_normalized_value(element, value) * 2.0f - 1.0f;
+          return true;
+        case kHIDUsage_Dig_YTilt:
+          sample.tiltY = hid_normalized_value(element, value) * 2.0f - 1.0f;
+          return true;
+        case kHIDUsage_Dig_TipSwitch:
+          setButton(0u);
+          return true;
+        case kHIDUsage_Dig_BarrelSwitch:
+          setButton(1u);
+          return true;
+        case kHIDUsage_Dig_InRange:
+          if (value == 0) {
+            sample.buttons = 0u;
+            sample.pressure = 0.0f;
+          }
+          return true;
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  void flush(Device& device) {
+    const double uptime = static_cast<double>(mach_absolute_time()) * ticksToSeconds_;
+    device.sample.time = steadyTimeFromUptime(static_cast<double>(device.reportTime) * ticksToSeconds_,
+                                              uptime,
+                                              std::chrono::steady_clock::now());
+    queue_->push(device.sample);
+    device.sample.deltaX = 0;
+    device.sample.deltaY = 0;
+    device.sample.scrollX = 0.0f;
+    device.sample.scrollY = 0.0f;
+    device.changed = false;
+  }
+
+  RawInputQueue* queue_ = nullptr;
+  std::thread thread_;
+  CFRunLoopRef runLoop_ = nullptr;
+  double ticksToSeconds_ = 1e-9;
+  uint32_t nextDeviceId_ = 1u;
+  // Touched only on the reader thread.
+  std::unordered_map<IOHIDDeviceRef, Device> devices_;
+};
+
 } // namespace
 
 class HostMac : public Host {
@@ -656,9 +975,13 @@ public:
   HostStatus destroySurface(SurfaceId surfaceId) override;
 
   HostResult<EventBatch> pollEvents(const EventBuffer& buffer) override;
+  HostResult<EventBufferSize> pendingEventsSize() const override;
   HostStatus waitEvents() override;
+  HostStatus wakeEvents() override;
 
   HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId) override;
+  HostResult<FrameBuffer> acquireFrameBuffer(SurfaceId surfaceId,
+                                             std::chrono::steady_clock::time_point deadline) override;
   HostStatus presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& buffer) override;
 
   HostStatus requestFrame(SurfaceId surfaceId, bool bypassCap) override;
@@ -691,6 +1014,7 @@ public:
   HostStatus writeSurfaceScreenshot(SurfaceId surfaceId,
                                     Utf8TextView path,
                                     const ScreenshotConfig& config) override;
+  HostStatus setSurfaceCaptureSink(SurfaceId surfaceId, std::shared_ptr<FrameCaptureSink> sink) override;
   HostResult<FileDialogResult> fileDialog(const FileDialogConfig& config,
                                           std::span<char> buffer) const override;
   HostResult<size_t> fileDialogPaths(const FileDialogConfig& config,
@@ -703,6 +1027,8 @@ public:
   HostStatus setSurfaceMaxSize(SurfaceId surfaceId, uint32_t width, uint32_t height) override;
 
   HostStatus setGamepadRumble(const GamepadRumble& rumble) override;
+  HostResult<GamepadState> gamepadState(uint32_t deviceId) const override;
+  HostStatus setGamepadInputConfig(const GamepadInputConfig& config) override;
   HostResult<PermissionStatus> checkPermission(PermissionType type) const override;
   HostResult<PermissionStatus> requestPermission(PermissionType type) override;
   HostResult<uint64_t> beginIdleSleepInhibit(Utf8TextView reason) override;
@@ -721,6 +1047,8 @@ public:
   HostStatus updateTrayItemTitle(uint64_t trayId, Utf8TextView title) override;
   HostStatus removeTrayItem(uint64_t trayId) override;
   HostStatus setRelativePointerCapture(SurfaceId surfaceId, bool enabled) override;
+  HostStatus setRawInputConfig(const RawInputConfig& config) override;
+  HostResult<RawInputBatch> drainRawInput(std::span<RawInputSample> outSamples) override;
   HostStatus setLogCallback(LogCallback callback) override;
 
   HostStatus setCallbacks(Callbacks callbacks) override;
@@ -734,9 +1062,13 @@ public:
   void handleModifiers(NSEvent* event);
   void handleText(uint64_t surfaceId, NSString* text, NSEvent* event);
   void handleFocus(uint64_t surfaceId, bool focused);
+  void handleVisibilityChange(uint64_t surfaceId);
   void handleScreenChange(uint64_t surfaceId);
   void handleWindowClosed(uint64_t surfaceId);
   void handleDisplayLinkTick();
+  // CVDisplayLink thread: false while no display-paced surface is due, so idle vsyncs skip the
+  // main-queue hop.
+  bool displayTickDue() const;
   void handleDisplayLinkTick(uint64_t surfaceId, CADisplayLink* link);
   void handleHostLimiterTick();
   void handleGamepadConnected(GCController* controller);
@@ -753,27 +1085,41 @@ public:
   void updateCursorRects(uint64_t surfaceId, NSView* view);
   void handlePowerStateChange();
   void handleThermalStateChange();
+  // Rebuilds the display snapshot and queues a DisplayEvent per change.
+  void refreshDisplays();
   void logMessage(LogLevel level, std::string_view message) const;
 
 private:
-  struct QueuedEvent {
-    Event event;
-    std::string text;
-  };
-
   HostStatus presentEmptyFrame(SurfaceState& surface);
-  HostResult<EventBatch> buildBatch(std::span<const QueuedEvent> events, const EventBuffer& buffer);
-  void enqueueEvent(Event event, std::string text = {});
+  // Text and drop events must already reference their text in textArena_.
+  void enqueueEvent(Event event);
   NSCursor* cursorForShape(CursorShape shape) const;
   void pumpEvents(bool wait);
   SurfaceState* findSurface(uint64_t surfaceId);
   const SurfaceState* findSurface(uint64_t surfaceId) const;
   void updateDisplayLinkState();
-  void updateHostLimiterState();
+  void updateFrameSchedule();
+  void forgetFrameSchedule(uint64_t surfaceId);
+  void armHostLimiter();
+  void publishDisplayWake();
+  std::chrono::nanoseconds displayTickTolerance() const;
+  FramePriority framePriorityFor(const SurfaceState& surface) const;
+  void scheduleSurface(FrameScheduler& scheduler,
+                       const SurfaceState& surface,
+                       std::chrono::nanoseconds interval,
+                       std::chrono::steady_clock::time_point now);
   void requestFrameForSurface(SurfaceState* surface);
+  void publishRenderParams(SurfaceState& surface);
+  HostResult<FrameBuffer> acquireFrameBufferImpl(SurfaceId surfaceId,
+                                                 std::optional<std::chrono::steady_clock::time_point> deadline);
+  HostResult<FrameBuffer> prepareFrameBuffer(SurfaceState& surface, uint32_t slotIndex);
+  void schedulePostedFrame(SurfaceState& surface);
+  void presentPostedFrame(uint64_t surfaceId);
+  void encodeSlotPresent(SurfaceState& surface, uint32_t slotIndex);
 
   NSApplication* app_ = nullptr;
-  std::unordered_map<uint64_t, std::unique_ptr<SurfaceState>> surfaces_;
+  // Keyed by SurfaceId::value; iterated in creation order by the tick and schedule passes.
+  SlotMap<SurfaceState> surfaces_;
   struct DeviceRecord {
     DeviceInfo info;
     DeviceCapabilities caps;
@@ -783,6 +1129,13 @@ private:
   std::vector<uint32_t> deviceOrder_;
   std::unordered_map<void*, uint32_t> gamepadIds_;
   std::unordered_map<uint32_t, GCController*> gamepadControllers_;
+  // Written on the main thread at hot-plug; gamepadState() may read it from any thread.
+  mutable std::shared_mutex gamepadStatesMutex_;
+  std::unordered_map<uint32_t, std::unique_ptr<GamepadStateBlock>> gamepadStates_;
+  GamepadInputConfig gamepadInputConfig_{};
+  RawInputConfig rawInputConfig_{};
+  RawInputQueue rawInputQueue_;
+  MacRawInputReader rawInputReader_;
   std::unordered_map<void*, uint32_t> touchIds_;
   uint32_t nextTouchId_ = 1u;
   IOHIDManagerRef hidManager_ = nullptr;
@@ -792,18 +1145,30 @@ private:
   id gamepadDisconnectObserver_ = nil;
   id powerStateObserver_ = nil;
   id thermalStateObserver_ = nil;
-  std::vector<QueuedEvent> eventQueue_;
-  std::vector<Event> callbackEvents_;
-  std::vector<char> callbackText_;
+  id screenParametersObserver_ = nil;
+  // Rebuilt only on reconfiguration callbacks and screen parameter changes; display queries read
+  // the current snapshot without touching CoreGraphics.
+  DisplayCache displayCache_;
+  // Text spans of queued events index into textArena_.
+  std::vector<Event> eventQueue_;
+  TextArena textArena_;
   Callbacks callbacks_{};
   LogCallback logCallback_{};
-  uint64_t nextSurfaceId_ = 1u;
+  // Held shared by render-thread calls and exclusively by the main thread while it adds or
+  // removes surfaces; the main thread reads surfaces_ without it.
+  mutable std::shared_mutex surfacesMutex_;
+  // Expires with the host so work bounced to the main queue can tell it has gone.
+  std::shared_ptr<bool> lifetime_ = std::make_shared<bool>(true);
   uint32_t nextDeviceId_ = 5u;
   uint64_t nextTrayId_ = 1u;
   CVDisplayLinkRef cvDisplayLink_ = nullptr;
   std::optional<std::chrono::nanoseconds> displayInterval_{};
   dispatch_source_t hostLimiterTimer_ = nil;
-  std::chrono::nanoseconds hostLimiterInterval_{0};
+  // Continuous surfaces paced by the display link and by the host limiter timer, respectively.
+  FrameScheduler displayScheduler_;
+  FrameScheduler limiterScheduler_;
+  // steady_clock nanoseconds of the next display-paced deadline minus tick tolerance.
+  std::atomic<int64_t> displayWakeNs_{INT64_MAX};
   std::optional<SurfaceId> focusedSurface_{};
   bool cursorVisible_ = true;
   bool relativePointerEnabled_ = false;
@@ -832,7 +1197,7 @@ static CVReturn display_link_callback(CVDisplayLinkRef displayLink,
   (void)flagsIn;
   (void)flagsOut;
   auto* host = static_cast<PrimeHost::HostMac*>(context);
-  if (!host) {
+  if (!host || !host->displayTickDue()) {
     return kCVReturnSuccess;
   }
   dispatch_async(dispatch_get_main_queue(), ^{
@@ -841,6 +1206,19 @@ static CVReturn display_link_callback(CVDisplayLinkRef displayLink,
   return kCVReturnSuccess;
 }
 
+// CoreGraphics delivers these on the main run loop, once per affected display with a begin pass
+// before the change and a second pass after it.
+static void display_reconfiguration_callback(CGDirectDisplayID display,
+                                             CGDisplayChangeSummaryFlags flags,
+                                             void* userInfo) {
+  (void)display;
+  auto* host = static_cast<PrimeHost::HostMac*>(userInfo);
+  if (!host || (flags & kCGDisplayBeginConfigurationFlag) != 0u) {
+    return;
+  }
+  host->refreshDisplays();
+}
+
 static void hid_device_attached(void* context, IOReturn result, void* sender, IOHIDDeviceRef device) {
   (void)result;
   (void)sender;
@@ -897,6 +1275,24 @@ static void hid_device_removed(void* context, IOReturn result, void* sender, IOH
   }
 }
 
+- (void)windowDidChangeOcclusionState:(NSNotification*)notification {
+  if (self.host) {
+    self.host->handleVisibilityChange(self.surfaceId);
+  }
+}
+
+- (void)windowDidMiniaturize:(NSNotification*)notification {
+  if (self.host) {
+    self.host->handleVisibilityChange(self.surfaceId);
+  }
+}
+
+- (void)windowDidDeminiaturize:(NSNotification*)notification {
+  if (self.host) {
+    self.host->handleVisibilityChange(self.surfaceId);
+  }
+}
+
 - (void)windowWillClose:(NSNotification*)notification {
   if (self.host) {
     self.host->handleWindowClosed(self.surfaceId);
@@ -1394,6 +1790,21 @@ HostMac::HostMac() {
                     }];
   }
 
+  if (auto records = query_display_records()) {
+    std::vector<DisplayEvent> initial;
+    displayCache_.publish(std::move(*records), initial);
+  }
+  CGDisplayRegisterReconfigurationCallback(&display_reconfiguration_callback, this);
+  // EDR headroom follows brightness and never triggers a reconfiguration.
+  screenParametersObserver_ =
+      [[NSNotificationCenter defaultCenter]
+          addObserverForName:NSApplicationDidChangeScreenParametersNotification
+                      object:nil
+                       queue:[NSOperationQueue mainQueue]
+                  usingBlock:^(__unused NSNotification* note) {
+                    refreshDisplays();
+                  }];
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
   CVDisplayLinkCreateWithActiveCGDisplays(&cvDisplayLink_);
@@ -1410,7 +1821,9 @@ HostMac::HostMac() {
 }
 
 HostMac::~HostMac() {
+  lifetime_.reset();
   releaseRelativePointer();
+  rawInputReader_.stop();
   if (hostLimiterTimer_) {
     dispatch_source_cancel(hostLimiterTimer_);
     hostLimiterTimer_ = nil;
@@ -1451,6 +1864,11 @@ HostMac::~HostMac() {
     [[NSNotificationCenter defaultCenter] removeObserver:powerStateObserver_];
     powerStateObserver_ = nil;
   }
+  CGDisplayRemoveReconfigurationCallback(&display_reconfiguration_callback, this);
+  if (screenParametersObserver_) {
+    [[NSNotificationCenter defaultCenter] removeObserver:screenParametersObserver_];
+    screenParametersObserver_ = nil;
+  }
   if (hidManager_) {
     IOHIDManagerUnscheduleFromRunLoop(hidManager_, CFRunLoopGetMain(), kCFRunLoopDefaultMode);
     IOHIDManagerClose(hidManager_, kIOHIDOptionsTypeNone);
@@ -1491,11 +1909,12 @@ HostResult<HostCapabilities> HostMac::hostCapabilities() const {
     caps.supportsHaptics = false;
   }
   caps.supportsHeadless = true;
+  caps.supportsRawInput = true;
   return caps;
 }
 
 HostResult<SurfaceCapabilities> HostMac::surfaceCapabilities(SurfaceId surfaceId) const {
-  if (surfaces_.find(surfaceId.value) == surfaces_.end()) {
+  if (!surfaces_.contains(surfaceId.value)) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
   SurfaceCapabilities caps{};
@@ -1549,119 +1968,36 @@ HostResult<size_t> HostMac::devices(std::span<DeviceInfo> outDevices) const {
 }
 
 HostResult<size_t> HostMac::displays(std::span<DisplayInfo> outDisplays) const {
-  uint32_t count = 0u;
-  if (CGGetActiveDisplayList(0, nullptr, &count) != kCGErrorSuccess) {
-    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
-  }
+  const DisplaySnapshotReader snapshot = displayCache_.read();
+  std::span<const DisplayRecord> records = snapshot->records();
   if (outDisplays.empty()) {
-    return static_cast<size_t>(count);
+    return records.size();
   }
-  if (outDisplays.size() < count) {
+  if (outDisplays.size() < records.size()) {
     return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
   }
-  std::vector<CGDirectDisplayID> ids(count);
-  if (CGGetActiveDisplayList(count, ids.data(), &count) != kCGErrorSuccess) {
-    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  for (size_t i = 0; i < records.size(); ++i) {
+    outDisplays[i] = records[i].info;
   }
-  size_t written = 0u;
-  for (CGDirectDisplayID id : ids) {
-    CGRect bounds = CGDisplayBounds(id);
-    DisplayInfo info{};
-    info.displayId = static_cast<uint32_t>(id);
-    info.x = static_cast<int32_t>(std::lround(bounds.origin.x));
-    info.y = static_cast<int32_t>(std::lround(bounds.origin.y));
-    info.width = static_cast<uint32_t>(std::lround(bounds.size.width));
-    info.height = static_cast<uint32_t>(std::lround(bounds.size.height));
-    info.scale = 1.0f;
-    double fallbackRate = 0.0;
-    for (NSScreen* screen in [NSScreen screens]) {
-      NSNumber* screenNumber = screen.deviceDescription[@"NSScreenNumber"];
-      if (screenNumber && screenNumber.unsignedIntValue == id) {
-        info.scale = static_cast<float>(screen.backingScaleFactor);
-        if (@available(macOS 10.15, *)) {
-          fallbackRate = static_cast<double>(screen.maximumFramesPerSecond);
-        }
-        break;
-      }
-    }
-    CGDisplayModeRef mode = CGDisplayCopyDisplayMode(id);
-    if (mode) {
-      info.refreshRate = resolvedRefreshRate(CGDisplayModeGetRefreshRate(mode), fallbackRate);
-      CGDisplayModeRelease(mode);
-    } else {
-      info.refreshRate = resolvedRefreshRate(0.0, fallbackRate);
-    }
-    info.isPrimary = (id == CGMainDisplayID());
-    outDisplays[written++] = info;
-  }
-  return written;
+  return records.size();
 }
 
 HostResult<DisplayInfo> HostMac::displayInfo(uint32_t displayId) const {
-  uint32_t count = 0u;
-  if (CGGetActiveDisplayList(0, nullptr, &count) != kCGErrorSuccess) {
-    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
-  }
-  std::vector<CGDirectDisplayID> ids(count);
-  if (CGGetActiveDisplayList(count, ids.data(), &count) != kCGErrorSuccess) {
-    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
-  }
-  for (CGDirectDisplayID id : ids) {
-    if (static_cast<uint32_t>(id) != displayId) {
-      continue;
-    }
-    CGRect bounds = CGDisplayBounds(id);
-    DisplayInfo info{};
-    info.displayId = static_cast<uint32_t>(id);
-    info.x = static_cast<int32_t>(std::lround(bounds.origin.x));
-    info.y = static_cast<int32_t>(std::lround(bounds.origin.y));
-    info.width = static_cast<uint32_t>(std::lround(bounds.size.width));
-    info.height = static_cast<uint32_t>(std::lround(bounds.size.height));
-    info.scale = 1.0f;
-    double fallbackRate = 0.0;
-    for (NSScreen* screen in [NSScreen screens]) {
-      NSNumber* screenNumber = screen.deviceDescription[@"NSScreenNumber"];
-      if (screenNumber && screenNumber.unsignedIntValue == id) {
-        info.scale = static_cast<float>(screen.backingScaleFactor);
-        if (@available(macOS 10.15, *)) {
-          fallbackRate = static_cast<double>(screen.maximumFramesPerSecond);
-        }
-        break;
-      }
-    }
-    CGDisplayModeRef mode = CGDisplayCopyDisplayMode(id);
-    if (mode) {
-      info.refreshRate = resolvedRefreshRate(CGDisplayModeGetRefreshRate(mode), fallbackRate);
-      CGDisplayModeRelease(mode);
-    } else {
-      info.refreshRate = resolvedRefreshRate(0.0, fallbackRate);
-    }
-    info.isPrimary = (id == CGMainDisplayID());
-    return info;
+  const DisplaySnapshotReader snapshot = displayCache_.read();
+  const DisplayRecord* record = snapshot->find(displayId);
+  if (!record) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
   }
-  return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
+  return record->info;
 }
 
 HostResult<DisplayHdrInfo> HostMac::displayHdrInfo(uint32_t displayId) const {
-  NSScreen* target = nil;
-  for (NSScreen* screen in [NSScreen screens]) {
-    NSNumber* screenNumber = screen.deviceDescription[@"NSScreenNumber"];
-    if (screenNumber && screenNumber.unsignedIntValue == displayId) {
-      target = screen;
-      break;
-    }
-  }
-  if (!target) {
+  const DisplaySnapshotReader snapshot = displayCache_.read();
+  const DisplayRecord* record = snapshot->find(displayId);
+  if (!record) {
     return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
   }
-
-  DisplayHdrInfo info{};
-  if (@available(macOS 10.15, *)) {
-    info.maxEdr = static_cast<float>(target.maximumExtendedDynamicRangeColorComponentValue);
-    info.maxEdrPotential = static_cast<float>(target.maximumPotentialExtendedDynamicRangeColorComponentValue);
-    info.supportsHdr = info.maxEdr > 1.0f || info.maxEdrPotential > 1.0f;
-  }
-  return info;
+  return record->hdr;
 }
 
 HostResult<uint32_t> HostMac::surfaceDisplay(SurfaceId surfaceId) const {
@@ -1695,15 +2031,7 @@ HostStatus HostMac::setSurfaceDisplay(SurfaceId surfaceId, uint32_t displayId) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
   if (surface->headless) {
-    NSScreen* targetScreen = nil;
-    for (NSScreen* screen in [NSScreen screens]) {
-      NSNumber* screenNumber = screen.deviceDescription[@"NSScreenNumber"];
-      if (screenNumber && screenNumber.unsignedIntValue == displayId) {
-        targetScreen = screen;
-        break;
-      }
-    }
-    if (!targetScreen) {
+    if (!displayCache_.read()->find(displayId)) {
       return std::unexpected(HostError{HostErrorCode::InvalidDisplay});
     }
     surface->headlessDisplayId = displayId;
@@ -1734,7 +2062,7 @@ HostStatus HostMac::setSurfaceDisplay(SurfaceId surfaceId, uint32_t displayId) {
 }
 
 HostResult<SurfaceId> HostMac::createSurface(const SurfaceConfig& config) {
-  SurfaceId surfaceId{nextSurfaceId_++};
+  SurfaceId surfaceId{surfaces_.nextHandle()};
 
   if (config.width == 0u || config.height == 0u) {
     return std::unexpected(HostError{HostErrorCode::InvalidConfig});
@@ -1757,7 +2085,13 @@ HostResult<SurfaceId> HostMac::createSurface(const SurfaceConfig& config) {
     state->headlessSize = SurfaceSize{config.width, config.height};
     state->headlessDisplayId = static_cast<uint32_t>(CGMainDisplayID());
     state->displayInterval = display_interval_for_display(state->headlessDisplayId);
-    surfaces_.emplace(surfaceId.value, std::move(state));
+    SurfaceState* statePtr = state.get();
+    {
+      std::unique_lock<std::shared_mutex> lock(surfacesMutex_);
+      surfaces_.insert(std::move(state));
+    }
+    // Published once registered so surfaceCapabilities() clamps the buffer count.
+    publishRenderParams(*statePtr);
 
     Event created{};
     created.scope = Event::Scope::Surface;
@@ -1863,7 +2197,11 @@ HostResult<SurfaceId> HostMac::createSurface(const SurfaceConfig& config) {
     }
   }
 #endif
-  surfaces_.emplace(surfaceId.value, std::move(state));
+  {
+    std::unique_lock<std::shared_mutex> lock(surfacesMutex_);
+    surfaces_.insert(std::move(state));
+  }
+  publishRenderParams(*statePtr);
 
   if (statePtr) {
     auto caps = surfaceCapabilities(surfaceId);
@@ -1886,14 +2224,14 @@ HostResult<SurfaceId> HostMac::createSurface(const SurfaceConfig& config) {
 }
 
 HostStatus HostMac::destroySurface(SurfaceId surfaceId) {
-  auto it = surfaces_.find(surfaceId.value);
-  if (it == surfaces_.end()) {
+  SurfaceState* surface = findSurface(surfaceId.value);
+  if (!surface) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
   if (focusedSurface_ && focusedSurface_->value == surfaceId.value) {
     focusedSurface_.reset();
   }
-  if (it->second && it->second->headless) {
+  if (surface->headless) {
     Event evt{};
     evt.scope = Event::Scope::Surface;
     evt.surfaceId = surfaceId;
@@ -1904,18 +2242,24 @@ HostStatus HostMac::destroySurface(SurfaceId surfaceId) {
   if (relativePointerEnabled_ && relativePointerSurface_ && relativePointerSurface_->value == surfaceId.value) {
     releaseRelativePointer();
   }
-  NSWindow* window = it->second->window;
+  NSWindow* window = surface->window;
 #if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
-  if (it->second->viewDisplayLink) {
-    [it->second->viewDisplayLink invalidate];
-    it->second->viewDisplayLink = nil;
+  if (surface->viewDisplayLink) {
+    [surface->viewDisplayLink invalidate];
+    surface->viewDisplayLink = nil;
   }
 #endif
-  it->second->window = nil;
-  it->second->view = nil;
-  it->second->layer = nil;
-  it->second->commandQueue = nil;
-  surfaces_.erase(it);
+  forgetFrameSchedule(surfaceId.value);
+  // Wake a render thread blocked in acquireFrameBuffer before taking the lock it re-checks under.
+  surface->frameSlots->close();
+  {
+    std::unique_lock<std::shared_mutex> lock(surfacesMutex_);
+    surface->window = nil;
+    surface->view = nil;
+    surface->layer = nil;
+    surface->commandQueue = nil;
+    surfaces_.erase(surfaceId.value);
+  }
   if (window) {
     [window close];
   }
@@ -1932,14 +2276,38 @@ HostResult<EventBatch> HostMac::pollEvents(const EventBuffer& buffer) {
   }
   pumpEvents(false);
 
-  auto batch = buildBatch(std::span<const QueuedEvent>(eventQueue_.data(), eventQueue_.size()), buffer);
-  if (!batch) {
-    return std::unexpected(batch.error());
+  // Deliver the longest prefix whose text fits; the rest stays queued and is reported in `pending`,
+  // so one oversized drop cannot wedge the queue.
+  const std::span<const Event> queued(eventQueue_.data(), std::min(buffer.events.size(), eventQueue_.size()));
+  const size_t count = eventsFittingText(queued, buffer.textBytes.size());
+  std::copy_n(eventQueue_.begin(), count, buffer.events.begin());
+  auto textBytes = copyEventText(buffer.events.first(count), textArena_, buffer.textBytes);
+  if (!textBytes) {
+    return std::unexpected(textBytes.error());
+  }
+  eventQueue_.erase(eventQueue_.begin(), eventQueue_.begin() + static_cast<long>(count));
+  const EventBufferSize pending = eventBufferSize(eventQueue_);
+
+  // Start the next generation from an empty arena; while events remain queued, drop the consumed
+  // prefix once it is the larger part so a caller polling in small batches keeps the arena bounded.
+  if (eventQueue_.empty()) {
+    textArena_.reset();
+  } else {
+    const size_t consumedText = eventTextRange(eventQueue_).first;
+    if (consumedText > textArena_.size() / 2u) {
+      textArena_.discardFront(consumedText);
+      rebaseEventText(eventQueue_, consumedText);
+    }
   }
+  return EventBatch{
+      std::span<const Event>(buffer.events.data(), count),
+      std::span<const char>(buffer.textBytes.data(), *textBytes),
+      pending,
+  };
+}
 
-  size_t consumed = batch->events.size();
-  eventQueue_.erase(eventQueue_.begin(), eventQueue_.begin() + static_cast<long>(consumed));
-  return batch;
+HostResult<EventBufferSize> HostMac::pendingEventsSize() const {
+  return eventBufferSize(eventQueue_);
 }
 
 HostStatus HostMac::waitEvents() {
@@ -1947,109 +2315,135 @@ HostStatus HostMac::waitEvents() {
   return {};
 }
 
+HostStatus HostMac::wakeEvents() {
+  // postEvent is safe from any thread; the event only ends the wait and is otherwise ignored.
+  NSEvent* event = [NSEvent otherEventWithType:NSEventTypeApplicationDefined
+                                      location:NSZeroPoint
+                                 modifierFlags:0
+                                     timestamp:0
+                                  windowNumber:0
+                                       context:nil
+                                       subtype:0
+                                         data1:0
+                                         data2:0];
+  if (!event) {
+    return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+  }
+  [NSApp postEvent:event atStart:NO];
+  return {};
+}
+
 HostResult<FrameBuffer> HostMac::acquireFrameBuffer(SurfaceId surfaceId) {
+  return acquireFrameBufferImpl(surfaceId, std::nullopt);
+}
+
+HostResult<FrameBuffer> HostMac::acquireFrameBuffer(SurfaceId surfaceId,
+                                                    std::chrono::steady_clock::time_point deadline) {
+  return acquireFrameBufferImpl(surfaceId, deadline);
+}
+
+HostResult<FrameBuffer> HostMac::acquireFrameBufferImpl(
+    SurfaceId surfaceId,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+  // Render-thread entry point: reads only the published render params, never AppKit state.
+  std::shared_lock<std::shared_mutex> lock(surfacesMutex_);
   auto* surface = findSurface(surfaceId.value);
   if (!surface) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
-  if (surface->frameConfig.colorFormat != ColorFormat::B8G8R8A8_UNORM) {
+  surface->renderParams.consume(surface->renderView);
+  const SurfaceRenderParams& params = surface->renderView;
+  if (params.colorFormat != ColorFormat::B8G8R8A8_UNORM) {
     return std::unexpected(HostError{HostErrorCode::Unsupported});
   }
-
-  uint32_t widthPx = 0u;
-  uint32_t heightPx = 0u;
-  float scale = 1.0f;
-  if (surface->headless) {
-    widthPx = surface->headlessSize.width;
-    heightPx = surface->headlessSize.height;
-  } else if (surface->window && surface->window.contentView) {
-    NSView* view = surface->window.contentView;
-    NSRect bounds = view.bounds;
-    scale = surface->window.backingScaleFactor;
-    widthPx = static_cast<uint32_t>(std::lround(bounds.size.width * scale));
-    heightPx = static_cast<uint32_t>(std::lround(bounds.size.height * scale));
-  }
-
+  const uint32_t widthPx = params.widthPx;
+  const uint32_t heightPx = params.heightPx;
   if (widthPx == 0u || heightPx == 0u) {
     return std::unexpected(HostError{HostErrorCode::InvalidConfig});
   }
 
-  uint32_t desiredBuffers = 2u;
-  auto caps = surfaceCapabilities(surfaceId);
-  if (caps) {
-    desiredBuffers = effectiveBufferCount(surface->frameConfig, caps.value());
-  }
-  if (desiredBuffers == 0u) {
-    desiredBuffers = 2u;
-  }
-
-  if (surface->frameBuffers.empty()) {
+  FrameSlotTable& slots = *surface->frameSlots;
+  const uint32_t desiredBuffers = std::clamp(params.bufferCount, 1u, FrameSlotTable::MaxSlots);
+  // A buffer-count change waits until no slot is acquired or on the GPU.
+  if (desiredBuffers != slots.count() && slots.resize(desiredBuffers)) {
+    surface->frameBuffers.clear();
     surface->frameBuffers.resize(desiredBuffers);
-    surface->frameBufferCursor = 0u;
-  } else if (desiredBuffers != surface->frameBuffers.size()) {
-    bool canResize = true;
-    for (const auto& slot : surface->frameBuffers) {
-      if (slot.inFlight || slot.acquired) {
-        canResize = false;
-        break;
-      }
-    }
-    if (canResize) {
-      surface->frameBuffers.clear();
-      surface->frameBuffers.resize(desiredBuffers);
-      surface->frameBufferCursor = 0u;
-    }
   }
-
   if (surface->frameBuffers.empty()) {
     return std::unexpected(HostError{HostErrorCode::OutOfMemory});
   }
 
-  size_t slotIndex = surface->frameBuffers.size();
-  for (size_t i = 0; i < surface->frameBuffers.size(); ++i) {
-    size_t candidate = (surface->frameBufferCursor + i) % surface->frameBuffers.size();
-    auto& slot = surface->frameBuffers[candidate];
-    if (!slot.inFlight && !slot.acquired) {
-      slotIndex = candidate;
-      break;
+  if (!deadline) {
+    auto slotIndex = slots.acquire();
+    if (!slotIndex) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
     }
+    return prepareFrameBuffer(*surface, *slotIndex);
+  }
+
+  // Wait without the surfaces lock so destroySurface can proceed; it closes the table, which
+  // wakes us, and the lookup below then fails.
+  std::shared_ptr<FrameSlotTable> table = surface->frameSlots;
+  const uint32_t maxInFlight = params.maxFrameLatency;
+  lock.unlock();
+  const auto waitStart = std::chrono::steady_clock::now();
+  auto slotIndex = table->acquireUntil(*deadline, maxInFlight);
+  const auto waited = std::chrono::steady_clock::now() - waitStart;
+  lock.lock();
+  surface = findSurface(surfaceId.value);
+  if (!surface || surface->frameSlots != table) {
+    return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
-  if (slotIndex >= surface->frameBuffers.size()) {
+  surface->acquireWaitNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(),
+                                   std::memory_order_relaxed);
+  if (!slotIndex) {
     return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
   }
+  return prepareFrameBuffer(*surface, *slotIndex);
+}
 
-  auto& slot = surface->frameBuffers[slotIndex];
-  slot.acquired = true;
-  surface->frameBufferCursor = (slotIndex + 1u) % surface->frameBuffers.size();
+// Sizes the acquired slot's pixels and texture for the current render params. Called with the
+// surfaces lock held shared; releases the slot on failure.
+HostResult<FrameBuffer> HostMac::prepareFrameBuffer(SurfaceState& surface, uint32_t slotIndex) {
+  FrameSlotTable& slots = *surface.frameSlots;
+  const SurfaceRenderParams& params = surface.renderView;
+  const uint32_t widthPx = params.widthPx;
+  const uint32_t heightPx = params.heightPx;
+  auto& slot = surface.frameBuffers[slotIndex];
 
-  uint32_t stride = widthPx * 4u;
-  auto area = checkedSizeMul(widthPx, heightPx);
-  auto total = area ? checkedSizeMul(*area, static_cast<size_t>(4u)) : std::nullopt;
+  auto stride = frameBufferStride(widthPx, params.bufferPolicy.layout);
+  auto total = stride ? checkedSizeMul(*stride, heightPx) : std::nullopt;
   if (!total) {
-    slot.acquired = false;
+    slots.release(slotIndex);
     return std::unexpected(HostError{HostErrorCode::OutOfMemory});
   }
 
-  bool sizeChanged = slot.width != widthPx || slot.height != heightPx || slot.stride != stride;
+  bool sizeChanged = slot.width != widthPx || slot.height != heightPx || slot.stride != *stride;
+  // The storage only grows, so a resize that fits (pooled headless surfaces) reuses the mapping.
+  // It keeps the pixels when the byte count is unchanged, which a reshape (w x h to h x w) must not.
+  const bool reshaped = sizeChanged && slot.pixels.size() == *total;
+  if (!slot.pixels.resize(*total, params.bufferPolicy)) {
+    slots.release(slotIndex);
+    return std::unexpected(HostError{HostErrorCode::OutOfMemory});
+  }
+  if (reshaped) {
+    std::memset(slot.pixels.data(), 0, slot.pixels.size());
+  }
   if (sizeChanged) {
-    slot.pixels.clear();
-    slot.pixels.resize(*total, 0u);
     slot.width = widthPx;
     slot.height = heightPx;
-    slot.stride = stride;
-  } else if (slot.pixels.size() != *total) {
-    slot.pixels.resize(*total, 0u);
+    slot.stride = *stride;
   }
 
-  if (!surface->headless) {
-    if (!surface->layer || !surface->commandQueue) {
-      slot.acquired = false;
+  if (!surface.headless) {
+    if (!surface.layer || !surface.commandQueue) {
+      slots.release(slotIndex);
       return std::unexpected(HostError{HostErrorCode::PlatformFailure});
     }
     if (sizeChanged || !slot.texture) {
-      id<MTLDevice> device = surface->layer.device;
+      id<MTLDevice> device = surface.layer.device;
       if (!device) {
-        slot.acquired = false;
+        slots.release(slotIndex);
         return std::unexpected(HostError{HostErrorCode::PlatformFailure});
       }
       MTLTextureDescriptor* desc =
@@ -2062,7 +2456,7 @@ HostResult<FrameBuffer> HostMac::acquireFrameBuffer(SurfaceId surfaceId) {
       desc.cpuCacheMode = MTLCPUCacheModeWriteCombined;
       slot.texture = [device newTextureWithDescriptor:desc];
       if (!slot.texture) {
-        slot.acquired = false;
+        slots.release(slotIndex);
         return std::unexpected(HostError{HostErrorCode::PlatformFailure});
       }
     }
@@ -2070,15 +2464,16 @@ HostResult<FrameBuffer> HostMac::acquireFrameBuffer(SurfaceId surfaceId) {
 
   FrameBuffer buffer{};
   buffer.size = ImageSize{widthPx, heightPx};
-  buffer.stride = stride;
-  buffer.colorFormat = surface->frameConfig.colorFormat;
-  buffer.scale = scale;
-  buffer.bufferIndex = static_cast<uint32_t>(slotIndex);
-  buffer.pixels = std::span<uint8_t>(slot.pixels);
+  buffer.stride = *stride;
+  buffer.colorFormat = params.colorFormat;
+  buffer.scale = params.scale;
+  buffer.bufferIndex = slotIndex;
+  buffer.pixels = slot.pixels.span();
   return buffer;
 }
 
 HostStatus HostMac::presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& buffer) {
+  std::shared_lock<std::shared_mutex> lock(surfacesMutex_);
   auto* surface = findSurface(surfaceId.value);
   if (!surface) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
@@ -2086,25 +2481,33 @@ HostStatus HostMac::presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& b
   if (buffer.colorFormat != ColorFormat::B8G8R8A8_UNORM) {
     return std::unexpected(HostError{HostErrorCode::Unsupported});
   }
-  if (buffer.bufferIndex >= surface->frameBuffers.size()) {
+  FrameSlotTable& slots = *surface->frameSlots;
+  if (buffer.bufferIndex >= surface->frameBuffers.size() ||
+      slots.state(buffer.bufferIndex) != FrameSlotState::Acquired) {
     return std::unexpected(HostError{HostErrorCode::InvalidConfig});
   }
 
   auto& slot = surface->frameBuffers[buffer.bufferIndex];
-  if (!slot.acquired) {
-    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  const bool mailbox = surface->renderView.mailbox;
+  if (surface->captureSink) {
+    surface->captureSink->submit(imageView(buffer));
   }
-
-  slot.acquired = false;
-
   if (surface->headless) {
-    slot.inFlight = false;
+    if (mailbox) {
+      slots.post(buffer.bufferIndex);
+      schedulePostedFrame(*surface);
+      return {};
+    }
+    surface->shownSlot.store(buffer.bufferIndex, std::memory_order_release);
+    slots.release(buffer.bufferIndex);
     return {};
   }
   if (!surface->layer || !surface->commandQueue) {
+    slots.release(buffer.bufferIndex);
     return std::unexpected(HostError{HostErrorCode::PlatformFailure});
   }
   if (!slot.texture || slot.width != buffer.size.width || slot.height != buffer.size.height) {
+    slots.release(buffer.bufferIndex);
     return std::unexpected(HostError{HostErrorCode::InvalidConfig});
   }
 
@@ -2114,13 +2517,33 @@ HostStatus HostMac::presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& b
                     mipmapLevel:0
                       withBytes:slot.pixels.data()
                     bytesPerRow:slot.stride];
+  }
 
-    id<CAMetalDrawable> drawable = [surface->layer nextDrawable];
+  if (mailbox) {
+    // The upload is done; the main thread blits whichever posted slot is newest when it runs, so
+    // a slow nextDrawable never holds up the render thread.
+    slots.post(buffer.bufferIndex);
+    schedulePostedFrame(*surface);
+    return {};
+  }
+  slots.submit(buffer.bufferIndex);
+  encodeSlotPresent(*surface, buffer.bufferIndex);
+  return {};
+}
+
+// Blits an in-flight slot's texture to the next drawable and presents it. The slot returns to
+// Free when the GPU finishes, or right away if no drawable is available.
+void HostMac::encodeSlotPresent(SurfaceState& surface, uint32_t slotIndex) {
+  auto& slot = surface.frameBuffers[slotIndex];
+  std::shared_ptr<FrameSlotTable> completion = surface.frameSlots;
+  @autoreleasepool {
+    id<CAMetalDrawable> drawable = [surface.layer nextDrawable];
     if (!drawable) {
-      return {};
+      completion->complete(slotIndex);
+      return;
     }
 
-    id<MTLCommandBuffer> commandBuffer = [surface->commandQueue commandBuffer];
+    id<MTLCommandBuffer> commandBuffer = [surface.commandQueue commandBuffer];
     id<MTLBlitCommandEncoder> blit = [commandBuffer blitCommandEncoder];
     MTLOrigin origin = {0, 0, 0};
     MTLSize size = {slot.width, slot.height, 1};
@@ -2139,18 +2562,65 @@ HostStatus HostMac::presentFrameBuffer(SurfaceId surfaceId, const FrameBuffer& b
     [CATransaction setDisableActions:YES];
     [commandBuffer presentDrawable:drawable];
     [CATransaction commit];
-    slot.inFlight = true;
-    auto* slotPtr = &slot;
     [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> _Nonnull) {
-      slotPtr->inFlight = false;
+      completion->complete(slotIndex);
     }];
     [commandBuffer commit];
   }
+}
 
-  return {};
+void HostMac::schedulePostedFrame(SurfaceState& surface) {
+  if (surface.mailboxScheduled.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  const uint64_t surfaceId = surface.surfaceId.value;
+  std::weak_ptr<bool> alive = lifetime_;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    if (alive.lock()) {
+      presentPostedFrame(surfaceId);
+    }
+  });
+}
+
+// Main thread. Shows the newest posted frame; anything posted after the flag clears schedules
+// another pass.
+void HostMac::presentPostedFrame(uint64_t surfaceId) {
+  auto* surface = findSurface(surfaceId);
+  if (!surface) {
+    return;
+  }
+  surface->mailboxScheduled.store(false, std::memory_order_release);
+  auto slotIndex = surface->frameSlots->takePosted();
+  if (!slotIndex) {
+    return;
+  }
+  if (surface->headless || !surface->layer || !surface->commandQueue) {
+    if (surface->headless) {
+      surface->shownSlot.store(*slotIndex, std::memory_order_release);
+    }
+    surface->frameSlots->complete(*slotIndex);
+    return;
+  }
+  encodeSlotPresent(*surface, *slotIndex);
 }
 
 HostStatus HostMac::requestFrame(SurfaceId surfaceId, bool bypassCap) {
+  if (![NSThread isMainThread]) {
+    // Frame callbacks and pacing state belong to the main thread; hop there.
+    {
+      std::shared_lock<std::shared_mutex> lock(surfacesMutex_);
+      if (!findSurface(surfaceId.value)) {
+        return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+      }
+    }
+    std::weak_ptr<bool> alive = lifetime_;
+    dispatch_async(dispatch_get_main_queue(), ^{
+      if (alive.lock()) {
+        requestFrame(surfaceId, bypassCap);
+      }
+    });
+    return {};
+  }
   auto* surface = findSurface(surfaceId.value);
   if (!surface) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
@@ -2199,6 +2669,8 @@ HostStatus HostMac::requestFrame(SurfaceId surfaceId, bool bypassCap) {
                                                 timing.delta,
                                                 surface->frameConfig.framePolicy,
                                                 surface->frameConfig.framePacingSource);
+  diag.acquireWait = std::chrono::nanoseconds(surface->acquireWaitNs.exchange(0, std::memory_order_relaxed));
+  diag.supersededFrames = surface->frameSlots->takeSuperseded();
 
   callbacks_.onFrame(surfaceId, timing, diag);
   return {};
@@ -2224,6 +2696,7 @@ HostStatus HostMac::setFrameConfig(SurfaceId surfaceId, const FrameConfig& confi
   }
   surface->frameConfig = resolved;
   apply_layer_config(*surface, caps.value());
+  publishRenderParams(*surface);
   updateDisplayLinkState();
   return {};
 }
@@ -2300,6 +2773,7 @@ HostStatus HostMac::setSurfaceSize(SurfaceId surfaceId, uint32_t width, uint32_t
   }
   if (surface->headless) {
     surface->headlessSize = SurfaceSize{width, height};
+    publishRenderParams(*surface);
     return {};
   }
   if (!surface->window) {
@@ -2900,10 +3374,38 @@ HostStatus HostMac::setClipboardImage(const ImageData& image) {
   return {};
 }
 
+HostStatus HostMac::setSurfaceCaptureSink(SurfaceId surfaceId, std::shared_ptr<FrameCaptureSink> sink) {
+  std::unique_lock<std::shared_mutex> lock(surfacesMutex_);
+  auto* surface = findSurface(surfaceId.value);
+  if (!surface) {
+    return std::unexpected(HostError{HostErrorCode::InvalidSurface});
+  }
+  surface->captureSink = std::move(sink);
+  return {};
+}
+
 HostStatus HostMac::writeSurfaceScreenshot(SurfaceId surfaceId,
                                            Utf8TextView path,
                                            const ScreenshotConfig& config) {
   auto* surface = findSurface(surfaceId.value);
+  if (surface && surface->headless) {
+    // No window to capture: encode the last presented frame, pinned so the renderer cannot reuse
+    // its slot meanwhile. Fails while that slot is being redrawn.
+    if (!imageFileFormatForPath(path)) {
+      return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+    }
+    std::shared_lock<std::shared_mutex> lock(surfacesMutex_);
+    FrameSlotTable& slots = *surface->frameSlots;
+    const uint32_t slotIndex = surface->shownSlot.load(std::memory_order_acquire);
+    if (slotIndex >= surface->frameBuffers.size() || !slots.acquireSlot(slotIndex)) {
+      return std::unexpected(HostError{HostErrorCode::PlatformFailure});
+    }
+    const auto& slot = surface->frameBuffers[slotIndex];
+    ImageView image{ImageSize{slot.width, slot.height}, slot.stride, ColorFormat::B8G8R8A8_UNORM, slot.pixels.span()};
+    auto status = writeImageFile(image, path);
+    slots.release(slotIndex);
+    return status;
+  }
   if (!surface || !surface->window) {
     return std::unexpected(HostError{HostErrorCode::InvalidSurface});
   }
@@ -3317,6 +3819,26 @@ HostStatus HostMac::setSurfaceMaxSize(SurfaceId surfaceId, uint32_t width, uint3
   return {};
 }
 
+HostResult<GamepadState> HostMac::gamepadState(uint32_t deviceId) const {
+  std::shared_lock<std::shared_mutex> lock(gamepadStatesMutex_);
+  auto it = gamepadStates_.find(deviceId);
+  if (it == gamepadStates_.end()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  return it->second->snapshot();
+}
+
+HostStatus HostMac::setGamepadInputConfig(const GamepadInputConfig& config) {
+  if (auto status = validateGamepadInputConfig(config); !status) {
+    return status;
+  }
+  gamepadInputConfig_ = config;
+  for (auto& entry : gamepadStates_) {
+    entry.second->applyConfig(config);
+  }
+  return {};
+}
+
 HostStatus HostMac::setGamepadRumble(const GamepadRumble& rumble) {
   auto controllerIt = gamepadControllers_.find(rumble.deviceId);
   if (controllerIt == gamepadControllers_.end()) {
@@ -3804,6 +4326,30 @@ HostStatus HostMac::setRelativePointerCapture(SurfaceId surfaceId, bool enabled)
   return {};
 }
 
+HostStatus HostMac::setRawInputConfig(const RawInputConfig& config) {
+  if (auto status = validateRawInputConfig(config); !status) {
+    return status;
+  }
+  rawInputReader_.stop();
+  rawInputConfig_ = config;
+  if (!config.enabled) {
+    return {};
+  }
+  rawInputQueue_.reset(config.capacity);
+  if (auto status = rawInputReader_.start(rawInputQueue_); !status) {
+    rawInputConfig_.enabled = false;
+    return status;
+  }
+  return {};
+}
+
+HostResult<RawInputBatch> HostMac::drainRawInput(std::span<RawInputSample> outSamples) {
+  if (!rawInputConfig_.enabled) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return rawInputQueue_.drain(outSamples);
+}
+
 HostStatus HostMac::setLogCallback(LogCallback callback) {
   logCallback_ = std::move(callback);
   return {};
@@ -3813,25 +4359,11 @@ HostStatus HostMac::setCallbacks(Callbacks callbacks) {
   callbacks_ = std::move(callbacks);
   updateDisplayLinkState();
   if (callbacks_.onEvents && !eventQueue_.empty()) {
-    callbackEvents_.clear();
-    callbackText_.clear();
-    callbackEvents_.resize(eventQueue_.size());
-    size_t textBytes = 0u;
-    for (const auto& queued : eventQueue_) {
-      textBytes += queued.text.size();
-    }
-    if (textBytes > 0u) {
-      callbackText_.resize(textBytes);
-    }
-    EventBuffer buffer{
-        std::span<Event>(callbackEvents_.data(), callbackEvents_.size()),
-        std::span<char>(callbackText_.data(), callbackText_.size()),
-    };
-    auto batch = buildBatch(std::span<const QueuedEvent>(eventQueue_.data(), eventQueue_.size()), buffer);
-    if (batch) {
-      callbacks_.onEvents(*batch);
-      eventQueue_.clear();
-    }
+    // Queued spans already index into the arena, so the callback reads it in place.
+    EventBatch batch{std::span<const Event>(eventQueue_.data(), eventQueue_.size()), textArena_.bytes()};
+    callbacks_.onEvents(batch);
+    eventQueue_.clear();
+    textArena_.reset();
   }
   return {};
 }
@@ -3851,6 +4383,7 @@ void HostMac::handleResize(uint64_t surfaceId) {
     surface->layer.contentsScale = scale;
     surface->layer.drawableSize = CGSizeMake(bounds.size.width * scale, bounds.size.height * scale);
     [CATransaction commit];
+    publishRenderParams(*surface);
 
     ResizeEvent resize{};
     resize.width = static_cast<uint32_t>(bounds.size.width);
@@ -4196,17 +4729,21 @@ void HostMac::handleText(uint64_t surfaceId, NSString* text, NSEvent* event) {
   if (!data || data.length == 0) {
     return;
   }
-  std::string utf8(static_cast<const char*>(data.bytes), data.length);
+  auto span = textArena_.append(std::string_view(static_cast<const char*>(data.bytes), data.length));
+  if (!span) {
+    return;
+  }
 
   TextEvent textEvent{};
   textEvent.deviceId = kKeyboardDeviceId;
+  textEvent.text = *span;
 
   Event evt{};
   evt.scope = Event::Scope::Surface;
   evt.surfaceId = SurfaceId{surfaceId};
   evt.time = eventTime;
   evt.payload = textEvent;
-  enqueueEvent(std::move(evt), std::move(utf8));
+  enqueueEvent(std::move(evt));
   requestFrameForSurface(surface);
 }
 
@@ -4229,6 +4766,16 @@ void HostMac::handleFocus(uint64_t surfaceId, bool focused) {
   event.time = event_time_for([NSApp currentEvent]);
   event.payload = focus;
   enqueueEvent(std::move(event));
+  updateFrameSchedule();
+  requestFrameForSurface(surface);
+}
+
+void HostMac::handleVisibilityChange(uint64_t surfaceId) {
+  auto* surface = findSurface(surfaceId);
+  if (!surface) {
+    return;
+  }
+  updateFrameSchedule();
   requestFrameForSurface(surface);
 }
 
@@ -4251,6 +4798,7 @@ void HostMac::handleScreenChange(uint64_t surfaceId) {
     return;
   }
   surface->displayInterval = display_interval_for_display(screenNumber.unsignedIntValue);
+  updateFrameSchedule();
   requestFrameForSurface(surface);
 }
 
@@ -4266,6 +4814,10 @@ void HostMac::handleGamepadConnected(GCController* controller) {
   uint32_t deviceId = nextDeviceId_++;
   gamepadIds_[key] = deviceId;
   gamepadControllers_[deviceId] = controller;
+  {
+    std::unique_lock<std::shared_mutex> lock(gamepadStatesMutex_);
+    gamepadStates_[deviceId] = std::make_unique<GamepadStateBlock>(deviceId);
+  }
 
   DeviceRecord record{};
   record.info.deviceId = deviceId;
@@ -4505,6 +5057,10 @@ void HostMac::handleGamepadDisconnected(GCController* controller) {
   uint32_t deviceId = it->second;
   gamepadIds_.erase(it);
   gamepadControllers_.erase(deviceId);
+  {
+    std::unique_lock<std::shared_mutex> lock(gamepadStatesMutex_);
+    gamepadStates_.erase(deviceId);
+  }
   auto hapticsIt = hapticsEngines_.find(deviceId);
   if (hapticsIt != hapticsEngines_.end()) {
     if (hapticsIt->second) {
@@ -4561,7 +5117,8 @@ void HostMac::handleDrop(uint64_t surfaceId, NSArray<NSURL*>* urls) {
     return;
   }
 
-  std::string text;
+  // Paths are joined in place in the arena, so a large drop costs no per-path allocation.
+  const size_t textBegin = textArena_.size();
   uint32_t count = 0u;
   for (NSURL* url in urls) {
     if (!url) {
@@ -4575,11 +5132,12 @@ void HostMac::handleDrop(uint64_t surfaceId, NSArray<NSURL*>* urls) {
     if (!data || data.length == 0) {
       continue;
     }
-    if (!text.empty()) {
-      text.push_back('\0');
+    if (count > 0u && !textArena_.append(std::string_view("\0", 1u))) {
+      break;
+    }
+    if (!textArena_.append(std::string_view(static_cast<const char*>(data.bytes), data.length))) {
+      break;
     }
-    text.append(reinterpret_cast<const char*>(data.bytes),
-                reinterpret_cast<const char*>(data.bytes) + data.length);
     ++count;
   }
 
@@ -4589,14 +5147,14 @@ void HostMac::handleDrop(uint64_t surfaceId, NSArray<NSURL*>* urls) {
 
   DropEvent drop{};
   drop.count = count;
-  drop.paths = TextSpan{0u, static_cast<uint32_t>(text.size())};
+  drop.paths = textArena_.spanFrom(textBegin);
 
   Event event{};
   event.scope = Event::Scope::Surface;
   event.surfaceId = surface->surfaceId;
   event.time = event_time_for([NSApp currentEvent]);
   event.payload = drop;
-  enqueueEvent(std::move(event), std::move(text));
+  enqueueEvent(std::move(event));
   requestFrameForSurface(surface);
 }
 
@@ -4624,10 +5182,46 @@ void HostMac::handleThermalStateChange() {
   }
 }
 
+void HostMac::refreshDisplays() {
+  auto records = query_display_records();
+  if (!records) {
+    return;
+  }
+  std::vector<DisplayEvent> changes;
+  if (!displayCache_.publish(std::move(*records), changes)) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  bool rateChanged = false;
+  for (const DisplayEvent& change : changes) {
+    rateChanged |= (change.fields & static_cast<DisplayFieldMask>(DisplayField::RefreshRate)) != 0u;
+    Event event{};
+    event.scope = Event::Scope::Global;
+    event.time = now;
+    event.payload = change;
+    enqueueEvent(std::move(event));
+  }
+  if (!rateChanged) {
+    return;
+  }
+  for (auto& entry : surfaces_) {
+    SurfaceState& surface = *entry.value;
+    if (auto displayId = surfaceDisplay(surface.surfaceId)) {
+      surface.displayInterval = display_interval_for_display(*displayId);
+    }
+  }
+  updateFrameSchedule();
+}
+
 void HostMac::enqueueGamepadButton(uint32_t deviceId,
                                    uint32_t controlId,
                                    bool pressed,
                                    std::optional<float> value) {
+  const auto now = std::chrono::steady_clock::now();
+  if (auto it = gamepadStates_.find(deviceId); it != gamepadStates_.end()) {
+    it->second->setButton(controlId, pressed, value, now);
+  }
+
   GamepadButtonEvent button{};
   button.deviceId = deviceId;
   button.controlId = controlId;
@@ -4636,7 +5230,7 @@ void HostMac::enqueueGamepadButton(uint32_t deviceId,
 
   Event event{};
   event.scope = Event::Scope::Global;
-  event.time = std::chrono::steady_clock::now();
+  event.time = now;
   event.payload = button;
   enqueueEvent(std::move(event));
   if (focusedSurface_) {
@@ -4645,16 +5239,32 @@ void HostMac::enqueueGamepadButton(uint32_t deviceId,
 }
 
 void HostMac::enqueueGamepadAxis(uint32_t deviceId, uint32_t controlId, float value) {
-  GamepadAxisEvent axis{};
-  axis.deviceId = deviceId;
-  axis.controlId = controlId;
-  axis.value = clampGamepadAxisValue(controlId, value);
+  auto it = gamepadStates_.find(deviceId);
+  if (it == gamepadStates_.end()) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  const uint32_t report = it->second->setAxis(controlId, value, gamepadInputConfig_, now);
+  if (!gamepadInputConfig_.axisEvents || report == 0u) {
+    return;
+  }
+  // A radial deadzone couples a stick's axes, so one raw update can report both of them.
+  const GamepadState& state = it->second->current();
+  for (uint32_t axisId = 0; axisId < GamepadAxisCount; ++axisId) {
+    if ((report & (1u << axisId)) == 0u) {
+      continue;
+    }
+    GamepadAxisEvent axis{};
+    axis.deviceId = deviceId;
+    axis.controlId = axisId;
+    axis.value = state.axes[axisId];
 
-  Event event{};
-  event.scope = Event::Scope::Global;
-  event.time = std::chrono::steady_clock::now();
-  event.payload = axis;
-  enqueueEvent(std::move(event));
+    Event event{};
+    event.scope = Event::Scope::Global;
+    event.time = now;
+    event.payload = axis;
+    enqueueEvent(std::move(event));
+  }
   if (focusedSurface_) {
     requestFrameForSurface(findSurface(focusedSurface_->value));
   }
@@ -4682,8 +5292,7 @@ void HostMac::handleWindowClosed(uint64_t surfaceId) {
   evt.payload = LifecycleEvent{LifecyclePhase::Destroyed};
   enqueueEvent(std::move(evt));
 
-  auto it = surfaces_.find(surfaceId);
-  if (it != surfaces_.end()) {
+  if (SurfaceState* surface = findSurface(surfaceId)) {
     if (focusedSurface_ && focusedSurface_->value == surfaceId) {
       focusedSurface_.reset();
     }
@@ -4691,12 +5300,15 @@ void HostMac::handleWindowClosed(uint64_t surfaceId) {
       releaseRelativePointer();
     }
 #if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
-    if (it->second->viewDisplayLink) {
-      [it->second->viewDisplayLink invalidate];
-      it->second->viewDisplayLink = nil;
+    if (surface->viewDisplayLink) {
+      [surface->viewDisplayLink invalidate];
+      surface->viewDisplayLink = nil;
     }
 #endif
-    surfaces_.erase(it);
+    forgetFrameSchedule(surfaceId);
+    surface->frameSlots->close();
+    std::unique_lock<std::shared_mutex> lock(surfacesMutex_);
+    surfaces_.erase(surfaceId);
   }
   updateDisplayLinkState();
 }
@@ -4731,38 +5343,30 @@ HostStatus HostMac::presentEmptyFrame(SurfaceState& surface) {
   return {};
 }
 
-HostResult<EventBatch> HostMac::buildBatch(std::span<const QueuedEvent> events, const EventBuffer& buffer) {
-  size_t count = std::min(buffer.events.size(), events.size());
-  TextBufferWriter writer{buffer.textBytes, 0u};
-  auto needsTextPayload = [](const auto& payload) {
-    if (auto* input = std::get_if<InputEvent>(&payload)) {
-      return std::get_if<TextEvent>(input) != nullptr;
-    }
-    return std::holds_alternative<DropEvent>(payload);
-  };
-  for (size_t i = 0; i < count; ++i) {
-    Event out = events[i].event;
-    if (!events[i].text.empty() || needsTextPayload(out.payload)) {
-      auto span = writer.append(events[i].text);
-      if (!span) {
-        return std::unexpected(span.error());
-      }
-      if (auto* input = std::get_if<InputEvent>(&out.payload)) {
-        if (auto* text = std::get_if<TextEvent>(input)) {
-          text->text = span.value();
-        }
-      } else if (auto* drop = std::get_if<DropEvent>(&out.payload)) {
-        drop->paths = span.value();
-      }
-    }
-    buffer.events[i] = out;
+void HostMac::publishRenderParams(SurfaceState& surface) {
+  SurfaceRenderParams params{};
+  if (surface.headless) {
+    params.widthPx = surface.headlessSize.width;
+    params.heightPx = surface.headlessSize.height;
+  } else if (surface.window && surface.window.contentView) {
+    NSRect bounds = surface.window.contentView.bounds;
+    const CGFloat scale = surface.window.backingScaleFactor;
+    params.scale = static_cast<float>(scale);
+    params.widthPx = static_cast<uint32_t>(std::lround(bounds.size.width * scale));
+    params.heightPx = static_cast<uint32_t>(std::lround(bounds.size.height * scale));
   }
-
-  EventBatch batch{
-      std::span<const Event>(buffer.events.data(), count),
-      std::span<const char>(buffer.textBytes.data(), writer.offset),
-  };
-  return batch;
+  params.colorFormat = surface.frameConfig.colorFormat;
+  params.bufferCount = surface.frameConfig.bufferCount;
+  if (auto caps = surfaceCapabilities(surface.surfaceId)) {
+    params.bufferCount = effectiveBufferCount(surface.frameConfig, caps.value());
+  }
+  if (params.bufferCount == 0u) {
+    params.bufferCount = 2u;
+  }
+  params.maxFrameLatency = std::clamp(surface.frameConfig.maxFrameLatency, 1u, params.bufferCount);
+  params.mailbox = surface.frameConfig.presentMode != PresentMode::LowLatency;
+  params.bufferPolicy = surface.frameConfig.bufferPolicy;
+  surface.renderParams.publish(params);
 }
 
 void HostMac::requestFrameForSurface(SurfaceState* surface) {
@@ -4777,27 +5381,16 @@ void HostMac::requestFrameForSurface(SurfaceState* surface) {
   requestFrame(surface->surfaceId, bypassCap);
 }
 
-void HostMac::enqueueEvent(Event event, std::string text) {
-  QueuedEvent queued{std::move(event), std::move(text)};
+void HostMac::enqueueEvent(Event event) {
   if (callbacks_.onEvents) {
-    callbackEvents_.clear();
-    callbackText_.clear();
-    callbackEvents_.resize(1);
-    EventBuffer buffer{
-        std::span<Event>(callbackEvents_.data(), callbackEvents_.size()),
-        std::span<char>(),
-    };
-    if (!queued.text.empty()) {
-      callbackText_.resize(queued.text.size());
-      buffer.textBytes = std::span<char>(callbackText_.data(), callbackText_.size());
-    }
-    auto batch = buildBatch(std::span<const QueuedEvent>(&queued, 1), buffer);
-    if (batch) {
-      callbacks_.onEvents(*batch);
+    callbacks_.onEvents(EventBatch{std::span<const Event>(&event, 1), textArena_.bytes()});
+    // With callbacks installed nothing stays queued, so the arena only held this event's text.
+    if (eventQueue_.empty()) {
+      textArena_.reset();
     }
     return;
   }
-  eventQueue_.push_back(std::move(queued));
+  eventQueue_.push_back(std::move(event));
 }
 
 NSCursor* HostMac::cursorForShape(CursorShape shape) const {
@@ -4887,33 +5480,25 @@ void HostMac::pumpEvents(bool wait) {
 }
 
 SurfaceState* HostMac::findSurface(uint64_t surfaceId) {
-  auto it = surfaces_.find(surfaceId);
-  if (it == surfaces_.end()) {
-    return nullptr;
-  }
-  return it->second.get();
+  return surfaces_.find(surfaceId);
 }
 
 const SurfaceState* HostMac::findSurface(uint64_t surfaceId) const {
-  auto it = surfaces_.find(surfaceId);
-  if (it == surfaces_.end()) {
-    return nullptr;
-  }
-  return it->second.get();
+  return surfaces_.find(surfaceId);
 }
 
 void HostMac::updateDisplayLinkState() {
   bool shouldRunCv = false;
   for (const auto& entry : surfaces_) {
-    if (!entry.second) {
+    if (!entry.value) {
       continue;
     }
     const bool wantsContinuous =
-        entry.second->frameConfig.framePolicy == FramePolicy::Continuous &&
-        entry.second->frameConfig.framePacingSource == FramePacingSource::Platform;
+        entry.value->frameConfig.framePolicy == FramePolicy::Continuous &&
+        entry.value->frameConfig.framePacingSource == FramePacingSource::Platform;
 #if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
-    if (entry.second->viewDisplayLink) {
-      entry.second->viewDisplayLink.paused = !wantsContinuous;
+    if (entry.value->viewDisplayLink) {
+      entry.value->viewDisplayLink.paused = !wantsContinuous;
       continue;
     }
 #endif
@@ -4922,6 +5507,7 @@ void HostMac::updateDisplayLinkState() {
     }
   }
 
+  updateFrameSchedule();
   if (!cvDisplayLink_) {
     return;
   }
@@ -4933,23 +5519,40 @@ void HostMac::updateDisplayLinkState() {
     CVDisplayLinkStop(cvDisplayLink_);
   }
 #pragma clang diagnostic pop
-
-  updateHostLimiterState();
 }
 
 void HostMac::handleDisplayLinkTick() {
-  for (auto& entry : surfaces_) {
-    if (entry.second &&
-        entry.second->frameConfig.framePolicy == FramePolicy::Continuous &&
-        entry.second->frameConfig.framePacingSource == FramePacingSource::Platform) {
-#if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
-      if (entry.second->viewDisplayLink) {
-        continue;
-      }
-#endif
-      requestFrame(entry.second->surfaceId, false);
+  const auto now = std::chrono::steady_clock::now();
+  const auto tolerance = displayTickTolerance();
+  std::array<uint64_t, 16> due{};
+  size_t count = 0u;
+  do {
+    count = displayScheduler_.collectDue(now, tolerance, due);
+    for (size_t i = 0; i < count; ++i) {
+      requestFrame(SurfaceId{due[i]}, false);
     }
+  } while (count == due.size());
+  publishDisplayWake();
+}
+
+bool HostMac::displayTickDue() const {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() >=
+         displayWakeNs_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds HostMac::displayTickTolerance() const {
+  return displayInterval_.value_or(std::chrono::nanoseconds(16'666'667)) / 2;
+}
+
+void HostMac::publishDisplayWake() {
+  auto wake = displayScheduler_.nextWake();
+  int64_t wakeNs = INT64_MAX;
+  if (wake) {
+    wakeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wake->time_since_epoch() - displayTickTolerance())
+                 .count();
   }
+  displayWakeNs_.store(wakeNs, std::memory_order_relaxed);
 }
 
 void HostMac::handleDisplayLinkTick(uint64_t surfaceId, CADisplayLink* link) {
@@ -4971,58 +5574,106 @@ void HostMac::handleDisplayLinkTick(uint64_t surfaceId, CADisplayLink* link) {
 }
 
 void HostMac::handleHostLimiterTick() {
-  for (auto& entry : surfaces_) {
-    if (!entry.second) {
-      continue;
-    }
-    if (entry.second->frameConfig.framePolicy != FramePolicy::Continuous) {
-      continue;
-    }
-    if (entry.second->frameConfig.framePacingSource != FramePacingSource::HostLimiter) {
-      continue;
+  // Surfaces due within half a millisecond share this wake instead of arming another timer.
+  const auto now = std::chrono::steady_clock::now();
+  std::array<uint64_t, 16> due{};
+  size_t count = 0u;
+  do {
+    count = limiterScheduler_.collectDue(now, std::chrono::microseconds(500), due);
+    for (size_t i = 0; i < count; ++i) {
+      requestFrame(SurfaceId{due[i]}, false);
     }
-    requestFrame(entry.second->surfaceId, false);
+  } while (count == due.size());
+  armHostLimiter();
+}
+
+FramePriority HostMac::framePriorityFor(const SurfaceState& surface) const {
+  if (focusedSurface_ && focusedSurface_->value == surface.surfaceId.value) {
+    return FramePriority::Focused;
+  }
+  if (surface.headless) {
+    return FramePriority::Visible;
+  }
+  if (!surface.window || surface.window.miniaturized || !surface.window.visible || NSApp.hidden) {
+    return FramePriority::Background;
   }
+  return FramePriority::Visible;
 }
 
-void HostMac::updateHostLimiterState() {
-  std::optional<std::chrono::nanoseconds> interval;
+void HostMac::scheduleSurface(FrameScheduler& scheduler,
+                              const SurfaceState& surface,
+                              std::chrono::nanoseconds interval,
+                              std::chrono::steady_clock::time_point now) {
+  const uint64_t surfaceId = surface.surfaceId.value;
+  scheduler.setSurface(surfaceId, interval, now);
+  scheduler.setPriority(surfaceId, framePriorityFor(surface));
+  const bool occluded = !surface.headless && surface.window &&
+                        (surface.window.occlusionState & NSWindowOcclusionStateVisible) == 0;
+  scheduler.setOccluded(surfaceId, occluded);
+}
+
+// Re-reads pacing, focus and visibility for every surface. Each continuous surface lives in the
+// scheduler for its pacing source with its own interval, so a 30 Hz preview no longer wakes the
+// loop at the main view's rate.
+void HostMac::updateFrameSchedule() {
+  const auto now = std::chrono::steady_clock::now();
   for (const auto& entry : surfaces_) {
-    const auto* surface = entry.second.get();
+    const SurfaceState* surface = entry.value.get();
     if (!surface) {
       continue;
     }
-    if (surface->frameConfig.framePolicy != FramePolicy::Continuous) {
-      continue;
-    }
-    if (surface->frameConfig.framePacingSource != FramePacingSource::HostLimiter) {
-      continue;
-    }
-    std::optional<std::chrono::nanoseconds> candidate = surface->frameConfig.frameInterval;
-    if (!candidate || candidate->count() <= 0) {
-      candidate = surface->displayInterval;
+    const bool continuous = surface->frameConfig.framePolicy == FramePolicy::Continuous;
+    const FramePacingSource source = surface->frameConfig.framePacingSource;
+    std::optional<std::chrono::nanoseconds> configured = surface->frameConfig.frameInterval;
+    if (configured && configured->count() <= 0) {
+      configured.reset();
     }
-    if ((!candidate || candidate->count() <= 0) && displayInterval_) {
-      candidate = displayInterval_;
-    }
-    if (!candidate || candidate->count() <= 0) {
-      candidate = std::chrono::nanoseconds(16'666'667);
+
+    bool displayPaced = continuous && source == FramePacingSource::Platform;
+#if defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 140000
+    // Surfaces with their own CADisplayLink are ticked by it directly.
+    displayPaced = displayPaced && !surface->viewDisplayLink;
+#endif
+    if (displayPaced) {
+      // Zero follows every vsync; an explicit interval skips ticks.
+      scheduleSurface(displayScheduler_, *surface, configured.value_or(std::chrono::nanoseconds(0)), now);
+    } else {
+      displayScheduler_.removeSurface(entry.handle);
     }
-    if (!interval || candidate.value() < interval.value()) {
-      interval = candidate;
+
+    if (continuous && source == FramePacingSource::HostLimiter) {
+      std::optional<std::chrono::nanoseconds> interval = configured;
+      if (!interval && surface->displayInterval && surface->displayInterval->count() > 0) {
+        interval = surface->displayInterval;
+      }
+      if (!interval && displayInterval_ && displayInterval_->count() > 0) {
+        interval = displayInterval_;
+      }
+      scheduleSurface(limiterScheduler_, *surface, interval.value_or(std::chrono::nanoseconds(16'666'667)), now);
+    } else {
+      limiterScheduler_.removeSurface(entry.handle);
     }
   }
+  publishDisplayWake();
+  armHostLimiter();
+}
 
-  if (!interval) {
+void HostMac::forgetFrameSchedule(uint64_t surfaceId) {
+  displayScheduler_.removeSurface(surfaceId);
+  limiterScheduler_.removeSurface(surfaceId);
+}
+
+// One-shot timer for the earliest host-limiter deadline; nothing is armed while no surface needs it.
+void HostMac::armHostLimiter() {
+  auto wake = limiterScheduler_.nextWake();
+  if (!wake) {
     if (hostLimiterTimer_) {
       dispatch_source_cancel(hostLimiterTimer_);
       hostLimiterTimer_ = nil;
     }
-    hostLimiterInterval_ = std::chrono::nanoseconds(0);
     return;
   }
 
-  const uint64_t nanos = static_cast<uint64_t>(std::max<int64_t>(interval->count(), 1));
   if (!hostLimiterTimer_) {
     hostLimiterTimer_ =
         dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
@@ -5033,14 +5684,10 @@ void HostMac::updateHostLimiterState() {
     dispatch_resume(hostLimiterTimer_);
   }
 
-  if (hostLimiterInterval_ != *interval) {
-    const uint64_t leeway = nanos / 10;
-    dispatch_source_set_timer(hostLimiterTimer_,
-                              dispatch_time(DISPATCH_TIME_NOW, 0),
-                              nanos,
-                              leeway);
-    hostLimiterInterval_ = *interval;
-  }
+  const auto delay = std::max(*wake - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+  const int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+  const uint64_t leeway = static_cast<uint64_t>(std::min<int64_t>(nanos / 10, 500'000));
+  dispatch_source_set_timer(hostLimiterTimer_, dispatch_time(DISPATCH_TIME_NOW, nanos), DISPATCH_TIME_FOREVER, leeway);
 }
 
 HostResult<std::unique_ptr<Host>> createHostMac() {
@@ -0,0 +1,729 @@
+#include "platform/null/AudioNull.h"
+
+#include "PrimeHost/AudioConfigDefaults.h"
+#include "PrimeHost/AudioConfigValidation.h"
+#include "AudioMixKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace PrimeHost {
+
+AudioHostNull::AudioHostNull(const AudioNullConfig& config) : config_(config) {
+  devices_.push_back(NullDevice{DeviceId, "Null Output"});
+  inputs_.push_back(NullInput{LoopbackDeviceId, "Null Loopback", true, {}});
+}
+
+AudioHostNull::~AudioHostNull() {
+  closeCaptureStream();
+  closeStream();
+}
+
+HostResult<size_t> AudioHostNull::outputDevices(std::span<AudioDeviceInfo> outDevices) const {
+  if (outDevices.empty()) {
+    return devices_.size();
+  }
+  if (outDevices.size() < devices_.size()) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+  size_t count = 0u;
+  for (const NullDevice& device : devices_) {
+    outDevices[count++] = makeInfo(device);
+  }
+  return count;
+}
+
+HostResult<AudioDeviceInfo> AudioHostNull::outputDeviceInfo(AudioDeviceId deviceId) const {
+  const NullDevice* device = findDevice(deviceId);
+  if (!device) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  return makeInfo(*device);
+}
+
+HostResult<AudioDeviceId> AudioHostNull::defaultOutputDevice() const {
+  if (defaultDevice_ == 0) {
+    return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+  }
+  return defaultDevice_;
+}
+
+HostStatus AudioHostNull::openStream(AudioDeviceId deviceId,
+                                     const AudioStreamConfig& config,
+                                     AudioCallback callback,
+                                     void* userData) {
+  if (!findDevice(deviceId)) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  if (!callback) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+  auto validation = validateAudioStreamConfig(resolved);
+  if (!validation) {
+    return validation;
+  }
+
+  closeStream();
+
+  const uint32_t maxFrames = std::max(resolved.bufferFrames, resolved.periodFrames);
+  for (Lane& lane : lanes_) {
+    lane.output.assign(static_cast<size_t>(maxFrames) * resolved.format.channels, 0.0f);
+    lane.device = 0;
+  }
+  lanes_[0].device = deviceId;
+  mixer_.prepare(resolved.format.channels, maxFrames, resolved.format.sampleRate);
+  const auto crossfadeFrames = static_cast<uint32_t>(
+      std::chrono::duration<double>(resolved.crossfadeDuration).count() * resolved.format.sampleRate);
+  switcher_.prepare(resolved.format.channels, maxFrames, crossfadeFrames, &AudioHostNull::renderSource, this);
+
+  activeConfig_ = resolved;
+  callback_ = callback;
+  userData_ = userData;
+  open_ = true;
+  return {};
+}
+
+HostStatus AudioHostNull::startStream() {
+  if (!open_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (running_.load()) {
+    return {};
+  }
+  running_.store(true);
+  startLane(switcher_.currentLane());
+  return {};
+}
+
+HostStatus AudioHostNull::stopStream() {
+  if (!open_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  running_.store(false);
+  stopLane(0u);
+  stopLane(1u);
+  if (auto settled = switcher_.settle()) {
+    finishSwitch(*settled);
+  }
+  return {};
+}
+
+HostStatus AudioHostNull::closeStream() {
+  if (!open_) {
+    return {};
+  }
+  stopStream();
+  if (duplexInput_.source && duplexInput_.source->loopback) {
+    disableLoopback();
+  }
+  duplexCallback_ = nullptr;
+  duplexUserData_ = nullptr;
+  duplexInput_ = {};
+  duplexBuffer_.clear();
+  switcher_.release();
+  mixer_.release();
+  for (Lane& lane : lanes_) {
+    lane.output.clear();
+    lane.device = 0;
+  }
+  callback_ = nullptr;
+  userData_ = nullptr;
+  open_ = false;
+  return {};
+}
+
+HostResult<AudioStreamConfig> AudioHostNull::activeConfig() const {
+  if (!open_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return activeConfig_;
+}
+
+HostResult<size_t> AudioHostNull::inputDevices(std::span<AudioDeviceInfo> outDevices) const {
+  if (outDevices.empty()) {
+    return inputs_.size();
+  }
+  if (outDevices.size() < inputs_.size()) {
+    return std::unexpected(HostError{HostErrorCode::BufferTooSmall});
+  }
+  size_t count = 0u;
+  for (const NullInput& input : inputs_) {
+    outDevices[count++] = makeInputInfo(input);
+  }
+  return count;
+}
+
+HostResult<AudioDeviceInfo> AudioHostNull::inputDeviceInfo(AudioDeviceId deviceId) const {
+  const NullInput* input = findInput(deviceId);
+  if (!input) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  return makeInputInfo(*input);
+}
+
+HostResult<AudioDeviceId> AudioHostNull::defaultInputDevice() const {
+  return LoopbackDeviceId;
+}
+
+HostStatus AudioHostNull::openCaptureStream(AudioDeviceId deviceId,
+                                            const AudioStreamConfig& config,
+                                            AudioCaptureCallback callback,
+                                            void* userData) {
+  const NullInput* input = findInput(deviceId);
+  if (!input) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  if (!callback) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+  auto validation = validateAudioStreamConfig(resolved);
+  if (!validation) {
+    return validation;
+  }
+  auto format = checkInputFormat(*input, resolved.format);
+  if (!format) {
+    return format;
+  }
+  if (input->loopback && duplexInput_.source && duplexInput_.source->loopback) {
+    return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+  }
+
+  closeCaptureStream();
+
+  const uint32_t maxFrames = std::max(resolved.bufferFrames, resolved.periodFrames);
+  captureBuffer_.assign(static_cast<size_t>(maxFrames) * resolved.format.channels, 0.0f);
+  if (input->loopback) {
+    enableLoopback(maxFrames);
+  }
+  captureConfig_ = resolved;
+  captureCallback_ = callback;
+  captureUserData_ = userData;
+  captureInput_ = InputCursor{input, 0u};
+  captureFrameIndex_ = 0u;
+  captureOpen_ = true;
+  return {};
+}
+
+HostStatus AudioHostNull::startCaptureStream() {
+  if (!captureOpen_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  if (captureRunning_.load()) {
+    return {};
+  }
+  captureRunning_.store(true);
+  if (config_.realtime) {
+    captureClock_ = std::thread([this]() { runCaptureClock(); });
+  }
+  return {};
+}
+
+HostStatus AudioHostNull::stopCaptureStream() {
+  if (!captureOpen_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  captureRunning_.store(false);
+  if (captureClock_.joinable()) {
+    captureClock_.join();
+  }
+  return {};
+}
+
+HostStatus AudioHostNull::closeCaptureStream() {
+  if (!captureOpen_) {
+    return {};
+  }
+  stopCaptureStream();
+  if (captureInput_.source && captureInput_.source->loopback) {
+    disableLoopback();
+  }
+  captureCallback_ = nullptr;
+  captureUserData_ = nullptr;
+  captureInput_ = {};
+  captureBuffer_.clear();
+  captureOpen_ = false;
+  return {};
+}
+
+HostResult<AudioStreamConfig> AudioHostNull::activeCaptureConfig() const {
+  if (!captureOpen_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return captureConfig_;
+}
+
+HostStatus AudioHostNull::openDuplexStream(AudioDeviceId inputDeviceId,
+                                           AudioDeviceId outputDeviceId,
+                                           const AudioStreamConfig& config,
+                                           AudioDuplexCallback callback,
+                                           void* userData) {
+  const NullInput* input = findInput(inputDeviceId);
+  if (!input) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  if (!callback) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  AudioStreamConfig resolved = resolveAudioStreamConfig(config);
+  if (input->loopback && captureOpen_ && captureInput_.source == input) {
+    return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+  }
+  if (!input->loopback) {
+    auto format = checkInputFormat(*input, resolved.format);
+    if (!format) {
+      return format;
+    }
+  }
+  auto opened = openStream(outputDeviceId, config, &AudioHostNull::renderDuplex, this);
+  if (!opened) {
+    return opened;
+  }
+  const uint32_t maxFrames = std::max(activeConfig_.bufferFrames, activeConfig_.periodFrames);
+  duplexBuffer_.assign(static_cast<size_t>(maxFrames) * activeConfig_.format.channels, 0.0f);
+  duplexInput_ = InputCursor{input, 0u};
+  duplexCallback_ = callback;
+  duplexUserData_ = userData;
+  if (input->loopback) {
+    enableLoopback(maxFrames);
+  }
+  return {};
+}
+
+HostResult<AudioMixStreamId> AudioHostNull::addMixStream(const AudioMixStreamConfig& config,
+                                                         AudioCallback callback,
+                                                         void* userData) {
+  return mixer_.addStream(config, callback, userData);
+}
+
+HostStatus AudioHostNull::removeMixStream(AudioMixStreamId streamId) {
+  return mixer_.removeStream(streamId);
+}
+
+HostStatus AudioHostNull::setMixStreamGain(AudioMixStreamId streamId, float gain) {
+  return mixer_.setStreamGain(streamId, gain);
+}
+
+HostResult<AudioMixStreamStats> AudioHostNull::mixStreamStats(AudioMixStreamId streamId) const {
+  return mixer_.streamStats(streamId);
+}
+
+HostStatus AudioHostNull::setCallbacks(AudioCallbacks callbacks) {
+  callbacks_ = std::move(callbacks);
+  return {};
+}
+
+HostResult<AudioDeviceId> AudioHostNull::addVirtualDevice(Utf8TextView name) {
+  const AudioDeviceId deviceId = nextDeviceId_++;
+  devices_.push_back(NullDevice{deviceId, std::string(name)});
+  const bool becameDefault = defaultDevice_ == 0;
+  if (becameDefault) {
+    defaultDevice_ = deviceId;
+  }
+  emitDeviceEvent(deviceId, true, becameDefault);
+  if (becameDefault) {
+    followDefault(false);
+  }
+  return deviceId;
+}
+
+HostStatus AudioHostNull::removeVirtualDevice(AudioDeviceId deviceId) {
+  auto it = std::find_if(devices_.begin(), devices_.end(), [&](const NullDevice& device) {
+    return device.id == deviceId;
+  });
+  if (it == devices_.end()) {
+    auto input = std::find_if(inputs_.begin(), inputs_.end(), [&](const NullInput& device) {
+      return device.id == deviceId && !device.loopback;
+    });
+    if (input == inputs_.end()) {
+      return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+    }
+    if (captureInput_.source == &*input || duplexInput_.source == &*input) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+    }
+    inputs_.erase(input);
+    emitDeviceEvent(deviceId, false, false, true);
+    return {};
+  }
+  devices_.erase(it);
+  emitDeviceEvent(deviceId, false, false);
+  if (defaultDevice_ == deviceId) {
+    defaultDevice_ = devices_.empty() ? 0 : devices_.front().id;
+    if (defaultDevice_ != 0) {
+      emitDeviceEvent(defaultDevice_, true, true);
+    }
+  }
+  const bool activeLost = open_ && lanes_[switcher_.currentLane()].device == deviceId;
+  followDefault(activeLost);
+  return {};
+}
+
+HostStatus AudioHostNull::setDefaultDevice(AudioDeviceId deviceId) {
+  if (!findDevice(deviceId)) {
+    return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+  }
+  if (defaultDevice_ == deviceId) {
+    return {};
+  }
+  defaultDevice_ = deviceId;
+  emitDeviceEvent(deviceId, true, true);
+  followDefault(false);
+  return {};
+}
+
+HostResult<AudioDeviceId> AudioHostNull::addFileInputDevice(const std::filesystem::path& path) {
+  auto audio = readWavFile(path);
+  if (!audio) {
+    return std::unexpected(audio.error());
+  }
+  const AudioDeviceId deviceId = nextDeviceId_++;
+  inputs_.push_back(NullInput{deviceId, path.filename().string(), false, std::move(audio.value())});
+  emitDeviceEvent(deviceId, true, false, true);
+  return deviceId;
+}
+
+HostResult<AudioDeviceId> AudioHostNull::activeDevice() const {
+  if (!open_) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return lanes_[switcher_.currentLane()].device;
+}
+
+bool AudioHostNull::pollDeviceSwitch() {
+  auto result = switcher_.takeCompletedSwitch();
+  if (!result) {
+    return false;
+  }
+  finishSwitch(*result);
+  return true;
+}
+
+HostResult<std::span<const float>> AudioHostNull::renderFrames(uint32_t frames) {
+  if (config_.realtime) {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+  if (!open_ || !running_.load()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  return renderLane(switcher_.currentLane(), frames);
+}
+
+HostResult<std::span<const float>> AudioHostNull::renderCaptureFrames(uint32_t frames) {
+  if (config_.realtime) {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+  if (!captureOpen_ || !captureRunning_.load()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  const uint32_t channels = captureConfig_.format.channels;
+  frames = std::min<uint32_t>(frames, static_cast<uint32_t>(captureBuffer_.size() / channels));
+  std::span<float> out(captureBuffer_.data(), static_cast<size_t>(frames) * channels);
+  renderCapture(out, frames);
+  return std::span<const float>(out.data(), out.size());
+}
+
+HostResult<std::span<const float>> AudioHostNull::renderDeviceFrames(AudioDeviceId deviceId, uint32_t frames) {
+  if (config_.realtime) {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+  if (!open_ || !running_.load()) {
+    return std::unexpected(HostError{HostErrorCode::InvalidConfig});
+  }
+  for (uint32_t lane = 0; lane < lanes_.size(); ++lane) {
+    if (lanes_[lane].device == deviceId && lanes_[lane].running.load()) {
+      return renderLane(lane, frames);
+    }
+  }
+  return std::unexpected(HostError{HostErrorCode::InvalidDevice});
+}
+
+void AudioHostNull::renderSource(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+  auto* self = static_cast<AudioHostNull*>(userData);
+  self->callback_(interleaved, ctx, self->userData_);
+  self->mixer_.render(interleaved, ctx);
+}
+
+void AudioHostNull::renderDuplex(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+  auto* self = static_cast<AudioHostNull*>(userData);
+  const uint32_t channels = self->activeConfig_.format.channels;
+  std::span<float> input(self->duplexBuffer_.data(), interleaved.size());
+  AudioDuplexContext duplex{};
+  duplex.output = ctx;
+  duplex.inputTime = ctx.time;
+  if (self->duplexInput_.source->loopback && self->activeConfig_.format.sampleRate > 0u) {
+    // Loopback input was rendered by earlier callbacks; date it by how much is still queued.
+    const double queuedFrames = static_cast<double>(self->loopback_.size()) / std::max(1u, self->loopbackChannels_);
+    duplex.inputTime -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(queuedFrames / self->activeConfig_.format.sampleRate));
+  }
+  duplex.inputUnderrun = !self->pullInput(self->duplexInput_, input, channels);
+  self->duplexCallback_(input, interleaved, duplex, self->duplexUserData_);
+}
+
+const AudioHostNull::NullDevice* AudioHostNull::findDevice(AudioDeviceId deviceId) const {
+  for (const NullDevice& device : devices_) {
+    if (device.id == deviceId) {
+      return &device;
+    }
+  }
+  return nullptr;
+}
+
+AudioDeviceInfo AudioHostNull::makeInfo(const NullDevice& device) const {
+  AudioDeviceInfo info{};
+  info.id = device.id;
+  info.name = device.name;
+  info.isDefault = device.id == defaultDevice_;
+  info.preferredFormat = config_.deviceFormat;
+  return info;
+}
+
+const AudioHostNull::NullInput* AudioHostNull::findInput(AudioDeviceId deviceId) const {
+  for (const NullInput& input : inputs_) {
+    if (input.id == deviceId) {
+      return &input;
+    }
+  }
+  return nullptr;
+}
+
+AudioDeviceInfo AudioHostNull::makeInputInfo(const NullInput& input) const {
+  AudioDeviceInfo info{};
+  info.id = input.id;
+  info.name = input.name;
+  info.isDefault = input.id == LoopbackDeviceId;
+  if (input.loopback) {
+    info.preferredFormat = open_ ? activeConfig_.format : config_.deviceFormat;
+  } else {
+    info.preferredFormat.sampleRate = input.audio.sampleRate;
+    info.preferredFormat.channels = input.audio.channels;
+  }
+  return info;
+}
+
+HostStatus AudioHostNull::checkInputFormat(const NullInput& input, const AudioFormat& format) const {
+  if (input.loopback) {
+    // The loopback taps the output stream, so it can only be captured at the output's rate.
+    if (!open_) {
+      return std::unexpected(HostError{HostErrorCode::DeviceUnavailable});
+    }
+    if (format.sampleRate != activeConfig_.format.sampleRate) {
+      return std::unexpected(HostError{HostErrorCode::Unsupported});
+    }
+    return {};
+  }
+  if (format.sampleRate != input.audio.sampleRate) {
+    return std::unexpected(HostError{HostErrorCode::Unsupported});
+  }
+  return {};
+}
+
+void AudioHostNull::emitDeviceEvent(AudioDeviceId deviceId, bool connected, bool isDefault, bool isInput) const {
+  if (!callbacks_.onDeviceEvent) {
+    return;
+  }
+  AudioDeviceEvent event{};
+  event.deviceId = deviceId;
+  event.connected = connected;
+  event.isDefault = isDefault;
+  event.isInput = isInput;
+  callbacks_.onDeviceEvent(event);
+}
+
+void AudioHostNull::followDefault(bool activeLost) {
+  if (!open_ || !activeConfig_.followDefaultDevice || defaultDevice_ == 0) {
+    return;
+  }
+  const uint32_t current = switcher_.currentLane();
+  if (switcher_.switchPending()) {
+    // Re-evaluated in finishSwitch() once the in-flight switch completes.
+    if (activeLost) {
+      stopLane(current);
+      switcher_.outgoingLost();
+    }
+    return;
+  }
+  const AudioDeviceId from = lanes_[current].device;
+  if (from == defaultDevice_) {
+    return;
+  }
+  if (!running_.load()) {
+    // Nothing is playing, so there is nothing to crossfade; rebind the stream directly.
+    lanes_[current].device = defaultDevice_;
+    if (callbacks_.onDeviceSwitch) {
+      AudioDeviceSwitchEvent event{};
+      event.fromDevice = from;
+      event.toDevice = defaultDevice_;
+      callbacks_.onDeviceSwitch(event);
+    }
+    return;
+  }
+
+  const uint32_t incoming = switcher_.incomingLane();
+  lanes_[incoming].device = defaultDevice_;
+  if (activeLost) {
+    stopLane(current);
+  }
+  switcher_.beginSwitch(std::chrono::steady_clock::now());
+  if (activeLost) {
+    switcher_.outgoingLost();
+  }
+  startLane(incoming);
+}
+
+void AudioHostNull::finishSwitch(const AudioDeviceSwitcher::SwitchResult& result) {
+  const uint32_t current = switcher_.currentLane();
+  const uint32_t outgoing = 1u - current;
+  const AudioDeviceId from = lanes_[outgoing].device;
+  stopLane(outgoing);
+  lanes_[outgoing].device = 0;
+  if (callbacks_.onDeviceSwitch) {
+    AudioDeviceSwitchEvent event{};
+    event.fromDevice = from;
+    event.toDevice = lanes_[current].device;
+    event.switchLatency = result.switchLatency;
+    event.completionTime = result.completionTime;
+    event.crossfadeFrames = result.crossfadeFrames;
+    event.crossfaded = result.crossfaded;
+    callbacks_.onDeviceSwitch(event);
+  }
+  const bool activeLost = !findDevice(lanes_[current].device);
+  followDefault(activeLost);
+}
+
+HostResult<std::span<const float>> AudioHostNull::renderLane(uint32_t lane, uint32_t frames) {
+  const uint32_t channels = activeConfig_.format.channels;
+  std::vector<float>& output = lanes_[lane].output;
+  frames = std::min<uint32_t>(frames, static_cast<uint32_t>(output.size() / channels));
+  std::span<float> out(output.data(), static_cast<size_t>(frames) * channels);
+  switcher_.render(lane, out);
+  feedLoopback(lane, out);
+  return std::span<const float>(out.data(), out.size());
+}
+
+void AudioHostNull::startLane(uint32_t lane) {
+  Lane& target = lanes_[lane];
+  if (target.running.load()) {
+    return;
+  }
+  target.running.store(true);
+  if (config_.realtime) {
+    target.clock = std::thread([this, lane]() { runClock(lane); });
+  }
+}
+
+void AudioHostNull::stopLane(uint32_t lane) {
+  Lane& target = lanes_[lane];
+  target.running.store(false);
+  if (target.clock.joinable()) {
+    target.clock.join();
+  }
+}
+
+void AudioHostNull::runClock(uint32_t lane) {
+  const uint32_t frames = activeConfig_.periodFrames;
+  const uint32_t channels = activeConfig_.format.channels;
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(frames) / activeConfig_.format.sampleRate));
+  std::span<float> out(lanes_[lane].output.data(), static_cast<size_t>(frames) * channels);
+  auto deadline = std::chrono::steady_clock::now();
+  while (lanes_[lane].running.load(std::memory_order_acquire)) {
+    switcher_.render(lane, out);
+    feedLoopback(lane, out);
+    deadline += period;
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+void AudioHostNull::enableLoopback(uint32_t maxFrames) {
+  disableLoopback();
+  loopbackChannels_ = activeConfig_.format.channels;
+  const size_t capacityFrames = static_cast<size_t>(maxFrames) * 8u + config_.loopbackLatencyFrames;
+  loopback_.reset(capacityFrames * loopbackChannels_);
+  loopbackScratch_.assign(static_cast<size_t>(maxFrames) * loopbackChannels_, 0.0f);
+  const std::vector<float> latency(static_cast<size_t>(config_.loopbackLatencyFrames) * loopbackChannels_, 0.0f);
+  loopback_.push(latency);
+  loopbackEnabled_.store(true);
+}
+
+void AudioHostNull::disableLoopback() {
+  loopbackEnabled_.store(false);
+  // A render thread may have seen the old flag; wait for it to leave the ring before it is reused.
+  while (loopbackWriters_.load() != 0u) {
+    std::this_thread::yield();
+  }
+}
+
+void AudioHostNull::feedLoopback(uint32_t lane, std::span<const float> interleaved) {
+  loopbackWriters_.fetch_add(1u);
+  if (loopbackEnabled_.load() && lane == switcher_.currentLane() &&
+      switcher_.phase() == AudioDeviceSwitcher::Phase::Idle &&
+      loopbackChannels_ == activeConfig_.format.channels) {
+    const size_t freeSamples = loopback_.capacity() - loopback_.size();
+    const size_t pushSamples = (std::min(freeSamples, interleaved.size()) / loopbackChannels_) * loopbackChannels_;
+    loopback_.push(interleaved.first(pushSamples));
+  }
+  loopbackWriters_.fetch_sub(1u);
+}
+
+bool AudioHostNull::pullInput(InputCursor& cursor, std::span<float> out, uint32_t channels) {
+  std::memset(out.data(), 0, out.size() * sizeof(float));
+  const size_t frames = out.size() / channels;
+  if (cursor.source->loopback) {
+    const size_t wanted = std::min(frames * loopbackChannels_, loopbackScratch_.size());
+    const size_t popped = loopback_.pop(std::span<float>(loopbackScratch_.data(), wanted));
+    const size_t poppedFrames = popped / std::max(1u, loopbackChannels_);
+    mixMapped(out.data(), channels, loopbackScratch_.data(), loopbackChannels_, poppedFrames, 1.0f, 1.0f);
+    return poppedFrames == frames;
+  }
+  const WavAudio& audio = cursor.source->audio;
+  const size_t fileFrames = audio.samples.size() / audio.channels;
+  if (fileFrames == 0u) {
+    return false;
+  }
+  size_t written = 0u;
+  while (written < frames) {
+    const size_t chunk = std::min(frames - written, fileFrames - cursor.frame);
+    mixMapped(out.data() + written * channels,
+              channels,
+              audio.samples.data() + cursor.frame * audio.channels,
+              audio.channels,
+              chunk,
+              1.0f,
+              1.0f);
+    written += chunk;
+    cursor.frame = (cursor.frame + chunk) % fileFrames;
+  }
+  return true;
+}
+
+void AudioHostNull::renderCapture(std::span<float> out, uint32_t frames) {
+  AudioCallbackContext ctx{};
+  ctx.frameIndex = captureFrameIndex_++;
+  ctx.time = std::chrono::steady_clock::now();
+  ctx.requestedFrames = frames;
+  ctx.isUnderrun = !pullInput(captureInput_, out, captureConfig_.format.channels);
+  captureCallback_(std::span<const float>(out.data(), out.size()), ctx, captureUserData_);
+}
+
+void AudioHostNull::runCaptureClock() {
+  const uint32_t frames = captureConfig_.periodFrames;
+  const uint32_t channels = captureConfig_.format.channels;
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(frames) / captureConfig_.format.sampleRate));
+  std::span<float> out(captureBuffer_.data(), static_cast<size_t>(frames) * channels);
+  auto deadline = std::chrono::steady_clock::now();
+  while (captureRunning_.load(std::memory_order_acquire)) {
+    renderCapture(out, frames);
+    deadline += period;
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+HostResult<std::unique_ptr<AudioHost>> createNullAudioHost() {
+  return std::make_unique<AudioHostNull>();
+}
+
+} // namespace PrimeHost
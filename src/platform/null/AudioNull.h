@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PrimeHost/Audio.h"
+#include "AudioDeviceSwitch.h"
+#include "AudioMixer.h"
+#include "SpscRing.h"
+#include "WavFileUtil.h"
+
+namespace PrimeHost {
+
+struct AudioNullConfig {
+  // When true, startStream() drives the callback from a thread paced at the period duration.
+  // When false, the caller pumps the stream with renderFrames().
+  bool realtime = true;
+  AudioFormat deviceFormat{};
+  // Frames of silence queued ahead of the loopback input, standing in for device latency.
+  uint32_t loopbackLatencyFrames = 0u;
+};
+
+// Portable backend with virtual devices. Used on platforms without a native backend and for
+// testing/benchmarking the render path. Starts with a single default output that discards its
+// output, and a loopback input that captures whatever the output stream renders. Tests can
+// hot-plug more outputs, move the default to exercise device switching, and add WAV-backed inputs.
+class AudioHostNull final : public AudioHost {
+public:
+  static constexpr AudioDeviceId DeviceId = 1u;
+  static constexpr AudioDeviceId LoopbackDeviceId = 2u;
+
+  explicit AudioHostNull(const AudioNullConfig& config = {});
+  ~AudioHostNull() override;
+
+  HostResult<size_t> outputDevices(std::span<AudioDeviceInfo> outDevices) const override;
+  HostResult<AudioDeviceInfo> outputDeviceInfo(AudioDeviceId deviceId) const override;
+  HostResult<AudioDeviceId> defaultOutputDevice() const override;
+
+  HostStatus openStream(AudioDeviceId deviceId,
+                        const AudioStreamConfig& config,
+                        AudioCallback callback,
+                        void* userData) override;
+  HostStatus startStream() override;
+  HostStatus stopStream() override;
+  HostStatus closeStream() override;
+
+  HostResult<AudioStreamConfig> activeConfig() const override;
+
+  HostResult<size_t> inputDevices(std::span<AudioDeviceInfo> outDevices) const override;
+  HostResult<AudioDeviceInfo> inputDeviceInfo(AudioDeviceId deviceId) const override;
+  HostResult<AudioDeviceId> defaultInputDevice() const override;
+
+  HostStatus openCaptureStream(AudioDeviceId deviceId,
+                               const AudioStreamConfig& config,
+                               AudioCaptureCallback callback,
+                               void* userData) override;
+  HostStatus startCaptureStream() override;
+  HostStatus stopCaptureStream() override;
+  HostStatus closeCaptureStream() override;
+  HostResult<AudioStreamConfig> activeCaptureConfig() const override;
+
+  HostStatus openDuplexStream(AudioDeviceId inputDeviceId,
+                              AudioDeviceId outputDeviceId,
+                              const AudioStreamConfig& config,
+                              AudioDuplexCallback callback,
+                              void* userData) override;
+
+  HostResult<AudioMixStreamId> addMixStream(const AudioMixStreamConfig& config,
+                                            AudioCallback callback,
+                                            void* userData) override;
+  HostStatus removeMixStream(AudioMixStreamId streamId) override;
+  HostStatus setMixStreamGain(AudioMixStreamId streamId, float gain) override;
+  HostResult<AudioMixStreamStats> mixStreamStats(AudioMixStreamId streamId) const override;
+
+  HostStatus setCallbacks(AudioCallbacks callbacks) override;
+
+  // Simulated hot-plug. Each change emits onDeviceEvent; streams opened with
+  // followDefaultDevice move to the new default through a crossfaded switch.
+  HostResult<AudioDeviceId> addVirtualDevice(Utf8TextView name);
+  HostStatus removeVirtualDevice(AudioDeviceId deviceId);
+  HostStatus setDefaultDevice(AudioDeviceId deviceId);
+  // Adds an input device that plays a WAV file (16-bit PCM or float32) on a loop. The file is
+  // decoded up front, so capture never touches the file system.
+  HostResult<AudioDeviceId> addFileInputDevice(const std::filesystem::path& path);
+
+  // The device the stream currently plays on (the incoming device once a switch completes).
+  HostResult<AudioDeviceId> activeDevice() const;
+
+  // Finishes a device switch whose handover has completed: stops the outgoing device and emits
+  // onDeviceSwitch. Returns true if a switch finished. Call from the control thread.
+  bool pollDeviceSwitch();
+
+  // Runs one device callback of `frames` frames on the calling thread and returns the rendered
+  // interleaved samples. Only available for non-realtime hosts with a started stream.
+  HostResult<std::span<const float>> renderFrames(uint32_t frames);
+  // Same as renderFrames() for a specific open device, so tests can interleave the outgoing and
+  // incoming devices of a switch.
+  HostResult<std::span<const float>> renderDeviceFrames(AudioDeviceId deviceId, uint32_t frames);
+  // Runs one capture callback of `frames` frames and returns the captured samples. Only available
+  // for non-realtime hosts with a started capture stream.
+  HostResult<std::span<const float>> renderCaptureFrames(uint32_t frames);
+
+private:
+  struct NullDevice {
+    AudioDeviceId id = 0;
+    std::string name;
+  };
+
+  struct NullInput {
+    AudioDeviceId id = 0;
+    std::string name;
+    bool loopback = false;
+    WavAudio audio;
+  };
+
+  struct InputCursor {
+    const NullInput* source = nullptr;
+    size_t frame = 0u;
+  };
+
+  struct Lane {
+    AudioDeviceId device = 0;
+    std::vector<float> output;
+    std::atomic<bool> running{false};
+    std::thread clock;
+  };
+
+  static void renderSource(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData);
+  static void renderDuplex(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData);
+
+  const NullDevice* findDevice(AudioDeviceId deviceId) const;
+  AudioDeviceInfo makeInfo(const NullDevice& device) const;
+  const NullInput* findInput(AudioDeviceId deviceId) const;
+  AudioDeviceInfo makeInputInfo(const NullInput& input) const;
+  HostStatus checkInputFormat(const NullInput& input, const AudioFormat& format) const;
+  void emitDeviceEvent(AudioDeviceId deviceId, bool connected, bool isDefault, bool isInput = false) const;
+  void followDefault(bool activeLost);
+  void finishSwitch(const AudioDeviceSwitcher::SwitchResult& result);
+  HostResult<std::span<const float>> renderLane(uint32_t lane, uint32_t frames);
+  void startLane(uint32_t lane);
+  void stopLane(uint32_t lane);
+  void runClock(uint32_t lane);
+
+  void enableLoopback(uint32_t maxFrames);
+  void disableLoopback();
+  void feedLoopback(uint32_t lane, std::span<const float> interleaved);
+  // Fills `out` from the input; returns false (with the gap zeroed) when the input ran dry.
+  bool pullInput(InputCursor& cursor, std::span<float> out, uint32_t channels);
+  void renderCapture(std::span<float> out, uint32_t frames);
+  void runCaptureClock();
+
+  AudioNullConfig config_{};
+  std::list<NullDevice> devices_;
+  AudioDeviceId defaultDevice_ = DeviceId;
+  AudioDeviceId nextDeviceId_ = LoopbackDeviceId + 1u;
+  AudioCallbacks callbacks_{};
+  AudioMixer mixer_;
+  AudioDeviceSwitcher switcher_;
+
+  bool open_ = false;
+  AudioStreamConfig activeConfig_{};
+  AudioCallback callback_ = nullptr;
+  void* userData_ = nullptr;
+  std::array<Lane, 2> lanes_;
+  AudioDuplexCallback duplexCallback_ = nullptr;
+  void* duplexUserData_ = nullptr;
+  InputCursor duplexInput_{};
+  std::vector<float> duplexBuffer_;
+
+  std::atomic<bool> running_{false};
+
+  std::list<NullInput> inputs_;
+  SpscRing<float> loopback_;
+  std::vector<float> loopbackScratch_;
+  uint32_t loopbackChannels_ = 0u;
+  std::atomic<bool> loopbackEnabled_{false};
+  std::atomic<uint32_t> loopbackWriters_{0u};
+
+  bool captureOpen_ = false;
+  AudioStreamConfig captureConfig_{};
+  AudioCaptureCallback captureCallback_ = nullptr;
+  void* captureUserData_ = nullptr;
+  InputCursor captureInput_{};
+  std::vector<float> captureBuffer_;
+  uint64_t captureFrameIndex_ = 0u;
+  std::atomic<bool> captureRunning_{false};
+  std::thread captureClock_;
+};
+
+} // namespace PrimeHost
@@ -0,0 +1,222 @@
+#include "PrimeHost/Audio.h"
+
+#include "src/platform/null/AudioNull.h"
+#include "src/WavFileUtil.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <filesystem>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+struct OutputState {
+  float value = 0.0f;
+};
+
+void fill_output(std::span<float> interleaved, const AudioCallbackContext&, void* userData) {
+  auto* state = static_cast<OutputState*>(userData);
+  for (float& sample : interleaved) {
+    sample = state->value;
+  }
+}
+
+struct CaptureState {
+  std::vector<float> samples;
+  uint32_t calls = 0u;
+  bool lastUnderrun = false;
+};
+
+void record_capture(std::span<const float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+  auto* state = static_cast<CaptureState*>(userData);
+  state->samples.assign(interleaved.begin(), interleaved.end());
+  state->lastUnderrun = ctx.isUnderrun;
+  ++state->calls;
+}
+
+struct DuplexState {
+  float offset = 0.0f;
+  bool lastUnderrun = false;
+  bool inputBeforeOutput = true;
+};
+
+void monitor(std::span<const float> input, std::span<float> output, const AudioDuplexContext& ctx, void* userData) {
+  auto* state = static_cast<DuplexState*>(userData);
+  for (size_t i = 0; i < output.size(); ++i) {
+    output[i] = input[i] + state->offset;
+  }
+  state->lastUnderrun = ctx.inputUnderrun;
+  state->inputBeforeOutput = state->inputBeforeOutput && ctx.inputTime <= ctx.output.time;
+}
+
+AudioStreamConfig stereo_config() {
+  AudioStreamConfig config{};
+  config.format.sampleRate = 48000;
+  config.format.channels = 2;
+  config.bufferFrames = 256;
+  config.periodFrames = 128;
+  return config;
+}
+
+std::filesystem::path write_ramp_wav(uint32_t sampleRate, uint32_t frames) {
+  WavAudio audio{};
+  audio.sampleRate = sampleRate;
+  audio.channels = 1u;
+  for (uint32_t i = 0; i < frames; ++i) {
+    audio.samples.push_back(static_cast<float>(i) / frames);
+  }
+  auto path = std::filesystem::temp_directory_path() / "primehost_capture_ramp.wav";
+  REQUIRE(writeWavFile(path, audio).has_value());
+  return path;
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.capture");
+
+PH_TEST("primehost.audio.capture", "input device enumeration") {
+  AudioHostNull audio;
+  auto count = audio.inputDevices({});
+  PH_REQUIRE(count.has_value());
+  PH_CHECK(count.value() == 1u);
+  auto device = audio.defaultInputDevice();
+  PH_REQUIRE(device.has_value());
+  PH_CHECK(device.value() == AudioHostNull::LoopbackDeviceId);
+  auto info = audio.inputDeviceInfo(device.value());
+  PH_REQUIRE(info.has_value());
+  PH_CHECK(info->isDefault);
+  PH_CHECK(!audio.inputDeviceInfo(AudioHostNull::DeviceId).has_value());
+  PH_CHECK(!audio.activeCaptureConfig().has_value());
+}
+
+PH_TEST("primehost.audio.capture", "loopback captures the output stream") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  nullConfig.loopbackLatencyFrames = 64u;
+  AudioHostNull audio(nullConfig);
+
+  CaptureState capture{};
+  auto early = audio.openCaptureStream(AudioHostNull::LoopbackDeviceId, stereo_config(), record_capture, &capture);
+  PH_CHECK(!early.has_value());
+  PH_CHECK(early.error().code == HostErrorCode::DeviceUnavailable);
+
+  OutputState output{0.25f};
+  PH_REQUIRE(audio.openStream(AudioHostNull::DeviceId, stereo_config(), fill_output, &output).has_value());
+  PH_REQUIRE(audio.openCaptureStream(AudioHostNull::LoopbackDeviceId, stereo_config(), record_capture, &capture)
+                 .has_value());
+  PH_REQUIRE(audio.startStream().has_value());
+  PH_CHECK(!audio.renderCaptureFrames(128u).has_value());
+  PH_REQUIRE(audio.startCaptureStream().has_value());
+
+  PH_REQUIRE(audio.renderFrames(128u).has_value());
+  auto captured = audio.renderCaptureFrames(128u);
+  PH_REQUIRE(captured.has_value());
+  PH_CHECK(capture.calls == 1u);
+  PH_CHECK(!capture.lastUnderrun);
+  PH_CHECK(captured.value()[0] == doctest::Approx(0.0f));
+  PH_CHECK(captured.value()[64u * 2u - 1u] == doctest::Approx(0.0f));
+  PH_CHECK(captured.value()[64u * 2u] == doctest::Approx(0.25f));
+
+  captured = audio.renderCaptureFrames(128u);
+  PH_REQUIRE(captured.has_value());
+  PH_CHECK(capture.lastUnderrun);
+  PH_CHECK(captured.value()[0] == doctest::Approx(0.25f));
+  PH_CHECK(captured.value()[64u * 2u] == doctest::Approx(0.0f));
+
+  PH_CHECK(audio.closeCaptureStream().has_value());
+  PH_CHECK(!audio.activeCaptureConfig().has_value());
+}
+
+PH_TEST("primehost.audio.capture", "file input loops and maps channels") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+  auto path = write_ramp_wav(48000u, 100u);
+  auto device = audio.addFileInputDevice(path);
+  std::filesystem::remove(path);
+  PH_REQUIRE(device.has_value());
+  PH_CHECK(audio.inputDevices({}).value() == 2u);
+  auto info = audio.inputDeviceInfo(device.value());
+  PH_REQUIRE(info.has_value());
+  PH_CHECK(info->preferredFormat.channels == 1u);
+
+  CaptureState capture{};
+  AudioStreamConfig mismatched = stereo_config();
+  mismatched.format.sampleRate = 44100;
+  auto bad = audio.openCaptureStream(device.value(), mismatched, record_capture, &capture);
+  PH_CHECK(!bad.has_value());
+  PH_CHECK(bad.error().code == HostErrorCode::Unsupported);
+
+  PH_REQUIRE(audio.openCaptureStream(device.value(), stereo_config(), record_capture, &capture).has_value());
+  PH_REQUIRE(audio.startCaptureStream().has_value());
+  auto captured = audio.renderCaptureFrames(128u);
+  PH_REQUIRE(captured.has_value());
+  PH_CHECK(!capture.lastUnderrun);
+  PH_CHECK(captured.value()[2u * 10u] == doctest::Approx(0.10f));
+  PH_CHECK(captured.value()[2u * 10u + 1u] == doctest::Approx(0.10f));
+  PH_CHECK(captured.value()[2u * 110u] == doctest::Approx(0.10f));
+
+  PH_CHECK(!audio.removeVirtualDevice(device.value()).has_value());
+  PH_CHECK(audio.closeCaptureStream().has_value());
+  PH_CHECK(audio.removeVirtualDevice(device.value()).has_value());
+  PH_CHECK(audio.inputDevices({}).value() == 1u);
+}
+
+PH_TEST("primehost.audio.capture", "duplex delivers input with output") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+  auto path = write_ramp_wav(48000u, 480u);
+  auto device = audio.addFileInputDevice(path);
+  std::filesystem::remove(path);
+  PH_REQUIRE(device.has_value());
+
+  DuplexState duplex{};
+  duplex.offset = 1.0f;
+  PH_REQUIRE(audio.openDuplexStream(device.value(), AudioHostNull::DeviceId, stereo_config(), monitor, &duplex)
+                 .has_value());
+  PH_REQUIRE(audio.startStream().has_value());
+  auto rendered = audio.renderFrames(128u);
+  PH_REQUIRE(rendered.has_value());
+  PH_CHECK(!duplex.lastUnderrun);
+  PH_CHECK(rendered.value()[2u * 48u] == doctest::Approx(1.1f));
+  PH_CHECK(duplex.inputBeforeOutput);
+}
+
+PH_TEST("primehost.audio.capture", "duplex loopback feeds back previous output") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+
+  DuplexState duplex{};
+  duplex.offset = 0.125f;
+  PH_REQUIRE(audio.openDuplexStream(AudioHostNull::LoopbackDeviceId,
+                                    AudioHostNull::DeviceId,
+                                    stereo_config(),
+                                    monitor,
+                                    &duplex)
+                 .has_value());
+  CaptureState capture{};
+  auto busy = audio.openCaptureStream(AudioHostNull::LoopbackDeviceId, stereo_config(), record_capture, &capture);
+  PH_CHECK(!busy.has_value());
+
+  PH_REQUIRE(audio.startStream().has_value());
+  auto first = audio.renderFrames(128u);
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(duplex.lastUnderrun);
+  PH_CHECK(first.value()[0] == doctest::Approx(0.125f));
+  auto second = audio.renderFrames(128u);
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(!duplex.lastUnderrun);
+  PH_CHECK(second.value()[0] == doctest::Approx(0.25f));
+  PH_CHECK(duplex.inputBeforeOutput);
+
+  PH_CHECK(audio.closeStream().has_value());
+  PH_CHECK(audio.openStream(AudioHostNull::DeviceId, stereo_config(), fill_output, nullptr).has_value());
+  PH_CHECK(audio.openCaptureStream(AudioHostNull::LoopbackDeviceId, stereo_config(), record_capture, &capture)
+               .has_value());
+}
+
+TEST_SUITE_END();
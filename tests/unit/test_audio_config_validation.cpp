@@ -39,6 +39,11 @@ PH_TEST("primehost.audio", "validate audio config") {
   config.format.format = static_cast<SampleFormat>(99u);
   auto badFormat = validateAudioStreamConfig(config);
   PH_CHECK(!badFormat.has_value());
+
+  config.format.format = SampleFormat::Float32;
+  config.crossfadeDuration = std::chrono::nanoseconds(-1);
+  auto badCrossfade = validateAudioStreamConfig(config);
+  PH_CHECK(!badCrossfade.has_value());
 }
 
 TEST_SUITE_END();
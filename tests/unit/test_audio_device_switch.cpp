@@ -0,0 +1,154 @@
+#include "src/AudioDeviceSwitch.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+constexpr uint32_t kFrames = 4u;
+constexpr uint32_t kCrossfadeFrames = 8u;
+
+// Every sample carries frameIndex + 1 so gaps, repeats and silence are visible in the output.
+void fill_index(std::span<float> interleaved, const AudioCallbackContext& ctx, void*) {
+  for (float& sample : interleaved) {
+    sample = static_cast<float>(ctx.frameIndex + 1u);
+  }
+}
+
+std::vector<float> render_lane(AudioDeviceSwitcher& switcher, uint32_t lane) {
+  std::vector<float> out(kFrames, -1.0f);
+  switcher.render(lane, out);
+  return out;
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.switch");
+
+PH_TEST("primehost.audio.switch", "idle passes through current lane") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(1u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+  PH_CHECK(switcher.currentLane() == 0u);
+  PH_CHECK(render_lane(switcher, 0u)[0] == doctest::Approx(1.0f));
+  PH_CHECK(render_lane(switcher, 1u)[0] == doctest::Approx(0.0f));
+  PH_CHECK(render_lane(switcher, 0u)[0] == doctest::Approx(2.0f));
+  PH_CHECK(!switcher.takeCompletedSwitch().has_value());
+}
+
+PH_TEST("primehost.audio.switch", "crossfade hands over without gaps") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(1u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  PH_CHECK(!switcher.beginSwitch(std::chrono::steady_clock::now()));
+
+  // Incoming device starts before anything has been prefilled.
+  PH_CHECK(render_lane(switcher, 1u)[0] == doctest::Approx(0.0f));
+  PH_CHECK(switcher.phase() == AudioDeviceSwitcher::Phase::Prefill);
+
+  std::vector<float> outgoing;
+  std::vector<float> incoming;
+  for (int i = 0; i < 8 && !switcher.takeCompletedSwitch(); ++i) {
+    auto out = render_lane(switcher, 0u);
+    outgoing.insert(outgoing.end(), out.begin(), out.end());
+    auto in = render_lane(switcher, 1u);
+    incoming.insert(incoming.end(), in.begin(), in.end());
+  }
+  PH_CHECK(switcher.currentLane() == 1u);
+  PH_CHECK(switcher.phase() == AudioDeviceSwitcher::Phase::Idle);
+  PH_CHECK(switcher.underrunFrames() == 0u);
+
+  // Outgoing fades to silence over exactly the crossfade length.
+  PH_REQUIRE(outgoing.size() >= kFrames * 3u);
+  PH_CHECK(outgoing[0] == doctest::Approx(1.0f));
+  PH_CHECK(outgoing[kFrames] < 2.0f);
+  PH_CHECK(outgoing[kFrames * 3u - 1u] == doctest::Approx(0.0f));
+
+  // Incoming fades in, then plays the same timeline the outgoing device produced.
+  PH_REQUIRE(incoming.size() >= kFrames * 3u);
+  PH_CHECK(incoming[0] == doctest::Approx(1.0f / kCrossfadeFrames));
+  PH_CHECK(incoming[kFrames * 2u] == doctest::Approx(3.0f));
+
+  // After the handover the incoming lane drives the source; frame indices keep counting up.
+  float previous = incoming.back();
+  for (int i = 0; i < 3; ++i) {
+    auto in = render_lane(switcher, 1u);
+    PH_CHECK(in[0] == doctest::Approx(previous + 1.0f));
+    previous = in[0];
+    PH_CHECK(render_lane(switcher, 0u)[0] == doctest::Approx(0.0f));
+  }
+}
+
+PH_TEST("primehost.audio.switch", "completed switch reports latency") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(2u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  std::vector<float> buffer(kFrames * 2u);
+  for (int i = 0; i < 10 && switcher.switchPending(); ++i) {
+    switcher.render(0u, buffer);
+    switcher.render(1u, buffer);
+    if (auto result = switcher.takeCompletedSwitch()) {
+      PH_CHECK(result->crossfaded);
+      PH_CHECK(result->crossfadeFrames == kCrossfadeFrames);
+      PH_CHECK(result->switchLatency.count() >= 0);
+      PH_CHECK(result->completionTime >= result->switchLatency);
+    }
+  }
+  PH_CHECK(!switcher.switchPending());
+  PH_CHECK(switcher.currentLane() == 1u);
+}
+
+PH_TEST("primehost.audio.switch", "lost outgoing device hands over immediately") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(1u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+  render_lane(switcher, 0u);
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  switcher.outgoingLost();
+
+  auto in = render_lane(switcher, 1u);
+  PH_CHECK(in[0] == doctest::Approx(1.0f / kCrossfadeFrames * 2.0f));
+  PH_CHECK(in[kFrames - 1u] == doctest::Approx(2.0f * kFrames / kCrossfadeFrames));
+  auto result = switcher.takeCompletedSwitch();
+  PH_REQUIRE(result.has_value());
+  PH_CHECK(!result->crossfaded);
+  PH_CHECK(result->crossfadeFrames == 0u);
+  PH_CHECK(switcher.currentLane() == 1u);
+}
+
+PH_TEST("primehost.audio.switch", "incoming underrun is counted") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(1u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  render_lane(switcher, 0u);
+  render_lane(switcher, 1u);
+  auto starved = render_lane(switcher, 1u);
+  PH_CHECK(starved[0] == doctest::Approx(0.0f));
+  PH_CHECK(switcher.underrunFrames() == kFrames);
+}
+
+PH_TEST("primehost.audio.switch", "abort and settle") {
+  AudioDeviceSwitcher switcher;
+  switcher.prepare(1u, kFrames, kCrossfadeFrames, fill_index, nullptr);
+
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  switcher.abortSwitch();
+  PH_CHECK(!switcher.switchPending());
+  PH_CHECK(switcher.currentLane() == 0u);
+
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  PH_CHECK(!switcher.settle().has_value());
+  PH_CHECK(switcher.currentLane() == 0u);
+
+  PH_REQUIRE(switcher.beginSwitch(std::chrono::steady_clock::now()));
+  render_lane(switcher, 0u);
+  render_lane(switcher, 1u);
+  PH_CHECK(switcher.phase() == AudioDeviceSwitcher::Phase::Crossfade);
+  auto settled = switcher.settle();
+  PH_REQUIRE(settled.has_value());
+  PH_CHECK(switcher.currentLane() == 1u);
+  PH_CHECK(switcher.phase() == AudioDeviceSwitcher::Phase::Idle);
+}
+
+TEST_SUITE_END();
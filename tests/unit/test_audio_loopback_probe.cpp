@@ -0,0 +1,71 @@
+#include "src/AudioLoopbackProbe.h"
+#include "src/platform/null/AudioNull.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+AudioLoopbackReport run_probe(uint32_t bufferFrames, uint32_t latencyFrames, uint32_t callbacks) {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  nullConfig.loopbackLatencyFrames = latencyFrames;
+  AudioHostNull audio(nullConfig);
+  AudioStreamConfig config{};
+  config.format.sampleRate = 48000;
+  config.format.channels = 2;
+  config.bufferFrames = bufferFrames;
+  config.periodFrames = bufferFrames;
+
+  AudioLoopbackProbe probe;
+  probe.prepare(48000u, bufferFrames, callbacks);
+  REQUIRE(audio.openDuplexStream(AudioHostNull::LoopbackDeviceId,
+                                 AudioHostNull::DeviceId,
+                                 config,
+                                 &AudioLoopbackProbe::duplexCallback,
+                                 &probe)
+              .has_value());
+  REQUIRE(audio.startStream().has_value());
+  while (!probe.finished()) {
+    REQUIRE(audio.renderFrames(bufferFrames).has_value());
+  }
+  return probe.report();
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.loopback");
+
+PH_TEST("primehost.audio.loopback", "percentiles use nearest rank") {
+  std::vector<double> values{5.0, 1.0, 4.0, 2.0, 3.0, 6.0, 7.0, 8.0, 9.0, 10.0};
+  AudioPercentiles p = audioPercentiles(values);
+  PH_CHECK(p.p50 == doctest::Approx(5.0));
+  PH_CHECK(p.p90 == doctest::Approx(9.0));
+  PH_CHECK(p.p99 == doctest::Approx(10.0));
+  PH_CHECK(p.max == doctest::Approx(10.0));
+  std::vector<double> empty;
+  PH_CHECK(audioPercentiles(empty).max == doctest::Approx(0.0));
+}
+
+PH_TEST("primehost.audio.loopback", "impulse returns after one buffer without device latency") {
+  AudioLoopbackReport report = run_probe(256u, 0u, 16u);
+  PH_CHECK(report.callbacks == 16u);
+  PH_CHECK(report.impulses == 15u);
+  PH_CHECK(report.inputUnderruns == 1u);
+  PH_CHECK(report.latencyFrames.p50 == doctest::Approx(256.0));
+  PH_CHECK(report.latencyFrames.max == doctest::Approx(256.0));
+}
+
+PH_TEST("primehost.audio.loopback", "device latency longer than a buffer sets the round trip") {
+  AudioLoopbackReport report = run_probe(64u, 200u, 40u);
+  PH_CHECK(report.inputUnderruns == 0u);
+  PH_CHECK(report.impulses > 5u);
+  PH_CHECK(report.latencyFrames.p50 == doctest::Approx(200.0));
+  PH_CHECK(report.latencyFrames.max == doctest::Approx(200.0));
+  PH_CHECK(report.wakeErrorUs.max >= report.wakeErrorUs.p50);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,166 @@
+#include "PrimeHost/Audio.h"
+
+#include "src/AudioMixKernels.h"
+#include "src/AudioMixer.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <limits>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+void fill_constant(std::span<float> interleaved, const AudioCallbackContext&, void* userData) {
+  const float value = *static_cast<const float*>(userData);
+  for (float& sample : interleaved) {
+    sample = value;
+  }
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.mixer");
+
+PH_TEST("primehost.audio.mixer", "scaled mix matches scalar") {
+  std::vector<float> src(37);
+  std::vector<float> dst(37);
+  std::vector<float> expected(37);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<float>(i) * 0.25f;
+    dst[i] = 1.0f;
+    expected[i] = 1.0f;
+  }
+  mixScaled(dst.data(), src.data(), src.size(), 0.5f);
+  mixScaledScalar(expected.data(), src.data(), src.size(), 0.5f);
+  for (size_t i = 0; i < dst.size(); ++i) {
+    PH_CHECK(dst[i] == doctest::Approx(expected[i]));
+  }
+}
+
+PH_TEST("primehost.audio.mixer", "mono source upmixes") {
+  std::array<float, 4> src{1.0f, 2.0f, 3.0f, 4.0f};
+  std::array<float, 8> dst{};
+  mixMapped(dst.data(), 2u, src.data(), 1u, 4u, 1.0f, 1.0f);
+  PH_CHECK(dst[0] == doctest::Approx(1.0f));
+  PH_CHECK(dst[1] == doctest::Approx(1.0f));
+  PH_CHECK(dst[6] == doctest::Approx(4.0f));
+  PH_CHECK(dst[7] == doctest::Approx(4.0f));
+}
+
+PH_TEST("primehost.audio.mixer", "surplus source channels dropped") {
+  std::array<float, 8> src{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  std::array<float, 4> dst{};
+  mixMapped(dst.data(), 2u, src.data(), 4u, 2u, 1.0f, 1.0f);
+  PH_CHECK(dst[0] == doctest::Approx(1.0f));
+  PH_CHECK(dst[1] == doctest::Approx(2.0f));
+  PH_CHECK(dst[2] == doctest::Approx(5.0f));
+  PH_CHECK(dst[3] == doctest::Approx(6.0f));
+}
+
+PH_TEST("primehost.audio.mixer", "gain ramp reaches target") {
+  std::array<float, 4> src{1.0f, 1.0f, 1.0f, 1.0f};
+  std::array<float, 4> dst{};
+  mixMapped(dst.data(), 1u, src.data(), 1u, 4u, 0.0f, 1.0f);
+  PH_CHECK(dst[0] == doctest::Approx(0.25f));
+  PH_CHECK(dst[1] == doctest::Approx(0.5f));
+  PH_CHECK(dst[3] == doctest::Approx(1.0f));
+}
+
+PH_TEST("primehost.audio.mixer", "streams sum with gain") {
+  AudioMixer mixer;
+  mixer.prepare(2u, 64u, 48000u);
+
+  float first = 0.5f;
+  float second = 0.25f;
+  AudioMixStreamConfig config{};
+  config.channels = 2u;
+  auto a = mixer.addStream(config, fill_constant, &first);
+  config.channels = 1u;
+  config.gain = 2.0f;
+  auto b = mixer.addStream(config, fill_constant, &second);
+  PH_REQUIRE(a.has_value());
+  PH_REQUIRE(b.has_value());
+  PH_CHECK(a.value() != b.value());
+  PH_CHECK(mixer.activeStreamCount() == 2u);
+
+  std::vector<float> out(64u * 2u, 0.0f);
+  AudioCallbackContext ctx{};
+  ctx.requestedFrames = 64u;
+  mixer.render(out, ctx);
+  for (float sample : out) {
+    PH_CHECK(sample == doctest::Approx(1.0f));
+  }
+
+  auto stats = mixer.streamStats(a.value());
+  PH_REQUIRE(stats.has_value());
+  PH_CHECK(stats->callbackCount == 1u);
+  PH_CHECK(stats->totalCallbackTime >= stats->lastCallbackTime);
+}
+
+PH_TEST("primehost.audio.mixer", "buffers larger than scratch render in chunks") {
+  AudioMixer mixer;
+  mixer.prepare(1u, 16u, 48000u);
+  float value = 1.0f;
+  auto id = mixer.addStream(AudioMixStreamConfig{1u, 1.0f}, fill_constant, &value);
+  PH_REQUIRE(id.has_value());
+
+  std::vector<float> out(40u, 0.0f);
+  mixer.render(out, AudioCallbackContext{});
+  for (float sample : out) {
+    PH_CHECK(sample == doctest::Approx(1.0f));
+  }
+}
+
+PH_TEST("primehost.audio.mixer", "remove invalidates id") {
+  AudioMixer mixer;
+  mixer.prepare(2u, 32u, 48000u);
+  float value = 1.0f;
+  auto id = mixer.addStream(AudioMixStreamConfig{}, fill_constant, &value);
+  PH_REQUIRE(id.has_value());
+  PH_CHECK(mixer.removeStream(id.value()).has_value());
+  PH_CHECK(mixer.activeStreamCount() == 0u);
+
+  auto again = mixer.removeStream(id.value());
+  PH_CHECK(!again.has_value());
+  PH_CHECK(again.error().code == HostErrorCode::InvalidConfig);
+
+  auto reused = mixer.addStream(AudioMixStreamConfig{}, fill_constant, &value);
+  PH_REQUIRE(reused.has_value());
+  PH_CHECK(reused.value() != id.value());
+  PH_CHECK(!mixer.streamStats(id.value()).has_value());
+}
+
+PH_TEST("primehost.audio.mixer", "invalid stream configs") {
+  AudioMixer mixer;
+  float value = 1.0f;
+  auto noCallback = mixer.addStream(AudioMixStreamConfig{}, nullptr, nullptr);
+  PH_CHECK(!noCallback.has_value());
+  PH_CHECK(noCallback.error().code == HostErrorCode::InvalidConfig);
+
+  auto noChannels = mixer.addStream(AudioMixStreamConfig{0u, 1.0f}, fill_constant, &value);
+  PH_CHECK(!noChannels.has_value());
+
+  auto badGain = mixer.addStream(AudioMixStreamConfig{2u, -1.0f}, fill_constant, &value);
+  PH_CHECK(!badGain.has_value());
+
+  auto id = mixer.addStream(AudioMixStreamConfig{}, fill_constant, &value);
+  PH_REQUIRE(id.has_value());
+  auto gain = mixer.setStreamGain(id.value(), std::numeric_limits<float>::infinity());
+  PH_CHECK(!gain.has_value());
+}
+
+PH_TEST("primehost.audio.mixer", "stream capacity") {
+  AudioMixer mixer;
+  float value = 0.0f;
+  for (uint32_t i = 0; i < AudioMaxMixStreams; ++i) {
+    PH_CHECK(mixer.addStream(AudioMixStreamConfig{}, fill_constant, &value).has_value());
+  }
+  auto full = mixer.addStream(AudioMixStreamConfig{}, fill_constant, &value);
+  PH_CHECK(!full.has_value());
+  PH_CHECK(full.error().code == HostErrorCode::OutOfMemory);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,216 @@
+#include "PrimeHost/Audio.h"
+
+#include "src/platform/null/AudioNull.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+namespace {
+
+struct CallbackState {
+  std::atomic<uint32_t> calls{0u};
+  uint64_t lastFrameIndex = 0u;
+  float value = 0.0f;
+};
+
+void fill_state(std::span<float> interleaved, const AudioCallbackContext& ctx, void* userData) {
+  auto* state = static_cast<CallbackState*>(userData);
+  state->calls.fetch_add(1u);
+  state->lastFrameIndex = ctx.frameIndex;
+  for (float& sample : interleaved) {
+    sample = state->value;
+  }
+}
+
+AudioStreamConfig stereo_config() {
+  AudioStreamConfig config{};
+  config.format.sampleRate = 48000;
+  config.format.channels = 2;
+  config.bufferFrames = 256;
+  config.periodFrames = 128;
+  return config;
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.null");
+
+PH_TEST("primehost.audio.null", "factory and device enumeration") {
+  auto result = createNullAudioHost();
+  PH_REQUIRE(result.has_value());
+  auto audio = std::move(result.value());
+
+  auto count = audio->outputDevices({});
+  PH_REQUIRE(count.has_value());
+  PH_CHECK(count.value() == 1u);
+
+  auto device = audio->defaultOutputDevice();
+  PH_REQUIRE(device.has_value());
+  auto info = audio->outputDeviceInfo(device.value());
+  PH_REQUIRE(info.has_value());
+  PH_CHECK(info->isDefault);
+  PH_CHECK(!info->name.empty());
+
+  auto invalid = audio->openStream(0u, stereo_config(), fill_state, nullptr);
+  PH_CHECK(!invalid.has_value());
+  PH_CHECK(invalid.error().code == HostErrorCode::InvalidDevice);
+}
+
+PH_TEST("primehost.audio.null", "manual render mixes streams") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+
+  CallbackState primary{};
+  primary.value = 0.25f;
+  PH_REQUIRE(audio.openStream(AudioHostNull::DeviceId, stereo_config(), fill_state, &primary).has_value());
+
+  auto notStarted = audio.renderFrames(128u);
+  PH_CHECK(!notStarted.has_value());
+
+  CallbackState music{};
+  music.value = 0.5f;
+  auto musicId = audio.addMixStream(AudioMixStreamConfig{2u, 0.5f}, fill_state, &music);
+  PH_REQUIRE(musicId.has_value());
+
+  PH_REQUIRE(audio.startStream().has_value());
+  auto rendered = audio.renderFrames(128u);
+  PH_REQUIRE(rendered.has_value());
+  PH_CHECK(rendered->size() == 256u);
+  for (float sample : rendered.value()) {
+    PH_CHECK(sample == doctest::Approx(0.5f));
+  }
+
+  PH_CHECK(audio.removeMixStream(musicId.value()).has_value());
+  rendered = audio.renderFrames(128u);
+  PH_REQUIRE(rendered.has_value());
+  PH_CHECK(rendered.value()[0] == doctest::Approx(0.25f));
+  PH_CHECK(primary.lastFrameIndex == 1u);
+  PH_CHECK(music.calls.load() == 1u);
+}
+
+PH_TEST("primehost.audio.null", "realtime clock drives callbacks") {
+  auto result = createNullAudioHost();
+  PH_REQUIRE(result.has_value());
+  auto audio = std::move(result.value());
+
+  CallbackState primary{};
+  CallbackState extra{};
+  PH_REQUIRE(audio->openStream(AudioHostNull::DeviceId, stereo_config(), fill_state, &primary).has_value());
+  auto extraId = audio->addMixStream(AudioMixStreamConfig{}, fill_state, &extra);
+  PH_REQUIRE(extraId.has_value());
+  PH_REQUIRE(audio->startStream().has_value());
+
+  for (int i = 0; i < 200 && extra.calls.load() < 3u; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  PH_CHECK(extra.calls.load() >= 3u);
+  PH_CHECK(audio->removeMixStream(extraId.value()).has_value());
+  const uint32_t callsAfterRemove = extra.calls.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  PH_CHECK(extra.calls.load() == callsAfterRemove);
+
+  PH_CHECK(audio->closeStream().has_value());
+  PH_CHECK(!audio->activeConfig().has_value());
+}
+
+PH_TEST("primehost.audio.null", "follow default device crossfades to new device") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+
+  std::vector<AudioDeviceEvent> deviceEvents;
+  std::vector<AudioDeviceSwitchEvent> switchEvents;
+  AudioCallbacks callbacks{};
+  callbacks.onDeviceEvent = [&](const AudioDeviceEvent& event) { deviceEvents.push_back(event); };
+  callbacks.onDeviceSwitch = [&](const AudioDeviceSwitchEvent& event) { switchEvents.push_back(event); };
+  PH_REQUIRE(audio.setCallbacks(std::move(callbacks)).has_value());
+
+  CallbackState primary{};
+  primary.value = 0.5f;
+  AudioStreamConfig config = stereo_config();
+  config.followDefaultDevice = true;
+  config.crossfadeDuration = std::chrono::milliseconds(4);
+  PH_REQUIRE(audio.openStream(AudioHostNull::DeviceId, config, fill_state, &primary).has_value());
+  PH_REQUIRE(audio.startStream().has_value());
+  PH_REQUIRE(audio.renderFrames(128u).has_value());
+
+  auto headphones = audio.addVirtualDevice("Headphones");
+  PH_REQUIRE(headphones.has_value());
+  PH_CHECK(audio.outputDevices({}).value() == 2u);
+  PH_REQUIRE(audio.setDefaultDevice(headphones.value()).has_value());
+  PH_REQUIRE(deviceEvents.size() == 2u);
+  PH_CHECK(deviceEvents.back().deviceId == headphones.value());
+  PH_CHECK(deviceEvents.back().isDefault);
+
+  for (int i = 0; i < 16 && !audio.pollDeviceSwitch(); ++i) {
+    PH_REQUIRE(audio.renderDeviceFrames(AudioHostNull::DeviceId, 128u).has_value());
+    PH_REQUIRE(audio.renderDeviceFrames(headphones.value(), 128u).has_value());
+  }
+  PH_REQUIRE(switchEvents.size() == 1u);
+  PH_CHECK(switchEvents[0].fromDevice == AudioHostNull::DeviceId);
+  PH_CHECK(switchEvents[0].toDevice == headphones.value());
+  PH_CHECK(switchEvents[0].crossfaded);
+  PH_CHECK(switchEvents[0].crossfadeFrames == 192u);
+  PH_CHECK(switchEvents[0].completionTime >= switchEvents[0].switchLatency);
+  PH_CHECK(audio.activeDevice().value() == headphones.value());
+  PH_CHECK(!audio.renderDeviceFrames(AudioHostNull::DeviceId, 128u).has_value());
+
+  const uint64_t lastIndex = primary.lastFrameIndex;
+  auto rendered = audio.renderFrames(128u);
+  PH_REQUIRE(rendered.has_value());
+  PH_CHECK(rendered.value()[0] == doctest::Approx(0.5f));
+  PH_CHECK(primary.lastFrameIndex == lastIndex + 1u);
+}
+
+PH_TEST("primehost.audio.null", "removing the active device hands over without crossfade") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+
+  std::vector<AudioDeviceSwitchEvent> switchEvents;
+  AudioCallbacks callbacks{};
+  callbacks.onDeviceSwitch = [&](const AudioDeviceSwitchEvent& event) { switchEvents.push_back(event); };
+  PH_REQUIRE(audio.setCallbacks(std::move(callbacks)).has_value());
+
+  auto speakers = audio.addVirtualDevice("Speakers");
+  PH_REQUIRE(speakers.has_value());
+
+  CallbackState primary{};
+  AudioStreamConfig config = stereo_config();
+  config.followDefaultDevice = true;
+  PH_REQUIRE(audio.openStream(AudioHostNull::DeviceId, config, fill_state, &primary).has_value());
+  PH_REQUIRE(audio.startStream().has_value());
+  PH_REQUIRE(audio.renderFrames(128u).has_value());
+
+  PH_REQUIRE(audio.removeVirtualDevice(AudioHostNull::DeviceId).has_value());
+  PH_CHECK(audio.defaultOutputDevice().value() == speakers.value());
+  PH_REQUIRE(audio.renderDeviceFrames(speakers.value(), 128u).has_value());
+  PH_CHECK(primary.lastFrameIndex == 1u);
+  PH_REQUIRE(audio.pollDeviceSwitch());
+  PH_REQUIRE(switchEvents.size() == 1u);
+  PH_CHECK(!switchEvents[0].crossfaded);
+  PH_CHECK(audio.activeDevice().value() == speakers.value());
+}
+
+PH_TEST("primehost.audio.null", "streams without follow stay on their device") {
+  AudioNullConfig nullConfig{};
+  nullConfig.realtime = false;
+  AudioHostNull audio(nullConfig);
+  CallbackState primary{};
+  PH_REQUIRE(audio.openStream(AudioHostNull::DeviceId, stereo_config(), fill_state, &primary).has_value());
+  PH_REQUIRE(audio.startStream().has_value());
+  auto other = audio.addVirtualDevice("Other");
+  PH_REQUIRE(other.has_value());
+  PH_REQUIRE(audio.setDefaultDevice(other.value()).has_value());
+  PH_CHECK(!audio.pollDeviceSwitch());
+  PH_CHECK(audio.activeDevice().value() == AudioHostNull::DeviceId);
+  PH_CHECK(!audio.renderDeviceFrames(other.value(), 128u).has_value());
+}
+
+TEST_SUITE_END();
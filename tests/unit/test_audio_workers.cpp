@@ -0,0 +1,121 @@
+#include "PrimeHost/AudioWorkers.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+using namespace PrimeHost;
+
+namespace {
+
+struct JobState {
+  std::array<std::atomic<uint32_t>, 256> runs{};
+};
+
+void count_job(uint32_t jobIndex, void* userData) {
+  auto* state = static_cast<JobState*>(userData);
+  state->runs[jobIndex].fetch_add(1u);
+}
+
+void slow_job(uint32_t, void*) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+std::chrono::steady_clock::time_point far_deadline() {
+  return std::chrono::steady_clock::now() + std::chrono::seconds(10);
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("primehost.audio.workers");
+
+PH_TEST("primehost.audio.workers", "dispatch runs every job once") {
+  AudioWorkerPoolConfig config{};
+  config.workerCount = 3u;
+  config.realtimePriority = false;
+  auto pool = createAudioWorkerPool(config);
+  PH_REQUIRE(pool.has_value());
+  PH_CHECK(pool.value()->workerCount() == 3u);
+
+  JobState state{};
+  for (int round = 0; round < 200; ++round) {
+    auto result = pool.value()->dispatch(64u, count_job, &state, far_deadline());
+    PH_REQUIRE(result.has_value());
+    PH_CHECK(result->completed == 64u);
+    PH_CHECK(result->dropped == 0u);
+    PH_CHECK(result->overrun.count() == 0);
+  }
+  for (uint32_t i = 0; i < 64u; ++i) {
+    PH_CHECK(state.runs[i].load() == 200u);
+  }
+  PH_CHECK(state.runs[64].load() == 0u);
+
+  AudioWorkerStats stats = pool.value()->stats();
+  PH_CHECK(stats.dispatchCount == 200u);
+  PH_CHECK(stats.jobsCompleted == 64u * 200u);
+  PH_CHECK(stats.deadlineMisses == 0u);
+  PH_CHECK(stats.maxDispatchTime >= stats.lastDispatchTime);
+}
+
+PH_TEST("primehost.audio.workers", "jobs past the deadline are dropped") {
+  AudioWorkerPoolConfig config{};
+  config.workerCount = 1u;
+  config.realtimePriority = false;
+  auto pool = createAudioWorkerPool(config);
+  PH_REQUIRE(pool.has_value());
+
+  JobState state{};
+  auto expired = pool.value()->dispatch(16u, count_job, &state, std::chrono::steady_clock::now());
+  PH_REQUIRE(expired.has_value());
+  PH_CHECK(expired->dropped == 16u);
+  PH_CHECK(expired->completed == 0u);
+  PH_CHECK(state.runs[0].load() == 0u);
+
+  auto tight = pool.value()->dispatch(
+      8u, slow_job, nullptr, std::chrono::steady_clock::now() + std::chrono::milliseconds(3));
+  PH_REQUIRE(tight.has_value());
+  PH_CHECK(tight->completed + tight->dropped == 8u);
+  PH_CHECK(tight->dropped > 0u);
+  PH_CHECK(tight->completed > 0u);
+
+  // The caller itself runs a slow job past the deadline, so dispatch returns late.
+  PH_CHECK(tight->overrun > std::chrono::nanoseconds(0));
+
+  AudioWorkerStats stats = pool.value()->stats();
+  PH_CHECK(stats.deadlineMisses == 2u);
+  PH_CHECK(stats.overruns == 2u);
+  PH_CHECK(stats.maxOverrun >= tight->overrun);
+  PH_CHECK(stats.jobsDropped == 16u + tight->dropped);
+  pool.value()->resetStats();
+  PH_CHECK(pool.value()->stats().dispatchCount == 0u);
+  PH_CHECK(pool.value()->stats().overruns == 0u);
+}
+
+PH_TEST("primehost.audio.workers", "invalid dispatch") {
+  AudioWorkerPoolConfig config{};
+  config.workerCount = 1u;
+  config.realtimePriority = false;
+  auto pool = createAudioWorkerPool(config);
+  PH_REQUIRE(pool.has_value());
+
+  auto noJob = pool.value()->dispatch(4u, nullptr, nullptr, far_deadline());
+  PH_CHECK(!noJob.has_value());
+  auto tooMany = pool.value()->dispatch(AudioMaxJobsPerDispatch + 1u, count_job, nullptr, far_deadline());
+  PH_CHECK(!tooMany.has_value());
+  auto empty = pool.value()->dispatch(0u, count_job, nullptr, far_deadline());
+  PH_REQUIRE(empty.has_value());
+  PH_CHECK(empty->completed == 0u);
+}
+
+PH_TEST("primehost.audio.workers", "deadline from callback context") {
+  AudioCallbackContext ctx{};
+  ctx.time = std::chrono::steady_clock::time_point{} + std::chrono::seconds(1);
+  ctx.requestedFrames = 480u;
+  auto deadline = audioDispatchDeadline(ctx, 48000u, 0.5f);
+  PH_CHECK(deadline - ctx.time == std::chrono::milliseconds(5));
+  PH_CHECK(audioDispatchDeadline(ctx, 0u) == ctx.time);
+}
+
+TEST_SUITE_END();
@@ -14,4 +14,20 @@ PH_TEST("primehost.device", "name matching") {
   PH_CHECK(!deviceNameMatches("Nintendo Switch Pro Controller", "Joy-Con (L)"));
 }
 
+PH_TEST("primehost.device", "normalized names") {
+  NormalizedDeviceName name = normalizeDeviceName("  Xbox_Wireless--Controller (045E) ");
+  PH_CHECK(name.view() == "xbox wireless controller 045e");
+  PH_CHECK(deviceNameMatchScore(name, "XBOX Wireless Controller (045e)") == 100);
+  PH_CHECK(deviceNameMatchScore(name, "Wireless Controller") == 80);
+  PH_CHECK(deviceNameMatchScore(name, "") == 0);
+
+  std::string_view longName(
+      "Controller Controller Controller Controller Controller Controller Controller Controller "
+      "Controller Controller Controller Controller Controller Controller Controller Controller "
+      "Controller Controller Controller Controller Controller Controller Controller Controller");
+  NormalizedDeviceName truncated = normalizeDeviceName(longName);
+  PH_CHECK(truncated.size <= NormalizedDeviceName::Capacity);
+  PH_CHECK(truncated.view().back() != ' ');
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,157 @@
+#include "DisplayCache.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.displaycache");
+
+namespace {
+
+DisplayRecord display_record(uint32_t displayId, int32_t x, float scale = 2.0f) {
+  DisplayRecord record{};
+  record.info.displayId = displayId;
+  record.info.x = x;
+  record.info.width = 1920u;
+  record.info.height = 1080u;
+  record.info.scale = scale;
+  record.info.refreshRate = 60.0f;
+  return record;
+}
+
+} // namespace
+
+PH_TEST("primehost.displaycache", "snapshot finds every display by id") {
+  std::vector<DisplayRecord> records;
+  for (uint32_t i = 0; i < 9u; ++i) {
+    // Ids that collide in the low bits still resolve through probing.
+    records.push_back(display_record(i * 1024u + 1u, static_cast<int32_t>(i)));
+  }
+  const DisplaySnapshot snapshot(records, 3u);
+  PH_CHECK(snapshot.generation() == 3u);
+  PH_CHECK(snapshot.records().size() == 9u);
+  for (uint32_t i = 0; i < 9u; ++i) {
+    const DisplayRecord* record = snapshot.find(i * 1024u + 1u);
+    PH_REQUIRE(record != nullptr);
+    PH_CHECK(record->info.x == static_cast<int32_t>(i));
+  }
+  PH_CHECK(snapshot.find(2u) == nullptr);
+  PH_CHECK(DisplaySnapshot{}.find(1u) == nullptr);
+}
+
+PH_TEST("primehost.displaycache", "diff reports added removed and changed displays") {
+  DisplayRecord primary = display_record(1u, 0);
+  primary.info.isPrimary = true;
+  const DisplaySnapshot before({primary, display_record(2u, 1920), display_record(3u, 3840)}, 1u);
+
+  DisplayRecord moved = display_record(2u, -1920, 1.0f);
+  DisplayRecord hdr = display_record(3u, 3840);
+  hdr.hdr.maxEdr = 2.0f;
+  hdr.hdr.supportsHdr = true;
+  const DisplaySnapshot after({primary, moved, hdr, display_record(4u, 5760)}, 2u);
+
+  std::vector<DisplayEvent> changes;
+  diffDisplaySnapshots(before, after, changes);
+  PH_REQUIRE(changes.size() == 3u);
+  PH_CHECK(changes[0].displayId == 2u);
+  PH_CHECK(changes[0].change == DisplayChange::Changed);
+  PH_CHECK(changes[0].fields ==
+           (static_cast<DisplayFieldMask>(DisplayField::Bounds) | static_cast<DisplayFieldMask>(DisplayField::Scale)));
+  PH_CHECK(changes[1].displayId == 3u);
+  PH_CHECK(changes[1].fields == static_cast<DisplayFieldMask>(DisplayField::Hdr));
+  PH_CHECK(changes[2].displayId == 4u);
+  PH_CHECK(changes[2].change == DisplayChange::Added);
+
+  changes.clear();
+  diffDisplaySnapshots(after, before, changes);
+  PH_REQUIRE(changes.size() == 3u);
+  PH_CHECK(changes[0].displayId == 4u);
+  PH_CHECK(changes[0].change == DisplayChange::Removed);
+}
+
+PH_TEST("primehost.displaycache", "publish swaps snapshots only on change") {
+  DisplayCache cache;
+  PH_CHECK(cache.read()->records().empty());
+  std::vector<DisplayEvent> changes;
+  PH_CHECK(cache.publish({display_record(1u, 0)}, changes));
+  PH_CHECK(changes.size() == 1u);
+  const DisplaySnapshot* first = &*cache.read();
+  PH_CHECK(first->generation() == 1u);
+
+  changes.clear();
+  PH_CHECK(!cache.publish({display_record(1u, 0)}, changes));
+  PH_CHECK(changes.empty());
+  PH_CHECK(&*cache.read() == first);
+
+  PH_CHECK(cache.publish({display_record(1u, 0), display_record(2u, 1920)}, changes));
+  PH_CHECK(cache.read()->generation() == 2u);
+  // Nobody was reading, so the superseded snapshot is freed straight away.
+  PH_CHECK(cache.retiredCount() == 0u);
+}
+
+PH_TEST("primehost.displaycache", "a pinned snapshot outlives publishes and is then freed") {
+  DisplayCache cache;
+  std::vector<DisplayEvent> changes;
+  cache.publish({display_record(1u, 0)}, changes);
+  {
+    const DisplaySnapshotReader pinned = cache.read();
+    PH_CHECK(cache.publish({display_record(1u, 0), display_record(2u, 1920)}, changes));
+    PH_CHECK(cache.retiredCount() == 1u);
+    PH_CHECK(pinned->generation() == 1u);
+    PH_CHECK(pinned->find(1u) != nullptr);
+    PH_CHECK(pinned->find(2u) == nullptr);
+  }
+  // An unchanged topology (a brightness notification that moved nothing) still reclaims.
+  PH_CHECK(!cache.publish({display_record(1u, 0), display_record(2u, 1920)}, changes));
+  PH_CHECK(cache.retiredCount() == 0u);
+
+  // EDR headroom churn keeps publishing without accumulating snapshots.
+  for (uint32_t i = 0; i < 1000u; ++i) {
+    DisplayRecord record = display_record(1u, 0);
+    record.hdr.maxEdr = 1.0f + static_cast<float>(i % 2u);
+    PH_CHECK(cache.publish({record}, changes));
+  }
+  PH_CHECK(cache.retiredCount() == 0u);
+}
+
+PH_TEST("primehost.displaycache", "readers see whole snapshots while the topology changes") {
+  DisplayCache cache;
+  std::vector<DisplayEvent> changes;
+  cache.publish({display_record(1u, 1)}, changes);
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+  std::thread reader([&]() {
+    while (!done.load(std::memory_order_acquire)) {
+      const DisplaySnapshotReader pinned = cache.read();
+      const DisplaySnapshot& snapshot = *pinned;
+      // Every published topology has generation() displays, all at x == generation.
+      const auto records = snapshot.records();
+      if (records.size() != snapshot.generation()) {
+        torn.store(true);
+      }
+      for (const DisplayRecord& record : records) {
+        if (record.info.x != static_cast<int32_t>(snapshot.generation()) ||
+            snapshot.find(record.info.displayId) != &record) {
+          torn.store(true);
+        }
+      }
+    }
+  });
+  for (uint32_t generation = 2u; generation <= 64u; ++generation) {
+    std::vector<DisplayRecord> records;
+    for (uint32_t i = 0; i < generation; ++i) {
+      records.push_back(display_record(i + 1u, static_cast<int32_t>(generation)));
+    }
+    cache.publish(std::move(records), changes);
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+  PH_CHECK(!torn.load());
+  PH_CHECK(cache.read()->generation() == 64u);
+}
+
+TEST_SUITE_END();
@@ -45,4 +45,25 @@ PH_TEST("primehost.events", "pollEvents invalid text buffer") {
   }
 }
 
+PH_TEST("primehost.events", "pending size matches what poll leaves queued") {
+  auto hostResult = createHost();
+  if (!hostResult) {
+    PH_CHECK(hostResult.error().code == HostErrorCode::Unsupported);
+    return;
+  }
+  auto host = std::move(hostResult.value());
+
+  std::array<Event, 1> events{};
+  EventBuffer buffer{
+      std::span<Event>(events.data(), events.size()),
+      std::span<char>(),
+  };
+  auto batch = host->pollEvents(buffer);
+  PH_REQUIRE(batch.has_value());
+  auto pending = host->pendingEventsSize();
+  PH_REQUIRE(pending.has_value());
+  PH_CHECK(pending->events == batch->pending.events);
+  PH_CHECK(pending->textBytes == batch->pending.textBytes);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,440 @@
+#include "EventLog.h"
+#include "PrimeHost/Replay.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+using namespace PrimeHost;
+using namespace std::chrono_literals;
+
+TEST_SUITE_BEGIN("primehost.eventlog");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Event surface_event(uint64_t surfaceId, Clock::time_point time, decltype(Event::payload) payload) {
+  Event event{};
+  event.scope = Event::Scope::Surface;
+  event.surfaceId = SurfaceId{surfaceId};
+  event.time = time;
+  event.payload = std::move(payload);
+  return event;
+}
+
+Event pointer_move(uint64_t surfaceId, Clock::time_point time, int32_t x, int32_t y) {
+  PointerEvent pointer{};
+  pointer.deviceId = 1u;
+  pointer.phase = PointerPhase::Move;
+  pointer.x = x;
+  pointer.y = y;
+  return surface_event(surfaceId, time, InputEvent{pointer});
+}
+
+std::filesystem::path temp_log(const char* name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+std::vector<uint8_t> read_file(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+PH_TEST("primehost.eventlog", "every payload round-trips") {
+  const auto t0 = Clock::time_point(1'000'000'000ns);
+  TextArena source;
+  auto hello = source.append("héllo");
+  auto paths = source.append("/a\n/b");
+  PH_REQUIRE(hello.has_value());
+  PH_REQUIRE(paths.has_value());
+
+  PointerEvent pen{};
+  pen.deviceId = 3u;
+  pen.pointerId = 9u;
+  pen.deviceType = PointerDeviceType::Pen;
+  pen.phase = PointerPhase::Down;
+  pen.x = -40;
+  pen.y = 1200;
+  pen.deltaX = -3;
+  pen.pressure = 0.625f;
+  pen.twist = 90.0f;
+  pen.buttonMask = 5u;
+  pen.isPrimary = false;
+
+  Event global{};
+  global.scope = Event::Scope::Global;
+  global.time = t0 + 9ms;
+  global.payload = PowerEvent{true};
+
+  std::vector<Event> events{
+      surface_event(1u, t0, InputEvent{pen}),
+      surface_event(1u, t0 + 1ms, InputEvent{KeyEvent{2u, 0x04u, 0x03u, true, true}}),
+      surface_event(1u, t0 + 2ms, InputEvent{TextEvent{2u, *hello}}),
+      surface_event(1u, t0 + 3ms, InputEvent{ScrollEvent{1u, 0.5f, -2.25f, true}}),
+      surface_event(1u, t0 + 4ms, InputEvent{GamepadButtonEvent{7u, 3u, true, 0.75f}}),
+      surface_event(1u, t0 + 5ms, InputEvent{GamepadAxisEvent{7u, 1u, -0.5f}}),
+      surface_event(1u, t0 + 6ms, InputEvent{DeviceEvent{7u, DeviceType::Gamepad, false}}),
+      surface_event(2u, t0 + 7ms, ResizeEvent{640u, 480u, 2.0f}),
+      surface_event(2u, t0 + 8ms, DropEvent{2u, *paths}),
+      global,
+      surface_event(2u, t0 + 10ms, FocusEvent{true}),
+      surface_event(2u, t0 + 11ms, ThermalEvent{ThermalState::Serious}),
+      surface_event(2u, t0 + 12ms, LifecycleEvent{LifecyclePhase::Backgrounded}),
+      surface_event(2u, t0 + 12500us, DisplayEvent{70u, DisplayChange::Changed, 0x05u}),
+  };
+
+  EventLogFrame frame{};
+  frame.surfaceId = SurfaceId{2u};
+  frame.timing = FrameTiming{t0 + 13ms, 16'666'667ns, 42u};
+  frame.diagnostics.targetInterval = 16'666'667ns;
+  frame.diagnostics.actualInterval = 17ms;
+  frame.diagnostics.missedDeadline = true;
+  frame.diagnostics.droppedFrames = 1u;
+  frame.diagnostics.acquireWait = 250us;
+  frame.diagnostics.supersededFrames = 4u;
+
+  std::vector<uint8_t> bytes;
+  encodeEventLogHeader(bytes);
+  EventLogEncoder encoder;
+  for (const Event& event : events) {
+    PH_REQUIRE(encoder.encodeEvent(event, source.bytes(), bytes).has_value());
+  }
+  encoder.encodeFrame(frame, bytes);
+
+  EventLogDecoder decoder(bytes);
+  PH_REQUIRE(decoder.valid());
+  TextArena text;
+  for (const Event& expected : events) {
+    Event event{};
+    EventLogFrame unused{};
+    auto kind = decoder.next(event, unused, text);
+    PH_REQUIRE(kind.has_value());
+    PH_REQUIRE(*kind == EventLogRecordKind::Event);
+    PH_CHECK(event.scope == expected.scope);
+    PH_CHECK(event.surfaceId.has_value() == expected.surfaceId.has_value());
+    PH_CHECK(event.time == expected.time);
+    PH_CHECK(event.payload.index() == expected.payload.index());
+    if (const auto* display = std::get_if<DisplayEvent>(&event.payload)) {
+      PH_CHECK(display->displayId == 70u);
+      PH_CHECK(display->change == DisplayChange::Changed);
+      PH_CHECK(display->fields == 0x05u);
+    }
+    if (const TextSpan* span = eventTextSpan(event)) {
+      const TextSpan* original = eventTextSpan(expected);
+      PH_REQUIRE(original != nullptr);
+      const std::string_view decoded(text.bytes().data() + span->offset, span->length);
+      const std::string_view recorded(source.bytes().data() + original->offset, original->length);
+      PH_CHECK(decoded == recorded);
+    }
+  }
+
+  Event event{};
+  EventLogFrame decodedFrame{};
+  auto kind = decoder.next(event, decodedFrame, text);
+  PH_REQUIRE(kind.has_value());
+  PH_REQUIRE(*kind == EventLogRecordKind::Frame);
+  PH_CHECK(decodedFrame.surfaceId == frame.surfaceId);
+  PH_CHECK(decodedFrame.timing.time == frame.timing.time);
+  PH_CHECK(decodedFrame.timing.delta == frame.timing.delta);
+  PH_CHECK(decodedFrame.timing.frameIndex == 42u);
+  PH_CHECK(decodedFrame.diagnostics.missedDeadline);
+  PH_CHECK(!decodedFrame.diagnostics.wasThrottled);
+  PH_CHECK(decodedFrame.diagnostics.acquireWait == 250us);
+  PH_CHECK(decodedFrame.diagnostics.supersededFrames == 4u);
+
+  auto end = decoder.next(event, decodedFrame, text);
+  PH_REQUIRE(end.has_value());
+  PH_CHECK(!end->has_value());
+}
+
+PH_TEST("primehost.eventlog", "pointer fields survive the delta encoding") {
+  TextArena none;
+  PointerEvent pen{};
+  pen.deviceType = PointerDeviceType::Pen;
+  pen.phase = PointerPhase::Cancel;
+  pen.x = -40;
+  pen.y = 1200;
+  pen.deltaY = 7;
+  pen.tiltX = -12.5f;
+  pen.distance = 0.25f;
+  pen.buttonMask = 0x80000000u;
+  pen.isPrimary = false;
+
+  std::vector<uint8_t> bytes;
+  encodeEventLogHeader(bytes);
+  EventLogEncoder encoder;
+  const Event move = pointer_move(1u, Clock::time_point{}, 500, 500);
+  const Event down = surface_event(1u, Clock::time_point{}, InputEvent{pen});
+  PH_REQUIRE(encoder.encodeEvent(move, none.bytes(), bytes).has_value());
+  PH_REQUIRE(encoder.encodeEvent(down, none.bytes(), bytes).has_value());
+
+  EventLogDecoder decoder(bytes);
+  Event event{};
+  EventLogFrame frame{};
+  TextArena text;
+  PH_REQUIRE(decoder.next(event, frame, text).has_value());
+  PH_REQUIRE(decoder.next(event, frame, text).has_value());
+  const auto& pointer = std::get<PointerEvent>(std::get<InputEvent>(event.payload));
+  PH_CHECK(pointer.deviceType == PointerDeviceType::Pen);
+  PH_CHECK(pointer.phase == PointerPhase::Cancel);
+  PH_CHECK(pointer.x == -40);
+  PH_CHECK(pointer.y == 1200);
+  PH_CHECK(!pointer.deltaX.has_value());
+  PH_CHECK(pointer.deltaY == std::optional<int32_t>(7));
+  PH_CHECK(pointer.tiltX == std::optional<float>(-12.5f));
+  PH_CHECK(!pointer.tiltY.has_value());
+  PH_CHECK(pointer.distance == std::optional<float>(0.25f));
+  PH_CHECK(pointer.buttonMask == 0x80000000u);
+  PH_CHECK(!pointer.isPrimary);
+}
+
+PH_TEST("primehost.eventlog", "pointer streams stay compact") {
+  TextArena none;
+  std::vector<uint8_t> bytes;
+  EventLogEncoder encoder;
+  const auto t0 = Clock::time_point(5'000'000'000ns);
+  constexpr int kMoves = 1000;
+  for (int i = 0; i < kMoves; ++i) {
+    const Event event = pointer_move(1u, t0 + i * 1ms, 400 + i % 7, 300 - i % 5);
+    PH_REQUIRE(encoder.encodeEvent(event, none.bytes(), bytes).has_value());
+  }
+  // After the first record: tag, 1ms delta, surface, device, pointer, packed flags, two small
+  // position deltas, presence mask and buttons.
+  PH_CHECK(bytes.size() <= 16u + static_cast<size_t>(kMoves - 1) * 12u);
+  PH_CHECK(bytes.size() * 4u < static_cast<size_t>(kMoves) * sizeof(Event));
+}
+
+PH_TEST("primehost.eventlog", "corrupt logs are rejected") {
+  TextArena source;
+  auto hello = source.append("hello");
+  PH_REQUIRE(hello.has_value());
+  std::vector<uint8_t> bytes;
+  encodeEventLogHeader(bytes);
+  EventLogEncoder encoder;
+  const Event text = surface_event(1u, Clock::time_point{}, InputEvent{TextEvent{0u, *hello}});
+  PH_REQUIRE(encoder.encodeEvent(text, source.bytes(), bytes).has_value());
+
+  Event event{};
+  EventLogFrame frame{};
+  TextArena arena;
+
+  std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 2);
+  EventLogDecoder truncatedDecoder(truncated);
+  PH_CHECK(!truncatedDecoder.next(event, frame, arena).has_value());
+
+  std::vector<uint8_t> badType = bytes;
+  // Every 4-bit type is taken since DisplayEvent, so corrupt the tag into a flagged end marker.
+  badType[5] = 0x20u;
+  EventLogDecoder badTypeDecoder(badType);
+  PH_CHECK(!badTypeDecoder.next(event, frame, arena).has_value());
+
+  std::vector<uint8_t> badMagic = bytes;
+  badMagic[0] = 'X';
+  EventLogDecoder badMagicDecoder(badMagic);
+  PH_CHECK(!badMagicDecoder.valid());
+  PH_CHECK(!badMagicDecoder.next(event, frame, arena).has_value());
+
+  // Spans outside the batch text are refused before anything is written.
+  const size_t before = bytes.size();
+  const Event outside = surface_event(1u, Clock::time_point{}, InputEvent{TextEvent{0u, TextSpan{3u, 10u}}});
+  PH_CHECK(!encoder.encodeEvent(outside, source.bytes(), bytes).has_value());
+  PH_CHECK(bytes.size() == before);
+}
+
+PH_TEST("primehost.eventlog", "zero padding ends the log") {
+  TextArena none;
+  std::vector<uint8_t> bytes;
+  encodeEventLogHeader(bytes);
+  EventLogEncoder encoder;
+  PH_REQUIRE(encoder.encodeEvent(pointer_move(1u, Clock::time_point{}, 1, 2), none.bytes(), bytes).has_value());
+  bytes.resize(bytes.size() + 64u, 0u);
+
+  EventLogDecoder decoder(bytes);
+  Event event{};
+  EventLogFrame frame{};
+  TextArena text;
+  auto first = decoder.next(event, frame, text);
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(first->has_value());
+  auto end = decoder.next(event, frame, text);
+  PH_REQUIRE(end.has_value());
+  PH_CHECK(!end->has_value());
+}
+
+PH_TEST("primehost.eventlog", "recorder output replays through ReplayHost") {
+  const auto path = temp_log("primehost_replay.phel");
+  const auto t0 = Clock::now();
+  TextArena text;
+  auto typed = text.append("ok");
+  PH_REQUIRE(typed.has_value());
+  uint64_t written = 0u;
+  {
+    auto recorder = createEventRecorder(path.string());
+    PH_REQUIRE(recorder.has_value());
+    std::array<Event, 3> batch{
+        surface_event(7u, t0, ResizeEvent{320u, 200u, 2.0f}),
+        pointer_move(7u, t0 + 1ms, 10, 20),
+        surface_event(7u, t0 + 2ms, InputEvent{TextEvent{0u, *typed}}),
+    };
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{batch, text.bytes()}).has_value());
+    const FrameTiming timing{t0 + 3ms, 16ms, 1u};
+    PH_REQUIRE((*recorder)->recordFrame(SurfaceId{7u}, timing, FrameDiagnostics{}).has_value());
+    std::array<Event, 1> after{pointer_move(7u, t0 + 4ms, 11, 22)};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{after, {}}).has_value());
+    PH_REQUIRE((*recorder)->flush().has_value());
+    written = (*recorder)->bytesWritten();
+  }
+  // Closing trims the preallocated mapping to the records written.
+  PH_CHECK(written < 96u);
+  PH_CHECK(read_file(path).size() == written);
+
+  auto replay = createReplayHost(ReplayConfig{path.string(), 0.0});
+  PH_REQUIRE(replay.has_value());
+  ReplayHost& host = **replay;
+  auto surface = host.createSurface(SurfaceConfig{100u, 100u, true, true, std::nullopt});
+  PH_REQUIRE(surface.has_value());
+  PH_CHECK(surface->value == 7u);
+
+  std::vector<uint64_t> frames;
+  Callbacks callbacks{};
+  callbacks.onFrame = [&](SurfaceId id, const FrameTiming& timing, const FrameDiagnostics&) {
+    frames.push_back(id.value);
+    PH_CHECK(timing.frameIndex == 1u);
+  };
+  PH_REQUIRE(host.setCallbacks(std::move(callbacks)).has_value());
+
+  std::array<Event, 8> storage{};
+  std::array<char, 16> textBytes{};
+  auto batch = host.pollEvents(EventBuffer{storage, textBytes});
+  PH_REQUIRE(batch.has_value());
+  PH_REQUIRE(batch->events.size() == 3u);
+  PH_CHECK(frames.empty());
+  const auto& typedEvent = std::get<TextEvent>(std::get<InputEvent>(batch->events[2].payload));
+  PH_CHECK(std::string_view(batch->textBytes.data() + typedEvent.text.offset, typedEvent.text.length) == "ok");
+  PH_CHECK(batch->events[1].time - batch->events[0].time == 1ms);
+
+  // The resize was applied to the headless surface, so frame buffers follow the recording.
+  auto buffer = host.acquireFrameBuffer(*surface);
+  PH_REQUIRE(buffer.has_value());
+  PH_CHECK(buffer->size.width == 640u);
+  PH_CHECK(buffer->size.height == 400u);
+  PH_CHECK(host.presentFrameBuffer(*surface, *buffer).has_value());
+
+  PH_REQUIRE(host.waitEvents().has_value());
+  PH_CHECK(frames == std::vector<uint64_t>{7u});
+  auto lastBatch = host.pollEvents(EventBuffer{storage, textBytes});
+  PH_REQUIRE(lastBatch.has_value());
+  PH_REQUIRE(lastBatch->events.size() == 1u);
+  PH_CHECK(std::get<PointerEvent>(std::get<InputEvent>(lastBatch->events[0].payload)).y == 22);
+  PH_CHECK(host.finished());
+  PH_CHECK(host.replayedEvents() == 4u);
+  PH_CHECK(host.replayedFrames() == 1u);
+  PH_CHECK(host.waitEvents().has_value());
+
+  replay->reset();
+  std::filesystem::remove(path);
+}
+
+PH_TEST("primehost.eventlog", "records the file cannot hold are dropped without shifting later ones") {
+  const auto path = temp_log("primehost_replay_full.phel");
+  const auto t0 = Clock::now();
+  {
+    auto recorder = createEventRecorder(path.string());
+    PH_REQUIRE(recorder.has_value());
+    std::array<Event, 1> first{pointer_move(3u, t0, 10, 20)};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{first, {}}).has_value());
+
+    // Cap the file at its preallocated size so the next large batch cannot grow it.
+    rlimit saved{};
+    PH_REQUIRE(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+    auto* previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit capped = saved;
+    capped.rlim_cur = static_cast<rlim_t>(std::filesystem::file_size(path));
+    PH_REQUIRE(setrlimit(RLIMIT_FSIZE, &capped) == 0);
+    std::vector<Event> burst;
+    for (int32_t i = 0; i < 300000; ++i) {
+      burst.push_back(pointer_move(3u, t0 + 1ms + std::chrono::microseconds(i), 5000 + i, -5000 - i));
+    }
+    const auto overflow = (*recorder)->recordEvents(EventBatch{burst, {}});
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, previousHandler);
+    PH_CHECK(!overflow.has_value());
+    PH_CHECK((*recorder)->droppedRecords() == burst.size());
+
+    std::array<Event, 1> after{pointer_move(3u, t0 + 2ms, 11, 22)};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{after, {}}).has_value());
+  }
+
+  auto replay = createReplayHost(ReplayConfig{path.string(), 0.0});
+  PH_REQUIRE(replay.has_value());
+  std::array<Event, 4> storage{};
+  auto batch = (*replay)->pollEvents(EventBuffer{storage, {}});
+  PH_REQUIRE(batch.has_value());
+  PH_REQUIRE(batch->events.size() == 2u);
+  const auto& moved = std::get<PointerEvent>(std::get<InputEvent>(batch->events[1].payload));
+  PH_CHECK(moved.x == 11);
+  PH_CHECK(moved.y == 22);
+  PH_CHECK(batch->events[1].time - batch->events[0].time == 2ms);
+
+  replay->reset();
+  std::filesystem::remove(path);
+}
+
+PH_TEST("primehost.eventlog", "paced replay waits for recorded times") {
+  const auto path = temp_log("primehost_replay_paced.phel");
+  const auto t0 = Clock::now();
+  {
+    auto recorder = createEventRecorder(path.string());
+    PH_REQUIRE(recorder.has_value());
+    std::array<Event, 2> batch{pointer_move(1u, t0, 0, 0), pointer_move(1u, t0 + 40ms, 1, 1)};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{batch, {}}).has_value());
+  }
+
+  auto replay = createReplayHost(ReplayConfig{path.string(), 2.0});
+  PH_REQUIRE(replay.has_value());
+  ReplayHost& host = **replay;
+  std::array<Event, 4> storage{};
+  auto first = host.pollEvents(EventBuffer{storage, {}});
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(first->events.size() == 1u);
+  PH_CHECK(first->pending.events == 0u);
+
+  const auto waitStart = Clock::now();
+  PH_REQUIRE(host.waitEvents().has_value());
+  PH_CHECK(Clock::now() - waitStart >= 15ms);
+  auto second = host.pollEvents(EventBuffer{storage, {}});
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(second->events.size() == 1u);
+  PH_CHECK(host.finished());
+
+  replay->reset();
+  std::filesystem::remove(path);
+}
+
+PH_TEST("primehost.eventlog", "replay rejects missing and corrupt logs") {
+  PH_CHECK(!createReplayHost(ReplayConfig{"", 1.0}).has_value());
+  PH_CHECK(!createReplayHost(ReplayConfig{temp_log("primehost_missing.phel").string(), -1.0}).has_value());
+  PH_CHECK(!createReplayHost(ReplayConfig{temp_log("primehost_missing.phel").string(), 1.0}).has_value());
+
+  const auto path = temp_log("primehost_replay_corrupt.phel");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "PHEL" << static_cast<char>(EventLogVersion) << static_cast<char>(0x21) << static_cast<char>(0x80);
+  }
+  auto replay = createReplayHost(ReplayConfig{path.string(), 1.0});
+  PH_REQUIRE(!replay.has_value());
+  PH_CHECK(replay.error().code == HostErrorCode::InvalidConfig);
+  std::filesystem::remove(path);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,241 @@
+#include "PrimeHost/PrimeHost.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.framecapture");
+
+namespace {
+
+std::filesystem::path temp_path(const char* name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+std::vector<uint8_t> read_file(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Solid BGRA frame with row padding.
+struct Frame {
+  ImageSize size;
+  std::vector<uint8_t> pixels;
+
+  Frame(uint32_t width, uint32_t height, std::array<uint8_t, 4> bgra) : size{width, height} {
+    pixels.resize(static_cast<size_t>(stride()) * height, 0u);
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        std::memcpy(pixels.data() + static_cast<size_t>(y) * stride() + x * 4u, bgra.data(), 4u);
+      }
+    }
+  }
+
+  uint32_t stride() const { return size.width * 4u + 8u; }
+  ImageView view() const { return ImageView{size, stride(), ColorFormat::B8G8R8A8_UNORM, pixels}; }
+};
+
+} // namespace
+
+PH_TEST("primehost.framecapture", "y4m stream holds every frame") {
+  const auto path = temp_path("primehost_capture.y4m");
+  FrameCaptureConfig config{};
+  config.path = path.string();
+  config.frameRateNumerator = 30u;
+  {
+    auto sink = createFrameCaptureSink(config);
+    PH_REQUIRE(sink.has_value());
+    const Frame white(8u, 4u, {255u, 255u, 255u, 255u});
+    const Frame blue(8u, 4u, {255u, 0u, 0u, 255u});
+    for (int i = 0; i < 5; ++i) {
+      PH_CHECK((*sink)->submit(i % 2 == 0 ? white.view() : blue.view()).has_value());
+    }
+    PH_REQUIRE((*sink)->flush().has_value());
+    const FrameCaptureStats stats = (*sink)->stats();
+    PH_CHECK(stats.presented == 5u);
+    PH_CHECK(stats.written + stats.dropped == 5u);
+    PH_CHECK(stats.bytesWritten == read_file(path).size());
+  }
+
+  const auto bytes = read_file(path);
+  const std::string header = "YUV4MPEG2 W8 H4 F30:1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+  PH_REQUIRE(bytes.size() > header.size());
+  PH_CHECK(std::string(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(header.size())) == header);
+  const size_t frameBytes = 6u + 8u * 4u * 3u;
+  PH_CHECK((bytes.size() - header.size()) % frameBytes == 0u);
+  // White maps to Y=255, Cb=Cr=128.
+  const uint8_t* first = bytes.data() + header.size() + 6u;
+  PH_CHECK(first[0] == 255u);
+  PH_CHECK(first[32] == 128u);
+  PH_CHECK(first[64] == 128u);
+  std::filesystem::remove(path);
+}
+
+PH_TEST("primehost.framecapture", "rgba stream decimates and rejects size changes") {
+  const auto path = temp_path("primehost_capture.rgba");
+  FrameCaptureConfig config{};
+  config.path = path.string();
+  config.format = FrameCaptureFormat::Rgba;
+  config.frameStep = 2u;
+  config.queueDepth = 8u;
+  config.writeBufferBytes = 64u;
+  auto sink = createFrameCaptureSink(config);
+  PH_REQUIRE(sink.has_value());
+
+  const Frame frame(4u, 2u, {0x10u, 0x20u, 0x30u, 0x40u});
+  for (int i = 0; i < 6; ++i) {
+    PH_CHECK((*sink)->submit(frame.view()).has_value());
+    PH_REQUIRE((*sink)->flush().has_value());
+  }
+  const Frame larger(5u, 2u, {0u, 0u, 0u, 255u});
+  auto mismatch = (*sink)->submit(larger.view());
+  PH_REQUIRE(!mismatch.has_value());
+  PH_CHECK(mismatch.error().code == HostErrorCode::InvalidConfig);
+  PH_REQUIRE((*sink)->flush().has_value());
+
+  const FrameCaptureStats stats = (*sink)->stats();
+  PH_CHECK(stats.presented == 7u);
+  PH_CHECK(stats.decimated == 3u);
+  PH_CHECK(stats.rejected == 1u);
+  PH_CHECK(stats.dropped == 0u);
+  PH_CHECK(stats.written == 3u);
+
+  const auto bytes = read_file(path);
+  PH_REQUIRE(bytes.size() == 3u * 4u * 2u * 4u);
+  PH_CHECK(bytes[0] == 0x30u);
+  PH_CHECK(bytes[1] == 0x20u);
+  PH_CHECK(bytes[2] == 0x10u);
+  PH_CHECK(bytes[3] == 0x40u);
+  sink->reset();
+  std::filesystem::remove(path);
+}
+
+PH_TEST("primehost.framecapture", "image sequence numbers files by presented frame") {
+  const auto dir = temp_path("primehost_capture_seq");
+  std::filesystem::remove_all(dir);
+  FrameCaptureConfig config{};
+  config.path = dir.string();
+  config.format = FrameCaptureFormat::ImageSequence;
+  config.frameStep = 2u;
+  config.image.format = ImageFileFormat::Qoi;
+  auto sink = createFrameCaptureSink(config);
+  PH_REQUIRE(sink.has_value());
+
+  const Frame frame(6u, 3u, {1u, 2u, 3u, 255u});
+  for (int i = 0; i < 4; ++i) {
+    PH_CHECK((*sink)->submit(frame.view()).has_value());
+    PH_REQUIRE((*sink)->flush().has_value());
+  }
+  PH_CHECK(std::filesystem::exists(dir / "frame_000000.qoi"));
+  PH_CHECK(!std::filesystem::exists(dir / "frame_000001.qoi"));
+  PH_CHECK(std::filesystem::exists(dir / "frame_000002.qoi"));
+  const auto qoi = read_file(dir / "frame_000002.qoi");
+  PH_REQUIRE(qoi.size() > 4u);
+  PH_CHECK(std::memcmp(qoi.data(), "qoif", 4u) == 0);
+  sink->reset();
+  std::filesystem::remove_all(dir);
+}
+
+PH_TEST("primehost.framecapture", "a full queue drops frames instead of blocking") {
+  const auto dir = temp_path("primehost_capture_drop");
+  std::filesystem::remove_all(dir);
+  FrameCaptureConfig config{};
+  config.path = dir.string();
+  config.format = FrameCaptureFormat::ImageSequence;
+  config.queueDepth = 1u;
+  config.image.threadCount = 1u;
+  auto sink = createFrameCaptureSink(config);
+  PH_REQUIRE(sink.has_value());
+
+  // Submitting copies ~4 MB; writing encodes a 1024x1024 PNG, so the writer cannot keep up.
+  const Frame frame(1024u, 1024u, {9u, 99u, 199u, 255u});
+  constexpr uint64_t kFrames = 48u;
+  for (uint64_t i = 0; i < kFrames; ++i) {
+    PH_CHECK((*sink)->submit(frame.view()).has_value());
+  }
+  PH_REQUIRE((*sink)->flush().has_value());
+  const FrameCaptureStats stats = (*sink)->stats();
+  PH_CHECK(stats.presented == kFrames);
+  PH_CHECK(stats.dropped > 0u);
+  PH_CHECK(stats.written + stats.dropped == kFrames);
+  sink->reset();
+  std::filesystem::remove_all(dir);
+}
+
+PH_TEST("primehost.framecapture", "invalid configs are rejected") {
+  FrameCaptureConfig config{};
+  PH_CHECK(!createFrameCaptureSink(config).has_value());
+  config.path = temp_path("primehost_capture_invalid.y4m").string();
+  config.frameStep = 0u;
+  PH_CHECK(!createFrameCaptureSink(config).has_value());
+  config.frameStep = 1u;
+  config.queueDepth = 0u;
+  PH_CHECK(!createFrameCaptureSink(config).has_value());
+  config.queueDepth = 65u;
+  PH_CHECK(!createFrameCaptureSink(config).has_value());
+  config.queueDepth = 2u;
+  config.path = (temp_path("primehost_capture_missing") / "nested" / "out.y4m").string();
+  auto missing = createFrameCaptureSink(config);
+  PH_REQUIRE(!missing.has_value());
+  PH_CHECK(missing.error().code == HostErrorCode::PlatformFailure);
+}
+
+PH_TEST("primehost.framecapture", "attached sink sees replay host presents") {
+  const auto logPath = temp_path("primehost_capture_replay.phel");
+  {
+    auto recorder = createEventRecorder(logPath.string());
+    PH_REQUIRE(recorder.has_value());
+    Event resize{};
+    resize.scope = Event::Scope::Surface;
+    resize.surfaceId = SurfaceId{1u};
+    resize.time = std::chrono::steady_clock::now();
+    resize.payload = ResizeEvent{16u, 8u, 1.0f};
+    std::array<Event, 1> batch{resize};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{batch, {}}).has_value());
+  }
+  auto replay = createReplayHost(ReplayConfig{logPath.string(), 0.0});
+  PH_REQUIRE(replay.has_value());
+  ReplayHost& host = **replay;
+  auto surface = host.createSurface(SurfaceConfig{16u, 8u, true, true, std::nullopt});
+  PH_REQUIRE(surface.has_value());
+
+  const auto capturePath = temp_path("primehost_capture_replay.rgba");
+  FrameCaptureConfig config{};
+  config.path = capturePath.string();
+  config.format = FrameCaptureFormat::Rgba;
+  auto sink = createFrameCaptureSink(config);
+  PH_REQUIRE(sink.has_value());
+  PH_CHECK(!host.setSurfaceCaptureSink(SurfaceId{99u}, *sink).has_value());
+  PH_REQUIRE(host.setSurfaceCaptureSink(*surface, *sink).has_value());
+
+  for (int i = 0; i < 3; ++i) {
+    auto buffer = host.acquireFrameBuffer(*surface);
+    PH_REQUIRE(buffer.has_value());
+    PH_REQUIRE(host.presentFrameBuffer(*surface, *buffer).has_value());
+    PH_REQUIRE((*sink)->flush().has_value());
+  }
+  PH_REQUIRE(host.setSurfaceCaptureSink(*surface, nullptr).has_value());
+  auto buffer = host.acquireFrameBuffer(*surface);
+  PH_REQUIRE(buffer.has_value());
+  PH_REQUIRE(host.presentFrameBuffer(*surface, *buffer).has_value());
+
+  PH_REQUIRE((*sink)->flush().has_value());
+  PH_CHECK((*sink)->stats().presented == 3u);
+  PH_CHECK((*sink)->stats().written == 3u);
+  PH_CHECK(read_file(capturePath).size() == 3u * buffer->pixels.size());
+
+  sink->reset();
+  replay->reset();
+  std::filesystem::remove(capturePath);
+  std::filesystem::remove(logPath);
+}
+
+TEST_SUITE_END();
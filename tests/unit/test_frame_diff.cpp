@@ -0,0 +1,180 @@
+#include "PrimeHost/PrimeHost.h"
+#include "PixelDiffKernels.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.framediff");
+
+namespace {
+
+struct Frame {
+  ImageSize size;
+  uint32_t stride = 0u;
+  std::vector<uint8_t> pixels;
+
+  Frame(uint32_t width, uint32_t height) : size{width, height}, stride(width * 4u + 16u) {
+    pixels.resize(static_cast<size_t>(stride) * height);
+    uint32_t seed = 99u;
+    for (uint8_t& byte : pixels) {
+      seed = seed * 1664525u + 1013904223u;
+      byte = static_cast<uint8_t>(seed >> 24u);
+    }
+  }
+
+  uint8_t* pixel(uint32_t x, uint32_t y) { return pixels.data() + static_cast<size_t>(y) * stride + x * 4u; }
+  ImageView view() const { return ImageView{size, stride, ColorFormat::B8G8R8A8_UNORM, pixels}; }
+};
+
+} // namespace
+
+PH_TEST("primehost.framediff", "kernel matches the scalar reference on every tail length") {
+  std::vector<uint8_t> a(67u * 4u);
+  std::vector<uint8_t> b(67u * 4u);
+  uint32_t seed = 7u;
+  for (size_t i = 0; i < a.size(); ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    a[i] = static_cast<uint8_t>(seed >> 24u);
+    // Mostly small deltas so the threshold splits pixels both ways.
+    b[i] = static_cast<uint8_t>(a[i] + ((seed >> 8u) % 7u) - 3u);
+  }
+  for (uint8_t threshold : {0u, 2u, 255u}) {
+    for (uint32_t mask : {0xFFFFFFFFu, 0x00FFFFFFu}) {
+      PixelDiffParams params{};
+      params.threshold = threshold;
+      params.channelMask = mask;
+      for (uint32_t count = 0u; count <= 67u; ++count) {
+        std::vector<uint8_t> fast(count * 4u);
+        std::vector<uint8_t> slow(count * 4u);
+        const PixelDiffRun run = diffPixels(a.data(), b.data(), fast.data(), count, params);
+        PixelDiffRun reference{};
+        diffPixelsScalar(a.data(), b.data(), slow.data(), 0u, count, params, reference);
+        PH_CHECK(run.differing == reference.differing);
+        PH_CHECK(run.maxDelta == reference.maxDelta);
+        if (reference.differing != 0u) {
+          PH_CHECK(run.first == reference.first);
+          PH_CHECK(run.last == reference.last);
+        }
+        PH_CHECK(fast == slow);
+      }
+    }
+  }
+}
+
+PH_TEST("primehost.framediff", "identical frames report no differences") {
+  const Frame frame(130u, 70u);
+  auto result = diffImages(frame.view(), frame.view());
+  PH_REQUIRE(result.has_value());
+  PH_CHECK(result->maxChannelDelta == 0u);
+  PH_CHECK(result->differingPixels == 0u);
+  PH_CHECK(result->differingTiles == 0u);
+  PH_CHECK(result->bounds.width == 0u);
+}
+
+PH_TEST("primehost.framediff", "differences are located per tile") {
+  const Frame expected(200u, 100u);
+  Frame actual = expected;
+  // Two pixels in tile (0, 0) and one in tile (3, 1) with tileSize 64.
+  actual.pixel(3u, 5u)[1] ^= 0x40u;
+  actual.pixel(10u, 20u)[2] ^= 0x01u;
+  actual.pixel(199u, 99u)[0] ^= 0x80u;
+  // Alpha-only change.
+  actual.pixel(100u, 50u)[3] ^= 0x10u;
+
+  std::array<DiffRect, 1> tiles{};
+  std::vector<uint8_t> diff(200u * 100u * 4u);
+  FrameDiffConfig config{};
+  config.compareAlpha = false;
+  auto result = diffImages(expected.view(), actual.view(), config, FrameDiffOutput{tiles, diff});
+  PH_REQUIRE(result.has_value());
+  PH_CHECK(result->differingPixels == 3u);
+  PH_CHECK(result->differingTiles == 2u);
+  PH_CHECK(result->maxChannelDelta == 0x80u);
+  PH_CHECK(tiles[0].x == 3u);
+  PH_CHECK(tiles[0].y == 5u);
+  PH_CHECK(tiles[0].width == 8u);
+  PH_CHECK(tiles[0].height == 16u);
+  PH_CHECK(result->bounds.x == 3u);
+  PH_CHECK(result->bounds.y == 5u);
+  PH_CHECK(result->bounds.width == 197u);
+  PH_CHECK(result->bounds.height == 95u);
+
+  const uint8_t* red = diff.data() + (5u * 200u + 3u) * 4u;
+  PH_CHECK(red[0] == 0u);
+  PH_CHECK(red[1] == 0u);
+  PH_CHECK(red[2] == 255u);
+  PH_CHECK(red[3] == 255u);
+  const uint8_t* same = diff.data();
+  PH_CHECK(same[0] == 0u);
+  PH_CHECK(same[3] == 255u);
+
+  // The threshold absorbs the one-step change; alpha now counts.
+  config.threshold = 1u;
+  config.compareAlpha = true;
+  result = diffImages(expected.view(), actual.view(), config);
+  PH_REQUIRE(result.has_value());
+  PH_CHECK(result->differingPixels == 3u);
+  PH_CHECK(result->differingTiles == 3u);
+}
+
+PH_TEST("primehost.framediff", "results do not depend on thread count or tile size") {
+  const Frame expected(333u, 257u);
+  Frame actual = expected;
+  for (uint32_t i = 0; i < 500u; ++i) {
+    actual.pixel((i * 37u) % 333u, (i * 91u) % 257u)[i % 4u] += static_cast<uint8_t>(1u + i % 9u);
+  }
+  FrameDiffConfig config{};
+  config.threshold = 2u;
+  config.threadCount = 1u;
+  std::vector<uint8_t> diffSingle(333u * 257u * 4u);
+  auto single = diffImages(expected.view(), actual.view(), config, FrameDiffOutput{{}, diffSingle});
+  PH_REQUIRE(single.has_value());
+  PH_CHECK(single->differingPixels > 0u);
+  for (uint32_t threads : {2u, 8u}) {
+    for (uint32_t tileSize : {16u, 64u, 1000u}) {
+      config.threadCount = threads;
+      config.tileSize = tileSize;
+      std::vector<uint8_t> diff(diffSingle.size());
+      auto result = diffImages(expected.view(), actual.view(), config, FrameDiffOutput{{}, diff});
+      PH_REQUIRE(result.has_value());
+      PH_CHECK(result->differingPixels == single->differingPixels);
+      PH_CHECK(result->maxChannelDelta == single->maxChannelDelta);
+      PH_CHECK(result->bounds.width == single->bounds.width);
+      PH_CHECK(diff == diffSingle);
+    }
+  }
+}
+
+PH_TEST("primehost.framediff", "rgba image data and invalid inputs") {
+  std::vector<uint8_t> a(4u * 3u * 4u, 0x20u);
+  std::vector<uint8_t> b = a;
+  b[5u * 4u] = 0x30u;
+  std::vector<uint8_t> diff(a.size());
+  auto result = diffImages(ImageData{{4u, 3u}, a}, ImageData{{4u, 3u}, b}, {}, FrameDiffOutput{{}, diff});
+  PH_REQUIRE(result.has_value());
+  PH_CHECK(result->differingPixels == 1u);
+  PH_CHECK(result->bounds.x == 1u);
+  PH_CHECK(result->bounds.y == 1u);
+  PH_CHECK(diff[5u * 4u] == 255u);
+  PH_CHECK(diff[5u * 4u + 2u] == 0u);
+
+  auto mismatch = diffImages(ImageData{{4u, 3u}, a}, ImageData{{3u, 4u}, b});
+  PH_REQUIRE(!mismatch.has_value());
+  PH_CHECK(mismatch.error().code == HostErrorCode::InvalidConfig);
+  auto truncated = diffImages(ImageData{{4u, 3u}, a}, ImageData{{4u, 3u}, std::span<const uint8_t>(b).first(40u)});
+  PH_CHECK(!truncated.has_value());
+  FrameDiffConfig zeroTiles{};
+  zeroTiles.tileSize = 0u;
+  PH_CHECK(!diffImages(ImageData{{4u, 3u}, a}, ImageData{{4u, 3u}, b}, zeroTiles).has_value());
+  std::vector<uint8_t> small(8u);
+  auto tooSmall = diffImages(ImageData{{4u, 3u}, a}, ImageData{{4u, 3u}, b}, {}, FrameDiffOutput{{}, small});
+  PH_REQUIRE(!tooSmall.has_value());
+  PH_CHECK(tooSmall.error().code == HostErrorCode::BufferTooSmall);
+}
+
+TEST_SUITE_END();
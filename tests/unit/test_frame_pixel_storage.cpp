@@ -0,0 +1,90 @@
+#include "FramePixelStorage.h"
+#include "PrimeHost/PrimeHost.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.framepixelstorage");
+
+PH_TEST("primehost.framepixelstorage", "padded rows are an odd number of cache lines") {
+  PH_CHECK(frameBufferStride(100u, FrameBufferLayout::Packed) == 400u);
+  PH_CHECK(frameBufferStride(100u, FrameBufferLayout::Padded) == 448u);
+  PH_CHECK(frameBufferStride(1024u, FrameBufferLayout::Packed) == 4096u);
+  PH_CHECK(frameBufferStride(1024u, FrameBufferLayout::Padded) == 4160u);
+  PH_CHECK(frameBufferStride(1536u, FrameBufferLayout::Padded) == 6208u);
+  PH_CHECK(frameBufferStride(2560u, FrameBufferLayout::Padded) == 10304u);
+  PH_CHECK(frameBufferStride(3840u, FrameBufferLayout::Padded) == 15424u);
+  PH_CHECK(frameBufferStride(4096u, FrameBufferLayout::Padded) == 16448u);
+  PH_CHECK(frameBufferStride(7680u, FrameBufferLayout::Padded) == 30784u);
+  for (uint32_t width = 1u; width <= 8192u; ++width) {
+    const uint32_t stride = *frameBufferStride(width, FrameBufferLayout::Padded);
+    PH_CHECK(std::gcd(stride, 4096u) == 64u);
+  }
+  PH_CHECK(!frameBufferStride(UINT32_MAX, FrameBufferLayout::Padded).has_value());
+}
+
+PH_TEST("primehost.framepixelstorage", "storage is page aligned, zeroed and reused when it fits") {
+  FramePixelStorage storage;
+  PH_REQUIRE(storage.resize(10000u, FrameBufferPolicy{}));
+  PH_REQUIRE(storage.data() != nullptr);
+  PH_CHECK(reinterpret_cast<uintptr_t>(storage.data()) % 4096u == 0u);
+  PH_CHECK(storage.size() == 10000u);
+  PH_CHECK(storage.capacity() >= 10000u);
+  auto pixels = storage.span();
+  PH_CHECK(std::all_of(pixels.begin(), pixels.end(), [](uint8_t value) { return value == 0u; }));
+
+  std::fill(pixels.begin(), pixels.end(), uint8_t{0x7Fu});
+  const uint8_t* mapping = storage.data();
+  // Same size keeps the contents; a smaller one reuses the mapping but starts from zero.
+  PH_REQUIRE(storage.resize(10000u, FrameBufferPolicy{}));
+  PH_CHECK(storage.data()[9999] == 0x7Fu);
+  PH_REQUIRE(storage.resize(5000u, FrameBufferPolicy{}));
+  PH_CHECK(storage.data() == mapping);
+  pixels = storage.span();
+  PH_CHECK(std::all_of(pixels.begin(), pixels.end(), [](uint8_t value) { return value == 0u; }));
+
+  FramePixelStorage moved = std::move(storage);
+  PH_CHECK(moved.data() == mapping);
+  PH_CHECK(storage.data() == nullptr);
+
+  FrameBufferPolicy huge{};
+  huge.hugePages = true;
+  huge.firstTouch = true;
+  PH_REQUIRE(moved.resize(3u << 20u, huge));
+  PH_CHECK(reinterpret_cast<uintptr_t>(moved.data()) % HugePageSize == 0u);
+  PH_CHECK(moved.capacity() == 4u << 20u);
+  // Untouched pages still read as zero.
+  PH_CHECK(moved.data()[(3u << 20u) - 1u] == 0u);
+}
+
+PH_TEST("primehost.framepixelstorage", "frame buffers report the padded stride") {
+  const auto logPath = std::filesystem::temp_directory_path() / "primehost_frame_pixel_storage.phel";
+  {
+    auto recorder = createEventRecorder(logPath.string());
+    PH_REQUIRE(recorder.has_value());
+  }
+  auto host = createReplayHost(ReplayConfig{logPath.string(), 0.0});
+  std::filesystem::remove(logPath);
+  PH_REQUIRE(host.has_value());
+
+  auto surface = (*host)->createSurface(SurfaceConfig{1024u, 8u, false, true, std::nullopt});
+  PH_REQUIRE(surface.has_value());
+  FrameConfig config{};
+  config.bufferPolicy.layout = FrameBufferLayout::Padded;
+  PH_REQUIRE((*host)->setFrameConfig(*surface, config).has_value());
+
+  auto buffer = (*host)->acquireFrameBuffer(*surface);
+  PH_REQUIRE(buffer.has_value());
+  PH_CHECK(buffer->size.width == 1024u);
+  PH_CHECK(buffer->stride == 4160u);
+  PH_CHECK(buffer->pixels.size() == 4160u * 8u);
+  PH_CHECK(reinterpret_cast<uintptr_t>(buffer->pixels.data()) % 64u == 0u);
+  PH_CHECK((*host)->presentFrameBuffer(*surface, *buffer).has_value());
+}
+
+TEST_SUITE_END();
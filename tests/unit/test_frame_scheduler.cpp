@@ -0,0 +1,168 @@
+#include "FrameScheduler.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <chrono>
+#include <map>
+
+using namespace PrimeHost;
+using namespace std::chrono_literals;
+
+TEST_SUITE_BEGIN("primehost.framescheduler");
+
+namespace {
+
+using Clock = FrameScheduler::Clock;
+
+constexpr std::chrono::nanoseconds kTick144{6'944'445};
+constexpr std::chrono::nanoseconds kTick30{33'333'334};
+constexpr std::chrono::nanoseconds kTick60{16'666'667};
+
+// Drives `scheduler` with display ticks for `duration` and counts frames per surface.
+std::map<uint64_t, int> runDisplayTicks(FrameScheduler& scheduler,
+                                        Clock::time_point start,
+                                        std::chrono::nanoseconds tick,
+                                        std::chrono::nanoseconds duration) {
+  std::map<uint64_t, int> frames;
+  std::array<uint64_t, 8> due{};
+  for (auto now = start; now < start + duration; now += tick) {
+    const size_t count = scheduler.collectDue(now, tick / 2, due);
+    for (size_t i = 0; i < count; ++i) {
+      ++frames[due[i]];
+    }
+  }
+  return frames;
+}
+
+} // namespace
+
+PH_TEST("primehost.framescheduler", "surfaces keep independent cadences on a shared display") {
+  FrameScheduler scheduler;
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, 0ns, start);
+  scheduler.setSurface(2u, kTick30, start);
+  scheduler.setPriority(1u, FramePriority::Focused);
+
+  auto frames = runDisplayTicks(scheduler, start, kTick144, 1s);
+  PH_CHECK(frames[1u] == 144);
+  PH_CHECK(frames[2u] >= 29);
+  PH_CHECK(frames[2u] <= 31);
+}
+
+PH_TEST("primehost.framescheduler", "wakes only when a surface is due") {
+  FrameScheduler scheduler;
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, kTick60, start);
+  scheduler.setSurface(2u, kTick30, start);
+
+  std::map<uint64_t, int> frames;
+  int wakes = 0;
+  std::array<uint64_t, 4> due{};
+  auto now = start;
+  while (auto wake = scheduler.nextWake()) {
+    if (*wake >= start + 1s) {
+      break;
+    }
+    now = std::max(now, *wake);
+    const size_t count = scheduler.collectDue(now, 0ns, due);
+    PH_REQUIRE(count > 0u);
+    ++wakes;
+    for (size_t i = 0; i < count; ++i) {
+      ++frames[due[i]];
+    }
+  }
+  PH_CHECK(frames[1u] == 60);
+  PH_CHECK(frames[2u] == 30);
+  // Each wake served at least one surface; the 30 Hz surface never forces extra wakes.
+  PH_CHECK(wakes <= 90);
+}
+
+PH_TEST("primehost.framescheduler", "new surfaces with the same interval are staggered") {
+  FrameScheduler scheduler;
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, kTick30, start);
+  scheduler.setSurface(2u, kTick30, start);
+  std::array<uint64_t, 4> due{};
+  PH_CHECK(scheduler.collectDue(start, 0ns, due) == 1u);
+  PH_CHECK(due[0] == 1u);
+  PH_REQUIRE(scheduler.nextWake().has_value());
+  PH_CHECK(*scheduler.nextWake() == start + kTick30 / 2);
+}
+
+PH_TEST("primehost.framescheduler", "due surfaces come out in priority then join order") {
+  FrameScheduler scheduler;
+  const Clock::time_point start{};
+  scheduler.setSurface(10u, 0ns, start);
+  scheduler.setSurface(11u, 0ns, start);
+  scheduler.setSurface(12u, 0ns, start);
+  scheduler.setPriority(12u, FramePriority::Focused);
+
+  std::array<uint64_t, 3> due{};
+  PH_REQUIRE(scheduler.collectDue(start, 0ns, due) == 3u);
+  PH_CHECK(due[0] == 12u);
+  PH_CHECK(due[1] == 10u);
+  PH_CHECK(due[2] == 11u);
+
+  std::array<uint64_t, 1> one{};
+  PH_CHECK(scheduler.collectDue(start + 1ms, 0ns, one) == 1u);
+  PH_CHECK(one[0] == 12u);
+  PH_CHECK(scheduler.removeSurface(12u));
+  PH_CHECK(!scheduler.removeSurface(12u));
+  PH_CHECK(scheduler.collectDue(start + 1ms, 0ns, one) == 1u);
+  PH_CHECK(one[0] == 10u);
+}
+
+PH_TEST("primehost.framescheduler", "background and occluded surfaces are throttled") {
+  FrameSchedulerConfig config{};
+  config.backgroundInterval = 100ms;
+  config.occludedInterval = 250ms;
+  FrameScheduler scheduler(config);
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, kTick60, start);
+  scheduler.setSurface(2u, kTick60 + 1ns, start);
+  scheduler.setPriority(1u, FramePriority::Background);
+  scheduler.setOccluded(2u, true);
+
+  auto frames = runDisplayTicks(scheduler, start, 1ms, 1s);
+  PH_CHECK(frames[1u] == 10);
+  PH_CHECK(frames[2u] == 4);
+
+  // Uncovering pulls the deadline in, so the surface is due right away.
+  scheduler.setOccluded(2u, false);
+  std::array<uint64_t, 2> due{};
+  PH_CHECK(scheduler.collectDue(start + 1s, 0ns, due) >= 1u);
+  PH_CHECK(scheduler.contains(2u));
+}
+
+PH_TEST("primehost.framescheduler", "zero occluded interval pauses surfaces") {
+  FrameSchedulerConfig config{};
+  config.occludedInterval = 0ns;
+  FrameScheduler scheduler(config);
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, kTick60, start);
+  scheduler.setOccluded(1u, true);
+  PH_CHECK(!scheduler.nextWake().has_value());
+  std::array<uint64_t, 1> due{};
+  PH_CHECK(scheduler.collectDue(start + 1s, 0ns, due) == 0u);
+
+  scheduler.setOccluded(1u, false);
+  PH_REQUIRE(scheduler.nextWake().has_value());
+  PH_CHECK(scheduler.collectDue(start + 1s, 0ns, due) == 1u);
+}
+
+PH_TEST("primehost.framescheduler", "late wakes do not burst") {
+  FrameScheduler scheduler;
+  const Clock::time_point start{};
+  scheduler.setSurface(1u, kTick60, start);
+  std::array<uint64_t, 1> due{};
+  PH_CHECK(scheduler.collectDue(start, 0ns, due) == 1u);
+  // A stall of several intervals yields one frame, then the cadence restarts from now.
+  const auto late = start + 100ms;
+  PH_CHECK(scheduler.collectDue(late, 0ns, due) == 1u);
+  PH_CHECK(scheduler.collectDue(late, 0ns, due) == 0u);
+  PH_REQUIRE(scheduler.nextWake().has_value());
+  PH_CHECK(*scheduler.nextWake() == late + kTick60);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,339 @@
+#include "FrameSlots.h"
+#include "LatestValue.h"
+#include "SpscRing.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.frameslots");
+
+PH_TEST("primehost.frameslots", "slots cycle through acquire submit complete") {
+  FrameSlotTable slots;
+  PH_CHECK(!slots.acquire().has_value());
+  PH_CHECK(!slots.resize(0u));
+  PH_CHECK(!slots.resize(FrameSlotTable::MaxSlots + 1u));
+  PH_REQUIRE(slots.resize(2u));
+
+  auto first = slots.acquire();
+  auto second = slots.acquire();
+  PH_REQUIRE(first.has_value());
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(*first == 0u);
+  PH_CHECK(*second == 1u);
+  PH_CHECK(!slots.acquire().has_value());
+
+  PH_CHECK(!slots.complete(*first));
+  PH_CHECK(slots.submit(*first));
+  PH_CHECK(slots.state(*first) == FrameSlotState::InFlight);
+  PH_CHECK(!slots.release(*first));
+  PH_CHECK(slots.release(*second));
+  PH_CHECK(!slots.resize(3u));
+
+  // Round robin resumes after the last slot handed out, so slot 0 stays on the GPU.
+  auto third = slots.acquire();
+  PH_REQUIRE(third.has_value());
+  PH_CHECK(*third == 1u);
+  PH_CHECK(slots.release(*third));
+  PH_CHECK(slots.complete(*first));
+  PH_CHECK(slots.idle());
+  PH_CHECK(slots.resize(3u));
+  PH_CHECK(slots.count() == 3u);
+  PH_CHECK(!slots.submit(3u));
+}
+
+PH_TEST("primehost.frameslots", "pinned slot is skipped until released") {
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(2u));
+  PH_CHECK(slots.acquireSlot(1u));
+  PH_CHECK(!slots.acquireSlot(1u));
+  PH_CHECK(!slots.acquireSlot(2u));
+
+  auto first = slots.acquire();
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(*first == 0u);
+  PH_CHECK(!slots.acquire().has_value());
+
+  // Unpinning wakes a renderer waiting for a slot.
+  std::thread unpin([&slots]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    slots.release(1u);
+  });
+  auto second = slots.acquireUntil(std::chrono::steady_clock::now() + std::chrono::seconds(5), 0u);
+  unpin.join();
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(*second == 1u);
+  PH_CHECK(slots.release(*first));
+  PH_CHECK(slots.release(*second));
+  PH_CHECK(slots.idle());
+}
+
+PH_TEST("primehost.frameslots", "latest value yields only the newest publish") {
+  LatestValue<int> value;
+  int out = -1;
+  PH_CHECK(!value.consume(out));
+  PH_CHECK(out == -1);
+  value.publish(1);
+  value.publish(2);
+  value.publish(3);
+  PH_CHECK(value.consume(out));
+  PH_CHECK(out == 3);
+  PH_CHECK(!value.consume(out));
+  value.publish(4);
+  PH_CHECK(value.consume(out));
+  PH_CHECK(out == 4);
+}
+
+PH_TEST("primehost.frameslots", "acquire until times out when no slot frees") {
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(1u));
+  auto first = slots.acquire();
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(slots.submit(*first));
+
+  const auto start = std::chrono::steady_clock::now();
+  auto blocked = slots.acquireUntil(start + std::chrono::milliseconds(20), 0u);
+  PH_CHECK(!blocked.has_value());
+  PH_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+  PH_CHECK(slots.complete(*first));
+  auto next = slots.acquireUntil(std::chrono::steady_clock::time_point{}, 0u);
+  PH_CHECK(next.has_value());
+}
+
+PH_TEST("primehost.frameslots", "acquire until honours max frames in flight") {
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(3u));
+  auto first = slots.acquire();
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(slots.submit(*first));
+  PH_CHECK(slots.inFlight() == 1u);
+
+  const auto now = std::chrono::steady_clock::now();
+  PH_CHECK(!slots.acquireUntil(now, 1u).has_value());
+  auto second = slots.acquireUntil(now, 2u);
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(slots.release(*second));
+}
+
+PH_TEST("primehost.frameslots", "acquire until wakes on completion and close") {
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(2u));
+  for (int i = 0; i < 2; ++i) {
+    auto index = slots.acquire();
+    PH_REQUIRE(index.has_value());
+    PH_CHECK(slots.submit(*index));
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  std::thread gpu([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    slots.complete(1u);
+  });
+  auto woken = slots.acquireUntil(deadline, 0u);
+  gpu.join();
+  PH_REQUIRE(woken.has_value());
+  PH_CHECK(*woken == 1u);
+  PH_CHECK(slots.submit(*woken));
+
+  std::thread closer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    slots.close();
+  });
+  PH_CHECK(!slots.acquireUntil(deadline, 0u).has_value());
+  closer.join();
+  PH_CHECK(std::chrono::steady_clock::now() < deadline);
+  PH_CHECK(slots.closed());
+}
+
+namespace {
+
+struct RenderParams {
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+  uint64_t area = 0u;
+  uint32_t generation = 0u;
+};
+
+struct Pixels {
+  std::array<uint32_t, 64> words{};
+};
+
+} // namespace
+
+PH_TEST("primehost.frameslots", "mailbox shows only the newest posted frame") {
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(3u));
+  PH_CHECK(!slots.takePosted().has_value());
+
+  auto first = slots.acquire();
+  PH_REQUIRE(first.has_value());
+  PH_CHECK(slots.post(*first));
+  PH_CHECK(slots.state(*first) == FrameSlotState::Pending);
+  PH_CHECK(!slots.post(*first));
+  auto second = slots.acquire();
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(slots.post(*second));
+  PH_CHECK(slots.state(*first) == FrameSlotState::Free);
+  PH_CHECK(slots.takeSuperseded() == 1u);
+  PH_CHECK(slots.takeSuperseded() == 0u);
+
+  auto shown = slots.takePosted();
+  PH_REQUIRE(shown.has_value());
+  PH_CHECK(*shown == *second);
+  PH_CHECK(slots.state(*shown) == FrameSlotState::InFlight);
+  PH_CHECK(!slots.takePosted().has_value());
+  PH_CHECK(!slots.resize(2u));
+  PH_CHECK(slots.complete(*shown));
+  PH_CHECK(slots.idle());
+}
+
+// A render thread posting far faster than the display consumes never blocks, every frame is
+// either shown or superseded, and shown frames arrive in order with intact pixels.
+PH_TEST("primehost.frameslots", "mailbox keeps the renderer unthrottled") {
+  constexpr uint32_t kFrames = 20000u;
+  constexpr uint32_t kSlots = 3u;
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(kSlots));
+  std::array<Pixels, kSlots> pixels{};
+  std::atomic<bool> rendering{true};
+  std::atomic<bool> ordered{true};
+  std::atomic<bool> pixelsConsistent{true};
+  uint32_t shown = 0u;
+
+  std::thread display([&]() {
+    uint32_t last = 0u;
+    auto drain = [&]() {
+      auto index = slots.takePosted();
+      if (!index) {
+        return;
+      }
+      const Pixels& frame = pixels[*index];
+      for (uint32_t word : frame.words) {
+        if (word != frame.words[0]) {
+          pixelsConsistent.store(false, std::memory_order_relaxed);
+        }
+      }
+      if (frame.words[0] <= last) {
+        ordered.store(false, std::memory_order_relaxed);
+      }
+      last = frame.words[0];
+      ++shown;
+      slots.complete(*index);
+    };
+    while (rendering.load(std::memory_order_acquire)) {
+      drain();
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    drain();
+  });
+
+  // With three slots one can be on screen and one in the mailbox, so a third is always free.
+  uint32_t superseded = 0u;
+  uint32_t stalls = 0u;
+  for (uint32_t frame = 1u; frame <= kFrames;) {
+    auto index = slots.acquire();
+    if (!index) {
+      ++stalls;
+      std::this_thread::yield();
+      continue;
+    }
+    pixels[*index].words.fill(frame);
+    PH_CHECK(slots.post(*index));
+    superseded += slots.takeSuperseded();
+    ++frame;
+  }
+  rendering.store(false, std::memory_order_release);
+  display.join();
+  superseded += slots.takeSuperseded();
+
+  PH_CHECK(stalls == 0u);
+  PH_CHECK(ordered.load());
+  PH_CHECK(pixelsConsistent.load());
+  PH_CHECK(shown > 0u);
+  PH_CHECK(shown + superseded == kFrames);
+  PH_CHECK(slots.idle());
+}
+
+// Main thread publishes resizes, the render thread acquires/writes/submits, and a completion
+// thread reads the submitted pixels before freeing the slot. Slot pixels and params are plain
+// memory, so ThreadSanitizer flags any missing happens-before edge.
+PH_TEST("primehost.frameslots", "render thread handoff is race free") {
+  constexpr uint32_t kFrames = 4000u;
+  constexpr uint32_t kSlots = 3u;
+  FrameSlotTable slots;
+  PH_REQUIRE(slots.resize(kSlots));
+  std::array<Pixels, kSlots> pixels{};
+  LatestValue<RenderParams> params;
+  SpscRing<uint32_t> submitted;
+  submitted.reset(kSlots);
+  std::atomic<bool> rendering{true};
+  std::atomic<bool> paramsConsistent{true};
+  std::atomic<bool> pixelsConsistent{true};
+
+  std::thread main([&]() {
+    uint32_t generation = 0u;
+    while (rendering.load(std::memory_order_relaxed)) {
+      ++generation;
+      const uint32_t width = 16u + generation % 64u;
+      const uint32_t height = 9u + generation % 32u;
+      params.publish(RenderParams{width, height, static_cast<uint64_t>(width) * height, generation});
+      std::this_thread::yield();
+    }
+  });
+
+  std::thread gpu([&]() {
+    uint32_t completed = 0u;
+    while (completed < kFrames) {
+      uint32_t index = 0u;
+      if (!submitted.pop(index)) {
+        std::this_thread::yield();
+        continue;
+      }
+      const Pixels& frame = pixels[index];
+      for (uint32_t word : frame.words) {
+        if (word != frame.words[0]) {
+          pixelsConsistent.store(false, std::memory_order_relaxed);
+        }
+      }
+      PH_CHECK(slots.complete(index));
+      ++completed;
+    }
+  });
+
+  RenderParams view{};
+  uint32_t lastGeneration = 0u;
+  for (uint32_t frame = 1u; frame <= kFrames;) {
+    if (params.consume(view)) {
+      if (view.area != static_cast<uint64_t>(view.width) * view.height || view.generation < lastGeneration) {
+        paramsConsistent.store(false, std::memory_order_relaxed);
+      }
+      lastGeneration = view.generation;
+    }
+    auto index = slots.acquireUntil(std::chrono::steady_clock::now() + std::chrono::seconds(1), 2u);
+    if (!index) {
+      continue;
+    }
+    pixels[*index].words.fill(frame);
+    PH_CHECK(slots.submit(*index));
+    while (!submitted.push(*index)) {
+      std::this_thread::yield();
+    }
+    ++frame;
+  }
+  gpu.join();
+  rendering.store(false, std::memory_order_relaxed);
+  main.join();
+
+  PH_CHECK(paramsConsistent.load());
+  PH_CHECK(pixelsConsistent.load());
+  PH_CHECK(slots.idle());
+}
+
+TEST_SUITE_END();
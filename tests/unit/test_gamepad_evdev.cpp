@@ -0,0 +1,286 @@
+#include "platform/linux/GamepadEvdev.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <initializer_list>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.gamepad.evdev");
+
+namespace {
+
+struct Recorder {
+  std::vector<InputEvent> events;
+
+  static void sink(const InputEvent& event, void* userData) {
+    static_cast<Recorder*>(userData)->events.push_back(event);
+  }
+
+  template <typename T>
+  std::vector<T> of() const {
+    std::vector<T> out;
+    for (const InputEvent& event : events) {
+      if (auto* typed = std::get_if<T>(&event)) {
+        out.push_back(*typed);
+      }
+    }
+    return out;
+  }
+};
+
+// Stand-in for an evdev node: the backend reads recorded input_event records from a pipe.
+struct RecordedDevice {
+  int readFd = -1;
+  int writeFd = -1;
+
+  RecordedDevice() {
+    int fds[2] = {-1, -1};
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+      readFd = fds[0];
+      writeFd = fds[1];
+    }
+  }
+
+  ~RecordedDevice() {
+    closeWriter();
+  }
+
+  void closeWriter() {
+    if (writeFd >= 0) {
+      close(writeFd);
+      writeFd = -1;
+    }
+  }
+
+  void send(std::initializer_list<input_event> events) {
+    std::vector<input_event> buffer(events);
+    const ssize_t bytes = write(writeFd, buffer.data(), buffer.size() * sizeof(input_event));
+    PH_REQUIRE(bytes == static_cast<ssize_t>(buffer.size() * sizeof(input_event)));
+  }
+};
+
+input_event ev(uint16_t type, uint16_t code, int32_t value) {
+  input_event event{};
+  event.type = type;
+  event.code = code;
+  event.value = value;
+  return event;
+}
+
+input_event syn() {
+  return ev(EV_SYN, SYN_REPORT, 0);
+}
+
+void add_axis(EvdevDeviceInfo& info, uint32_t code, int32_t minimum, int32_t maximum, int32_t value) {
+  info.axes[code] = true;
+  info.absInfo[code].minimum = minimum;
+  info.absInfo[code].maximum = maximum;
+  info.absInfo[code].value = value;
+}
+
+// xpad's Xbox 360 layout.
+EvdevDeviceInfo xbox360() {
+  EvdevDeviceInfo info{};
+  info.name = "Microsoft X-Box 360 pad";
+  info.bus = BUS_USB;
+  info.vendor = 0x045Eu;
+  info.product = 0x028Eu;
+  info.version = 0x0114u;
+  for (uint32_t code : {BTN_A, BTN_B, BTN_X, BTN_Y, BTN_TL, BTN_TR, BTN_SELECT, BTN_START, BTN_MODE,
+                        BTN_THUMBL, BTN_THUMBR}) {
+    info.keys[code] = true;
+  }
+  add_axis(info, ABS_X, -32768, 32767, 0);
+  add_axis(info, ABS_Y, -32768, 32767, 0);
+  add_axis(info, ABS_Z, 0, 255, 0);
+  add_axis(info, ABS_RX, -32768, 32767, 0);
+  add_axis(info, ABS_RY, -32768, 32767, 0);
+  add_axis(info, ABS_RZ, 0, 255, 0);
+  add_axis(info, ABS_HAT0X, -1, 1, 0);
+  add_axis(info, ABS_HAT0Y, -1, 1, 0);
+  return info;
+}
+
+} // namespace
+
+PH_TEST("primehost.gamepad.evdev", "sdl button order") {
+  const EvdevDeviceInfo info = xbox360();
+  PH_CHECK(EvdevGamepad::looksLikeGamepad(info));
+  EvdevGamepad pad(1u, info, std::nullopt);
+  PH_CHECK(pad.buttonCount() == 11u);
+  PH_CHECK(pad.axisCount() == 6u);
+  PH_CHECK(pad.hatCount() == 1u);
+
+  EvdevDeviceInfo keyboard{};
+  keyboard.keys[KEY_A] = true;
+  PH_CHECK(!EvdevGamepad::looksLikeGamepad(keyboard));
+}
+
+PH_TEST("primehost.gamepad.evdev", "xbox 360 mapping") {
+  LinuxGamepadBackend backend;
+  Recorder recorder;
+  PH_REQUIRE(backend.start(&Recorder::sink, &recorder, false).has_value());
+  RecordedDevice device;
+  PH_REQUIRE(device.readFd >= 0);
+  auto deviceId = backend.addDevice(device.readFd, xbox360());
+  PH_REQUIRE(deviceId.has_value());
+  PH_REQUIRE(backend.device(*deviceId) != nullptr);
+  PH_CHECK(backend.device(*deviceId)->mapping().name == "Xbox 360 Controller");
+
+  auto connects = recorder.of<DeviceEvent>();
+  PH_REQUIRE(connects.size() == 1u);
+  PH_CHECK(connects[0].connected);
+  PH_CHECK(connects[0].deviceType == DeviceType::Gamepad);
+  recorder.events.clear();
+
+  device.send({ev(EV_KEY, BTN_A, 1), ev(EV_ABS, ABS_HAT0Y, -1), ev(EV_ABS, ABS_Z, 255),
+               ev(EV_ABS, ABS_Y, -32768), syn()});
+  auto emitted = backend.poll(std::chrono::milliseconds(100));
+  PH_REQUIRE(emitted.has_value());
+  PH_CHECK(*emitted == 4u);
+
+  auto buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 2u);
+  PH_CHECK(buttons[0].deviceId == *deviceId);
+  PH_CHECK(buttons[0].controlId == static_cast<uint32_t>(GamepadButtonId::South));
+  PH_CHECK(buttons[0].pressed);
+  PH_CHECK(buttons[1].controlId == static_cast<uint32_t>(GamepadButtonId::DpadUp));
+  PH_CHECK(buttons[1].pressed);
+
+  auto axes = recorder.of<GamepadAxisEvent>();
+  PH_REQUIRE(axes.size() == 2u);
+  PH_CHECK(axes[0].controlId == static_cast<uint32_t>(GamepadAxisId::LeftTrigger));
+  PH_CHECK(axes[0].value == doctest::Approx(1.0f));
+  // evdev Y grows downwards; PrimeHost reports stick up as positive.
+  PH_CHECK(axes[1].controlId == static_cast<uint32_t>(GamepadAxisId::LeftY));
+  PH_CHECK(axes[1].value == doctest::Approx(1.0f));
+
+  // Repeated values are filtered, releases are reported.
+  recorder.events.clear();
+  device.send({ev(EV_KEY, BTN_A, 1), ev(EV_ABS, ABS_HAT0Y, 0), syn()});
+  PH_CHECK(backend.poll(std::chrono::milliseconds(100)).value_or(0u) == 1u);
+  buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 1u);
+  PH_CHECK(buttons[0].controlId == static_cast<uint32_t>(GamepadButtonId::DpadUp));
+  PH_CHECK(!buttons[0].pressed);
+}
+
+PH_TEST("primehost.gamepad.evdev", "dualsense face buttons") {
+  EvdevDeviceInfo info{};
+  info.name = "Sony Interactive Entertainment DualSense Wireless Controller";
+  info.bus = BUS_USB;
+  info.vendor = 0x054Cu;
+  info.product = 0x0CE6u;
+  info.version = 0x8111u;
+  for (uint32_t code : {BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST, BTN_TL, BTN_TR, BTN_TL2, BTN_TR2,
+                        BTN_SELECT, BTN_START, BTN_MODE, BTN_THUMBL, BTN_THUMBR}) {
+    info.keys[code] = true;
+  }
+  add_axis(info, ABS_X, 0, 255, 128);
+  add_axis(info, ABS_Y, 0, 255, 128);
+  add_axis(info, ABS_Z, 0, 255, 0);
+  add_axis(info, ABS_RX, 0, 255, 128);
+  add_axis(info, ABS_RY, 0, 255, 128);
+  add_axis(info, ABS_RZ, 0, 255, 0);
+
+  Recorder recorder;
+  EvdevGamepad pad(7u, info, GamepadMappingDb{}.find(makeGamepadGuid(info.bus, info.vendor, info.product, 0u)));
+  PH_REQUIRE(pad.mapped());
+  // hid-playstation reports triangle as BTN_NORTH and square as BTN_WEST.
+  PH_CHECK(pad.handle(ev(EV_KEY, BTN_NORTH, 1), &Recorder::sink, &recorder) == 1u);
+  PH_CHECK(pad.handle(ev(EV_KEY, BTN_WEST, 1), &Recorder::sink, &recorder) == 1u);
+  auto buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 2u);
+  PH_CHECK(buttons[0].controlId == static_cast<uint32_t>(GamepadButtonId::North));
+  PH_CHECK(buttons[1].controlId == static_cast<uint32_t>(GamepadButtonId::West));
+}
+
+PH_TEST("primehost.gamepad.evdev", "kernel layout fallback") {
+  EvdevDeviceInfo info = xbox360();
+  info.vendor = 0x1234u;
+  info.product = 0x5678u;
+  info.axes[ABS_Z] = false;
+  info.keys[BTN_TL2] = true;
+
+  Recorder recorder;
+  EvdevGamepad pad(2u, info, std::nullopt);
+  PH_REQUIRE(pad.mapped());
+  pad.handle(ev(EV_KEY, BTN_Y, 1), &Recorder::sink, &recorder);
+  pad.handle(ev(EV_KEY, BTN_TL2, 1), &Recorder::sink, &recorder);
+  pad.handle(ev(EV_ABS, ABS_HAT0X, -1), &Recorder::sink, &recorder);
+
+  auto buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 2u);
+  PH_CHECK(buttons[0].controlId == static_cast<uint32_t>(GamepadButtonId::North));
+  PH_CHECK(buttons[1].controlId == static_cast<uint32_t>(GamepadButtonId::DpadLeft));
+  // A digital trigger still drives the trigger axis.
+  auto axes = recorder.of<GamepadAxisEvent>();
+  PH_REQUIRE(axes.size() == 1u);
+  PH_CHECK(axes[0].controlId == static_cast<uint32_t>(GamepadAxisId::LeftTrigger));
+  PH_CHECK(axes[0].value == doctest::Approx(1.0f));
+}
+
+PH_TEST("primehost.gamepad.evdev", "raw fallback") {
+  EvdevDeviceInfo info{};
+  info.name = "Generic USB Joystick";
+  info.keys[BTN_TRIGGER] = true;
+  info.keys[BTN_THUMB] = true;
+  add_axis(info, ABS_X, 0, 1023, 512);
+  add_axis(info, ABS_Y, 0, 1023, 512);
+  add_axis(info, ABS_HAT0X, -1, 1, 0);
+  add_axis(info, ABS_HAT0Y, -1, 1, 0);
+  PH_CHECK(EvdevGamepad::looksLikeGamepad(info));
+
+  Recorder recorder;
+  EvdevGamepad pad(3u, info, std::nullopt);
+  PH_CHECK(!pad.mapped());
+  pad.handle(ev(EV_KEY, BTN_THUMB, 1), &Recorder::sink, &recorder);
+  pad.handle(ev(EV_ABS, ABS_X, 1023), &Recorder::sink, &recorder);
+  pad.handle(ev(EV_ABS, ABS_HAT0Y, 1), &Recorder::sink, &recorder);
+
+  auto buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 1u);
+  PH_CHECK(buttons[0].controlId == GamepadRawControlBase + 1u);
+  auto axes = recorder.of<GamepadAxisEvent>();
+  PH_REQUIRE(axes.size() == 2u);
+  PH_CHECK(axes[0].controlId == GamepadRawControlBase + 0u);
+  PH_CHECK(axes[0].value == doctest::Approx(1.0f));
+  // Hats follow the plain axes, two controls per hat.
+  PH_CHECK(axes[1].controlId == GamepadRawControlBase + 3u);
+  PH_CHECK(axes[1].value == doctest::Approx(1.0f));
+}
+
+PH_TEST("primehost.gamepad.evdev", "dropped events and disconnect") {
+  LinuxGamepadBackend backend;
+  Recorder recorder;
+  PH_REQUIRE(backend.start(&Recorder::sink, &recorder, false).has_value());
+  RecordedDevice device;
+  auto deviceId = backend.addDevice(device.readFd, xbox360());
+  PH_REQUIRE(deviceId.has_value());
+  recorder.events.clear();
+
+  device.send({ev(EV_KEY, BTN_A, 1), ev(EV_SYN, SYN_DROPPED, 0), ev(EV_KEY, BTN_B, 1), syn(),
+               ev(EV_KEY, BTN_X, 1), syn()});
+  PH_CHECK(backend.poll(std::chrono::milliseconds(100)).value_or(0u) == 2u);
+  auto buttons = recorder.of<GamepadButtonEvent>();
+  PH_REQUIRE(buttons.size() == 2u);
+  PH_CHECK(buttons[0].controlId == static_cast<uint32_t>(GamepadButtonId::South));
+  PH_CHECK(buttons[1].controlId == static_cast<uint32_t>(GamepadButtonId::West));
+
+  recorder.events.clear();
+  device.closeWriter();
+  PH_CHECK(backend.poll(std::chrono::milliseconds(100)).value_or(0u) == 1u);
+  auto disconnects = recorder.of<DeviceEvent>();
+  PH_REQUIRE(disconnects.size() == 1u);
+  PH_CHECK(disconnects[0].deviceId == *deviceId);
+  PH_CHECK(!disconnects[0].connected);
+  PH_CHECK(backend.device(*deviceId) == nullptr);
+  PH_CHECK(!backend.removeDevice(*deviceId).has_value());
+}
+
+TEST_SUITE_END();
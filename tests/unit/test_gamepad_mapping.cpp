@@ -0,0 +1,206 @@
+#include "GamepadMapping.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <algorithm>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.gamepad.mapping");
+
+PH_TEST("primehost.gamepad.mapping", "guid round trip") {
+  const GamepadGuid guid = makeGamepadGuid(0x03u, 0x045Eu, 0x028Eu, 0x0114u);
+  PH_CHECK(guid.bus() == 0x03u);
+  PH_CHECK(guid.vendor() == 0x045Eu);
+  PH_CHECK(guid.product() == 0x028Eu);
+  PH_CHECK(guid.version() == 0x0114u);
+
+  auto parsed = parseGamepadGuid("030000005e0400008e02000014010000");
+  PH_REQUIRE(parsed.has_value());
+  PH_CHECK(*parsed == guid);
+
+  PH_CHECK(!parseGamepadGuid("030000005e0400008e020000").has_value());
+  PH_CHECK(!parseGamepadGuid("030000005e0400008e0200001401000g").has_value());
+}
+
+PH_TEST("primehost.gamepad.mapping", "parse sources") {
+  auto mapping = parseGamepadMapping(
+      "03000000341200007856000000000000,Test Pad,a:b2,dpup:h0.1,lefttrigger:a2,+leftx:-a0,righty:a4~,"
+      "misc1:b9,paddle1:b10,platform:Linux,");
+  PH_REQUIRE(mapping.has_value());
+  PH_CHECK(mapping->name == "Test Pad");
+  PH_CHECK(mapping->guid.vendor() == 0x1234u);
+  PH_CHECK(mapping->guid.product() == 0x5678u);
+  auto bindings = mapping->activeBindings();
+  // paddle1 has no PrimeHost control and is skipped.
+  PH_REQUIRE(bindings.size() == 6u);
+
+  PH_CHECK(bindings[0].kind == GamepadInputKind::Button);
+  PH_CHECK(bindings[0].index == 2u);
+  PH_CHECK(!bindings[0].toAxis);
+  PH_CHECK(bindings[0].controlId == static_cast<uint32_t>(GamepadButtonId::South));
+
+  PH_CHECK(bindings[1].kind == GamepadInputKind::Hat);
+  PH_CHECK(bindings[1].index == 0u);
+  PH_CHECK(bindings[1].hatMask == 1u);
+  PH_CHECK(bindings[1].controlId == static_cast<uint32_t>(GamepadButtonId::DpadUp));
+
+  PH_CHECK(bindings[2].kind == GamepadInputKind::Axis);
+  PH_CHECK(bindings[2].toAxis);
+  PH_CHECK(bindings[2].controlId == static_cast<uint32_t>(GamepadAxisId::LeftTrigger));
+
+  PH_CHECK(bindings[3].inputRange == -1);
+  PH_CHECK(bindings[3].outputRange == 1);
+  PH_CHECK(bindings[3].controlId == static_cast<uint32_t>(GamepadAxisId::LeftX));
+
+  PH_CHECK(bindings[4].invert);
+  PH_CHECK(bindings[4].controlId == static_cast<uint32_t>(GamepadAxisId::RightY));
+
+  PH_CHECK(bindings[5].controlId == static_cast<uint32_t>(GamepadButtonId::Misc));
+}
+
+PH_TEST("primehost.gamepad.mapping", "parse errors") {
+  auto other = parseGamepadMapping("03000000341200007856000000000000,Pad,a:b0,platform:Windows,");
+  PH_REQUIRE(!other.has_value());
+  PH_CHECK(other.error().code == HostErrorCode::Unsupported);
+
+  auto any = parseGamepadMapping("03000000341200007856000000000000,Pad,a:b0,platform:Windows,", {});
+  PH_CHECK(any.has_value());
+
+  const char* malformed[] = {
+      "not-a-guid,Pad,a:b0,",
+      "03000000341200007856000000000000",
+      "03000000341200007856000000000000,Pad,a:x0,",
+      "03000000341200007856000000000000,Pad,a:b,",
+      "03000000341200007856000000000000,Pad,dpup:h0.16,",
+      "03000000341200007856000000000000,Pad,+a:b0,",
+      "03000000341200007856000000000000,Pad,a:+b0,",
+  };
+  for (const char* line : malformed) {
+    auto result = parseGamepadMapping(line);
+    PH_CHECK(!result.has_value());
+    if (!result) {
+      PH_CHECK(result.error().code == HostErrorCode::InvalidConfig);
+    }
+  }
+}
+
+PH_TEST("primehost.gamepad.mapping", "builtin table parses") {
+  auto builtin = builtinGamepadMappings();
+  auto guids = builtinGamepadGuids();
+  PH_CHECK(builtin.size() > 200u);
+  PH_REQUIRE(guids.size() == builtin.size());
+  for (size_t i = 0; i < builtin.size(); ++i) {
+    auto mapping = parseGamepadMapping(builtin[i]);
+    PH_CHECK(mapping.has_value());
+    if (mapping) {
+      PH_CHECK(mapping->bindingCount >= 15u);
+      PH_CHECK(mapping->guid == guids[i]);
+    }
+  }
+}
+
+PH_TEST("primehost.gamepad.mapping", "builtin lookup finds every line") {
+  GamepadMappingDb db;
+  for (const GamepadGuid& guid : builtinGamepadGuids()) {
+    auto lines = findBuiltinGamepadLines(guid.vendor(), guid.product());
+    PH_CHECK(!lines.vendorFallback);
+    PH_CHECK(std::ranges::any_of(lines.indices, [&](uint16_t line) { return builtinGamepadGuids()[line] == guid; }));
+    auto found = db.find(guid);
+    PH_REQUIRE(found.has_value());
+    PH_CHECK(found->guid == guid);
+  }
+}
+
+PH_TEST("primehost.gamepad.mapping", "vendor fallback") {
+  GamepadMappingDb db;
+  // An unknown Microsoft product over USB borrows the xpad layout; over Bluetooth it does not.
+  auto usb = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x0BFFu, 0u));
+  PH_REQUIRE(usb.has_value());
+  PH_CHECK(usb->name == "Xbox 360 Controller");
+  PH_CHECK(!db.find(makeGamepadGuid(0x05u, 0x045Eu, 0x0BFFu, 0u)).has_value());
+
+  auto sony = db.find(makeGamepadGuid(0x05u, 0x054Cu, 0x0FFFu, 0u));
+  PH_REQUIRE(sony.has_value());
+  PH_CHECK(sony->guid.bus() == 0x05u);
+  PH_CHECK(sony->guid.product() == 0x0CE6u);
+
+  // Any imported vendor/product match outranks the fallback.
+  PH_CHECK(db.importMappings("030000005e040000ff0b000001000000,Imported Pad,a:b0,platform:Linux,\n") == 1u);
+  auto imported = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x0BFFu, 0u));
+  PH_REQUIRE(imported.has_value());
+  PH_CHECK(imported->name == "Imported Pad");
+
+  PH_CHECK(findBuiltinGamepadLines(0x045Eu, 0x0BFFu).vendorFallback);
+  PH_CHECK(!findBuiltinGamepadLines(0x1234u, 0x5678u).vendorFallback);
+  PH_CHECK(findBuiltinGamepadLines(0x1234u, 0x5678u).indices.empty());
+}
+
+PH_TEST("primehost.gamepad.mapping", "builtin xpad variants") {
+  GamepadMappingDb db;
+  // Wireless receivers report the d-pad as buttons, fight sticks the triggers.
+  auto receiver = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x0719u, 0x0100u));
+  PH_REQUIRE(receiver.has_value());
+  auto stick = db.find(makeGamepadGuid(0x03u, 0x0F0Du, 0x000Du, 0u));
+  PH_REQUIRE(stick.has_value());
+  bool dpadButton = false;
+  for (const GamepadBinding& binding : receiver->activeBindings()) {
+    if (binding.controlId == static_cast<uint32_t>(GamepadButtonId::DpadUp) && !binding.toAxis) {
+      dpadButton = binding.kind == GamepadInputKind::Button && binding.index == 13u;
+    }
+  }
+  PH_CHECK(dpadButton);
+  bool triggerButton = false;
+  for (const GamepadBinding& binding : stick->activeBindings()) {
+    if (binding.controlId == static_cast<uint32_t>(GamepadAxisId::LeftTrigger) && binding.toAxis) {
+      triggerButton = binding.kind == GamepadInputKind::Button && binding.index == 6u;
+    }
+  }
+  PH_CHECK(triggerButton);
+}
+
+PH_TEST("primehost.gamepad.mapping", "lookup ignores version") {
+  GamepadMappingDb db;
+  auto xbox = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x028Eu, 0x0114u));
+  PH_REQUIRE(xbox.has_value());
+  PH_CHECK(xbox->name == "Xbox 360 Controller");
+
+  // Same device over another bus still resolves through vendor/product.
+  auto bluetooth = db.find(makeGamepadGuid(0x05u, 0x045Eu, 0x028Eu, 0u));
+  PH_CHECK(bluetooth.has_value());
+
+  // The Bluetooth DualSense entry wins over USB when the bus matches.
+  auto dualsense = db.find(makeGamepadGuid(0x05u, 0x054Cu, 0x0CE6u, 0x8100u));
+  PH_REQUIRE(dualsense.has_value());
+  PH_CHECK(dualsense->guid.bus() == 0x05u);
+
+  PH_CHECK(!db.find(makeGamepadGuid(0x03u, 0x1234u, 0x5678u, 0u)).has_value());
+}
+
+PH_TEST("primehost.gamepad.mapping", "imports override builtin") {
+  GamepadMappingDb db;
+  const char* text =
+      "# community mappings\n"
+      "\n"
+      "030000005e0400008e02000014010000,Custom 360,a:b1,b:b0,platform:Linux,\r\n"
+      "030000005e0400008e02000014010000,Custom 360 v2,a:b1,b:b0,platform:Linux,\n"
+      "03000000341200007856000000000000,Windows Pad,a:b0,platform:Windows,\n"
+      "garbage line\n";
+  PH_CHECK(db.importMappings(text) == 2u);
+  PH_CHECK(db.importedCount() == 1u);
+  PH_CHECK(db.importMappings("030000005e0400008e02000014010000,Custom 360 v3,a:b1,b:b0,platform:Linux,\n") == 1u);
+  PH_CHECK(db.importedCount() == 1u);
+
+  auto exact = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x028Eu, 0x0114u));
+  PH_REQUIRE(exact.has_value());
+  PH_CHECK(exact->name == "Custom 360 v3");
+
+  // A partial imported match still beats an equally partial builtin match.
+  auto other = db.find(makeGamepadGuid(0x03u, 0x045Eu, 0x028Eu, 0x0110u));
+  PH_REQUIRE(other.has_value());
+  PH_CHECK(other->name == "Custom 360 v3");
+
+  PH_CHECK(!db.find(makeGamepadGuid(0x03u, 0x1234u, 0x5678u, 0u)).has_value());
+}
+
+TEST_SUITE_END();
@@ -88,4 +88,21 @@ PH_TEST("primehost.gamepad", "vendor matching") {
   PH_CHECK(fallback.has_value());
 }
 
+PH_TEST("primehost.gamepad", "profile lookup precedence") {
+  // Product entries win over the vendor fallback.
+  auto f710 = findGamepadProfile(0x046D, 0xC21F, "Xbox");
+  PH_REQUIRE(f710.has_value());
+  PH_CHECK(f710->token == "f710");
+
+  auto dualsense = findGamepadProfile(0x054C, 0x0CE6, "");
+  PH_REQUIRE(dualsense.has_value());
+  PH_CHECK(dualsense->token == "dualsense");
+
+  // Unknown vendors fall through to the name tokens, which keep table order.
+  auto unknownVendor = findGamepadProfile(0x1234, 0x5678, "Logitech F310 for Xbox");
+  PH_REQUIRE(unknownVendor.has_value());
+  PH_CHECK(unknownVendor->token == "xbox");
+  PH_CHECK(!findGamepadProfile(0x1234, 0x5678, "Joystick").has_value());
+}
+
 TEST_SUITE_END();
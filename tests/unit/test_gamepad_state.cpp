@@ -0,0 +1,195 @@
+#include "GamepadStateBlock.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.gamepad.state");
+
+namespace {
+
+constexpr uint32_t axis_id(GamepadAxisId id) {
+  return static_cast<uint32_t>(id);
+}
+
+} // namespace
+
+PH_TEST("primehost.gamepad.state", "config validation") {
+  PH_CHECK(validateGamepadInputConfig(GamepadInputConfig{}).has_value());
+
+  GamepadInputConfig config{};
+  config.stickDeadzone = 0.6f;
+  config.stickOuterDeadzone = 0.4f;
+  PH_CHECK(!validateGamepadInputConfig(config).has_value());
+
+  config = {};
+  config.triggerDeadzone = 1.0f;
+  PH_CHECK(!validateGamepadInputConfig(config).has_value());
+
+  config = {};
+  config.responseExpo = 1.5f;
+  PH_CHECK(!validateGamepadInputConfig(config).has_value());
+
+  config = {};
+  config.axisEventThreshold = -0.1f;
+  PH_CHECK(!validateGamepadInputConfig(config).has_value());
+}
+
+PH_TEST("primehost.gamepad.state", "radial deadzone and curve") {
+  GamepadInputConfig config{};
+  config.stickDeadzone = 0.2f;
+  config.stickOuterDeadzone = 0.1f;
+  config.triggerDeadzone = 0.1f;
+
+  float raw[GamepadAxisCount] = {0.1f, 0.1f, 0.6f, 0.8f, 0.55f, 0.05f};
+  float out[GamepadAxisCount] = {};
+  applyGamepadResponse(raw, out, config);
+  // Left stick magnitude 0.14 is inside the radial deadzone even though neither axis alone is.
+  PH_CHECK(out[0] == 0.0f);
+  PH_CHECK(out[1] == 0.0f);
+  // Right stick is at full deflection, so the direction is kept and the magnitude saturates.
+  PH_CHECK(out[2] == doctest::Approx(0.6f));
+  PH_CHECK(out[3] == doctest::Approx(0.8f));
+  PH_CHECK(out[4] == doctest::Approx(0.5f));
+  PH_CHECK(out[5] == 0.0f);
+
+  // Diagonal corners do not exceed unit magnitude.
+  float corner[GamepadAxisCount] = {1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+  applyGamepadResponse(corner, out, config);
+  PH_CHECK(out[0] * out[0] + out[1] * out[1] == doctest::Approx(1.0f));
+  PH_CHECK(out[1] < 0.0f);
+  PH_CHECK(out[4] == doctest::Approx(1.0f));
+
+  config = {};
+  config.responseExpo = 1.0f;
+  float half[GamepadAxisCount] = {0.5f, 0.0f, 0.0f, -0.5f, 0.5f, 0.0f};
+  applyGamepadResponse(half, out, config);
+  PH_CHECK(out[0] == doctest::Approx(0.125f));
+  PH_CHECK(out[3] == doctest::Approx(-0.125f));
+  PH_CHECK(out[4] == doctest::Approx(0.125f));
+}
+
+PH_TEST("primehost.gamepad.state", "vector path matches scalar") {
+  GamepadInputConfig config{};
+  config.stickDeadzone = 0.12f;
+  config.stickOuterDeadzone = 0.05f;
+  config.triggerDeadzone = 0.08f;
+  config.responseExpo = 0.35f;
+  uint32_t seed = 12345u;
+  auto next = [&] {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8u) / 16777216.0f;
+  };
+  for (int i = 0; i < 1000; ++i) {
+    float raw[GamepadAxisCount] = {
+        next() * 2.0f - 1.0f, next() * 2.0f - 1.0f, next() * 2.0f - 1.0f, next() * 2.0f - 1.0f, next(), next()};
+    float vector[GamepadAxisCount] = {};
+    float scalar[GamepadAxisCount] = {};
+    applyGamepadResponse(raw, vector, config);
+    applyGamepadResponseScalar(raw, scalar, config);
+    for (uint32_t axis = 0; axis < GamepadAxisCount; ++axis) {
+      PH_CHECK(vector[axis] == doctest::Approx(scalar[axis]).epsilon(1e-5));
+    }
+  }
+}
+
+PH_TEST("primehost.gamepad.state", "snapshot tracks buttons and axes") {
+  GamepadStateBlock block(9u);
+  const auto now = std::chrono::steady_clock::now();
+  GamepadState initial = block.snapshot();
+  PH_CHECK(initial.deviceId == 9u);
+  PH_CHECK(initial.buttons == 0u);
+
+  block.setButton(static_cast<uint32_t>(GamepadButtonId::East), true, 0.75f, now);
+  block.setButton(static_cast<uint32_t>(GamepadButtonId::Start), true, std::nullopt, now);
+  block.setButton(99u, true, std::nullopt, now);
+  GamepadState state = block.snapshot();
+  PH_CHECK(state.sequence == initial.sequence + 2u);
+  PH_CHECK(state.pressed(GamepadButtonId::East));
+  PH_CHECK(state.pressed(GamepadButtonId::Start));
+  PH_CHECK(!state.pressed(GamepadButtonId::South));
+  PH_CHECK(state.buttonValues[static_cast<uint32_t>(GamepadButtonId::East)] == doctest::Approx(0.75f));
+  PH_CHECK(state.buttonValues[static_cast<uint32_t>(GamepadButtonId::Start)] == 1.0f);
+
+  block.setButton(static_cast<uint32_t>(GamepadButtonId::East), false, std::nullopt, now);
+  GamepadInputConfig config{};
+  PH_CHECK(block.setAxis(axis_id(GamepadAxisId::LeftTrigger), 2.0f, config, now) ==
+           (1u << axis_id(GamepadAxisId::LeftTrigger)));
+  state = block.snapshot();
+  PH_CHECK(!state.pressed(GamepadButtonId::East));
+  PH_CHECK(state.rawAxes[axis_id(GamepadAxisId::LeftTrigger)] == 1.0f);
+  PH_CHECK(state.axis(GamepadAxisId::LeftTrigger) == 1.0f);
+  PH_CHECK(state.time == now);
+}
+
+PH_TEST("primehost.gamepad.state", "event thresholds") {
+  GamepadStateBlock block(1u);
+  const auto now = std::chrono::steady_clock::now();
+  GamepadInputConfig config{};
+  config.stickDeadzone = 0.1f;
+  config.axisEventThreshold = 0.05f;
+  const uint32_t leftX = axis_id(GamepadAxisId::LeftX);
+  const uint32_t leftY = axis_id(GamepadAxisId::LeftY);
+
+  // Noise inside the deadzone never reports.
+  PH_CHECK(block.setAxis(leftX, 0.03f, config, now) == 0u);
+  PH_CHECK(block.setAxis(leftX, -0.05f, config, now) == 0u);
+  // Leaving the deadzone reports once the threshold is crossed.
+  PH_CHECK(block.setAxis(leftX, 0.12f, config, now) == 0u);
+  PH_CHECK(block.setAxis(leftX, 0.2f, config, now) == (1u << leftX));
+  PH_CHECK(block.setAxis(leftX, 0.21f, config, now) == 0u);
+  // Moving Y rescales the radial magnitude, so both stick axes may report.
+  PH_CHECK((block.setAxis(leftY, 0.6f, config, now) & (1u << leftY)) != 0u);
+  // Returning to rest always reports, regardless of threshold.
+  block.setAxis(leftY, 0.0f, config, now);
+  PH_CHECK(block.setAxis(leftX, 0.0f, config, now) == (1u << leftX));
+  PH_CHECK(block.snapshot().axis(GamepadAxisId::LeftX) == 0.0f);
+
+  // Changing the config reprocesses the latest raw values.
+  block.setAxis(leftX, 0.5f, config, now);
+  GamepadInputConfig wide = config;
+  wide.stickDeadzone = 0.6f;
+  block.applyConfig(wide);
+  PH_CHECK(block.snapshot().axis(GamepadAxisId::LeftX) == 0.0f);
+  PH_CHECK(block.snapshot().rawAxes[leftX] == doctest::Approx(0.5f));
+}
+
+PH_TEST("primehost.gamepad.state", "concurrent readers see whole updates") {
+  GamepadStateBlock block(2u);
+  GamepadInputConfig config{};
+  const auto base = std::chrono::steady_clock::time_point{};
+  auto valueFor = [](int64_t i) { return static_cast<float>(i % 100) / 100.0f; };
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> torn{0u};
+  std::atomic<uint32_t> reads{0u};
+  std::thread reader([&] {
+    uint64_t lastSequence = 0u;
+    while (!done.load(std::memory_order_acquire)) {
+      GamepadState state = block.snapshot();
+      // Every publish stamps the update index into `time`, so a mixed copy shows up as a value
+      // that does not belong to its timestamp.
+      const int64_t i = (state.time - base).count();
+      if (state.sequence < lastSequence || state.rawAxes[4] != valueFor(i) || state.axes[4] != state.rawAxes[4]) {
+        torn.fetch_add(1u, std::memory_order_relaxed);
+      }
+      lastSequence = state.sequence;
+      reads.fetch_add(1u, std::memory_order_relaxed);
+    }
+  });
+  // On a single core the writer can finish before the reader is ever scheduled.
+  while (reads.load(std::memory_order_relaxed) == 0u) {
+    std::this_thread::yield();
+  }
+  for (int64_t i = 1; i <= 50000; ++i) {
+    block.setAxis(4u, valueFor(i), config, base + std::chrono::steady_clock::duration(i));
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+  PH_CHECK(reads.load() > 0u);
+  PH_CHECK(torn.load() == 0u);
+}
+
+TEST_SUITE_END();
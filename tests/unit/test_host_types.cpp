@@ -118,6 +118,7 @@ PH_TEST("primehost.types", "host capabilities defaults") {
   PH_CHECK(!caps.supportsIme);
   PH_CHECK(!caps.supportsHaptics);
   PH_CHECK(!caps.supportsHeadless);
+  PH_CHECK(!caps.supportsRawInput);
 }
 
 PH_TEST("primehost.types", "host capabilities writable") {
@@ -128,6 +129,7 @@ PH_TEST("primehost.types", "host capabilities writable") {
   caps.supportsIme = true;
   caps.supportsHaptics = true;
   caps.supportsHeadless = true;
+  caps.supportsRawInput = true;
 
   PH_CHECK(caps.supportsClipboard);
   PH_CHECK(caps.supportsFileDialogs);
@@ -135,6 +137,7 @@ PH_TEST("primehost.types", "host capabilities writable") {
   PH_CHECK(caps.supportsIme);
   PH_CHECK(caps.supportsHaptics);
   PH_CHECK(caps.supportsHeadless);
+  PH_CHECK(caps.supportsRawInput);
 }
 
 PH_TEST("primehost.types", "surface capabilities defaults") {
@@ -0,0 +1,526 @@
+#include "PrimeHost/PrimeHost.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.imageencode");
+
+namespace {
+
+struct TestImage {
+  ImageSize size;
+  uint32_t stride = 0u;
+  std::vector<uint8_t> pixels;
+
+  ImageView view() const { return ImageView{size, stride, ColorFormat::B8G8R8A8_UNORM, pixels}; }
+};
+
+// BGRA mix of flat panels, a gradient and noise, with padded rows so stride != width * 4.
+TestImage make_image(uint32_t width, uint32_t height) {
+  TestImage image{};
+  image.size = ImageSize{width, height};
+  image.stride = width * 4u + 12u;
+  image.pixels.assign(static_cast<size_t>(image.stride) * height, 0xEEu);
+  uint32_t seed = 12345u;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint8_t* px = image.pixels.data() + static_cast<size_t>(y) * image.stride + x * 4u;
+      seed = seed * 1664525u + 1013904223u;
+      if (x < width / 2u) {
+        px[0] = 0x30u;
+        px[1] = y < height / 3u ? 0x40u : 0x90u;
+        px[2] = 0x20u;
+        px[3] = 0xFFu;
+      } else if (y < height / 2u) {
+        px[0] = static_cast<uint8_t>(x);
+        px[1] = static_cast<uint8_t>(y);
+        px[2] = static_cast<uint8_t>(x + y);
+        px[3] = static_cast<uint8_t>(0x80u + (x & 0x3Fu));
+      } else {
+        px[0] = static_cast<uint8_t>(seed >> 24u);
+        px[1] = static_cast<uint8_t>(seed >> 16u);
+        px[2] = static_cast<uint8_t>(seed >> 8u);
+        px[3] = static_cast<uint8_t>(seed);
+      }
+    }
+  }
+  return image;
+}
+
+// Expected RGB(A) bytes for the encoded image.
+std::vector<uint8_t> expected_rgb(const TestImage& image, bool alpha) {
+  std::vector<uint8_t> out;
+  for (uint32_t y = 0; y < image.size.height; ++y) {
+    for (uint32_t x = 0; x < image.size.width; ++x) {
+      const uint8_t* px = image.pixels.data() + static_cast<size_t>(y) * image.stride + x * 4u;
+      out.push_back(px[2]);
+      out.push_back(px[1]);
+      out.push_back(px[0]);
+      if (alpha) {
+        out.push_back(px[3]);
+      }
+    }
+  }
+  return out;
+}
+
+std::vector<uint8_t> encode(const ImageView& view, const ImageEncodeConfig& config) {
+  auto bound = maxEncodedImageSize(view.size, config);
+  REQUIRE(bound.has_value());
+  std::vector<uint8_t> out(*bound);
+  auto size = encodeImage(view, out, config);
+  REQUIRE(size.has_value());
+  CHECK(*size <= *bound);
+  out.resize(*size);
+  return out;
+}
+
+uint32_t read_be32(const uint8_t* data) {
+  return (uint32_t{data[0]} << 24u) | (uint32_t{data[1]} << 16u) | (uint32_t{data[2]} << 8u) | data[3];
+}
+
+// Bitwise reference checksums, independent of the encoder's table-driven ones.
+uint32_t reference_crc(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; ++k) {
+      crc = (crc & 1u) != 0u ? 0xEDB88320u ^ (crc >> 1u) : crc >> 1u;
+    }
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+uint32_t reference_adler(const std::vector<uint8_t>& data) {
+  uint32_t a = 1u;
+  uint32_t b = 0u;
+  for (uint8_t byte : data) {
+    a = (a + byte) % 65521u;
+    b = (b + a) % 65521u;
+  }
+  return a | (b << 16u);
+}
+
+// Minimal inflate for the block types the encoder emits: stored and fixed Huffman.
+class Inflater {
+public:
+  explicit Inflater(std::span<const uint8_t> data) : data_(data) {}
+
+  std::optional<std::vector<uint8_t>> run() {
+    std::vector<uint8_t> out;
+    bool last = false;
+    while (!last) {
+      last = bits(1u) != 0u;
+      const uint32_t type = bits(2u);
+      if (type == 0u) {
+        bit_ = 0u;
+        ++pos_;
+        if (pos_ + 4u > data_.size()) {
+          return std::nullopt;
+        }
+        const uint32_t length = data_[pos_] | (uint32_t{data_[pos_ + 1u]} << 8u);
+        const uint32_t inverse = data_[pos_ + 2u] | (uint32_t{data_[pos_ + 3u]} << 8u);
+        pos_ += 4u;
+        if ((length ^ 0xFFFFu) != inverse || pos_ + length > data_.size()) {
+          return std::nullopt;
+        }
+        out.insert(out.end(), data_.begin() + static_cast<std::ptrdiff_t>(pos_),
+                   data_.begin() + static_cast<std::ptrdiff_t>(pos_ + length));
+        pos_ += length;
+        continue;
+      }
+      if (type != 1u) {
+        return std::nullopt;
+      }
+      for (;;) {
+        const uint32_t symbol = literal();
+        if (failed_ || symbol > 285u) {
+          return std::nullopt;
+        }
+        if (symbol < 256u) {
+          out.push_back(static_cast<uint8_t>(symbol));
+          continue;
+        }
+        if (symbol == 256u) {
+          break;
+        }
+        static constexpr std::array<uint16_t, 29> lengthBase{3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                                             15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                                             67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr std::array<uint16_t, 30> distanceBase{
+            1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+            193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        const uint32_t lengthCode = symbol - 257u;
+        const uint32_t lengthExtra = lengthCode < 8u || lengthCode == 28u ? 0u : (lengthCode - 4u) / 4u;
+        const uint32_t length = lengthBase[lengthCode] + bits(lengthExtra);
+        uint32_t distanceCode = 0u;
+        for (int i = 0; i < 5; ++i) {
+          distanceCode = (distanceCode << 1u) | bits(1u);
+        }
+        if (distanceCode >= 30u) {
+          return std::nullopt;
+        }
+        const uint32_t distanceExtra = distanceCode < 4u ? 0u : (distanceCode - 2u) / 2u;
+        const uint32_t distance = distanceBase[distanceCode] + bits(distanceExtra);
+        if (failed_ || distance > out.size()) {
+          return std::nullopt;
+        }
+        for (uint32_t i = 0; i < length; ++i) {
+          out.push_back(out[out.size() - distance]);
+        }
+      }
+    }
+    return out;
+  }
+
+private:
+  uint32_t bits(uint32_t count) {
+    uint32_t value = 0u;
+    for (uint32_t i = 0; i < count; ++i) {
+      if (pos_ >= data_.size()) {
+        failed_ = true;
+        return 0u;
+      }
+      value |= ((data_[pos_] >> bit_) & 1u) << i;
+      if (++bit_ == 8u) {
+        bit_ = 0u;
+        ++pos_;
+      }
+    }
+    return value;
+  }
+
+  uint32_t literal() {
+    uint32_t code = 0u;
+    for (uint32_t length = 1u; length <= 9u; ++length) {
+      code = (code << 1u) | bits(1u);
+      if (length == 7u && code <= 0x17u) {
+        return 256u + code;
+      }
+      if (length == 8u && code >= 0x30u && code <= 0xBFu) {
+        return code - 0x30u;
+      }
+      if (length == 8u && code >= 0xC0u && code <= 0xC7u) {
+        return 280u + code - 0xC0u;
+      }
+      if (length == 9u && code >= 0x190u) {
+        return 144u + code - 0x190u;
+      }
+    }
+    failed_ = true;
+    return 0u;
+  }
+
+  std::span<const uint8_t> data_;
+  size_t pos_ = 0u;
+  uint32_t bit_ = 0u;
+  bool failed_ = false;
+};
+
+struct DecodedImage {
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+  uint32_t channels = 0u;
+  std::vector<uint8_t> pixels;
+};
+
+std::optional<DecodedImage> decode_png(const std::vector<uint8_t>& png) {
+  static constexpr std::array<uint8_t, 8> signature{0x89u, 'P', 'N', 'G', 0x0Du, 0x0Au, 0x1Au, 0x0Au};
+  if (png.size() < signature.size() || !std::equal(signature.begin(), signature.end(), png.begin())) {
+    return std::nullopt;
+  }
+  DecodedImage image{};
+  std::vector<uint8_t> zlib;
+  bool ended = false;
+  size_t pos = signature.size();
+  while (pos + 12u <= png.size() && !ended) {
+    const uint32_t length = read_be32(png.data() + pos);
+    if (pos + 12u + length > png.size() || read_be32(png.data() + pos + 8u + length) !=
+                                               reference_crc(png.data() + pos + 4u, length + 4u)) {
+      return std::nullopt;
+    }
+    const std::string type(reinterpret_cast<const char*>(png.data() + pos + 4u), 4u);
+    const uint8_t* body = png.data() + pos + 8u;
+    if (type == "IHDR") {
+      image.width = read_be32(body);
+      image.height = read_be32(body + 4u);
+      if (body[8] != 8u || (body[9] != 2u && body[9] != 6u)) {
+        return std::nullopt;
+      }
+      image.channels = body[9] == 6u ? 4u : 3u;
+    } else if (type == "IDAT") {
+      zlib.insert(zlib.end(), body, body + length);
+    } else if (type == "IEND") {
+      ended = true;
+    }
+    pos += 12u + length;
+  }
+  if (!ended || pos != png.size() || zlib.size() < 6u || ((zlib[0] << 8u) | zlib[1]) % 31u != 0u) {
+    return std::nullopt;
+  }
+  auto raw = Inflater(std::span<const uint8_t>(zlib).subspan(2u, zlib.size() - 6u)).run();
+  if (!raw || reference_adler(*raw) != read_be32(zlib.data() + zlib.size() - 4u)) {
+    return std::nullopt;
+  }
+  const size_t rowBytes = static_cast<size_t>(image.width) * image.channels;
+  if (raw->size() != (rowBytes + 1u) * image.height) {
+    return std::nullopt;
+  }
+  image.pixels.resize(rowBytes * image.height);
+  for (uint32_t y = 0; y < image.height; ++y) {
+    const uint8_t filter = (*raw)[y * (rowBytes + 1u)];
+    const uint8_t* src = raw->data() + y * (rowBytes + 1u) + 1u;
+    uint8_t* dst = image.pixels.data() + y * rowBytes;
+    for (size_t i = 0; i < rowBytes; ++i) {
+      const uint8_t left = i >= image.channels ? dst[i - image.channels] : 0u;
+      const uint8_t up = y > 0u ? dst[i - rowBytes] : 0u;
+      if (filter == 0u) {
+        dst[i] = src[i];
+      } else if (filter == 1u) {
+        dst[i] = static_cast<uint8_t>(src[i] + left);
+      } else if (filter == 2u) {
+        dst[i] = static_cast<uint8_t>(src[i] + up);
+      } else {
+        return std::nullopt;
+      }
+    }
+  }
+  return image;
+}
+
+std::optional<DecodedImage> decode_qoi(const std::vector<uint8_t>& qoi) {
+  if (qoi.size() < 22u || std::memcmp(qoi.data(), "qoif", 4u) != 0) {
+    return std::nullopt;
+  }
+  DecodedImage image{};
+  image.width = read_be32(qoi.data() + 4u);
+  image.height = read_be32(qoi.data() + 8u);
+  image.channels = qoi[12];
+  std::array<std::array<uint8_t, 4>, 64> index{};
+  std::array<uint8_t, 4> px{0u, 0u, 0u, 255u};
+  size_t pos = 14u;
+  const size_t end = qoi.size() - 8u;
+  const size_t count = static_cast<size_t>(image.width) * image.height;
+  uint32_t run = 0u;
+  for (size_t i = 0; i < count; ++i) {
+    if (run > 0u) {
+      --run;
+    } else {
+      if (pos >= end) {
+        return std::nullopt;
+      }
+      const uint8_t op = qoi[pos++];
+      if (op == 0xFEu) {
+        px[0] = qoi[pos];
+        px[1] = qoi[pos + 1u];
+        px[2] = qoi[pos + 2u];
+        pos += 3u;
+      } else if (op == 0xFFu) {
+        std::memcpy(px.data(), qoi.data() + pos, 4u);
+        pos += 4u;
+      } else if ((op & 0xC0u) == 0x00u) {
+        px = index[op];
+      } else if ((op & 0xC0u) == 0x40u) {
+        px[0] = static_cast<uint8_t>(px[0] + ((op >> 4u) & 3u) - 2u);
+        px[1] = static_cast<uint8_t>(px[1] + ((op >> 2u) & 3u) - 2u);
+        px[2] = static_cast<uint8_t>(px[2] + (op & 3u) - 2u);
+      } else if ((op & 0xC0u) == 0x80u) {
+        const int dg = (op & 0x3F) - 32;
+        const uint8_t next = qoi[pos++];
+        px[0] = static_cast<uint8_t>(px[0] + dg - 8 + (next >> 4u));
+        px[1] = static_cast<uint8_t>(px[1] + dg);
+        px[2] = static_cast<uint8_t>(px[2] + dg - 8 + (next & 0x0F));
+      } else {
+        run = op & 0x3Fu;
+      }
+      index[(px[0] * 3u + px[1] * 5u + px[2] * 7u + px[3] * 11u) % 64u] = px;
+    }
+    image.pixels.insert(image.pixels.end(), px.begin(), px.begin() + image.channels);
+  }
+  static constexpr std::array<uint8_t, 8> tail{0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u};
+  if (pos != end || !std::equal(tail.begin(), tail.end(), qoi.begin() + static_cast<std::ptrdiff_t>(end))) {
+    return std::nullopt;
+  }
+  return image;
+}
+
+std::vector<uint8_t> read_file(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+PH_TEST("primehost.imageencode", "png round trips in every mode") {
+  // 700 px RGBA rows put the larger image over two deflate bands.
+  const std::array<TestImage, 2> images{make_image(37u, 23u), make_image(700u, 700u)};
+  for (const TestImage& image : images) {
+    for (bool alpha : {false, true}) {
+      size_t storedSize = 0u;
+      for (PngCompression compression : {PngCompression::Stored, PngCompression::Fast}) {
+        ImageEncodeConfig config{};
+        config.alpha = alpha;
+        config.pngCompression = compression;
+        const auto png = encode(image.view(), config);
+        auto decoded = decode_png(png);
+        PH_REQUIRE(decoded.has_value());
+        PH_CHECK(decoded->width == image.size.width);
+        PH_CHECK(decoded->height == image.size.height);
+        PH_CHECK(decoded->channels == (alpha ? 4u : 3u));
+        PH_CHECK(decoded->pixels == expected_rgb(image, alpha));
+        if (compression == PngCompression::Stored) {
+          storedSize = png.size();
+        } else {
+          PH_CHECK(png.size() < storedSize);
+        }
+      }
+    }
+  }
+}
+
+PH_TEST("primehost.imageencode", "png output does not depend on thread count") {
+  const TestImage image = make_image(700u, 700u);
+  ImageEncodeConfig config{};
+  config.alpha = true;
+  config.threadCount = 1u;
+  const auto single = encode(image.view(), config);
+  for (uint32_t threads : {2u, 3u, 8u, 0u}) {
+    config.threadCount = threads;
+    PH_CHECK(encode(image.view(), config) == single);
+  }
+}
+
+PH_TEST("primehost.imageencode", "qoi round trips with and without alpha") {
+  const TestImage image = make_image(61u, 45u);
+  for (bool alpha : {false, true}) {
+    ImageEncodeConfig config{};
+    config.format = ImageFileFormat::Qoi;
+    config.alpha = alpha;
+    auto decoded = decode_qoi(encode(image.view(), config));
+    PH_REQUIRE(decoded.has_value());
+    PH_CHECK(decoded->width == image.size.width);
+    PH_CHECK(decoded->channels == (alpha ? 4u : 3u));
+    PH_CHECK(decoded->pixels == expected_rgb(image, alpha));
+  }
+
+  // Long flat runs collapse to run opcodes.
+  std::vector<uint8_t> flat(256u * 256u * 4u, 0x7Fu);
+  ImageEncodeConfig config{};
+  config.format = ImageFileFormat::Qoi;
+  const auto qoi = encode(ImageView{ImageSize{256u, 256u}, 1024u, ColorFormat::B8G8R8A8_UNORM, flat}, config);
+  PH_CHECK(qoi.size() < 1200u);
+}
+
+PH_TEST("primehost.imageencode", "invalid views and short buffers are rejected") {
+  const TestImage image = make_image(16u, 8u);
+  std::vector<uint8_t> out(1u << 16u);
+
+  ImageView empty = image.view();
+  empty.size.height = 0u;
+  ImageView narrow = image.view();
+  narrow.stride = 60u;
+  ImageView truncated = image.view();
+  truncated.pixels = truncated.pixels.first(truncated.pixels.size() - 13u);
+  for (const ImageView& view : {empty, narrow, truncated}) {
+    auto result = encodeImage(view, out);
+    PH_REQUIRE(!result.has_value());
+    PH_CHECK(result.error().code == HostErrorCode::InvalidConfig);
+    PH_CHECK(!captureImage(view).has_value());
+  }
+  PH_CHECK(!maxEncodedImageSize(ImageSize{0u, 4u}).has_value());
+
+  for (ImageFileFormat format : {ImageFileFormat::Png, ImageFileFormat::Qoi}) {
+    ImageEncodeConfig config{};
+    config.format = format;
+    auto small = encodeImage(image.view(), std::span<uint8_t>(out).first(40u), config);
+    PH_REQUIRE(!small.has_value());
+    PH_CHECK(small.error().code == HostErrorCode::BufferTooSmall);
+  }
+}
+
+PH_TEST("primehost.imageencode", "captured images encode like the source") {
+  const TestImage image = make_image(33u, 17u);
+  auto captured = captureImage(image.view());
+  PH_REQUIRE(captured.has_value());
+  PH_CHECK(captured->pixels.size() == 33u * 17u * 4u);
+  PH_CHECK(encode(captured->view(), {}) == encode(image.view(), {}));
+}
+
+PH_TEST("primehost.imageencode", "image files take their format from the extension") {
+  PH_CHECK(imageFileFormatForPath("shot.PNG") == ImageFileFormat::Png);
+  PH_CHECK(imageFileFormatForPath("/tmp/a.qoi") == ImageFileFormat::Qoi);
+  PH_CHECK(!imageFileFormatForPath("shot.bmp").has_value());
+  PH_CHECK(!imageFileFormatForPath("qoi").has_value());
+
+  const TestImage image = make_image(20u, 10u);
+  const auto dir = std::filesystem::temp_directory_path();
+  PH_REQUIRE(writeImageFile(image.view(), (dir / "primehost_encode.png").string()).has_value());
+  PH_REQUIRE(writeImageFile(image.view(), (dir / "primehost_encode.qoi").string()).has_value());
+  PH_CHECK(decode_png(read_file(dir / "primehost_encode.png")).has_value());
+  PH_CHECK(decode_qoi(read_file(dir / "primehost_encode.qoi")).has_value());
+  auto unknown = writeImageFile(image.view(), (dir / "primehost_encode.bmp").string());
+  PH_REQUIRE(!unknown.has_value());
+  PH_CHECK(unknown.error().code == HostErrorCode::InvalidConfig);
+  std::filesystem::remove(dir / "primehost_encode.png");
+  std::filesystem::remove(dir / "primehost_encode.qoi");
+}
+
+PH_TEST("primehost.imageencode", "replay host screenshots the last presented frame") {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto logPath = dir / "primehost_encode_replay.phel";
+  {
+    auto recorder = createEventRecorder(logPath.string());
+    PH_REQUIRE(recorder.has_value());
+    Event resize{};
+    resize.scope = Event::Scope::Surface;
+    resize.surfaceId = SurfaceId{1u};
+    resize.time = std::chrono::steady_clock::now();
+    resize.payload = ResizeEvent{12u, 6u, 1.0f};
+    std::array<Event, 1> batch{resize};
+    PH_REQUIRE((*recorder)->recordEvents(EventBatch{batch, {}}).has_value());
+  }
+  auto replay = createReplayHost(ReplayConfig{logPath.string(), 0.0});
+  PH_REQUIRE(replay.has_value());
+  ReplayHost& host = **replay;
+  auto surface = host.createSurface(SurfaceConfig{12u, 6u, true, true, std::nullopt});
+  PH_REQUIRE(surface.has_value());
+
+  const auto shotPath = dir / "primehost_encode_replay.png";
+  auto early = host.writeSurfaceScreenshot(*surface, shotPath.string());
+  PH_REQUIRE(!early.has_value());
+  PH_CHECK(early.error().code == HostErrorCode::PlatformFailure);
+
+  auto buffer = host.acquireFrameBuffer(*surface);
+  PH_REQUIRE(buffer.has_value());
+  for (size_t i = 0; i < buffer->pixels.size(); i += 4u) {
+    buffer->pixels[i] = 0x10u;
+    buffer->pixels[i + 1u] = 0x20u;
+    buffer->pixels[i + 2u] = 0x30u;
+    buffer->pixels[i + 3u] = 0xFFu;
+  }
+  PH_REQUIRE(host.presentFrameBuffer(*surface, *buffer).has_value());
+  PH_REQUIRE(host.writeSurfaceScreenshot(*surface, shotPath.string()).has_value());
+  auto decoded = decode_png(read_file(shotPath));
+  PH_REQUIRE(decoded.has_value());
+  PH_CHECK(decoded->width == buffer->size.width);
+  PH_CHECK(decoded->height == buffer->size.height);
+  PH_CHECK(decoded->pixels[0] == 0x30u);
+  PH_CHECK(decoded->pixels[2] == 0x10u);
+  PH_CHECK(!host.writeSurfaceScreenshot(SurfaceId{99u}, shotPath.string()).has_value());
+
+  replay->reset();
+  std::filesystem::remove(shotPath);
+  std::filesystem::remove(logPath);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,219 @@
+#include "PrimeHost/PrimeHost.h"
+#include "CoreTopology.h"
+#include "WorkStealingDeque.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.jobsystem");
+
+PH_TEST("primehost.jobsystem", "deque pops newest, steals oldest and hands each item out once") {
+  std::vector<int> items(1000);
+  WorkStealingDeque<int> deque(4u);
+  PH_CHECK(deque.pop() == nullptr);
+  PH_CHECK(deque.steal() == nullptr);
+  for (int i = 0; i < 4; ++i) {
+    PH_CHECK(deque.push(&items[i]));
+  }
+  PH_CHECK(!deque.push(&items[4]));
+  PH_CHECK(deque.pop() == &items[3]);
+  PH_CHECK(deque.steal() == &items[0]);
+  PH_CHECK(deque.pop() == &items[2]);
+  PH_CHECK(deque.pop() == &items[1]);
+  PH_CHECK(deque.empty());
+
+  // The owner pushes and pops while thieves steal; every item must surface exactly once.
+  WorkStealingDeque<int> shared(64u);
+  std::vector<std::atomic<uint32_t>> seen(items.size());
+  std::atomic<bool> done{false};
+  auto take = [&](int* item) { seen[static_cast<size_t>(item - items.data())].fetch_add(1u); };
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; ++t) {
+    thieves.emplace_back([&]() {
+      while (!done.load()) {
+        if (int* item = shared.steal()) {
+          take(item);
+        }
+      }
+    });
+  }
+  for (size_t i = 0; i < items.size(); ++i) {
+    while (!shared.push(&items[i])) {
+      if (int* item = shared.pop()) {
+        take(item);
+      }
+    }
+    if (i % 3u == 0u) {
+      if (int* item = shared.pop()) {
+        take(item);
+      }
+    }
+  }
+  while (int* item = shared.pop()) {
+    take(item);
+  }
+  done.store(true);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  bool once = true;
+  for (auto& count : seen) {
+    once = once && count.load() == 1u;
+  }
+  PH_CHECK(once);
+}
+
+PH_TEST("primehost.jobsystem", "parallelFor runs every index once, nested and from many callers") {
+  JobSystemConfig config{};
+  config.workerCount = 3u;
+  config.coreClass = CoreClass::Any;
+  auto system = createJobSystem(config);
+  PH_REQUIRE(system.has_value());
+  JobSystem& jobs = **system;
+  PH_CHECK(jobs.concurrency() == 4u);
+
+  std::vector<std::atomic<uint32_t>> hits(64u * 64u);
+  jobs.parallelFor(64u, 0u, [&](uint32_t outer) {
+    jobs.parallelFor(64u, 0u, [&](uint32_t inner) { hits[outer * 64u + inner].fetch_add(1u); });
+  });
+  // Callers outside the pool share it too.
+  std::vector<std::thread> callers;
+  for (uint32_t c = 0; c < 3u; ++c) {
+    callers.emplace_back([&, c]() {
+      jobs.parallelFor(1000u, 0u, [&](uint32_t i) { hits[(c * 1000u + i) % hits.size()].fetch_add(1u); });
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  uint32_t total = 0u;
+  bool allHit = true;
+  for (auto& hit : hits) {
+    allHit = allHit && hit.load() >= 1u;
+    total += hit.load();
+  }
+  PH_CHECK(allHit);
+  PH_CHECK(total == 64u * 64u + 3000u);
+
+  // maxConcurrency 1 keeps the work on the caller.
+  const auto caller = std::this_thread::get_id();
+  bool inline_only = true;
+  jobs.parallelFor(100u, 1u, [&](uint32_t) { inline_only = inline_only && std::this_thread::get_id() == caller; });
+  PH_CHECK(inline_only);
+
+  std::vector<uint32_t> range(1001u, 0u);
+  parallelForRange(jobs, 1001u, 64u, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      ++range[i];
+    }
+  });
+  PH_CHECK(std::all_of(range.begin(), range.end(), [](uint32_t value) { return value == 1u; }));
+
+  std::vector<uint32_t> area(100u * 70u, 0u);
+  parallelForTiles(jobs, 100u, 70u, 32u, [&](const JobTile& tile) {
+    for (uint32_t y = tile.y; y < tile.y + tile.height; ++y) {
+      for (uint32_t x = tile.x; x < tile.x + tile.width; ++x) {
+        ++area[y * 100u + x];
+      }
+    }
+  });
+  PH_CHECK(std::all_of(area.begin(), area.end(), [](uint32_t value) { return value == 1u; }));
+
+  const JobSystemStats stats = jobs.stats();
+  PH_CHECK(stats.workerCount == 3u);
+  PH_CHECK(stats.placedWorkers == 0u);
+  PH_CHECK(stats.tasksExecuted >= 64u * 64u + 3000u + 100u);
+}
+
+PH_TEST("primehost.jobsystem", "callers outside the pool park while helpers finish") {
+  JobSystemConfig config{};
+  config.workerCount = 2u;
+  config.coreClass = CoreClass::Any;
+  auto system = createJobSystem(config);
+  PH_REQUIRE(system.has_value());
+  auto thread_cpu_ms = []() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1.0e6;
+  };
+  const auto caller = std::this_thread::get_id();
+  std::atomic<uint32_t> ran{0u};
+  const double cpuBefore = thread_cpu_ms();
+  const auto wallBefore = std::chrono::steady_clock::now();
+  // Indices the helpers take are slow, so the caller finishes its own and then waits on them.
+  (*system)->parallelFor(8u, 0u, [&](uint32_t) {
+    if (std::this_thread::get_id() != caller) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    }
+    ran.fetch_add(1u);
+  });
+  const double waitedMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallBefore).count();
+  PH_CHECK(ran.load() == 8u);
+  if (waitedMs >= 40.0) {
+    PH_CHECK(thread_cpu_ms() - cpuBefore < waitedMs * 0.5);
+  }
+}
+
+PH_TEST("primehost.jobsystem", "host work runs on the default executor") {
+  struct CountingExecutor final : JobExecutor {
+    std::atomic<uint32_t> calls{0u};
+    uint32_t concurrency() const override { return 2u; }
+    void parallelFor(uint32_t count, uint32_t, const std::function<void(uint32_t)>& task) override {
+      calls.fetch_add(1u);
+      for (uint32_t i = 0; i < count; ++i) {
+        task(i);
+      }
+    }
+  };
+  auto executor = std::make_shared<CountingExecutor>();
+  setDefaultJobExecutor(executor);
+  PH_CHECK(defaultJobExecutor() == executor);
+
+  std::vector<uint8_t> pixels(1024u * 1024u * 4u, 0u);
+  FrameBuffer buffer{};
+  buffer.size = ImageSize{1024u, 1024u};
+  buffer.stride = 1024u * 4u;
+  buffer.pixels = pixels;
+  PixelOpsConfig config{};
+  config.threadCount = 4u;
+  PH_REQUIRE(clearFrameBuffer(buffer, PixelColor{}, config).has_value());
+  PH_CHECK(executor->calls.load() == 1u);
+
+  setDefaultJobExecutor(nullptr);
+  PH_CHECK(defaultJobExecutor() != executor);
+  PH_REQUIRE(clearFrameBuffer(buffer, PixelColor{1u, 2u, 3u, 4u}, config).has_value());
+  PH_CHECK(executor->calls.load() == 1u);
+  PH_CHECK(pixels.back() == 4u);
+}
+
+PH_TEST("primehost.jobsystem", "cores split into performance and efficiency classes") {
+  // Hybrid x86: two favored P-cores boost above the rest; E-cores run far slower.
+  const CpuCapacity hybrid[] = {{0u, 5800000u}, {1u, 5800000u}, {2u, 5500000u}, {3u, 5500000u},
+                                {4u, 4300000u}, {5u, 4300000u}, {6u, 4300000u}, {7u, 4300000u}};
+  const CoreTopology topology = classifyCores(hybrid);
+  PH_CHECK(topology.hybrid());
+  PH_CHECK(topology.performanceCores == 4u);
+  PH_CHECK(topology.efficiencyCores == 4u);
+  PH_CHECK(topology.efficiencyCpus.front() == 4u);
+
+  const CpuCapacity uniform[] = {{0u, 1024u}, {1u, 1024u}, {2u, 1024u}};
+  const CoreTopology flat = classifyCores(uniform);
+  PH_CHECK(!flat.hybrid());
+  PH_CHECK(flat.performanceCores == 3u);
+  PH_CHECK(!placeCurrentThread(flat, CoreClass::Performance));
+
+  const CoreTopology local = queryCoreTopology();
+  PH_CHECK(local.performanceCores + local.efficiencyCores >= 1u);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,45 @@
+#include "PerfectHashUtil.h"
+
+#include "tests/unit/test_helpers.h"
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.perfecthash");
+
+namespace {
+
+constexpr std::array<uint32_t, 256> make_keys() {
+  std::array<uint32_t, 256> keys{};
+  for (uint32_t i = 0; i < keys.size(); ++i) {
+    keys[i] = (0x045Eu + i * 7u) << 16u | (i * 0x1F3u & 0xFFFFu);
+  }
+  return keys;
+}
+
+constexpr auto kKeys = make_keys();
+constexpr PerfectHashTable<kKeys.size()> kTable(kKeys);
+static_assert(kTable.valid());
+static_assert(kTable.find(kKeys[17]) == 17u);
+
+} // namespace
+
+PH_TEST("primehost.perfecthash", "finds every key") {
+  for (uint32_t i = 0; i < kKeys.size(); ++i) {
+    auto index = kTable.find(kKeys[i]);
+    PH_REQUIRE(index.has_value());
+    PH_CHECK(*index == i);
+  }
+  PH_CHECK(!kTable.find(0u).has_value());
+  PH_CHECK(!kTable.find(kKeys[3] + 1u).has_value());
+}
+
+PH_TEST("primehost.perfecthash", "rejects duplicates") {
+  constexpr PerfectHashTable<3> duplicate(std::array<uint32_t, 3>{1u, 2u, 1u});
+  PH_CHECK(!duplicate.valid());
+  constexpr PerfectHashTable<1> single(std::array<uint32_t, 1>{42u});
+  PH_CHECK(single.valid());
+  PH_CHECK(single.find(42u) == 0u);
+  PH_CHECK(!single.find(43u).has_value());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,194 @@
+#include "PrimeHost/PrimeHost.h"
+#include "PixelOpKernels.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.pixelops");
+
+namespace {
+
+std::vector<uint8_t> noise(size_t bytes, uint32_t seed) {
+  std::vector<uint8_t> out(bytes);
+  for (uint8_t& byte : out) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(seed >> 24u);
+  }
+  return out;
+}
+
+struct Frame {
+  ImageSize size;
+  uint32_t stride = 0u;
+  std::vector<uint8_t> pixels;
+
+  Frame(uint32_t width, uint32_t height, uint32_t seed = 5u)
+      : size{width, height}, stride(width * 4u + 12u), pixels(noise(static_cast<size_t>(stride) * height, seed)) {}
+
+  const uint8_t* pixel(uint32_t x, uint32_t y) const {
+    return pixels.data() + static_cast<size_t>(y) * stride + x * 4u;
+  }
+  FrameBuffer buffer() {
+    FrameBuffer out{};
+    out.size = size;
+    out.stride = stride;
+    out.pixels = pixels;
+    return out;
+  }
+  ImageView view() const { return ImageView{size, stride, ColorFormat::B8G8R8A8_UNORM, pixels}; }
+};
+
+// Runs everything on the caller and counts the tasks it was handed.
+struct CountingExecutor final : JobExecutor {
+  uint32_t tasks = 0u;
+
+  uint32_t concurrency() const override { return 1u; }
+  void parallelFor(uint32_t count, uint32_t, const std::function<void(uint32_t)>& task) override {
+    for (uint32_t i = 0; i < count; ++i) {
+      task(i);
+      ++tasks;
+    }
+  }
+};
+
+bool is_color(const uint8_t* pixel, uint8_t b, uint8_t g, uint8_t r, uint8_t a) {
+  return pixel[0] == b && pixel[1] == g && pixel[2] == r && pixel[3] == a;
+}
+
+} // namespace
+
+PH_TEST("primehost.pixelops", "kernels match the scalar reference on every tail length") {
+  // One spare pixel past the longest run keeps GCC's vectorized-loop bounds check quiet.
+  auto src = noise(68u * 4u, 11u);
+  const auto dst = noise(68u * 4u, 12u);
+  // Premultiply, and make a run of the source opaque to cover the copy path.
+  for (size_t i = 0; i < src.size(); i += 4u) {
+    if (i >= 16u && i < 48u) {
+      src[i + 3u] = 255u;
+    }
+    for (size_t c = 0; c < 3u; ++c) {
+      src[i + c] = std::min(src[i + c], src[i + 3u]);
+    }
+  }
+  for (uint32_t count = 0u; count <= 67u; ++count) {
+    auto fast = dst;
+    auto slow = dst;
+    blendPixels(fast.data(), src.data(), count);
+    blendPixelsScalar(slow.data(), src.data(), 0u, count);
+    PH_CHECK(fast == slow);
+
+    fast = dst;
+    slow = dst;
+    fillPixels(fast.data(), count, 0x80402010u);
+    fillPixelsScalar(slow.data(), 0u, count, 0x80402010u);
+    PH_CHECK(fast == slow);
+  }
+
+  const auto top = noise(9u * 4u, 13u);
+  const auto bottom = noise(9u * 4u, 14u);
+  std::vector<BilinearTap> taps;
+  for (uint32_t x0 = 0u; x0 < 8u; ++x0) {
+    for (uint32_t fx : {0u, 1u, 128u, 255u, 256u}) {
+      taps.push_back(BilinearTap{x0, fx});
+    }
+  }
+  const auto count = static_cast<uint32_t>(taps.size());
+  for (uint32_t fy : {0u, 77u, 256u}) {
+    std::vector<uint8_t> fast(count * 4u);
+    std::vector<uint8_t> slow(count * 4u);
+    bilinearRow(fast.data(), top.data(), bottom.data(), taps.data(), count, fy);
+    bilinearRowScalar(slow.data(), top.data(), bottom.data(), taps.data(), 0u, count, fy);
+    PH_CHECK(fast == slow);
+  }
+}
+
+PH_TEST("primehost.pixelops", "fills are clipped and parallel bands cover every row") {
+  Frame frame(700u, 500u);
+  const Frame before = frame;
+  PixelOpsConfig config{};
+  config.rowsPerTask = 7u;
+  config.threadCount = 4u;
+  PH_REQUIRE(clearFrameBuffer(frame.buffer(), PixelColor{10u, 20u, 30u, 40u}, config).has_value());
+  bool cleared = true;
+  for (uint32_t y = 0; y < frame.size.height; ++y) {
+    for (uint32_t x = 0; x < frame.size.width; ++x) {
+      cleared = cleared && is_color(frame.pixel(x, y), 30u, 20u, 10u, 40u);
+    }
+    // Row padding is left alone.
+    cleared = cleared && frame.pixel(frame.size.width, y)[0] == before.pixel(frame.size.width, y)[0];
+  }
+  PH_CHECK(cleared);
+
+  PH_REQUIRE(fillRect(frame.buffer(), PixelRect{-5, 490, 10u, 20u}, PixelColor{1u, 2u, 3u, 4u}).has_value());
+  PH_CHECK(is_color(frame.pixel(0u, 490u), 3u, 2u, 1u, 4u));
+  PH_CHECK(is_color(frame.pixel(4u, 499u), 3u, 2u, 1u, 4u));
+  PH_CHECK(is_color(frame.pixel(5u, 499u), 30u, 20u, 10u, 40u));
+  PH_CHECK(is_color(frame.pixel(0u, 489u), 30u, 20u, 10u, 40u));
+  PH_CHECK(fillRect(frame.buffer(), PixelRect{800, 0, 10u, 10u}, PixelColor{}).has_value());
+
+  CountingExecutor executor;
+  config.executor = &executor;
+  PH_REQUIRE(clearFrameBuffer(frame.buffer(), PixelColor{}, config).has_value());
+  PH_CHECK(executor.tasks == (500u + 6u) / 7u);
+  PH_CHECK(is_color(frame.pixel(699u, 499u), 0u, 0u, 0u, 255u));
+
+  FrameBuffer broken = frame.buffer();
+  broken.stride = 4u;
+  PH_CHECK(!clearFrameBuffer(broken, PixelColor{}).has_value());
+}
+
+PH_TEST("primehost.pixelops", "blending composites premultiplied sources with clipping") {
+  Frame frame(8u, 8u);
+  PH_REQUIRE(clearFrameBuffer(frame.buffer(), PixelColor{0u, 0u, 200u, 255u}).has_value());
+  // Half-transparent premultiplied red over opaque blue.
+  std::vector<uint8_t> sprite(4u * 4u * 4u);
+  for (size_t i = 0; i < sprite.size(); i += 4u) {
+    sprite[i + 0u] = 0u;
+    sprite[i + 1u] = 0u;
+    sprite[i + 2u] = 128u;
+    sprite[i + 3u] = 128u;
+  }
+  const ImageView source{ImageSize{4u, 4u}, 16u, ColorFormat::B8G8R8A8_UNORM, sprite};
+  PH_REQUIRE(blendImage(frame.buffer(), source, 6, -2).has_value());
+  PH_CHECK(is_color(frame.pixel(6u, 0u), 100u, 0u, 128u, 255u));
+  PH_CHECK(is_color(frame.pixel(7u, 1u), 100u, 0u, 128u, 255u));
+  PH_CHECK(is_color(frame.pixel(5u, 0u), 200u, 0u, 0u, 255u));
+  PH_CHECK(is_color(frame.pixel(6u, 2u), 200u, 0u, 0u, 255u));
+  PH_CHECK(blendImage(frame.buffer(), source, -4, 0).has_value());
+  PH_CHECK(is_color(frame.pixel(0u, 0u), 200u, 0u, 0u, 255u));
+}
+
+PH_TEST("primehost.pixelops", "scaling samples pixel centers with both filters") {
+  // 2x2 source: black, white / white, black.
+  std::vector<uint8_t> checker = {0u, 0u, 0u, 255u, 255u, 255u, 255u, 255u,
+                                  255u, 255u, 255u, 255u, 0u, 0u, 0u, 255u};
+  const ImageView source{ImageSize{2u, 2u}, 8u, ColorFormat::B8G8R8A8_UNORM, checker};
+  Frame frame(4u, 4u);
+
+  PH_REQUIRE(scaleImage(frame.buffer(), PixelRect{0, 0, 4u, 4u}, source, ScaleFilter::Nearest).has_value());
+  PH_CHECK(is_color(frame.pixel(1u, 1u), 0u, 0u, 0u, 255u));
+  PH_CHECK(is_color(frame.pixel(2u, 1u), 255u, 255u, 255u, 255u));
+  PH_CHECK(is_color(frame.pixel(3u, 3u), 0u, 0u, 0u, 255u));
+
+  PH_REQUIRE(scaleImage(frame.buffer(), PixelRect{0, 0, 4u, 4u}, source, ScaleFilter::Bilinear).has_value());
+  // Corners clamp to the source corners; inner pixels mix a quarter of the opposite color.
+  PH_CHECK(is_color(frame.pixel(0u, 0u), 0u, 0u, 0u, 255u));
+  PH_CHECK(is_color(frame.pixel(3u, 0u), 255u, 255u, 255u, 255u));
+  PH_CHECK(frame.pixel(1u, 1u)[0] > 90u);
+  PH_CHECK(frame.pixel(1u, 1u)[0] < 100u);
+  PH_CHECK(frame.pixel(1u, 1u)[3] == 255u);
+
+  // Clipping keeps the sampling grid of the whole rect.
+  Frame clipped(2u, 4u);
+  PH_REQUIRE(scaleImage(clipped.buffer(), PixelRect{-2, 0, 4u, 4u}, source, ScaleFilter::Bilinear).has_value());
+  for (uint32_t y = 0; y < 4u; ++y) {
+    for (uint32_t x = 0; x < 2u; ++x) {
+      PH_CHECK(std::equal(clipped.pixel(x, y), clipped.pixel(x, y) + 4, frame.pixel(x + 2u, y)));
+    }
+  }
+}
+
+TEST_SUITE_END();
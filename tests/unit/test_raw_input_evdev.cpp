@@ -0,0 +1,219 @@
+#include "platform/linux/RawInputEvdev.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.rawinput.evdev");
+
+namespace {
+
+// Stand-in for an evdev node: the reader consumes recorded input_event records from a pipe.
+struct RecordedDevice {
+  int readFd = -1;
+  int writeFd = -1;
+
+  RecordedDevice() {
+    int fds[2] = {-1, -1};
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+      readFd = fds[0];
+      writeFd = fds[1];
+    }
+  }
+
+  ~RecordedDevice() {
+    if (writeFd >= 0) {
+      close(writeFd);
+    }
+  }
+
+  void send(std::initializer_list<input_event> events) {
+    std::vector<input_event> buffer(events);
+    const ssize_t bytes = write(writeFd, buffer.data(), buffer.size() * sizeof(input_event));
+    PH_REQUIRE(bytes == static_cast<ssize_t>(buffer.size() * sizeof(input_event)));
+  }
+};
+
+input_event ev(uint16_t type, uint16_t code, int32_t value) {
+  input_event event{};
+  event.type = type;
+  event.code = code;
+  event.value = value;
+  return event;
+}
+
+input_event syn() {
+  return ev(EV_SYN, SYN_REPORT, 0);
+}
+
+input_event syn_at(double seconds) {
+  input_event event = syn();
+  event.input_event_sec = static_cast<decltype(event.input_event_sec)>(seconds);
+  event.input_event_usec =
+      static_cast<decltype(event.input_event_usec)>((seconds - static_cast<double>(event.input_event_sec)) * 1e6);
+  return event;
+}
+
+EvdevDeviceInfo gaming_mouse(bool hiResWheel) {
+  EvdevDeviceInfo info{};
+  info.name = "Logitech G502 HERO Gaming Mouse";
+  info.relative[REL_X] = true;
+  info.relative[REL_Y] = true;
+  info.relative[REL_WHEEL] = true;
+  info.relative[REL_WHEEL_HI_RES] = hiResWheel;
+  info.keys[BTN_LEFT] = true;
+  info.keys[BTN_RIGHT] = true;
+  info.keys[BTN_MIDDLE] = true;
+  return info;
+}
+
+EvdevDeviceInfo pen_tablet() {
+  EvdevDeviceInfo info{};
+  info.name = "Wacom Intuos Pro M Pen";
+  info.keys[BTN_TOOL_PEN] = true;
+  info.keys[BTN_TOUCH] = true;
+  info.keys[BTN_STYLUS] = true;
+  for (auto [code, maximum] : std::array<std::pair<uint32_t, int32_t>, 3>{
+           {{ABS_X, 44800}, {ABS_Y, 29600}, {ABS_PRESSURE, 8191}}}) {
+    info.axes[code] = true;
+    info.absInfo[code].maximum = maximum;
+  }
+  info.axes[ABS_TILT_X] = true;
+  info.absInfo[ABS_TILT_X].minimum = -64;
+  info.absInfo[ABS_TILT_X].maximum = 63;
+  return info;
+}
+
+std::vector<RawInputSample> feed(EvdevRawPointer& pointer, std::initializer_list<input_event> events) {
+  std::vector<RawInputSample> samples;
+  const auto now = std::chrono::steady_clock::now();
+  for (const input_event& event : events) {
+    RawInputSample sample;
+    if (pointer.handle(event, 0.0, now, sample)) {
+      samples.push_back(sample);
+    }
+  }
+  return samples;
+}
+
+} // namespace
+
+PH_TEST("primehost.rawinput.evdev", "pointer classification") {
+  PH_CHECK(EvdevRawPointer::looksLikePointer(gaming_mouse(false)));
+  PH_CHECK(EvdevRawPointer::looksLikePointer(pen_tablet()));
+  EvdevDeviceInfo keyboard{};
+  keyboard.keys[KEY_A] = true;
+  PH_CHECK(!EvdevRawPointer::looksLikePointer(keyboard));
+  EvdevRawPointer pen(1u, pen_tablet());
+  PH_CHECK(pen.deviceType() == RawInputDeviceType::Pen);
+}
+
+PH_TEST("primehost.rawinput.evdev", "mouse report becomes one sample") {
+  EvdevRawPointer mouse(3u, gaming_mouse(false));
+  auto samples = feed(mouse,
+                      {ev(EV_REL, REL_X, 4),
+                       ev(EV_REL, REL_Y, -2),
+                       ev(EV_KEY, BTN_LEFT, 1),
+                       syn(),
+                       syn(),
+                       ev(EV_REL, REL_X, 1),
+                       ev(EV_REL, REL_WHEEL, -1),
+                       ev(EV_KEY, BTN_LEFT, 0),
+                       syn()});
+  PH_REQUIRE(samples.size() == 2u);
+  PH_CHECK(samples[0].deviceId == 3u);
+  PH_CHECK(samples[0].deviceType == RawInputDeviceType::Mouse);
+  PH_CHECK(samples[0].deltaX == 4);
+  PH_CHECK(samples[0].deltaY == -2);
+  PH_CHECK(samples[0].buttons == 1u);
+  PH_CHECK(samples[1].deltaX == 1);
+  PH_CHECK(samples[1].deltaY == 0);
+  PH_CHECK(samples[1].scrollY == -1.0f);
+  PH_CHECK(samples[1].buttons == 0u);
+}
+
+PH_TEST("primehost.rawinput.evdev", "high resolution wheel replaces detent counts") {
+  EvdevRawPointer mouse(1u, gaming_mouse(true));
+  auto samples = feed(mouse, {ev(EV_REL, REL_WHEEL_HI_RES, 60), ev(EV_REL, REL_WHEEL, 1), syn()});
+  PH_REQUIRE(samples.size() == 1u);
+  PH_CHECK(samples[0].scrollY == 0.5f);
+}
+
+PH_TEST("primehost.rawinput.evdev", "pen axes are normalized") {
+  EvdevRawPointer pen(2u, pen_tablet());
+  auto samples = feed(pen,
+                      {ev(EV_KEY, BTN_TOOL_PEN, 1),
+                       ev(EV_ABS, ABS_X, 22400),
+                       ev(EV_ABS, ABS_Y, 29600),
+                       ev(EV_ABS, ABS_PRESSURE, 8191),
+                       ev(EV_ABS, ABS_TILT_X, -64),
+                       ev(EV_KEY, BTN_TOUCH, 1),
+                       syn(),
+                       ev(EV_KEY, BTN_TOUCH, 0),
+                       ev(EV_KEY, BTN_TOOL_PEN, 0),
+                       syn()});
+  PH_REQUIRE(samples.size() == 2u);
+  PH_CHECK(samples[0].x == 0.5f);
+  PH_CHECK(samples[0].y == 1.0f);
+  PH_CHECK(samples[0].pressure == 1.0f);
+  PH_CHECK(samples[0].tiltX == -1.0f);
+  PH_CHECK(samples[0].buttons == 1u);
+  PH_CHECK(samples[1].buttons == 0u);
+  PH_CHECK(samples[1].pressure == 0.0f);
+}
+
+PH_TEST("primehost.rawinput.evdev", "event timestamps map onto steady clock") {
+  EvdevRawPointer mouse(1u, gaming_mouse(false));
+  const auto now = std::chrono::steady_clock::now();
+  RawInputSample sample;
+  PH_CHECK(!mouse.handle(ev(EV_REL, REL_X, 1), 100.0, now, sample));
+  PH_REQUIRE(mouse.handle(syn_at(99.75), 100.0, now, sample));
+  const auto age = std::chrono::duration_cast<std::chrono::microseconds>(now - sample.time);
+  PH_CHECK(age.count() == 250000);
+}
+
+PH_TEST("primehost.rawinput.evdev", "reader thread fills queue and skips dropped reports") {
+  RawInputQueue queue;
+  queue.reset(64u);
+  LinuxRawInputReader reader;
+  PH_REQUIRE(reader.start(queue, false).has_value());
+  RecordedDevice device;
+  auto deviceId = reader.addDevice(device.readFd, gaming_mouse(false));
+  PH_REQUIRE(deviceId.has_value());
+
+  device.send({ev(EV_REL, REL_X, 5),
+               syn(),
+               ev(EV_REL, REL_X, 7),
+               ev(EV_SYN, SYN_DROPPED, 0),
+               ev(EV_REL, REL_X, 9),
+               syn(),
+               ev(EV_REL, REL_Y, 3),
+               syn()});
+
+  std::array<RawInputSample, 16> out{};
+  std::vector<RawInputSample> received;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (received.size() < 2u && std::chrono::steady_clock::now() < deadline) {
+    RawInputBatch batch = queue.drain(out);
+    received.insert(received.end(), batch.samples.begin(), batch.samples.end());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  reader.stop();
+  PH_CHECK(!reader.running());
+  PH_REQUIRE(received.size() == 2u);
+  PH_CHECK(received[0].deviceId == *deviceId);
+  PH_CHECK(received[0].deltaX == 5);
+  PH_CHECK(received[1].deltaX == 0);
+  PH_CHECK(received[1].deltaY == 3);
+  PH_CHECK(!reader.removeDevice(*deviceId).has_value());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,101 @@
+#include "RawInputQueue.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.rawinput");
+
+namespace {
+
+RawInputSample sample(int32_t deltaX) {
+  RawInputSample value{};
+  value.deviceId = 1u;
+  value.deltaX = deltaX;
+  return value;
+}
+
+} // namespace
+
+PH_TEST("primehost.rawinput", "config validation") {
+  RawInputConfig config{};
+  PH_CHECK(validateRawInputConfig(config).has_value());
+  config.enabled = true;
+  PH_CHECK(validateRawInputConfig(config).has_value());
+  config.capacity = 0u;
+  PH_CHECK(!validateRawInputConfig(config).has_value());
+  config.capacity = RawInputMaxCapacity + 1u;
+  PH_CHECK(!validateRawInputConfig(config).has_value());
+  config.enabled = false;
+  PH_CHECK(validateRawInputConfig(config).has_value());
+}
+
+PH_TEST("primehost.rawinput", "drain returns samples in order") {
+  RawInputQueue queue;
+  queue.reset(8u);
+  for (int32_t i = 0; i < 5; ++i) {
+    PH_CHECK(queue.push(sample(i)));
+  }
+  std::array<RawInputSample, 3> out{};
+  RawInputBatch batch = queue.drain(out);
+  PH_REQUIRE(batch.samples.size() == 3u);
+  PH_CHECK(batch.samples.data() == out.data());
+  PH_CHECK(batch.samples[0].deltaX == 0);
+  PH_CHECK(batch.samples[2].deltaX == 2);
+  PH_CHECK(batch.droppedSamples == 0u);
+
+  batch = queue.drain(out);
+  PH_REQUIRE(batch.samples.size() == 2u);
+  PH_CHECK(batch.samples[0].deltaX == 3);
+  PH_CHECK(batch.samples[1].deltaX == 4);
+  PH_CHECK(queue.drain(out).samples.empty());
+}
+
+PH_TEST("primehost.rawinput", "full ring drops newest and reports count once") {
+  RawInputQueue queue;
+  queue.reset(4u);
+  const size_t capacity = queue.capacity();
+  for (size_t i = 0; i < capacity + 3u; ++i) {
+    queue.push(sample(static_cast<int32_t>(i)));
+  }
+  std::vector<RawInputSample> out(capacity + 3u);
+  RawInputBatch batch = queue.drain(out);
+  PH_CHECK(batch.samples.size() == capacity);
+  PH_CHECK(batch.samples.front().deltaX == 0);
+  PH_CHECK(batch.droppedSamples == 3u);
+  PH_CHECK(queue.drain(out).droppedSamples == 0u);
+}
+
+PH_TEST("primehost.rawinput", "producer thread hands off without loss or reordering") {
+  RawInputQueue queue;
+  queue.reset(256u);
+  constexpr int32_t kSamples = 20000;
+  std::thread producer([&]() {
+    for (int32_t i = 0; i < kSamples;) {
+      if (queue.push(sample(i))) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::array<RawInputSample, 64> out{};
+  int32_t expected = 0;
+  bool ordered = true;
+  while (expected < kSamples) {
+    RawInputBatch batch = queue.drain(out);
+    for (const RawInputSample& value : batch.samples) {
+      ordered = ordered && value.deltaX == expected;
+      ++expected;
+    }
+  }
+  producer.join();
+  PH_CHECK(ordered);
+  PH_CHECK(expected == kSamples);
+}
+
+TEST_SUITE_END();
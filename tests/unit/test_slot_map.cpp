@@ -0,0 +1,68 @@
+#include "SlotMap.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.slotmap");
+
+PH_TEST("primehost.slotmap", "handles resolve to their values and are never zero") {
+  SlotMap<int> map;
+  PH_CHECK(map.find(0u) == nullptr);
+  const auto predicted = map.nextHandle();
+  const auto a = map.insert(std::make_unique<int>(1));
+  const auto b = map.insert(std::make_unique<int>(2));
+  PH_CHECK(a == predicted);
+  PH_CHECK(a != 0u);
+  PH_CHECK(b != 0u);
+  PH_CHECK(a != b);
+  PH_REQUIRE(map.find(a) != nullptr);
+  PH_CHECK(*map.find(a) == 1);
+  PH_CHECK(*map.find(b) == 2);
+  PH_CHECK(map.size() == 2u);
+  PH_CHECK(!map.contains(b + 1u));
+}
+
+PH_TEST("primehost.slotmap", "stale handles miss after their slot is reused") {
+  SlotMap<int> map;
+  const auto first = map.insert(std::make_unique<int>(1));
+  int* address = map.find(first);
+  auto removed = map.erase(first);
+  PH_REQUIRE(removed != nullptr);
+  PH_CHECK(removed.get() == address);
+  PH_CHECK(map.find(first) == nullptr);
+  PH_CHECK(map.erase(first) == nullptr);
+
+  const auto second = map.insert(std::make_unique<int>(2));
+  // Same slot, new generation.
+  PH_CHECK(static_cast<uint32_t>(second) == static_cast<uint32_t>(first));
+  PH_CHECK(second != first);
+  PH_CHECK(map.find(first) == nullptr);
+  PH_CHECK(*map.find(second) == 2);
+}
+
+PH_TEST("primehost.slotmap", "iteration follows insertion order across erases") {
+  SlotMap<int> map;
+  std::vector<SlotMap<int>::Handle> handles;
+  for (int i = 0; i < 6; ++i) {
+    handles.push_back(map.insert(std::make_unique<int>(i)));
+  }
+  int* stable = map.find(handles[4]);
+  map.erase(handles[1]);
+  map.erase(handles[3]);
+  handles.push_back(map.insert(std::make_unique<int>(6)));
+
+  std::vector<int> order;
+  for (const auto& entry : map) {
+    order.push_back(*entry.value);
+    PH_CHECK(map.find(entry.handle) == entry.value.get());
+  }
+  PH_CHECK(order == std::vector<int>{0, 2, 4, 5, 6});
+  // Values do not move when other entries come and go.
+  PH_CHECK(map.find(handles[4]) == stable);
+  PH_CHECK(*map.find(handles[5]) == 5);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,123 @@
+#include "PrimeHost/PrimeHost.h"
+#include "PrimeHost/SurfacePool.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <array>
+#include <filesystem>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.surfacepool");
+
+namespace {
+
+// ReplayHost over an empty log: a portable Host whose surfaces hold plain pixel vectors.
+std::unique_ptr<ReplayHost> empty_replay_host(const char* name) {
+  const auto logPath = std::filesystem::temp_directory_path() / name;
+  {
+    auto recorder = createEventRecorder(logPath.string());
+    if (!recorder) {
+      return nullptr;
+    }
+  }
+  auto replay = createReplayHost(ReplayConfig{logPath.string(), 0.0});
+  std::filesystem::remove(logPath);
+  return replay ? std::move(*replay) : nullptr;
+}
+
+} // namespace
+
+PH_TEST("primehost.surfacepool", "released surfaces are reused with their pixel storage") {
+  auto host = empty_replay_host("primehost_surface_pool_reuse.phel");
+  PH_REQUIRE(host != nullptr);
+  auto pool = createHeadlessSurfacePool(*host);
+  PH_REQUIRE(pool.has_value());
+
+  auto first = (*pool)->acquire(64u, 64u);
+  PH_REQUIRE(first.has_value());
+  auto buffer = host->acquireFrameBuffer(*first);
+  PH_REQUIRE(buffer.has_value());
+  const uint8_t* storage = buffer->pixels.data();
+  PH_REQUIRE((*pool)->release(*first).has_value());
+  PH_CHECK(!(*pool)->release(*first).has_value());
+
+  // Same size class, smaller frame: the same surface comes back resized in place.
+  auto second = (*pool)->acquire(60u, 50u);
+  PH_REQUIRE(second.has_value());
+  PH_CHECK(*second == *first);
+  auto size = host->surfaceSize(*second);
+  PH_REQUIRE(size.has_value());
+  PH_CHECK(size->width == 60u);
+  PH_CHECK(size->height == 50u);
+  buffer = host->acquireFrameBuffer(*second);
+  PH_REQUIRE(buffer.has_value());
+  PH_CHECK(buffer->pixels.data() == storage);
+  PH_CHECK(buffer->size.width == 60u);
+
+  // A much larger frame gets a new surface.
+  auto large = (*pool)->acquire(512u, 512u);
+  PH_REQUIRE(large.has_value());
+  PH_CHECK(*large != *first);
+
+  const SurfacePoolStats stats = (*pool)->stats();
+  PH_CHECK(stats.created == 2u);
+  PH_CHECK(stats.reused == 1u);
+  PH_CHECK(stats.inUse == 2u);
+  PH_CHECK(stats.idle == 0u);
+  PH_CHECK(!(*pool)->release(SurfaceId{999u}).has_value());
+  PH_CHECK(!(*pool)->acquire(0u, 16u).has_value());
+}
+
+PH_TEST("primehost.surfacepool", "batches acquire together and idle surfaces are capped") {
+  auto host = empty_replay_host("primehost_surface_pool_batch.phel");
+  PH_REQUIRE(host != nullptr);
+  SurfacePoolConfig config{};
+  config.maxIdlePerClass = 2u;
+  auto pool = createHeadlessSurfacePool(*host, config);
+  PH_REQUIRE(pool.has_value());
+
+  std::array<SurfaceId, 4> batch{};
+  PH_REQUIRE((*pool)->acquire(32u, 32u, batch).has_value());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    PH_CHECK(batch[i].isValid());
+    PH_CHECK(host->surfaceSize(batch[i]).has_value());
+    for (size_t j = 0; j < i; ++j) {
+      PH_CHECK(batch[i] != batch[j]);
+    }
+  }
+  for (SurfaceId surface : batch) {
+    PH_REQUIRE((*pool)->release(surface).has_value());
+  }
+  SurfacePoolStats stats = (*pool)->stats();
+  PH_CHECK(stats.idle == 2u);
+  PH_CHECK(stats.destroyed == 2u);
+  PH_CHECK(host->surfaceSize(batch[0]).has_value());
+  PH_CHECK(!host->surfaceSize(batch[3]).has_value());
+
+  // The next batch reuses both idle surfaces and creates the rest.
+  PH_REQUIRE((*pool)->acquire(30u, 30u, batch).has_value());
+  stats = (*pool)->stats();
+  PH_CHECK(stats.reused == 2u);
+  PH_CHECK(stats.created == 6u);
+  PH_CHECK(stats.inUse == 4u);
+
+  // A surface destroyed behind the pool's back is skipped.
+  PH_REQUIRE((*pool)->release(batch[0]).has_value());
+  PH_REQUIRE(host->destroySurface(batch[0]).has_value());
+  auto replacement = (*pool)->acquire(30u, 30u);
+  PH_REQUIRE(replacement.has_value());
+  PH_CHECK(host->surfaceSize(*replacement).has_value());
+
+  PH_REQUIRE((*pool)->release(*replacement).has_value());
+  (*pool)->trim();
+  PH_CHECK((*pool)->stats().idle == 0u);
+  PH_CHECK(!host->surfaceSize(*replacement).has_value());
+
+  // Destroying the pool destroys what it still holds.
+  const SurfaceId held = batch[1];
+  pool->reset();
+  PH_CHECK(!host->surfaceSize(held).has_value());
+}
+
+TEST_SUITE_END();
@@ -5,6 +5,9 @@
 #include "tests/unit/test_helpers.h"
 
 #include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
 
 using namespace PrimeHost;
 
@@ -68,4 +71,114 @@ PH_TEST("primehost.text_buffer", "span overflow fails") {
   PH_CHECK(span.error().code == HostErrorCode::BufferTooSmall);
 }
 
+namespace {
+
+Event text_event(TextSpan span) {
+  TextEvent text{};
+  text.text = span;
+  Event event{};
+  event.payload = InputEvent{text};
+  return event;
+}
+
+Event drop_event(TextSpan span, uint32_t count) {
+  DropEvent drop{};
+  drop.paths = span;
+  drop.count = count;
+  Event event{};
+  event.payload = drop;
+  return event;
+}
+
+std::string_view span_text(std::span<const char> bytes, const TextSpan* span) {
+  return std::string_view(bytes.data() + span->offset, span->length);
+}
+
+} // namespace
+
+PH_TEST("primehost.text_buffer", "arena joins paths in place and reuses capacity") {
+  TextArena arena;
+  auto hello = arena.append("hello");
+  PH_REQUIRE(hello.has_value());
+  const size_t begin = arena.size();
+  PH_CHECK(arena.append("/a").has_value());
+  PH_CHECK(arena.append(std::string_view("\0", 1u)).has_value());
+  PH_CHECK(arena.append("/b").has_value());
+  TextSpan paths = arena.spanFrom(begin);
+  PH_CHECK(paths.offset == 5u);
+  PH_CHECK(paths.length == 5u);
+  PH_CHECK(std::string_view(arena.bytes().data() + paths.offset, paths.length) == std::string_view("/a\0/b", 5u));
+
+  const size_t capacity = arena.capacity();
+  arena.reset();
+  PH_CHECK(arena.size() == 0u);
+  PH_CHECK(arena.capacity() == capacity);
+}
+
+PH_TEST("primehost.text_buffer", "event text copies out as one region") {
+  TextArena arena;
+  PH_CHECK(arena.append("consumed").has_value());
+  std::vector<Event> events;
+  events.push_back(text_event(*arena.append("ab")));
+  events.push_back(Event{});
+  events.push_back(drop_event(*arena.append(std::string_view("/x\0/y", 5u)), 2u));
+  events.push_back(text_event(*arena.append("")));
+
+  auto range = eventTextRange(events);
+  PH_CHECK(range.first == 8u);
+  PH_CHECK(range.second == 15u);
+
+  std::array<char, 6> tooSmall{};
+  std::vector<Event> untouched = events;
+  auto failed = copyEventText(untouched, arena, tooSmall);
+  PH_REQUIRE(!failed.has_value());
+  PH_CHECK(failed.error().code == HostErrorCode::BufferTooSmall);
+  PH_CHECK(eventTextSpan(untouched[0])->offset == 8u);
+
+  std::array<char, 16> out{};
+  auto copied = copyEventText(events, arena, out);
+  PH_REQUIRE(copied.has_value());
+  PH_CHECK(*copied == 7u);
+  std::span<const char> bytes(out.data(), *copied);
+  PH_CHECK(span_text(bytes, eventTextSpan(events[0])) == "ab");
+  PH_CHECK(eventTextSpan(events[1]) == nullptr);
+  PH_CHECK(span_text(bytes, eventTextSpan(events[2])) == std::string_view("/x\0/y", 5u));
+  PH_CHECK(eventTextSpan(events[3])->offset == 7u);
+  PH_CHECK(eventTextSpan(events[3])->length == 0u);
+}
+
+PH_TEST("primehost.text_buffer", "oversized text ends the batch and is reported pending") {
+  TextArena arena;
+  std::vector<Event> events;
+  events.push_back(text_event(*arena.append("abc")));
+  events.push_back(Event{});
+  events.push_back(drop_event(*arena.append(std::string(64u, 'p')), 1u));
+  events.push_back(text_event(*arena.append("z")));
+
+  PH_CHECK(eventsFittingText(events, 0u) == 0u);
+  PH_CHECK(eventsFittingText(events, 3u) == 2u);
+  PH_CHECK(eventsFittingText(events, 66u) == 2u);
+  PH_CHECK(eventsFittingText(events, 67u) == 3u);
+  PH_CHECK(eventsFittingText(events, 68u) == 4u);
+  PH_CHECK(eventsFittingText(std::span<const Event>(events).subspan(1u, 1u), 0u) == 1u);
+
+  EventBufferSize rest = eventBufferSize(std::span<const Event>(events).subspan(2u));
+  PH_CHECK(rest.events == 2u);
+  PH_CHECK(rest.textBytes == 65u);
+  EventBufferSize none = eventBufferSize({});
+  PH_CHECK(none.events == 0u);
+  PH_CHECK(none.textBytes == 0u);
+}
+
+PH_TEST("primehost.text_buffer", "discarding consumed text rebases queued spans") {
+  TextArena arena;
+  PH_CHECK(arena.append("old text").has_value());
+  std::vector<Event> queued{text_event(*arena.append("kept"))};
+  const size_t consumed = eventTextRange(queued).first;
+  arena.discardFront(consumed);
+  rebaseEventText(queued, consumed);
+  PH_CHECK(arena.size() == 4u);
+  PH_CHECK(span_text(arena.bytes(), eventTextSpan(queued[0])) == "kept");
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,40 @@
+#include "TokenMatchUtil.h"
+
+#include "tests/unit/test_helpers.h"
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.tokenmatch");
+
+namespace {
+
+constexpr std::array<std::string_view, 4> kTokens{"he", "she", "his", "hers"};
+constexpr TokenMatcher<kTokens.size(), tokenMatcherStateCount(kTokens)> kMatcher(kTokens);
+static_assert(kMatcher.valid());
+
+} // namespace
+
+PH_TEST("primehost.tokenmatch", "finds overlapping tokens") {
+  PH_CHECK(kMatcher.matchMask("ushers") == 0b1011u);
+  PH_CHECK(kMatcher.matchMask("HIS") == 0b0100u);
+  PH_CHECK(kMatcher.matchMask("") == 0u);
+  PH_CHECK(kMatcher.matchMask("h-e") == 0u);
+  PH_CHECK(kMatcher.firstMatch("Ushers") == 0u);
+  PH_CHECK(kMatcher.firstMatch("this") == 2u);
+  PH_CHECK(!kMatcher.firstMatch("xyz").has_value());
+}
+
+PH_TEST("primehost.tokenmatch", "spaces and invalid tokens") {
+  constexpr std::array<std::string_view, 2> tokens{"switch pro", "8bitdo"};
+  constexpr TokenMatcher<tokens.size(), tokenMatcherStateCount(tokens)> matcher(tokens);
+  PH_CHECK(matcher.valid());
+  PH_CHECK(matcher.firstMatch("Nintendo Switch Pro Controller") == 0u);
+  PH_CHECK(!matcher.firstMatch("Nintendo Switch-Pro").has_value());
+  PH_CHECK(matcher.firstMatch("8BitDo SN30") == 1u);
+
+  constexpr std::array<std::string_view, 1> invalid{"joy-con"};
+  constexpr TokenMatcher<invalid.size(), tokenMatcherStateCount(invalid)> rejected(invalid);
+  PH_CHECK(!rejected.valid());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,54 @@
+#include "src/WavFileUtil.h"
+
+#include "tests/unit/test_helpers.h"
+
+#include <vector>
+
+using namespace PrimeHost;
+
+TEST_SUITE_BEGIN("primehost.wav");
+
+PH_TEST("primehost.wav", "float32 round trip") {
+  WavAudio audio{};
+  audio.sampleRate = 44100u;
+  audio.channels = 2u;
+  audio.samples = {0.0f, 0.5f, -0.5f, 1.0f};
+  std::vector<uint8_t> bytes = encodeWavFloat32(audio);
+  PH_CHECK(bytes.size() == 44u + 16u);
+  auto decoded = decodeWav(bytes);
+  PH_REQUIRE(decoded.has_value());
+  PH_CHECK(decoded->sampleRate == 44100u);
+  PH_CHECK(decoded->channels == 2u);
+  PH_CHECK(decoded->samples == audio.samples);
+}
+
+PH_TEST("primehost.wav", "pcm16 decode and rejects") {
+  WavAudio audio{};
+  audio.sampleRate = 8000u;
+  audio.channels = 1u;
+  audio.samples = {0.0f, 0.0f};
+  std::vector<uint8_t> bytes = encodeWavFloat32(audio);
+  // Rewrite the header as 16-bit PCM carrying four samples.
+  bytes[20] = 1u;
+  bytes[34] = 16u;
+  bytes[44] = 0x00;
+  bytes[45] = 0x40;
+  bytes[46] = 0x00;
+  bytes[47] = 0xC0;
+  auto decoded = decodeWav(bytes);
+  PH_REQUIRE(decoded.has_value());
+  PH_REQUIRE(decoded->samples.size() == 4u);
+  PH_CHECK(decoded->samples[0] == doctest::Approx(0.5f));
+  PH_CHECK(decoded->samples[1] == doctest::Approx(-0.5f));
+
+  bytes[34] = 24u;
+  auto unsupported = decodeWav(bytes);
+  PH_CHECK(!unsupported.has_value());
+  PH_CHECK(unsupported.error().code == HostErrorCode::Unsupported);
+
+  std::vector<uint8_t> garbage(8u, 0u);
+  PH_CHECK(!decodeWav(garbage).has_value());
+  PH_CHECK(!readWavFile("/nonexistent/primehost.wav").has_value());
+}
+
+TEST_SUITE_END();